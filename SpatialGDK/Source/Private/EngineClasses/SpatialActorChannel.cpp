@@ -12,15 +12,20 @@
 #include "EngineClasses/SpatialNetConnection.h"
 #include "EngineClasses/SpatialNetDriver.h"
 #include "EngineClasses/SpatialPackageMapClient.h"
+#include "Interop/SpatialDispatcher.h"
 #include "Interop/SpatialSender.h"
 #include "Interop/SpatialReceiver.h"
 #include "Interop/GlobalStateManager.h"
 #include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
 #include "Utils/EntityRegistry.h"
 #include "Utils/RepLayoutUtils.h"
 
 DEFINE_LOG_CATEGORY(LogSpatialActorChannel);
 
+DECLARE_CYCLE_STAT(TEXT("Actor Channel Handover Compare"), STAT_SpatialHandoverCompare, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Handover Objects Compared"), STAT_SpatialHandoverObjectsCompared, STATGROUP_SpatialNet);
+
 namespace
 {
 // This is a bookkeeping function that is similar to the one in RepLayout.cpp, modified for our needs (e.g. no NaKs)
@@ -61,9 +66,19 @@ USpatialActorChannel::USpatialActorChannel(const FObjectInitializer& ObjectIniti
 	: Super(ObjectInitializer)
 	, EntityId(0)
 	, bFirstTick(true)
+	, bNetOwned(false)
 	, NetDriver(nullptr)
 	, LastSpatialPosition(FVector::ZeroVector)
 	, LastSpatialRotation(FRotator::ZeroRotator)
+	, LastSpatialTransformUpdateTime(0.0f)
+	, LastReplicatedSpatialPosition(FVector::ZeroVector)
+	, LastReplicatedRotation(FRotator::ZeroRotator)
+	, bMovedLastReplication(false)
+	, SpatialPositionThresholdSquared(0.0f)
+	, SpatialRotationThreshold(0.0f)
+	, MinSpatialTransformUpdateInterval(0.0f)
+	, bAllHandoverDirty(false)
+	, LastHandoverFullCompareTime(0.0f)
 	, bCreatingNewEntity(false)
 {
 }
@@ -259,11 +274,30 @@ int64 USpatialActorChannel::ReplicateActor()
 		PlayerController->SendClientAdjustment();
 	}
 
+	// Ownership is changed by gameplay code on the authoritative server, so check for it here rather than polling every channel.
+	if (IsNetOwned() != bNetOwned)
+	{
+		MarkViewDirty();
+	}
+
 	// Update SpatialOS position.
 	if (!PlayerController && !Cast<APlayerState>(Actor))
 	{
-		UpdateSpatialPosition();
-		UpdateSpatialRotation();
+		// The transform an actor comes to rest with is always sent, even if the update rate holds it back or it is within the thresholds
+		// of the last one sent, since the actor may not move, and so may not be checked again, for a long time.
+		const FVector ActorSpatialPosition = GetActorSpatialPosition(Actor);
+		const FRotator ActorRotation = Actor->GetActorRotation();
+		const bool bMoved = ActorSpatialPosition != LastReplicatedSpatialPosition || ActorRotation != LastReplicatedRotation;
+		const bool bCameToRest = bMovedLastReplication && !bMoved;
+		LastReplicatedSpatialPosition = ActorSpatialPosition;
+		LastReplicatedRotation = ActorRotation;
+		bMovedLastReplication = bMoved;
+
+		if (bCameToRest || Connection->Driver->Time - LastSpatialTransformUpdateTime >= MinSpatialTransformUpdateInterval)
+		{
+			UpdateSpatialPosition(bCameToRest);
+			UpdateSpatialRotation(bCameToRest);
+		}
 	}
 	
 	// Update the replicated property change list.
@@ -294,8 +328,27 @@ int64 USpatialActorChannel::ReplicateActor()
 
 	ActorReplicator->RepState->LastCompareIndex = ChangelistState->CompareIndex;
 
+	// Unless a full compare is due, only compare the handover properties of objects which were marked as dirty.
+	const float HandoverFullCompareInterval = GetDefault<USpatialGDKSettings>()->HandoverFullCompareInterval;
+	const bool bFullHandoverCompareDue = HandoverFullCompareInterval <= 0.0f || Connection->Driver->Time - LastHandoverFullCompareTime >= HandoverFullCompareInterval;
+	if (bFullHandoverCompareDue)
+	{
+		LastHandoverFullCompareTime = Connection->Driver->Time;
+	}
+	const bool bFullHandoverCompare = bFullHandoverCompareDue || bAllHandoverDirty;
+
+	// Handover state tends to change along with replicated state, so compare it whenever the replicated properties changed.
+	if (RepChanged.Num() > 0)
+	{
+		MarkHandoverDirty(Actor);
+	}
+
 	// Update the handover property change list.
-	FHandoverChangeState HandoverChangeState = GetHandoverChangeList(*ActorHandoverShadowData, Actor);
+	FHandoverChangeState HandoverChangeState;
+	if (ShouldCompareHandover(Actor, bFullHandoverCompare))
+	{
+		HandoverChangeState = GetHandoverChangeList(*ActorHandoverShadowData, Actor);
+	}
 
 	// If any properties have changed, send a component update.
 	if (bCreatingNewEntity || RepChanged.Num() > 0 || HandoverChangeState.Num() > 0)
@@ -339,13 +392,23 @@ int64 USpatialActorChannel::ReplicateActor()
 		{
 			if (ClassInfo->SubobjectClasses.Contains(ActorComponent->GetClass()))
 			{
-				bWroteSomethingImportant |= ReplicateSubobject(ActorComponent, RepFlags);
+				if (ReplicateSubobject(ActorComponent, RepFlags))
+				{
+					MarkHandoverDirty(ActorComponent);
+					bWroteSomethingImportant = true;
+				}
 				bWroteSomethingImportant |= ActorComponent->ReplicateSubobjects(this, &DummyOutBunch, &RepFlags);
 			}
 		}
 
-		for (UObject* Subobject : NetDriver->TypebindingManager->GetHandoverSubobjects(Actor))
+		for (int32 SubobjectIndex : ClassInfo->HandoverSubobjectIndices)
 		{
+			UObject* Subobject = GetResolvedSubobject(SubobjectIndex);
+			if (Subobject == nullptr || !ShouldCompareHandover(Subobject, bFullHandoverCompare))
+			{
+				continue;
+			}
+
 			// Handover shadow data should already exist for this object. If it doesn't, it must have
 			// started replicating after SetChannelActor was called on the owning actor.
 			TArray<uint8>& SubobjectHandoverShadowData = HandoverShadowDataMap.FindChecked(Subobject).Get();
@@ -357,6 +420,9 @@ int64 USpatialActorChannel::ReplicateActor()
 		}
 	}
 
+	HandoverDirtyObjects.Empty();
+	bAllHandoverDirty = false;
+
 	// TODO: Handle deleted subobjects - see DataChannel.cpp:2542 - UNR:581
 
 	// If we evaluated everything, mark LastUpdateTime, even if nothing changed.
@@ -424,6 +490,25 @@ bool USpatialActorChannel::ReplicateSubobject(UObject* Obj, FOutBunch& Bunch, co
 	return ReplicateSubobject(Obj, RepFlags);
 }
 
+void USpatialActorChannel::ResolveSubobjects(const FClassInfo& Info)
+{
+	ResolvedSubobjects.Reset();
+	ResolvedSubobjects.SetNum(Info.SubobjectIndices.Num());
+
+	TArray<UObject*> DefaultSubobjects;
+	Actor->GetDefaultSubobjects(DefaultSubobjects);
+
+	for (UObject* Subobject : DefaultSubobjects)
+	{
+		// Like a search by class, the first subobject of each class is the one that gets replicated.
+		const int32* SubobjectIndex = Info.SubobjectIndices.Find(Subobject->GetClass());
+		if (SubobjectIndex != nullptr && !ResolvedSubobjects[*SubobjectIndex].IsValid())
+		{
+			ResolvedSubobjects[*SubobjectIndex] = Subobject;
+		}
+	}
+}
+
 void USpatialActorChannel::InitializeHandoverShadowData(TArray<uint8>& ShadowData, UObject* Object)
 {
 	FClassInfo* ClassInfo = NetDriver->TypebindingManager->FindClassInfoByClass(Object->GetClass());
@@ -452,8 +537,26 @@ void USpatialActorChannel::InitializeHandoverShadowData(TArray<uint8>& ShadowDat
 	}
 }
 
+bool USpatialActorChannel::ShouldCompareHandover(UObject* Object, bool bFullHandoverCompare) const
+{
+	return bCreatingNewEntity || bFullHandoverCompare || HandoverDirtyObjects.Contains(Object);
+}
+
+void USpatialActorChannel::MarkHandoverDirty(UObject* Object)
+{
+	HandoverDirtyObjects.Add(Object);
+}
+
+void USpatialActorChannel::MarkAllHandoverDirty()
+{
+	bAllHandoverDirty = true;
+}
+
 FHandoverChangeState USpatialActorChannel::GetHandoverChangeList(TArray<uint8>& ShadowData, UObject* Object)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SpatialHandoverCompare);
+	INC_DWORD_STAT(STAT_SpatialHandoverObjectsCompared);
+
 	FHandoverChangeState HandoverChanged;
 
 	FClassInfo* ClassInfo = NetDriver->TypebindingManager->FindClassInfoByClass(Object->GetClass());
@@ -482,11 +585,23 @@ void USpatialActorChannel::SetChannelActor(AActor* InActor)
 {
 	Super::SetChannelActor(InActor);
 
-	if (NetDriver->TypebindingManager->FindClassInfoByClass(InActor->GetClass()) == nullptr)
+	FClassInfo* Info = NetDriver->TypebindingManager->FindClassInfoByClass(InActor->GetClass());
+	if (Info == nullptr)
 	{
 		return;
 	}
 
+	ResolveSubobjects(*Info);
+
+	const FSpatialTransformReplicationSettings& TransformSettings = GetDefault<USpatialGDKSettings>()->GetTransformReplicationSettings(InActor->GetClass());
+	SpatialPositionThresholdSquared = FMath::Square(TransformSettings.PositionThreshold);
+	SpatialRotationThreshold = FMath::DegreesToRadians(TransformSettings.RotationThreshold);
+	MinSpatialTransformUpdateInterval = TransformSettings.MaxUpdateRate > 0.0f ? 1.0f / TransformSettings.MaxUpdateRate : 0.0f;
+
+	// An actor which never moves never comes to rest.
+	LastReplicatedSpatialPosition = GetActorSpatialPosition(InActor);
+	LastReplicatedRotation = InActor->GetActorRotation();
+
 	// Set up the shadow data for the handover properties. This is used later to compare the properties and send only changed ones.
 	check(!HandoverShadowDataMap.Contains(InActor));
 
@@ -495,8 +610,10 @@ void USpatialActorChannel::SetChannelActor(AActor* InActor)
 	InitializeHandoverShadowData(*ActorHandoverShadowData, InActor);
 
 	// Assume that all the replicated static components are already set as such. This is checked later in ReplicateSubobject.
-	for (UObject* Subobject : NetDriver->TypebindingManager->GetHandoverSubobjects(InActor))
+	for (int32 SubobjectIndex : Info->HandoverSubobjectIndices)
 	{
+		UObject* Subobject = GetResolvedSubobject(SubobjectIndex);
+		check(Subobject);
 		check(!HandoverShadowDataMap.Contains(Subobject));
 		InitializeHandoverShadowData(HandoverShadowDataMap.Add(Subobject, MakeShared<TArray<uint8>>()).Get(), Subobject);
 	}
@@ -509,7 +626,7 @@ void USpatialActorChannel::SetChannelActor(AActor* InActor)
 	if (EntityId == 0)
 	{
 		bCreatingNewEntity = true;
-		Sender->SendReserveEntityIdRequest(this);
+		Sender->ReserveEntityId(this);
 	}
 	else
 	{
@@ -518,6 +635,13 @@ void USpatialActorChannel::SetChannelActor(AActor* InActor)
 		// Inform USpatialNetDriver of this new actor channel/entity pairing
 		NetDriver->AddActorChannel(EntityId, this);
 	}
+
+	// Actors this server is authoritative over are tracked from the start, rather than once they first move far enough
+	// to send a position update. Actors which gain authority later are added by the receiver.
+	if (NetDriver->ActorGrid.IsValid() && InActor->Role == ROLE_Authority)
+	{
+		NetDriver->ActorGrid->AddOrUpdateActor(InActor, GetActorSpatialPosition(InActor));
+	}
 }
 
 FObjectReplicator& USpatialActorChannel::PreReceiveSpatialUpdate(UObject* TargetObject)
@@ -527,7 +651,13 @@ FObjectReplicator& USpatialActorChannel::PreReceiveSpatialUpdate(UObject* Target
 
 	FObjectReplicator& Replicator = FindOrCreateReplicator(TargetObject).Get();
 	TargetObject->PreNetReceive();
-	Replicator.RepLayout->InitShadowData(Replicator.RepState->StaticBuffer, TargetObject->GetClass(), (uint8*)TargetObject);
+
+	// The shadow data is kept up to date field by field as updates are applied (see ComponentReader::ApplySchemaObject),
+	// so it only needs to be built from scratch the first time this object receives anything.
+	if (Replicator.RepState->StaticBuffer.Num() == 0)
+	{
+		Replicator.RepLayout->InitShadowData(Replicator.RepState->StaticBuffer, TargetObject->GetClass(), (uint8*)TargetObject);
+	}
 
 	return Replicator;
 }
@@ -582,8 +712,13 @@ void USpatialActorChannel::OnReserveEntityIdResponse(const Worker_ReserveEntityI
 	}
 
 	UE_LOG(LogSpatialActorChannel, Verbose, TEXT("Reserved entity id (%lld) for: %s."), Op.entity_id, *Actor->GetName());
-  
-	EntityId = Op.entity_id;
+
+	OnEntityIdReserved(Op.entity_id);
+}
+
+void USpatialActorChannel::OnEntityIdReserved(Worker_EntityId ReservedEntityId)
+{
+	EntityId = ReservedEntityId;
 	RegisterEntityId(EntityId);
 
 	// Register Actor with package map since we know what the entity id is.
@@ -619,23 +754,28 @@ void USpatialActorChannel::OnCreateEntityResponse(const Worker_CreateEntityRespo
 	UE_LOG(LogSpatialActorChannel, Verbose, TEXT("Created entity (%lld) for: %s."), Op.entity_id, *Actor->GetName());
 }
 
-void USpatialActorChannel::UpdateSpatialPosition()
+void USpatialActorChannel::UpdateSpatialPosition(bool bCameToRest)
 {
 	// PlayerController's and PlayerState's are a special case here. To ensure that they and their associated pawn are 
 	// handed between workers at the same time (which is not guaranteed), we ensure that we update the position component 
 	// of the PlayerController and PlayerState at the same time as the pawn.
 
-	// Check that it has moved sufficiently far to be updated
-	const float SpatialPositionThreshold = 100.0f * 100.0f; // 1m (100cm)
+	// Check that it has moved sufficiently far to be updated, or at all if this is where it came to rest.
 	FVector ActorSpatialPosition = GetActorSpatialPosition(Actor);
-	if (FVector::DistSquared(ActorSpatialPosition, LastSpatialPosition) < SpatialPositionThreshold)
+	if (bCameToRest ? ActorSpatialPosition == LastSpatialPosition : FVector::DistSquared(ActorSpatialPosition, LastSpatialPosition) < SpatialPositionThresholdSquared)
 	{
 		return;
 	}
 
 	LastSpatialPosition = ActorSpatialPosition;
+	LastSpatialTransformUpdateTime = Connection->Driver->Time;
 	Sender->SendPositionUpdate(EntityId, LastSpatialPosition);
 
+	if (NetDriver->ActorGrid.IsValid())
+	{
+		NetDriver->ActorGrid->AddOrUpdateActor(Actor, LastSpatialPosition);
+	}
+
 	// If we're a pawn and are controlled by a player controller, update the player controller and the player state positions too.
 	if (APawn* Pawn = Cast<APawn>(Actor))
 	{
@@ -655,20 +795,18 @@ void USpatialActorChannel::UpdateSpatialPosition()
 	}
 }
 
-void USpatialActorChannel::UpdateSpatialRotation()
+void USpatialActorChannel::UpdateSpatialRotation(bool bCameToRest)
 {
 	FRotator ActorSpatialRotation = Actor->GetActorRotation();
 
-	// Only update the Actor's rotation if it has rotated far enough
-	const float SpatialRotationThreshold = 0.1f;  // 0.1 radian (~5.7 degrees)
-	FQuat RotationDelta = (ActorSpatialRotation - LastSpatialRotation).Quaternion();
-	RotationDelta.Normalize();
-	if (RotationDelta.GetAngle() < SpatialRotationThreshold)
+	// Only update the Actor's rotation if it has rotated far enough, or at all if this is where it came to rest.
+	if (bCameToRest ? ActorSpatialRotation == LastSpatialRotation : ActorSpatialRotation.Quaternion().AngularDistance(LastSpatialRotation.Quaternion()) < SpatialRotationThreshold)
 	{
 		return;
 	}
 
 	LastSpatialRotation = ActorSpatialRotation;
+	LastSpatialTransformUpdateTime = Connection->Driver->Time;
 	Sender->SendRotationUpdate(EntityId, Actor->GetActorRotation());
 }
 
@@ -691,32 +829,44 @@ FVector USpatialActorChannel::GetActorSpatialPosition(AActor* InActor)
 	}
 }
 
+bool USpatialActorChannel::IsNetOwned() const
+{
+	// Use Actor's connection to determine if client owned
+	if (UNetConnection* NetConnection = Actor->GetNetConnection())
+	{
+		if (APlayerController* PlayerController = NetConnection->PlayerController)
+		{
+			return PlayerController->PlayerState != nullptr;
+		}
+	}
+
+	return false;
+}
+
 void USpatialActorChannel::SpatialViewTick()
 {
 	if (Actor != nullptr && !Actor->IsPendingKill() && IsReadyForReplication())
 	{
 		bool bOldNetOwned = bNetOwned;
-
-		// Use Actor's connection to determine if client owned
-		bNetOwned = false;
-		if (UNetConnection* NetConnection = Actor->GetNetConnection())
-		{
-			if (APlayerController* PlayerController = NetConnection->PlayerController)
-			{
-				bNetOwned = PlayerController->PlayerState != nullptr;
-			}
-		}
+		bNetOwned = IsNetOwned();
 
 		if (bFirstTick || bOldNetOwned != bNetOwned)
 		{
 			if (IsAuthoritativeServer())
 			{
-				bool bSuccess = Sender->UpdateEntityACLs(Actor, GetEntityId());
+				// Gaining authority over the EntityACL marks the channel dirty again, so wait for that rather than retrying every tick.
+				// If the update fails anyway, the ownership sweep in USpatialDispatcher will try again.
+				bool bSuccess = NetDriver->StaticComponentView->HasAuthority(GetEntityId(), SpatialConstants::ENTITY_ACL_COMPONENT_ID) &&
+					Sender->UpdateEntityACLs(Actor, GetEntityId());
 
 				if (bFirstTick && bSuccess)
 				{
 					bFirstTick = false;
 				}
+				else if (!bSuccess)
+				{
+					bNetOwned = bOldNetOwned;
+				}
 			}
 			else if (!NetDriver->IsServer())
 			{
@@ -727,3 +877,26 @@ void USpatialActorChannel::SpatialViewTick()
 		}
 	}
 }
+
+bool USpatialActorChannel::NeedsViewTick()
+{
+	if (Actor == nullptr || Actor->IsPendingKill() || !IsReadyForReplication())
+	{
+		return false;
+	}
+
+	if (bFirstTick)
+	{
+		return IsAuthoritativeServer() || !NetDriver->IsServer();
+	}
+
+	return IsNetOwned() != bNetOwned;
+}
+
+void USpatialActorChannel::MarkViewDirty()
+{
+	if (NetDriver->Dispatcher != nullptr)
+	{
+		NetDriver->Dispatcher->MarkChannelDirty(this);
+	}
+}
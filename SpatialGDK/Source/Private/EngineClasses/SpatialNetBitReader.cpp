@@ -9,8 +9,9 @@
 
 DEFINE_LOG_CATEGORY(LogSpatialNetBitReader);
 
-FSpatialNetBitReader::FSpatialNetBitReader(USpatialPackageMapClient* InPackageMap, uint8* Source, int64 CountBits, TSet<FUnrealObjectRef>& InUnresolvedRefs)
-	: FNetBitReader(InPackageMap, Source, CountBits)
+// FBitReader takes its own copy of Source, so it is never written to.
+FSpatialNetBitReader::FSpatialNetBitReader(USpatialPackageMapClient* InPackageMap, const uint8* Source, int64 CountBits, TSet<FUnrealObjectRef>& InUnresolvedRefs)
+	: FNetBitReader(InPackageMap, const_cast<uint8*>(Source), CountBits)
 	, UnresolvedRefs(InUnresolvedRefs) {}
 
 void FSpatialNetBitReader::DeserializeObjectRef(FUnrealObjectRef& ObjectRef)
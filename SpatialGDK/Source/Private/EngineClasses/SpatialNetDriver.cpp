@@ -26,10 +26,14 @@
 #include "EngineClasses/SpatialPackageMapClient.h"
 #include "EngineClasses/SpatialPendingNetGame.h"
 #include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
 #include "Utils/EntityRegistry.h"
 
 DEFINE_LOG_CATEGORY(LogSpatialOSNetDriver);
 
+DECLARE_CYCLE_STAT(TEXT("Prioritize Actors"), STAT_SpatialPrioritizeActors, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Prioritized"), STAT_SpatialActorsPrioritized, STATGROUP_SpatialNet);
+
 bool USpatialNetDriver::InitBase(bool bInitAsClient, FNetworkNotify* InNotify, const FURL& URL, bool bReuseAddressAndPort, FString& Error)
 {
 	if (!Super::InitBase(bInitAsClient, InNotify, URL, bReuseAddressAndPort, Error))
@@ -40,6 +44,7 @@ bool USpatialNetDriver::InitBase(bool bInitAsClient, FNetworkNotify* InNotify, c
 	bConnectAsClient = bInitAsClient;
 
 	bAuthoritativeDestruction = true;
+	NextFarConsiderIndex = 0;
 
 	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &USpatialNetDriver::OnMapLoaded);
 
@@ -47,7 +52,7 @@ bool USpatialNetDriver::InitBase(bool bInitAsClient, FNetworkNotify* InNotify, c
 	ChannelClasses[CHTYPE_Actor] = USpatialActorChannel::StaticClass();
 
 	TypebindingManager = NewObject<USpatialTypebindingManager>();
-	TypebindingManager->Init();
+	TypebindingManager->Init(this);
 
 	// We do this here straight away to trigger LoadMap.
 	if (bInitAsClient)
@@ -82,6 +87,15 @@ void USpatialNetDriver::PostInitProperties()
 	}
 }
 
+void USpatialNetDriver::BeginDestroy()
+{
+	// The output device's flush thread sends through the worker connection, so it has to be stopped before the
+	// connection can be finished off. Objects unreachable in the same GC pass all begin destruction before any finish it.
+	SpatialOutputDevice.Reset();
+
+	Super::BeginDestroy();
+}
+
 void USpatialNetDriver::OnMapLoaded(UWorld* LoadedWorld)
 {
 	if (LoadedWorld->GetNetDriver() != this)
@@ -109,6 +123,8 @@ void USpatialNetDriver::OnMapLoaded(UWorld* LoadedWorld)
 	}
 
 	Connection = NewObject<USpatialWorkerConnection>();
+	Connection->ComponentLayouts = TypebindingManager->GetComponentLayouts();
+	Connection->bConnectToMock = LoadedWorld->URL.HasOption(TEXT("mockConnection"));
 
 	if (LoadedWorld->URL.HasOption(TEXT("locator")))
 	{
@@ -219,6 +235,21 @@ void USpatialNetDriver::NotifyActorDestroyed(AActor* ThisActor, bool IsSeamlessT
 	// Remove the actor from the property tracker map
 	RepChangedPropertyTrackerMap.Remove(ThisActor);
 
+	if (ActorGrid.IsValid())
+	{
+		ActorGrid->RemoveActor(ThisActor);
+	}
+
+	// Nothing can apply the operations still waiting on unresolved references for this actor.
+	if (Receiver != nullptr)
+	{
+		Receiver->DropPendingOperations(ThisActor);
+	}
+	if (Sender != nullptr)
+	{
+		Sender->DropPendingOperations(ThisActor);
+	}
+
 	const bool bIsServer = ServerConnection == nullptr;
 
 	if (bIsServer)
@@ -346,8 +377,66 @@ int32 USpatialNetDriver::ServerReplicateActors_PrepConnections(const float Delta
 	return bFoundReadyConnection ? NumClientsToTick : 0;
 }
 
+void USpatialNetDriver::UpdateActorGrid()
+{
+	// The grid is only used to prioritize actors near players, so it is only maintained while that is turned on.
+	const USpatialGDKSettings* SpatialGDKSettings = GetDefault<USpatialGDKSettings>();
+	if (SpatialGDKSettings->MaxActorReplicationsPerTick == 0 || SpatialGDKSettings->NearPlayerPriorityMultiplier <= 1.0f)
+	{
+		ActorGrid.Reset();
+		return;
+	}
+
+	if (ActorGrid.IsValid())
+	{
+		return;
+	}
+
+	// From here on actor channels and the receiver keep the grid up to date, but nothing has until now,
+	// so start it off with every actor this server has a channel for and is authoritative over.
+	ActorGrid = MakeUnique<FSpatialActorGrid>(SpatialGDKSettings->ActorGridCellSize);
+	for (UNetConnection* ClientConnection : ClientConnections)
+	{
+		for (const auto& ActorChannelPair : ClientConnection->ActorChannelMap())
+		{
+			USpatialActorChannel* Channel = Cast<USpatialActorChannel>(ActorChannelPair.Value);
+			AActor* Actor = Channel != nullptr ? Channel->Actor : nullptr;
+			if (Actor != nullptr && Actor->Role == ROLE_Authority)
+			{
+				ActorGrid->AddOrUpdateActor(Actor, Channel->GetActorSpatialPosition(Actor));
+			}
+		}
+	}
+}
+
+void USpatialNetDriver::GatherActorsNearPlayers(TSet<AActor*>& OutActors) const
+{
+	if (!ActorGrid.IsValid())
+	{
+		return;
+	}
+
+	const float PlayerPriorityDistance = GetDefault<USpatialGDKSettings>()->PlayerPriorityDistance;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || PlayerController->Role != ROLE_Authority)
+		{
+			continue;
+		}
+
+		if (AActor* ViewTarget = PlayerController->GetViewTarget())
+		{
+			ActorGrid->GatherActorsNear(ViewTarget->GetActorLocation(), PlayerPriorityDistance, OutActors);
+		}
+	}
+}
+
 int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection* InConnection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*> ConsiderList, const bool bCPUSaturated, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SpatialPrioritizeActors);
+
 	// Get list of visible/relevant actors.
 
 	NetTag++;
@@ -362,6 +451,8 @@ int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection*
 	int32 FinalSortedCount = 0;
 	int32 DeletedCount = 0;
 
+	UpdateActorGrid();
+
 	const int32 MaxSortedActors = ConsiderList.Num() + DestroyedStartupOrDormantActors.Num();
 	if (MaxSortedActors > 0)
 	{
@@ -371,10 +462,36 @@ int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection*
 		AGameNetworkManager* const NetworkManager = World->NetworkManager;
 		const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
 
-		for (FNetworkObjectInfo* ActorInfo : ConsiderList)
+		// SpatialGDK: Priority only matters when the number of actors replicated per tick is limited, in which case
+		// actors near the players on this worker are bumped up the list. The grid then also decides which actors are
+		// worth prioritizing at all: every actor near a player, but only as many of the rest as could fill the limit
+		// on their own. The rest take turns, starting each tick where the last one left off.
+		const int32 MaxActorReplicationsPerTick = (int32)GetDefault<USpatialGDKSettings>()->MaxActorReplicationsPerTick;
+		const float NearPlayerPriorityMultiplier = GetDefault<USpatialGDKSettings>()->NearPlayerPriorityMultiplier;
+		TSet<AActor*> ActorsNearPlayers;
+		int32 NumFarCandidatesLeft = MAX_int32;
+		int32 FirstConsiderIndex = 0;
+		if (MaxActorReplicationsPerTick > 0 && ActorGrid.IsValid())
+		{
+			GatherActorsNearPlayers(ActorsNearPlayers);
+			NumFarCandidatesLeft = MaxActorReplicationsPerTick;
+			FirstConsiderIndex = ConsiderList.Num() > 0 ? NextFarConsiderIndex % ConsiderList.Num() : 0;
+		}
+
+		for (int32 ConsiderCount = 0; ConsiderCount < ConsiderList.Num(); ConsiderCount++)
 		{
+			const int32 ConsiderIndex = (FirstConsiderIndex + ConsiderCount) % ConsiderList.Num();
+			FNetworkObjectInfo* ActorInfo = ConsiderList[ConsiderIndex];
 			AActor* Actor = ActorInfo->Actor;
 
+			const bool bNearPlayer = ActorsNearPlayers.Contains(Actor);
+			if (!bNearPlayer && NumFarCandidatesLeft == 0)
+			{
+				// Not considered this tick, so make sure it is considered again on the next one.
+				ActorInfo->bPendingNetUpdate = true;
+				continue;
+			}
+
 			UActorChannel* Channel = InConnection->ActorChannelMap().FindRef(Actor);
 
 			UNetConnection* PriorityConnection = InConnection;
@@ -385,6 +502,16 @@ int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection*
 				continue;
 			}
 
+			// SpatialGDK: Actors which already have a channel but aren't ready for replication (e.g. because another worker is
+			// authoritative over them) would be skipped by ReplicateActor anyway, so don't spend time prioritizing them.
+			if (USpatialActorChannel* SpatialChannel = Cast<USpatialActorChannel>(Channel))
+			{
+				if (!SpatialChannel->IsReadyForReplication())
+				{
+					continue;
+				}
+			}
+
 			// See of actor wants to try and go dormant
 			if (ShouldActorGoDormant(Actor, ConnectionViewers, Channel, Time, bLowNetBandwidth))
 			{
@@ -433,6 +560,15 @@ int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection*
 				OutPriorityList[FinalSortedCount] = FActorPriority(PriorityConnection, Channel, ActorInfo, ConnectionViewers, bLowNetBandwidth);
 				OutPriorityActors[FinalSortedCount] = OutPriorityList + FinalSortedCount;
 
+				if (bNearPlayer)
+				{
+					OutPriorityList[FinalSortedCount].Priority = (int32)(OutPriorityList[FinalSortedCount].Priority * NearPlayerPriorityMultiplier);
+				}
+				else if (NumFarCandidatesLeft != MAX_int32 && --NumFarCandidatesLeft == 0)
+				{
+					NextFarConsiderIndex = ConsiderIndex + 1;
+				}
+
 				FinalSortedCount++;
 
 				if (DebugRelevantActors)
@@ -452,10 +588,25 @@ int32 USpatialNetDriver::ServerReplicateActors_PrioritizeActors(UNetConnection*
 			DeletedCount++;
 		}
 
-		// Sort by priority
-		Sort(OutPriorityActors, FinalSortedCount, FCompareFActorPriority());
+		// SpatialGDK: Without a limit, every actor in the list is replicated this tick, so the order doesn't matter.
+		// With a limit, only the highest priority actors need to be found, so select them with a heap rather than sorting the whole list.
+		if (MaxActorReplicationsPerTick > 0 && FinalSortedCount > MaxActorReplicationsPerTick)
+		{
+			TArray<FActorPriority*, TMemStackAllocator<>> PriorityHeap;
+			PriorityHeap.Append(OutPriorityActors, FinalSortedCount);
+			PriorityHeap.Heapify(FCompareFActorPriority());
+
+			for (int32 i = 0; i < MaxActorReplicationsPerTick; i++)
+			{
+				PriorityHeap.HeapPop(OutPriorityActors[i], FCompareFActorPriority(), /* bAllowShrinking */ false);
+			}
+
+			FMemory::Memcpy(OutPriorityActors + MaxActorReplicationsPerTick, PriorityHeap.GetData(), PriorityHeap.Num() * sizeof(FActorPriority*));
+		}
 	}
 
+	INC_DWORD_STAT_BY(STAT_SpatialActorsPrioritized, FinalSortedCount);
+
 	UE_LOG(LogNetTraffic, Log, TEXT("ServerReplicateActors_PrioritizeActors: Potential %04i ConsiderList %03i FinalSortedCount %03i"), MaxSortedActors, ConsiderList.Num(), FinalSortedCount);
 
 	return FinalSortedCount;
@@ -737,8 +888,12 @@ int32 USpatialNetDriver::ServerReplicateActors(float DeltaSeconds)
 			// Get a sorted list of actors for this connection
 			const int32 FinalSortedCount = ServerReplicateActors_PrioritizeActors(SpatialConnection, ConnectionViewers, ConsiderList, bCPUSaturated, PriorityList, PriorityActors);
 
+			// SpatialGDK: Only process as many actors as we're allowed to replicate this tick. The rest are marked to be considered next tick below.
+			const int32 MaxActorReplicationsPerTick = (int32)GetDefault<USpatialGDKSettings>()->MaxActorReplicationsPerTick;
+			const int32 NumActorsToProcess = MaxActorReplicationsPerTick > 0 ? FMath::Min(FinalSortedCount, MaxActorReplicationsPerTick) : FinalSortedCount;
+
 			// Process the sorted list of actors for this connection
-			const int32 LastProcessedActor = ServerReplicateActors_ProcessPrioritizedActors(SpatialConnection, ConnectionViewers, PriorityActors, FinalSortedCount, Updated);
+			const int32 LastProcessedActor = ServerReplicateActors_ProcessPrioritizedActors(SpatialConnection, ConnectionViewers, PriorityActors, NumActorsToProcess, Updated);
 
 			// relevant actors that could not be processed this frame are marked to be considered for next frame
 			for (int32 k = LastProcessedActor; k < FinalSortedCount; k++)
@@ -814,11 +969,13 @@ void USpatialNetDriver::TickDispatch(float DeltaTime)
 
 	if (Connection != nullptr && Connection->IsConnected())
 	{
-		Worker_OpList* OpList = Connection->GetOpList();
-
-		Dispatcher->ProcessOps(OpList);
+		// Leave new ops with the connection while the dispatcher is still working through a backlog.
+		if (!Dispatcher->IsBackedUp())
+		{
+			Dispatcher->QueueOpLists(Connection->GetOpLists());
+		}
 
-		Worker_OpList_Destroy(OpList);
+		Dispatcher->ProcessOps();
 	}
 }
 
@@ -896,6 +1053,20 @@ void USpatialNetDriver::TickFlush(float DeltaTime)
 #endif // WITH_SERVER_CODE
 	}
 
+	// Send the component updates queued while replicating, at most one per entity and component.
+	if (Sender != nullptr)
+	{
+		GlobalStateManager->FlushSingletonEntityIds();
+		Sender->FlushComponentUpdates();
+		Sender->RemoveExpiredPendingOperations();
+	}
+
+	if (Receiver != nullptr)
+	{
+		Receiver->RemoveExpiredPendingOperations();
+		Receiver->ProcessReliableRPCRetries();
+	}
+
 	Super::TickFlush(DeltaTime);
 }
 
@@ -1155,6 +1326,9 @@ void USpatialPendingNetGame::SendJoin()
 void USpatialNetDriver::AddActorChannel(Worker_EntityId EntityId, USpatialActorChannel* Channel)
 {
 	EntityToActorChannel.Add(EntityId, Channel);
+
+	// A newly registered channel needs its initial ACL or component interest set up.
+	Channel->MarkViewDirty();
 }
 
 void USpatialNetDriver::RemoveActorChannel(Worker_EntityId EntityId)
@@ -1172,3 +1346,38 @@ USpatialActorChannel* USpatialNetDriver::GetActorChannelByEntityId(Worker_Entity
 {
 	return EntityToActorChannel.FindRef(EntityId);
 }
+
+void USpatialNetDriver::MarkHandoverDirty(UObject* Object)
+{
+	AActor* Actor = Cast<AActor>(Object);
+	if (Actor == nullptr)
+	{
+		Actor = Object->GetTypedOuter<AActor>();
+	}
+
+	if (Actor == nullptr || GetSpatialOSNetConnection() == nullptr)
+	{
+		return;
+	}
+
+	if (USpatialActorChannel* Channel = Cast<USpatialActorChannel>(GetSpatialOSNetConnection()->ActorChannelMap().FindRef(Actor)))
+	{
+		Channel->MarkHandoverDirty(Object);
+	}
+}
+
+void USpatialNetDriver::ForceNetUpdate(AActor* Actor)
+{
+	Super::ForceNetUpdate(Actor);
+
+	// Whatever needs the actor replicated straight away has likely changed its handover state too, so don't leave it for the next full compare.
+	if (GetSpatialOSNetConnection() == nullptr)
+	{
+		return;
+	}
+
+	if (USpatialActorChannel* Channel = Cast<USpatialActorChannel>(GetSpatialOSNetConnection()->ActorChannelMap().FindRef(Actor)))
+	{
+		Channel->MarkAllHandoverDirty();
+	}
+}
@@ -122,7 +122,7 @@ FNetworkGUID FSpatialNetGUIDCache::AssignNewEntityActorNetGUID(AActor* Actor, co
 	// Set up the NetGUID and ObjectRef for this actor.
 	FNetworkGUID NetGUID = GetOrAssignNetGUID_SpatialGDK(Actor);
 	FUnrealObjectRef ObjectRef(EntityId, 0);
-	RegisterObjectRef(NetGUID, ObjectRef);
+	RegisterObjectRef(NetGUID, ObjectRef, FUnrealObjectRefKey(EntityId, 0));
 	UE_LOG(LogSpatialOSPackageMap, Log, TEXT("Registered new object ref for actor: %s. NetGUID: %s, entity ID: %lld"),
 		*Actor->GetName(), *NetGUID.ToString(), EntityId);
 
@@ -145,7 +145,7 @@ FNetworkGUID FSpatialNetGUIDCache::AssignNewEntityActorNetGUID(AActor* Actor, co
 		{
 			FNetworkGUID SubobjectNetGUID = GetOrAssignNetGUID_SpatialGDK(Subobject);
 			FUnrealObjectRef SubobjectRef(EntityId, *Offset);
-			RegisterObjectRef(SubobjectNetGUID, SubobjectRef);
+			RegisterObjectRef(SubobjectNetGUID, SubobjectRef, FUnrealObjectRefKey(EntityId, *Offset));
 			UE_LOG(LogSpatialOSPackageMap, Log, TEXT("Registered new object ref for subobject %s inside actor %s. NetGUID: %s, object ref: %s"),
 				*Subobject->GetName(), *Actor->GetName(), *SubobjectNetGUID.ToString(), *SubobjectRef.ToString());
 
@@ -176,8 +176,10 @@ FNetworkGUID FSpatialNetGUIDCache::AssignNewStablyNamedObjectNetGUID(UObject* Ob
 		OuterGUID = AssignNewStablyNamedObjectNetGUID(OuterObject);
 	}
 
-	FUnrealObjectRef StablyNamedObjRef(0, 0, Object->GetFName().ToString(), (OuterGUID.IsValid() && !OuterGUID.IsDefault()) ? GetUnrealObjectRefFromNetGUID(OuterGUID) : FUnrealObjectRef());
-	RegisterObjectRef(NetGUID, StablyNamedObjRef);
+	const bool bHasOuterRef = OuterGUID.IsValid() && !OuterGUID.IsDefault();
+	const FString Path = Object->GetFName().ToString();
+	FUnrealObjectRef StablyNamedObjRef(0, 0, Path, bHasOuterRef ? GetUnrealObjectRefFromNetGUID(OuterGUID) : FUnrealObjectRef());
+	RegisterObjectRef(NetGUID, StablyNamedObjRef, FUnrealObjectRefKey(0, 0, InternPath(Path), bHasOuterRef ? OuterGUID : FNetworkGUID()));
 
 	return NetGUID;
 }
@@ -196,69 +198,82 @@ void FSpatialNetGUIDCache::RemoveEntityNetGUID(Worker_EntityId EntityId)
 	const SubobjectToOffsetMap& SubobjectNameToOffset = UnrealMetadata->SubobjectNameToOffset;
 	for (const auto& Pair : SubobjectNameToOffset)
 	{
-		FUnrealObjectRef SubobjectRef(EntityId, Pair.Value);
-		if (FNetworkGUID* SubobjectNetGUID = UnrealObjectRefToNetGUID.Find(SubobjectRef))
+		FNetworkGUID SubobjectNetGUID;
+		if (UnrealObjectRefToNetGUID.RemoveAndCopyValue(FUnrealObjectRefKey(EntityId, Pair.Value), SubobjectNetGUID))
 		{
-			NetGUIDToUnrealObjectRef.Remove(*SubobjectNetGUID);
-			UnrealObjectRefToNetGUID.Remove(SubobjectRef);
+			NetGUIDToUnrealObjectRef.Remove(SubobjectNetGUID);
 		}
 	}
 
 	// Remove actor.
-	FNetworkGUID EntityNetGUID = GetNetGUIDFromEntityId(EntityId);
-	FUnrealObjectRef* ActorRef = NetGUIDToUnrealObjectRef.Find(EntityNetGUID);
-	NetGUIDToUnrealObjectRef.Remove(EntityNetGUID);
-	UnrealObjectRefToNetGUID.Remove(*ActorRef);
+	FNetworkGUID EntityNetGUID;
+	if (UnrealObjectRefToNetGUID.RemoveAndCopyValue(FUnrealObjectRefKey(EntityId, 0), EntityNetGUID))
+	{
+		NetGUIDToUnrealObjectRef.Remove(EntityNetGUID);
+	}
 }
 
 FNetworkGUID FSpatialNetGUIDCache::GetNetGUIDFromUnrealObjectRef(const FUnrealObjectRef& ObjectRef)
 {
-	FUnrealObjectRef NetRemappedObjectRef = ObjectRef;
-	NetworkRemapObjectRefPaths(NetRemappedObjectRef);
-	return GetNetGUIDFromUnrealObjectRefInternal(NetRemappedObjectRef);
-}
+	if (!ObjectRef.Path.IsSet())
+	{
+		const FNetworkGUID* CachedGUID = UnrealObjectRefToNetGUID.Find(FUnrealObjectRefKey(ObjectRef.Entity, ObjectRef.Offset));
+		return CachedGUID ? *CachedGUID : FNetworkGUID{};
+	}
 
-FNetworkGUID FSpatialNetGUIDCache::GetNetGUIDFromUnrealObjectRefInternal(const FUnrealObjectRef& ObjectRef)
-{
-	FNetworkGUID* CachedGUID = UnrealObjectRefToNetGUID.Find(ObjectRef);
-	FNetworkGUID NetGUID = CachedGUID ? *CachedGUID : FNetworkGUID{};
-	if (!NetGUID.IsValid() && ObjectRef.Path.IsSet())
+	// Paths are network-sanitized (e.g. removing PIE prefix) before they're looked up, as they were registered with local names.
+	const int32 PathId = GetNetworkRemappedPathId(ObjectRef.Path.GetValue());
+
+	FNetworkGUID OuterGUID;
+	if (ObjectRef.Outer.IsSet())
 	{
-		FNetworkGUID OuterGUID;
-		if (ObjectRef.Outer.IsSet())
+		OuterGUID = GetNetGUIDFromUnrealObjectRef(ObjectRef.Outer.GetValue());
+
+		// Until the outer resolves, the ref can't be told apart from one with the same path and no outer, so leave it unresolved too.
+		// Top level objects are sent with a null outer, which is never registered.
+		if (!OuterGUID.IsValid() && !(ObjectRef.Outer.GetValue() == SpatialConstants::NULL_OBJECT_REF))
 		{
-			OuterGUID = GetNetGUIDFromUnrealObjectRef(ObjectRef.Outer.GetValue());
+			return FNetworkGUID{};
 		}
-		NetGUID = RegisterNetGUIDFromPath(ObjectRef.Path.GetValue(), OuterGUID);
-		RegisterObjectRef(NetGUID, ObjectRef);
 	}
+
+	const FUnrealObjectRefKey ObjectRefKey(ObjectRef.Entity, ObjectRef.Offset, PathId, OuterGUID);
+	if (const FNetworkGUID* CachedGUID = UnrealObjectRefToNetGUID.Find(ObjectRefKey))
+	{
+		return *CachedGUID;
+	}
+
+	const FString& Path = InternedPaths[PathId];
+	FNetworkGUID NetGUID = RegisterNetGUIDFromPath(Path, OuterGUID);
+	FUnrealObjectRef NetRemappedObjectRef(ObjectRef.Entity, ObjectRef.Offset, Path, OuterGUID.IsValid() ? GetUnrealObjectRefFromNetGUID(OuterGUID) : FUnrealObjectRef());
+	RegisterObjectRef(NetGUID, NetRemappedObjectRef, ObjectRefKey);
 	return NetGUID;
 }
 
-void FSpatialNetGUIDCache::NetworkRemapObjectRefPaths(FUnrealObjectRef& ObjectRef) const
+int32 FSpatialNetGUIDCache::InternPath(const FString& Path)
 {
-	// If we have paths, network-sanitize all of them (e.g. removing PIE prefix).
-	if (!ObjectRef.Path.IsSet())
+	if (const int32* PathId = PathToId.Find(Path))
 	{
-		return;
+		return *PathId;
 	}
 
-	FUnrealObjectRef* Iterator = &ObjectRef;
-	while (true)
+	const int32 PathId = InternedPaths.Add(Path);
+	PathToId.Add(Path, PathId);
+	return PathId;
+}
+
+int32 FSpatialNetGUIDCache::GetNetworkRemappedPathId(const FString& Path)
+{
+	if (const int32* PathId = NetworkPathToRemappedId.Find(Path))
 	{
-		if (Iterator->Path.IsSet())
-		{
-			FString TempPath(*Iterator->Path);
-			GEngine->NetworkRemapPath(Driver, TempPath, true);
-			Iterator->Path = TempPath;
-		}
-		if (!Iterator->Outer.IsSet())
-		{
-			break;
-		}
-		Iterator = &Iterator->Outer.GetValue();
+		return *PathId;
 	}
 
+	FString RemappedPath(Path);
+	GEngine->NetworkRemapPath(Driver, RemappedPath, true);
+	const int32 PathId = InternPath(RemappedPath);
+	NetworkPathToRemappedId.Add(Path, PathId);
+	return PathId;
 }
 
 FUnrealObjectRef FSpatialNetGUIDCache::GetUnrealObjectRefFromNetGUID(const FNetworkGUID& NetGUID) const
@@ -269,8 +284,7 @@ FUnrealObjectRef FSpatialNetGUIDCache::GetUnrealObjectRefFromNetGUID(const FNetw
 
 FNetworkGUID FSpatialNetGUIDCache::GetNetGUIDFromEntityId(Worker_EntityId EntityId) const
 {
-	FUnrealObjectRef ObjRef(EntityId, 0);
-	const FNetworkGUID* NetGUID = UnrealObjectRefToNetGUID.Find(ObjRef);
+	const FNetworkGUID* NetGUID = UnrealObjectRefToNetGUID.Find(FUnrealObjectRefKey(EntityId, 0));
 	return (NetGUID == nullptr ? FNetworkGUID(0) : *NetGUID);
 }
 
@@ -323,10 +337,10 @@ FNetworkGUID FSpatialNetGUIDCache::GetOrAssignNetGUID_SpatialGDK(UObject* Object
 	return NetGUID;
 }
 
-void FSpatialNetGUIDCache::RegisterObjectRef(FNetworkGUID NetGUID, const FUnrealObjectRef& ObjectRef)
+void FSpatialNetGUIDCache::RegisterObjectRef(FNetworkGUID NetGUID, const FUnrealObjectRef& ObjectRef, const FUnrealObjectRefKey& ObjectRefKey)
 {
 	checkSlow(!NetGUIDToUnrealObjectRef.Contains(NetGUID) || (NetGUIDToUnrealObjectRef.Contains(NetGUID) && NetGUIDToUnrealObjectRef.FindChecked(NetGUID) == ObjectRef));
-	checkSlow(!UnrealObjectRefToNetGUID.Contains(ObjectRef) || (UnrealObjectRefToNetGUID.Contains(ObjectRef) && UnrealObjectRefToNetGUID.FindChecked(ObjectRef) == NetGUID));
+	checkSlow(!UnrealObjectRefToNetGUID.Contains(ObjectRefKey) || (UnrealObjectRefToNetGUID.Contains(ObjectRefKey) && UnrealObjectRefToNetGUID.FindChecked(ObjectRefKey) == NetGUID));
 	NetGUIDToUnrealObjectRef.Emplace(NetGUID, ObjectRef);
-	UnrealObjectRefToNetGUID.Emplace(ObjectRef, NetGUID);
+	UnrealObjectRefToNetGUID.Emplace(ObjectRefKey, NetGUID);
 }
@@ -0,0 +1,478 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Interop/Connection/OpListRecording.h"
+
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY(LogSpatialOpListRecording);
+
+namespace
+{
+
+const uint32 OP_LIST_RECORDING_MAGIC = 0x4C504F53; // "SOPL"
+const uint32 OP_LIST_RECORDING_VERSION = 2;
+
+void WriteString(FArchive& Ar, const char* String)
+{
+	uint32 Length = String != nullptr ? FCStringAnsi::Strlen(String) : 0;
+	Ar << Length;
+	Ar.Serialize(const_cast<char*>(String), Length);
+}
+
+void WriteSchemaObject(FArchive& Ar, const Schema_Object* Object)
+{
+	uint32 Length = Schema_GetWriteBufferLength(Object);
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(Length);
+	Schema_WriteToBuffer(Object, Buffer.GetData());
+
+	Ar << Length;
+	Ar.Serialize(Buffer.GetData(), Length);
+}
+
+void WriteComponentUpdate(FArchive& Ar, const Worker_ComponentUpdate& Update)
+{
+	Ar << const_cast<Worker_ComponentId&>(Update.component_id);
+
+	WriteSchemaObject(Ar, Schema_GetComponentUpdateFields(Update.schema_type));
+	WriteSchemaObject(Ar, Schema_GetComponentUpdateEvents(Update.schema_type));
+
+	TArray<Schema_FieldId> ClearedFields;
+	ClearedFields.SetNumUninitialized(Schema_GetComponentUpdateClearedFieldCount(Update.schema_type));
+	Schema_GetComponentUpdateClearedFieldList(Update.schema_type, ClearedFields.GetData());
+	Ar << ClearedFields;
+}
+
+// An op list read back from a recording. Owns the ops and everything they point to.
+struct FReplayedOpList : public FSpatialOpList
+{
+	~FReplayedOpList()
+	{
+		for (Schema_ComponentData* Data : ComponentDatas)
+		{
+			Schema_DestroyComponentData(Data);
+		}
+		for (Schema_ComponentUpdate* Update : ComponentUpdates)
+		{
+			Schema_DestroyComponentUpdate(Update);
+		}
+		for (Schema_CommandRequest* Request : CommandRequests)
+		{
+			Schema_DestroyCommandRequest(Request);
+		}
+		for (Schema_CommandResponse* Response : CommandResponses)
+		{
+			Schema_DestroyCommandResponse(Response);
+		}
+
+		OpList = nullptr;
+	}
+
+	const char* ReadString(FArchive& Ar)
+	{
+		uint32 Length = 0;
+		Ar << Length;
+
+		TArray<char>& String = Strings.AddDefaulted_GetRef();
+		String.SetNumZeroed(Length + 1);
+		Ar.Serialize(String.GetData(), Length);
+		return String.GetData();
+	}
+
+	void ReadSchemaObject(FArchive& Ar, Schema_Object* Object)
+	{
+		uint32 Length = 0;
+		Ar << Length;
+
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(Length);
+		Ar.Serialize(Buffer.GetData(), Length);
+
+		if (Length > 0 && !Schema_MergeFromBuffer(Object, Buffer.GetData(), Length))
+		{
+			UE_LOG(LogSpatialOpListRecording, Error, TEXT("Failed to read schema object from op list recording."));
+			Ar.SetError();
+		}
+	}
+
+	Worker_ComponentData ReadComponentData(FArchive& Ar)
+	{
+		Worker_ComponentData Data = {};
+		Ar << Data.component_id;
+		Data.schema_type = ComponentDatas.Add_GetRef(Schema_CreateComponentData(Data.component_id));
+		ReadSchemaObject(Ar, Schema_GetComponentDataFields(Data.schema_type));
+		return Data;
+	}
+
+	Worker_ComponentUpdate ReadComponentUpdate(FArchive& Ar)
+	{
+		Worker_ComponentUpdate Update = {};
+		Ar << Update.component_id;
+		Update.schema_type = ComponentUpdates.Add_GetRef(Schema_CreateComponentUpdate(Update.component_id));
+		ReadSchemaObject(Ar, Schema_GetComponentUpdateFields(Update.schema_type));
+		ReadSchemaObject(Ar, Schema_GetComponentUpdateEvents(Update.schema_type));
+
+		TArray<Schema_FieldId> ClearedFields;
+		Ar << ClearedFields;
+		for (Schema_FieldId FieldId : ClearedFields)
+		{
+			Schema_AddComponentUpdateClearedField(Update.schema_type, FieldId);
+		}
+		return Update;
+	}
+
+	TArray<Worker_Op> Ops;
+	TArray<TArray<char>> Strings;
+	TArray<TArray<const char*>> AttributeSets;
+
+	TArray<Schema_ComponentData*> ComponentDatas;
+	TArray<Schema_ComponentUpdate*> ComponentUpdates;
+	TArray<Schema_CommandRequest*> CommandRequests;
+	TArray<Schema_CommandResponse*> CommandResponses;
+
+	Worker_OpList ReplayedOpList;
+};
+
+} // ::
+
+FSpatialOpListRecorder::FSpatialOpListRecorder(const FString& FilePath, const FString& WorkerId)
+	: Writer(IFileManager::Get().CreateFileWriter(*FilePath))
+	, NumRecordedOpLists(0)
+	, StartTime(FPlatformTime::Seconds())
+{
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogSpatialOpListRecording, Error, TEXT("Unable to open %s to record op lists."), *FilePath);
+		return;
+	}
+
+	uint32 Magic = OP_LIST_RECORDING_MAGIC;
+	uint32 Version = OP_LIST_RECORDING_VERSION;
+	FString RecordedWorkerId = WorkerId;
+	*Writer << Magic << Version << RecordedWorkerId;
+
+	UE_LOG(LogSpatialOpListRecording, Log, TEXT("Recording op lists to %s."), *FilePath);
+}
+
+FSpatialOpListRecorder::~FSpatialOpListRecorder()
+{
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		UE_LOG(LogSpatialOpListRecording, Log, TEXT("Recorded %d op lists."), NumRecordedOpLists);
+	}
+}
+
+void FSpatialOpListRecorder::RecordOpList(const Worker_OpList& OpList)
+{
+	if (!Writer.IsValid())
+	{
+		return;
+	}
+
+	uint32 NumOps = 0;
+	for (uint32 i = 0; i < OpList.op_count; ++i)
+	{
+		if (OpList.ops[i].op_type != WORKER_OP_TYPE_METRICS)
+		{
+			++NumOps;
+		}
+	}
+
+	double ReceivedTime = FPlatformTime::Seconds() - StartTime;
+	*Writer << ReceivedTime;
+	*Writer << NumOps;
+	for (uint32 i = 0; i < OpList.op_count; ++i)
+	{
+		if (OpList.ops[i].op_type != WORKER_OP_TYPE_METRICS)
+		{
+			RecordOp(OpList.ops[i]);
+		}
+	}
+
+	++NumRecordedOpLists;
+}
+
+void FSpatialOpListRecorder::RecordOp(const Worker_Op& InOp)
+{
+	FArchive& Ar = *Writer;
+
+	// The archive interface is non-const, but nothing is modified when saving.
+	Worker_Op& Op = const_cast<Worker_Op&>(InOp);
+	Ar << Op.op_type;
+
+	switch (Op.op_type)
+	{
+	case WORKER_OP_TYPE_DISCONNECT:
+		WriteString(Ar, Op.disconnect.reason);
+		break;
+	case WORKER_OP_TYPE_FLAG_UPDATE:
+		WriteString(Ar, Op.flag_update.name);
+		WriteString(Ar, Op.flag_update.value);
+		break;
+	case WORKER_OP_TYPE_LOG_MESSAGE:
+		Ar << Op.log_message.level;
+		WriteString(Ar, Op.log_message.message);
+		break;
+	case WORKER_OP_TYPE_CRITICAL_SECTION:
+		Ar << Op.critical_section.in_critical_section;
+		break;
+	case WORKER_OP_TYPE_ADD_ENTITY:
+		Ar << Op.add_entity.entity_id;
+		break;
+	case WORKER_OP_TYPE_REMOVE_ENTITY:
+		Ar << Op.remove_entity.entity_id;
+		break;
+	case WORKER_OP_TYPE_RESERVE_ENTITY_ID_RESPONSE:
+		Ar << Op.reserve_entity_id_response.request_id << Op.reserve_entity_id_response.status_code << Op.reserve_entity_id_response.entity_id;
+		WriteString(Ar, Op.reserve_entity_id_response.message);
+		break;
+	case WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE:
+		Ar << Op.reserve_entity_ids_response.request_id << Op.reserve_entity_ids_response.status_code;
+		Ar << Op.reserve_entity_ids_response.first_entity_id << Op.reserve_entity_ids_response.number_of_entity_ids;
+		WriteString(Ar, Op.reserve_entity_ids_response.message);
+		break;
+	case WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE:
+		Ar << Op.create_entity_response.request_id << Op.create_entity_response.status_code << Op.create_entity_response.entity_id;
+		WriteString(Ar, Op.create_entity_response.message);
+		break;
+	case WORKER_OP_TYPE_DELETE_ENTITY_RESPONSE:
+		Ar << Op.delete_entity_response.request_id << Op.delete_entity_response.status_code << Op.delete_entity_response.entity_id;
+		WriteString(Ar, Op.delete_entity_response.message);
+		break;
+	case WORKER_OP_TYPE_ENTITY_QUERY_RESPONSE:
+		// Query results are not recorded, only the outcome of the query.
+		Ar << Op.entity_query_response.request_id << Op.entity_query_response.status_code << Op.entity_query_response.result_count;
+		WriteString(Ar, Op.entity_query_response.message);
+		break;
+	case WORKER_OP_TYPE_ADD_COMPONENT:
+		Ar << Op.add_component.entity_id << Op.add_component.data.component_id;
+		WriteSchemaObject(Ar, Schema_GetComponentDataFields(Op.add_component.data.schema_type));
+		break;
+	case WORKER_OP_TYPE_REMOVE_COMPONENT:
+		Ar << Op.remove_component.entity_id << Op.remove_component.component_id;
+		break;
+	case WORKER_OP_TYPE_AUTHORITY_CHANGE:
+		Ar << Op.authority_change.entity_id << Op.authority_change.component_id << Op.authority_change.authority;
+		break;
+	case WORKER_OP_TYPE_COMPONENT_UPDATE:
+		Ar << Op.component_update.entity_id;
+		WriteComponentUpdate(Ar, Op.component_update.update);
+		break;
+	case WORKER_OP_TYPE_COMMAND_REQUEST:
+	{
+		Worker_CommandRequestOp& Request = Op.command_request;
+		Ar << Request.request_id << Request.entity_id << Request.timeout_millis;
+		WriteString(Ar, Request.caller_worker_id);
+		Ar << Request.caller_attribute_set.attribute_count;
+		for (uint32 i = 0; i < Request.caller_attribute_set.attribute_count; ++i)
+		{
+			WriteString(Ar, Request.caller_attribute_set.attributes[i]);
+		}
+
+		Ar << Request.request.component_id;
+		uint32 CommandIndex = Schema_GetCommandRequestCommandIndex(Request.request.schema_type);
+		Ar << CommandIndex;
+		WriteSchemaObject(Ar, Schema_GetCommandRequestObject(Request.request.schema_type));
+		break;
+	}
+	case WORKER_OP_TYPE_COMMAND_RESPONSE:
+	{
+		Worker_CommandResponseOp& Response = Op.command_response;
+		Ar << Response.request_id << Response.entity_id << Response.status_code << Response.command_id;
+		WriteString(Ar, Response.message);
+
+		Ar << Response.response.component_id;
+		uint8 bHasResponse = Response.response.schema_type != nullptr;
+		Ar << bHasResponse;
+		if (bHasResponse)
+		{
+			uint32 CommandIndex = Schema_GetCommandResponseCommandIndex(Response.response.schema_type);
+			Ar << CommandIndex;
+			WriteSchemaObject(Ar, Schema_GetCommandResponseObject(Response.response.schema_type));
+		}
+		break;
+	}
+	default:
+		checkNoEntry();
+		break;
+	}
+}
+
+FSpatialOpListReplayer::FSpatialOpListReplayer(const FString& FilePath)
+	: Reader(IFileManager::Get().CreateFileReader(*FilePath))
+	, bHasNextOpList(false)
+	, NextOpListTime(0.0)
+{
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogSpatialOpListRecording, Error, TEXT("Unable to open op list recording %s."), *FilePath);
+		return;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+
+	if (Magic != OP_LIST_RECORDING_MAGIC || Version != OP_LIST_RECORDING_VERSION)
+	{
+		UE_LOG(LogSpatialOpListRecording, Error, TEXT("%s is not a supported op list recording (version %u, expected %u)."), *FilePath, Version, OP_LIST_RECORDING_VERSION);
+		Reader.Reset();
+		return;
+	}
+
+	*Reader << WorkerId;
+	ReadNextOpListTime();
+}
+
+bool FSpatialOpListReplayer::IsFinished() const
+{
+	return !Reader.IsValid() || Reader->IsError() || !bHasNextOpList;
+}
+
+void FSpatialOpListReplayer::ReadNextOpListTime()
+{
+	bHasNextOpList = !Reader->IsError() && !Reader->AtEnd();
+	if (bHasNextOpList)
+	{
+		*Reader << NextOpListTime;
+	}
+}
+
+TUniquePtr<FSpatialOpList> FSpatialOpListReplayer::ReadNextOpList(const FSpatialComponentLayouts* ComponentLayouts)
+{
+	if (IsFinished())
+	{
+		return nullptr;
+	}
+
+	FArchive& Ar = *Reader;
+	TUniquePtr<FReplayedOpList> OpList = MakeUnique<FReplayedOpList>();
+
+	uint32 NumOps = 0;
+	Ar << NumOps;
+	OpList->Ops.SetNumZeroed(NumOps);
+
+	for (Worker_Op& Op : OpList->Ops)
+	{
+		Ar << Op.op_type;
+
+		switch (Op.op_type)
+		{
+		case WORKER_OP_TYPE_DISCONNECT:
+			Op.disconnect.reason = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_FLAG_UPDATE:
+			Op.flag_update.name = OpList->ReadString(Ar);
+			Op.flag_update.value = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_LOG_MESSAGE:
+			Ar << Op.log_message.level;
+			Op.log_message.message = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_CRITICAL_SECTION:
+			Ar << Op.critical_section.in_critical_section;
+			break;
+		case WORKER_OP_TYPE_ADD_ENTITY:
+			Ar << Op.add_entity.entity_id;
+			break;
+		case WORKER_OP_TYPE_REMOVE_ENTITY:
+			Ar << Op.remove_entity.entity_id;
+			break;
+		case WORKER_OP_TYPE_RESERVE_ENTITY_ID_RESPONSE:
+			Ar << Op.reserve_entity_id_response.request_id << Op.reserve_entity_id_response.status_code << Op.reserve_entity_id_response.entity_id;
+			Op.reserve_entity_id_response.message = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE:
+			Ar << Op.reserve_entity_ids_response.request_id << Op.reserve_entity_ids_response.status_code;
+			Ar << Op.reserve_entity_ids_response.first_entity_id << Op.reserve_entity_ids_response.number_of_entity_ids;
+			Op.reserve_entity_ids_response.message = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE:
+			Ar << Op.create_entity_response.request_id << Op.create_entity_response.status_code << Op.create_entity_response.entity_id;
+			Op.create_entity_response.message = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_DELETE_ENTITY_RESPONSE:
+			Ar << Op.delete_entity_response.request_id << Op.delete_entity_response.status_code << Op.delete_entity_response.entity_id;
+			Op.delete_entity_response.message = OpList->ReadString(Ar);
+			break;
+		case WORKER_OP_TYPE_ENTITY_QUERY_RESPONSE:
+			Ar << Op.entity_query_response.request_id << Op.entity_query_response.status_code << Op.entity_query_response.result_count;
+			Op.entity_query_response.message = OpList->ReadString(Ar);
+			Op.entity_query_response.results = nullptr;
+			break;
+		case WORKER_OP_TYPE_ADD_COMPONENT:
+			Ar << Op.add_component.entity_id;
+			Op.add_component.data = OpList->ReadComponentData(Ar);
+			break;
+		case WORKER_OP_TYPE_REMOVE_COMPONENT:
+			Ar << Op.remove_component.entity_id << Op.remove_component.component_id;
+			break;
+		case WORKER_OP_TYPE_AUTHORITY_CHANGE:
+			Ar << Op.authority_change.entity_id << Op.authority_change.component_id << Op.authority_change.authority;
+			break;
+		case WORKER_OP_TYPE_COMPONENT_UPDATE:
+			Ar << Op.component_update.entity_id;
+			Op.component_update.update = OpList->ReadComponentUpdate(Ar);
+			break;
+		case WORKER_OP_TYPE_COMMAND_REQUEST:
+		{
+			Worker_CommandRequestOp& Request = Op.command_request;
+			Ar << Request.request_id << Request.entity_id << Request.timeout_millis;
+			Request.caller_worker_id = OpList->ReadString(Ar);
+
+			Ar << Request.caller_attribute_set.attribute_count;
+			TArray<const char*>& Attributes = OpList->AttributeSets.AddDefaulted_GetRef();
+			for (uint32 i = 0; i < Request.caller_attribute_set.attribute_count; ++i)
+			{
+				Attributes.Add(OpList->ReadString(Ar));
+			}
+			Request.caller_attribute_set.attributes = Attributes.GetData();
+
+			uint32 CommandIndex = 0;
+			Ar << Request.request.component_id << CommandIndex;
+			Request.request.schema_type = OpList->CommandRequests.Add_GetRef(Schema_CreateCommandRequest(Request.request.component_id, CommandIndex));
+			OpList->ReadSchemaObject(Ar, Schema_GetCommandRequestObject(Request.request.schema_type));
+			break;
+		}
+		case WORKER_OP_TYPE_COMMAND_RESPONSE:
+		{
+			Worker_CommandResponseOp& Response = Op.command_response;
+			Ar << Response.request_id << Response.entity_id << Response.status_code << Response.command_id;
+			Response.message = OpList->ReadString(Ar);
+
+			Ar << Response.response.component_id;
+			uint8 bHasResponse = 0;
+			Ar << bHasResponse;
+			if (bHasResponse)
+			{
+				uint32 CommandIndex = 0;
+				Ar << CommandIndex;
+				Response.response.schema_type = OpList->CommandResponses.Add_GetRef(Schema_CreateCommandResponse(Response.response.component_id, CommandIndex));
+				OpList->ReadSchemaObject(Ar, Schema_GetCommandResponseObject(Response.response.schema_type));
+			}
+			break;
+		}
+		default:
+			UE_LOG(LogSpatialOpListRecording, Error, TEXT("Unknown op type %d in op list recording."), Op.op_type);
+			Ar.SetError();
+			break;
+		}
+
+		if (Ar.IsError())
+		{
+			Reader.Reset();
+			return nullptr;
+		}
+	}
+
+	OpList->ReplayedOpList.ops = OpList->Ops.GetData();
+	OpList->ReplayedOpList.op_count = OpList->Ops.Num();
+	OpList->OpList = &OpList->ReplayedOpList;
+	OpList->Decode(ComponentLayouts);
+
+	ReadNextOpListTime();
+
+	return OpList;
+}
@@ -0,0 +1,547 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Interop/Connection/SpatialMockConnection.h"
+
+DEFINE_LOG_CATEGORY(LogSpatialMockConnection);
+
+namespace
+{
+
+// Component data read from a snapshot is owned by the input stream, so it has to be copied before the stream moves on.
+Worker_ComponentData CopyComponentData(const Worker_ComponentData& Data)
+{
+	Worker_ComponentData Copy = {};
+	Copy.component_id = Data.component_id;
+	Copy.schema_type = Schema_CreateComponentData(Data.component_id);
+
+	Schema_Object* Fields = Schema_GetComponentDataFields(Data.schema_type);
+	const uint32 Length = Schema_GetWriteBufferLength(Fields);
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(Length);
+	Schema_WriteToBuffer(Fields, Buffer.GetData());
+
+	if (Length > 0 && !Schema_MergeFromBuffer(Schema_GetComponentDataFields(Copy.schema_type), Buffer.GetData(), Length))
+	{
+		UE_LOG(LogSpatialMockConnection, Error, TEXT("Failed to copy data for component %d."), Data.component_id);
+	}
+
+	return Copy;
+}
+
+} // ::
+
+// An op list generated by the mock connection. Owns the ops and everything they point to.
+struct FSpatialMockConnection::FMockOpList : public FSpatialOpList
+{
+	~FMockOpList()
+	{
+		for (Schema_ComponentData* Data : ComponentDatas)
+		{
+			Schema_DestroyComponentData(Data);
+		}
+		for (Schema_ComponentUpdate* Update : ComponentUpdates)
+		{
+			Schema_DestroyComponentUpdate(Update);
+		}
+		for (Schema_CommandRequest* Request : CommandRequests)
+		{
+			Schema_DestroyCommandRequest(Request);
+		}
+		for (Schema_CommandResponse* Response : CommandResponses)
+		{
+			Schema_DestroyCommandResponse(Response);
+		}
+
+		OpList = nullptr;
+	}
+
+	const char* AddString(const FString& String)
+	{
+		FTCHARToUTF8 UTF8String(*String);
+		TArray<char>& Chars = Strings.AddDefaulted_GetRef();
+		Chars.SetNumZeroed(UTF8String.Length() + 1);
+		FMemory::Memcpy(Chars.GetData(), UTF8String.Get(), UTF8String.Length());
+		return Chars.GetData();
+	}
+
+	TArray<Worker_Op> Ops;
+	TArray<TArray<char>> Strings;
+	TArray<TArray<const char*>> AttributeSets;
+
+	TArray<Schema_ComponentData*> ComponentDatas;
+	TArray<Schema_ComponentUpdate*> ComponentUpdates;
+	TArray<Schema_CommandRequest*> CommandRequests;
+	TArray<Schema_CommandResponse*> CommandResponses;
+
+	// When the request behind each response op was sent, to measure how long responses take to reach the GDK.
+	TArray<double> ResponseSendTimes;
+
+	Worker_OpList MockOpList;
+};
+
+FSpatialMockConnection::FSpatialMockConnection(const FString& InWorkerType, const FString& InWorkerId)
+	: WorkerType(InWorkerType)
+	, WorkerId(InWorkerId)
+	, NextEntityId(SpatialConstants::PLACEHOLDER_ENTITY_ID_LAST + 1)
+	, NextRequestId(1)
+	, bInCheckout(false)
+	, PendingOpList(MakeUnique<FMockOpList>())
+	, StartTime(FPlatformTime::Seconds())
+	, NumOpLists(0)
+	, NumOps(0)
+	, NumEntitiesCreated(0)
+	, NumComponentUpdates(0)
+	, NumRejectedComponentUpdates(0)
+	, NumCommandRequests(0)
+	, NumResponses(0)
+	, TotalResponseLatency(0.0)
+	, MaxResponseLatency(0.0)
+{
+	WorkerAttributes.Add(WorkerType);
+	WorkerAttributes.Add(TEXT("workerId:") + WorkerId);
+
+	UE_LOG(LogSpatialMockConnection, Log, TEXT("Using a mock SpatialOS connection as %s worker %s."), *WorkerType, *WorkerId);
+}
+
+FSpatialMockConnection::~FSpatialMockConnection()
+{
+	LogStats();
+}
+
+bool FSpatialMockConnection::LoadSnapshot(const FString& SnapshotPath)
+{
+	Worker_ComponentVtable DefaultVtable{};
+	Worker_SnapshotParameters Parameters{};
+	Parameters.default_component_vtable = &DefaultVtable;
+
+	Worker_SnapshotInputStream* InputStream = Worker_SnapshotInputStream_Create(TCHAR_TO_UTF8(*SnapshotPath), &Parameters);
+
+	bool bSuccess = true;
+	int32 NumEntities = 0;
+	BeginCheckout();
+	while (Worker_SnapshotInputStream_HasNext(InputStream))
+	{
+		const Worker_Entity* Entity = Worker_SnapshotInputStream_ReadEntity(InputStream);
+		if (Entity == nullptr)
+		{
+			bSuccess = false;
+			break;
+		}
+
+		TArray<Worker_ComponentData> Components;
+		for (uint32 i = 0; i < Entity->component_count; ++i)
+		{
+			Components.Add(CopyComponentData(Entity->components[i]));
+		}
+
+		AddEntity(Entity->entity_id, Components);
+		NextEntityId = FMath::Max(NextEntityId, Entity->entity_id + 1);
+		NumEntities++;
+	}
+	EndCheckout();
+
+	const char* Error = Worker_SnapshotInputStream_GetError(InputStream);
+	if (!bSuccess || Error != nullptr)
+	{
+		UE_LOG(LogSpatialMockConnection, Error, TEXT("Error reading snapshot %s: %s"), *SnapshotPath, Error != nullptr ? UTF8_TO_TCHAR(Error) : TEXT("unknown error"));
+		bSuccess = false;
+	}
+	else
+	{
+		UE_LOG(LogSpatialMockConnection, Log, TEXT("Loaded %d entities from snapshot %s."), NumEntities, *SnapshotPath);
+	}
+
+	Worker_SnapshotInputStream_Destroy(InputStream);
+
+	return bSuccess;
+}
+
+void FSpatialMockConnection::BeginCheckout()
+{
+	check(!bInCheckout);
+	bInCheckout = true;
+	AddOp(WORKER_OP_TYPE_CRITICAL_SECTION).critical_section.in_critical_section = 1;
+}
+
+void FSpatialMockConnection::EndCheckout()
+{
+	check(bInCheckout);
+	bInCheckout = false;
+	AddOp(WORKER_OP_TYPE_CRITICAL_SECTION).critical_section.in_critical_section = 0;
+}
+
+TUniquePtr<FSpatialOpList> FSpatialMockConnection::GetOpList(const FSpatialComponentLayouts* ComponentLayouts)
+{
+	if (PendingOpList->Ops.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FMockOpList> OpList = MoveTemp(PendingOpList);
+	PendingOpList = MakeUnique<FMockOpList>();
+
+	const double Now = FPlatformTime::Seconds();
+	for (double SendTime : OpList->ResponseSendTimes)
+	{
+		const double Latency = Now - SendTime;
+		TotalResponseLatency += Latency;
+		MaxResponseLatency = FMath::Max(MaxResponseLatency, Latency);
+	}
+	NumResponses += OpList->ResponseSendTimes.Num();
+
+	NumOpLists++;
+	NumOps += OpList->Ops.Num();
+
+	OpList->MockOpList.ops = OpList->Ops.GetData();
+	OpList->MockOpList.op_count = OpList->Ops.Num();
+	OpList->OpList = &OpList->MockOpList;
+	OpList->Decode(ComponentLayouts);
+
+	return OpList;
+}
+
+Worker_RequestId FSpatialMockConnection::SendReserveEntityIdRequest()
+{
+	const Worker_RequestId RequestId = AddRequest();
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_RESERVE_ENTITY_ID_RESPONSE);
+	Op.reserve_entity_id_response.request_id = RequestId;
+	Op.reserve_entity_id_response.status_code = WORKER_STATUS_CODE_SUCCESS;
+	Op.reserve_entity_id_response.message = PendingOpList->AddString(TEXT(""));
+	Op.reserve_entity_id_response.entity_id = NextEntityId++;
+	AddResponse(FPlatformTime::Seconds());
+
+	return RequestId;
+}
+
+Worker_RequestId FSpatialMockConnection::SendReserveEntityIdsRequest(uint32_t NumOfEntities)
+{
+	const Worker_RequestId RequestId = AddRequest();
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE);
+	Op.reserve_entity_ids_response.request_id = RequestId;
+	Op.reserve_entity_ids_response.status_code = WORKER_STATUS_CODE_SUCCESS;
+	Op.reserve_entity_ids_response.message = PendingOpList->AddString(TEXT(""));
+	Op.reserve_entity_ids_response.first_entity_id = NextEntityId;
+	Op.reserve_entity_ids_response.number_of_entity_ids = NumOfEntities;
+	NextEntityId += NumOfEntities;
+	AddResponse(FPlatformTime::Seconds());
+
+	return RequestId;
+}
+
+Worker_RequestId FSpatialMockConnection::SendCreateEntityRequest(uint32_t ComponentCount, const Worker_ComponentData* Components, const Worker_EntityId* EntityId)
+{
+	const Worker_RequestId RequestId = AddRequest();
+	const Worker_EntityId NewEntityId = EntityId != nullptr ? *EntityId : NextEntityId++;
+
+	if (Entities.Contains(NewEntityId))
+	{
+		for (uint32 i = 0; i < ComponentCount; ++i)
+		{
+			Schema_DestroyComponentData(Components[i].schema_type);
+		}
+
+		Worker_Op& Op = AddOp(WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE);
+		Op.create_entity_response.request_id = RequestId;
+		Op.create_entity_response.status_code = WORKER_STATUS_CODE_APPLICATION_ERROR;
+		Op.create_entity_response.message = PendingOpList->AddString(FString::Printf(TEXT("Entity %lld already exists."), NewEntityId));
+		Op.create_entity_response.entity_id = NewEntityId;
+		AddResponse(FPlatformTime::Seconds());
+		return RequestId;
+	}
+
+	AddEntity(NewEntityId, TArray<Worker_ComponentData>(Components, ComponentCount));
+	NextEntityId = FMath::Max(NextEntityId, NewEntityId + 1);
+	NumEntitiesCreated++;
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE);
+	Op.create_entity_response.request_id = RequestId;
+	Op.create_entity_response.status_code = WORKER_STATUS_CODE_SUCCESS;
+	Op.create_entity_response.message = PendingOpList->AddString(TEXT(""));
+	Op.create_entity_response.entity_id = NewEntityId;
+	AddResponse(FPlatformTime::Seconds());
+
+	return RequestId;
+}
+
+Worker_RequestId FSpatialMockConnection::SendDeleteEntityRequest(Worker_EntityId EntityId)
+{
+	const Worker_RequestId RequestId = AddRequest();
+
+	FMockEntity Entity;
+	const bool bFound = Entities.RemoveAndCopyValue(EntityId, Entity);
+	if (bFound)
+	{
+		for (Worker_ComponentId ComponentId : Entity.AuthoritativeComponents)
+		{
+			Worker_Op& Op = AddOp(WORKER_OP_TYPE_AUTHORITY_CHANGE);
+			Op.authority_change.entity_id = EntityId;
+			Op.authority_change.component_id = ComponentId;
+			Op.authority_change.authority = WORKER_AUTHORITY_NOT_AUTHORITATIVE;
+		}
+
+		for (Worker_ComponentId ComponentId : Entity.ComponentIds)
+		{
+			Worker_Op& Op = AddOp(WORKER_OP_TYPE_REMOVE_COMPONENT);
+			Op.remove_component.entity_id = EntityId;
+			Op.remove_component.component_id = ComponentId;
+		}
+
+		Worker_Op& Op = AddOp(WORKER_OP_TYPE_REMOVE_ENTITY);
+		Op.remove_entity.entity_id = EntityId;
+	}
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_DELETE_ENTITY_RESPONSE);
+	Op.delete_entity_response.request_id = RequestId;
+	Op.delete_entity_response.entity_id = EntityId;
+	Op.delete_entity_response.status_code = bFound ? WORKER_STATUS_CODE_SUCCESS : WORKER_STATUS_CODE_APPLICATION_ERROR;
+	Op.delete_entity_response.message = PendingOpList->AddString(bFound ? TEXT("") : FString::Printf(TEXT("Entity %lld does not exist."), EntityId));
+	AddResponse(FPlatformTime::Seconds());
+
+	return RequestId;
+}
+
+void FSpatialMockConnection::SendComponentUpdate(Worker_EntityId EntityId, const Worker_ComponentUpdate* ComponentUpdate)
+{
+	FMockEntity* Entity = Entities.Find(EntityId);
+
+	// The runtime drops updates from workers which aren't authoritative, so a well-behaved worker never sends one.
+	if (Entity == nullptr || !Entity->AuthoritativeComponents.Contains(ComponentUpdate->component_id))
+	{
+		UE_LOG(LogSpatialMockConnection, Verbose, TEXT("Dropping update for component %d on entity %lld, which this worker is not authoritative over."), ComponentUpdate->component_id, EntityId);
+		Schema_DestroyComponentUpdate(ComponentUpdate->schema_type);
+		NumRejectedComponentUpdates++;
+		return;
+	}
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_COMPONENT_UPDATE);
+	Op.component_update.entity_id = EntityId;
+	Op.component_update.update = *ComponentUpdate;
+	PendingOpList->ComponentUpdates.Add(ComponentUpdate->schema_type);
+	NumComponentUpdates++;
+
+	if (ComponentUpdate->component_id == SpatialConstants::ENTITY_ACL_COMPONENT_ID)
+	{
+		Entity->Acl.ApplyComponentUpdate(*ComponentUpdate);
+		UpdateAuthority(EntityId, *Entity);
+	}
+}
+
+Worker_RequestId FSpatialMockConnection::SendCommandRequest(Worker_EntityId EntityId, const Worker_CommandRequest* Request, uint32_t CommandId)
+{
+	const Worker_RequestId RequestId = AddRequest();
+	NumCommandRequests++;
+
+	const FMockEntity* Entity = Entities.Find(EntityId);
+	if (Entity == nullptr)
+	{
+		Schema_DestroyCommandRequest(Request->schema_type);
+		AddCommandFailure(RequestId, EntityId, Request->component_id, CommandId, WORKER_STATUS_CODE_APPLICATION_ERROR, FString::Printf(TEXT("Entity %lld does not exist."), EntityId));
+		return RequestId;
+	}
+
+	// This is the only worker, so if it isn't authoritative there is nobody to handle the command, and the runtime would time it out.
+	if (!Entity->AuthoritativeComponents.Contains(Request->component_id))
+	{
+		Schema_DestroyCommandRequest(Request->schema_type);
+		AddCommandFailure(RequestId, EntityId, Request->component_id, CommandId, WORKER_STATUS_CODE_TIMEOUT, FString::Printf(TEXT("No worker is authoritative over component %d on entity %lld."), Request->component_id, EntityId));
+		return RequestId;
+	}
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_COMMAND_REQUEST);
+	Worker_CommandRequestOp& RequestOp = Op.command_request;
+	RequestOp.request_id = RequestId;
+	RequestOp.entity_id = EntityId;
+	RequestOp.timeout_millis = 0;
+	RequestOp.caller_worker_id = PendingOpList->AddString(WorkerId);
+
+	TArray<const char*>& Attributes = PendingOpList->AttributeSets.AddDefaulted_GetRef();
+	for (const FString& Attribute : WorkerAttributes)
+	{
+		Attributes.Add(PendingOpList->AddString(Attribute));
+	}
+	RequestOp.caller_attribute_set.attribute_count = Attributes.Num();
+	RequestOp.caller_attribute_set.attributes = Attributes.GetData();
+
+	RequestOp.request = *Request;
+	PendingOpList->CommandRequests.Add(Request->schema_type);
+
+	PendingCommands.Add(RequestId, FPendingCommand{ EntityId, Request->component_id, CommandId, FPlatformTime::Seconds() });
+
+	return RequestId;
+}
+
+void FSpatialMockConnection::SendCommandResponse(Worker_RequestId RequestId, const Worker_CommandResponse* Response)
+{
+	FPendingCommand Command;
+	if (!PendingCommands.RemoveAndCopyValue(RequestId, Command))
+	{
+		UE_LOG(LogSpatialMockConnection, Warning, TEXT("Received a response to unknown command request %lld."), RequestId);
+		Schema_DestroyCommandResponse(Response->schema_type);
+		return;
+	}
+
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_COMMAND_RESPONSE);
+	Worker_CommandResponseOp& ResponseOp = Op.command_response;
+	ResponseOp.request_id = RequestId;
+	ResponseOp.entity_id = Command.EntityId;
+	ResponseOp.status_code = WORKER_STATUS_CODE_SUCCESS;
+	ResponseOp.message = PendingOpList->AddString(TEXT(""));
+	ResponseOp.response = *Response;
+	ResponseOp.command_id = Command.CommandId;
+	PendingOpList->CommandResponses.Add(Response->schema_type);
+	AddResponse(Command.SendTime);
+}
+
+FSpatialMockConnectionStats FSpatialMockConnection::GetStats() const
+{
+	FSpatialMockConnectionStats Stats;
+	Stats.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	Stats.NumOpLists = NumOpLists;
+	Stats.NumOps = NumOps;
+	Stats.NumEntitiesCreated = NumEntitiesCreated;
+	Stats.NumComponentUpdates = NumComponentUpdates;
+	Stats.NumRejectedComponentUpdates = NumRejectedComponentUpdates;
+	Stats.NumCommandRequests = NumCommandRequests;
+	Stats.NumResponses = NumResponses;
+	Stats.AverageResponseLatency = NumResponses > 0 ? TotalResponseLatency / NumResponses : 0.0;
+	Stats.MaxResponseLatency = MaxResponseLatency;
+	return Stats;
+}
+
+void FSpatialMockConnection::LogStats() const
+{
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	const double PerSecond = ElapsedSeconds > 0.0 ? 1.0 / ElapsedSeconds : 0.0;
+
+	UE_LOG(LogSpatialMockConnection, Display, TEXT("Mock connection stats after %.3f seconds: %d op lists, %d ops (%.1f per second), %d entities created (%.1f per second), ")
+		TEXT("%d component updates (%.1f per second, %d dropped), %d command requests (%.1f per second)."),
+		ElapsedSeconds, NumOpLists, NumOps, NumOps * PerSecond, NumEntitiesCreated, NumEntitiesCreated * PerSecond,
+		NumComponentUpdates, NumComponentUpdates * PerSecond, NumRejectedComponentUpdates, NumCommandRequests, NumCommandRequests * PerSecond);
+
+	UE_LOG(LogSpatialMockConnection, Display, TEXT("Mock connection response latency: %d responses, %.3f ms average, %.3f ms max."),
+		NumResponses, NumResponses > 0 ? 1000.0 * TotalResponseLatency / NumResponses : 0.0, 1000.0 * MaxResponseLatency);
+}
+
+Worker_Op& FSpatialMockConnection::AddOp(uint8_t OpType)
+{
+	Worker_Op& Op = PendingOpList->Ops.AddZeroed_GetRef();
+	Op.op_type = OpType;
+	return Op;
+}
+
+Worker_RequestId FSpatialMockConnection::AddRequest()
+{
+	return NextRequestId++;
+}
+
+void FSpatialMockConnection::AddResponse(double SendTime)
+{
+	PendingOpList->ResponseSendTimes.Add(SendTime);
+}
+
+void FSpatialMockConnection::AddEntity(Worker_EntityId EntityId, const TArray<Worker_ComponentData>& Components)
+{
+	FMockEntity& Entity = Entities.Add(EntityId);
+
+	// The runtime adds an entity and its initial authority atomically, so the GDK sees it all at once.
+	if (!bInCheckout)
+	{
+		AddOp(WORKER_OP_TYPE_CRITICAL_SECTION).critical_section.in_critical_section = 1;
+	}
+
+	AddOp(WORKER_OP_TYPE_ADD_ENTITY).add_entity.entity_id = EntityId;
+
+	for (const Worker_ComponentData& Data : Components)
+	{
+		if (Data.component_id == SpatialConstants::ENTITY_ACL_COMPONENT_ID)
+		{
+			Entity.Acl = improbable::EntityAcl(Data);
+		}
+
+		Worker_Op& Op = AddOp(WORKER_OP_TYPE_ADD_COMPONENT);
+		Op.add_component.entity_id = EntityId;
+		Op.add_component.data = Data;
+		PendingOpList->ComponentDatas.Add(Data.schema_type);
+
+		Entity.ComponentIds.Add(Data.component_id);
+	}
+
+	UpdateAuthority(EntityId, Entity);
+
+	if (!bInCheckout)
+	{
+		AddOp(WORKER_OP_TYPE_CRITICAL_SECTION).critical_section.in_critical_section = 0;
+	}
+}
+
+void FSpatialMockConnection::UpdateAuthority(Worker_EntityId EntityId, FMockEntity& Entity)
+{
+	for (Worker_ComponentId ComponentId : Entity.ComponentIds)
+	{
+		const bool bAuthoritative = HasWriteAccess(Entity, ComponentId);
+		if (bAuthoritative == Entity.AuthoritativeComponents.Contains(ComponentId))
+		{
+			continue;
+		}
+
+		if (bAuthoritative)
+		{
+			Entity.AuthoritativeComponents.Add(ComponentId);
+		}
+		else
+		{
+			Entity.AuthoritativeComponents.Remove(ComponentId);
+		}
+
+		Worker_Op& Op = AddOp(WORKER_OP_TYPE_AUTHORITY_CHANGE);
+		Op.authority_change.entity_id = EntityId;
+		Op.authority_change.component_id = ComponentId;
+		Op.authority_change.authority = bAuthoritative ? WORKER_AUTHORITY_AUTHORITATIVE : WORKER_AUTHORITY_NOT_AUTHORITATIVE;
+	}
+}
+
+bool FSpatialMockConnection::HasWriteAccess(const FMockEntity& Entity, Worker_ComponentId ComponentId) const
+{
+	const WorkerRequirementSet* RequirementSet = Entity.Acl.ComponentWriteAcl.Find(ComponentId);
+	if (RequirementSet == nullptr)
+	{
+		return false;
+	}
+
+	// A requirement set is satisfied by a worker which has every attribute of any one of its attribute sets.
+	for (const WorkerAttributeSet& AttributeSet : *RequirementSet)
+	{
+		bool bHasAllAttributes = true;
+		for (const FString& Attribute : AttributeSet)
+		{
+			if (!WorkerAttributes.Contains(Attribute))
+			{
+				bHasAllAttributes = false;
+				break;
+			}
+		}
+
+		if (bHasAllAttributes)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FSpatialMockConnection::AddCommandFailure(Worker_RequestId RequestId, Worker_EntityId EntityId, Worker_ComponentId ComponentId, uint32 CommandId, uint8_t StatusCode, const FString& Message)
+{
+	Worker_Op& Op = AddOp(WORKER_OP_TYPE_COMMAND_RESPONSE);
+	Worker_CommandResponseOp& ResponseOp = Op.command_response;
+	ResponseOp.request_id = RequestId;
+	ResponseOp.entity_id = EntityId;
+	ResponseOp.status_code = StatusCode;
+	ResponseOp.message = PendingOpList->AddString(Message);
+	ResponseOp.response.component_id = ComponentId;
+	ResponseOp.response.schema_type = nullptr;
+	ResponseOp.command_id = CommandId;
+	AddResponse(FPlatformTime::Seconds());
+}
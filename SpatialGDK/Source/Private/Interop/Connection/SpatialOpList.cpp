@@ -0,0 +1,264 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Interop/Connection/SpatialOpList.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Schema/Rotation.h"
+#include "Schema/StandardLibrary.h"
+#include "Schema/UnrealMetadata.h"
+#include "SpatialConstants.h"
+#include "Utils/SchemaUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Decode Op List"), STAT_SpatialDecodeOpList, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Generated Components Decoded"), STAT_SpatialGeneratedComponentsDecoded, STATGROUP_SpatialNet);
+
+namespace improbable
+{
+
+TUniquePtr<ComponentStorageBase> CreateStaticComponentStorage(const Worker_ComponentData& Data)
+{
+	switch (Data.component_id)
+	{
+	case SpatialConstants::ENTITY_ACL_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<EntityAcl>>(Data);
+	case SpatialConstants::METADATA_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<Metadata>>(Data);
+	case SpatialConstants::POSITION_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<Position>>(Data);
+	case SpatialConstants::PERSISTENCE_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<Persistence>>(Data);
+	case SpatialConstants::ROTATION_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<Rotation>>(Data);
+	case SpatialConstants::UNREAL_METADATA_COMPONENT_ID:
+		return MakeUnique<ComponentStorage<UnrealMetadata>>(Data);
+	default:
+		return nullptr;
+	}
+}
+
+namespace
+{
+
+// Position and Rotation updates always carry the whole component, so they are parsed into a copy which replaces the stored one.
+template <typename T>
+class TReplacingComponentUpdate : public ComponentUpdateBase
+{
+public:
+	explicit TReplacingComponentUpdate(const Worker_ComponentUpdate& Update)
+	{
+		Value.ApplyComponentUpdate(Update);
+	}
+
+	void ApplyTo(Component& Target) const override
+	{
+		static_cast<T&>(Target) = Value;
+	}
+
+private:
+	T Value;
+};
+
+// Either of the ACLs can be left out of an update, so only the ones it contains are replaced.
+class FEntityAclUpdate : public ComponentUpdateBase
+{
+public:
+	explicit FEntityAclUpdate(const Worker_ComponentUpdate& Update)
+	{
+		Schema_Object* ComponentObject = Schema_GetComponentUpdateFields(Update.schema_type);
+		bHasReadAcl = Schema_GetObjectCount(ComponentObject, 1) > 0;
+		bHasComponentWriteAcl = Schema_GetObjectCount(ComponentObject, 2) > 0;
+		Value.ApplyComponentUpdate(Update);
+	}
+
+	bool IsEmpty() const
+	{
+		return !bHasReadAcl && !bHasComponentWriteAcl;
+	}
+
+	void ApplyTo(Component& Target) const override
+	{
+		EntityAcl& TargetAcl = static_cast<EntityAcl&>(Target);
+		if (bHasReadAcl)
+		{
+			TargetAcl.ReadAcl = Value.ReadAcl;
+		}
+		if (bHasComponentWriteAcl)
+		{
+			TargetAcl.ComponentWriteAcl = Value.ComponentWriteAcl;
+		}
+	}
+
+private:
+	EntityAcl Value;
+	bool bHasReadAcl;
+	bool bHasComponentWriteAcl;
+};
+
+} // ::
+
+TUniquePtr<ComponentUpdateBase> CreateStaticComponentUpdate(const Worker_ComponentUpdate& Update)
+{
+	Schema_Object* ComponentObject = Schema_GetComponentUpdateFields(Update.schema_type);
+
+	switch (Update.component_id)
+	{
+	case SpatialConstants::ENTITY_ACL_COMPONENT_ID:
+	{
+		TUniquePtr<FEntityAclUpdate> AclUpdate = MakeUnique<FEntityAclUpdate>(Update);
+		if (AclUpdate->IsEmpty())
+		{
+			return nullptr;
+		}
+		return MoveTemp(AclUpdate);
+	}
+	case SpatialConstants::POSITION_COMPONENT_ID:
+		if (Schema_GetObjectCount(ComponentObject, 1) == 0)
+		{
+			return nullptr;
+		}
+		return MakeUnique<TReplacingComponentUpdate<Position>>(Update);
+	case SpatialConstants::ROTATION_COMPONENT_ID:
+		if (Schema_GetUint64Count(ComponentObject, 1) == 0)
+		{
+			return nullptr;
+		}
+		return MakeUnique<TReplacingComponentUpdate<Rotation>>(Update);
+	default:
+		return nullptr;
+	}
+}
+
+namespace
+{
+
+void ReadGeneratedComponentFields(Schema_Object* ComponentObject, const TArray<ESchemaPropertyKind>& FieldKinds, GeneratedComponentFields& Fields)
+{
+	Fields.FieldIds.SetNumUninitialized(Schema_GetUniqueFieldIdCount(ComponentObject));
+	Schema_GetUniqueFieldIds(ComponentObject, Fields.FieldIds.GetData());
+
+	for (Schema_FieldId FieldId : Fields.FieldIds)
+	{
+		if (FieldId == 0 || (int32)FieldId > FieldKinds.Num())
+		{
+			continue;
+		}
+
+		switch (FieldKinds[FieldId - 1])
+		{
+		case ESchemaPropertyKind::Name:
+		case ESchemaPropertyKind::String:
+		case ESchemaPropertyKind::Text:
+		{
+			TArray<FString>& Strings = Fields.Strings.Add(FieldId);
+			const uint32 Count = Schema_GetBytesCount(ComponentObject, FieldId);
+			Strings.Reserve(Count);
+			for (uint32 i = 0; i < Count; i++)
+			{
+				Strings.Add(IndexStringFromSchema(ComponentObject, FieldId, i));
+			}
+			break;
+		}
+		case ESchemaPropertyKind::Object:
+		{
+			TArray<FUnrealObjectRef>& ObjectRefs = Fields.ObjectRefs.Add(FieldId);
+			const uint32 Count = Schema_GetObjectCount(ComponentObject, FieldId);
+			ObjectRefs.Reserve(Count);
+			for (uint32 i = 0; i < Count; i++)
+			{
+				ObjectRefs.Add(IndexObjectRefFromSchema(ComponentObject, FieldId, i));
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+} // ::
+
+TSharedPtr<GeneratedComponentFields> CreateGeneratedComponentFields(const Worker_ComponentData& Data, const TArray<ESchemaPropertyKind>& FieldKinds)
+{
+	TSharedPtr<GeneratedComponentFields> Fields = MakeShared<GeneratedComponentFields>();
+	ReadGeneratedComponentFields(Schema_GetComponentDataFields(Data.schema_type), FieldKinds, *Fields);
+	return Fields;
+}
+
+TSharedPtr<GeneratedComponentFields> CreateGeneratedComponentFields(const Worker_ComponentUpdate& Update, const TArray<ESchemaPropertyKind>& FieldKinds)
+{
+	TSharedPtr<GeneratedComponentFields> Fields = MakeShared<GeneratedComponentFields>();
+	ReadGeneratedComponentFields(Schema_GetComponentUpdateFields(Update.schema_type), FieldKinds, *Fields);
+
+	TArray<Schema_FieldId> ClearedIds;
+	ClearedIds.SetNumUninitialized(Schema_GetComponentUpdateClearedFieldCount(Update.schema_type));
+	Schema_GetComponentUpdateClearedFieldList(Update.schema_type, ClearedIds.GetData());
+	Fields->ClearedFieldIds.Append(ClearedIds);
+
+	return Fields;
+}
+
+}
+
+FSpatialOpList::FSpatialOpList(Worker_OpList* InOpList)
+	: OpList(InOpList)
+{
+	check(OpList);
+}
+
+FSpatialOpList::FSpatialOpList()
+	: OpList(nullptr)
+{
+}
+
+FSpatialOpList::~FSpatialOpList()
+{
+	// Decoded data must be released before the op list it was read from.
+	DecodedComponents.Empty();
+	DecodedUpdates.Empty();
+	DecodedGeneratedComponents.Empty();
+
+	if (OpList != nullptr)
+	{
+		Worker_OpList_Destroy(OpList);
+	}
+}
+
+void FSpatialOpList::Decode(const FSpatialComponentLayouts* ComponentLayouts)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SpatialDecodeOpList);
+
+	for (uint32 i = 0; i < OpList->op_count; ++i)
+	{
+		const Worker_Op& Op = OpList->ops[i];
+		if (Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT)
+		{
+			if (TUniquePtr<improbable::ComponentStorageBase> Data = improbable::CreateStaticComponentStorage(Op.add_component.data))
+			{
+				DecodedComponents.Add(i, MoveTemp(Data));
+			}
+			else if (ComponentLayouts != nullptr)
+			{
+				if (TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe> FieldKinds = ComponentLayouts->Find(Op.add_component.data.component_id))
+				{
+					DecodedGeneratedComponents.Add(i, improbable::CreateGeneratedComponentFields(Op.add_component.data, *FieldKinds));
+					INC_DWORD_STAT(STAT_SpatialGeneratedComponentsDecoded);
+				}
+			}
+		}
+		else if (Op.op_type == WORKER_OP_TYPE_COMPONENT_UPDATE)
+		{
+			if (TUniquePtr<improbable::ComponentUpdateBase> Update = improbable::CreateStaticComponentUpdate(Op.component_update.update))
+			{
+				DecodedUpdates.Add(i, MoveTemp(Update));
+			}
+			else if (ComponentLayouts != nullptr)
+			{
+				if (TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe> FieldKinds = ComponentLayouts->Find(Op.component_update.update.component_id))
+				{
+					DecodedGeneratedComponents.Add(i, improbable::CreateGeneratedComponentFields(Op.component_update.update, *FieldKinds));
+					INC_DWORD_STAT(STAT_SpatialGeneratedComponentsDecoded);
+				}
+			}
+		}
+	}
+}
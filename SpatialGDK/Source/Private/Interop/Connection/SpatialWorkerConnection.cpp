@@ -3,15 +3,29 @@
 #include "Interop/Connection/SpatialWorkerConnection.h"
 
 #include "Async/Async.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ScopeLock.h"
+
+#include "SpatialGDKSettings.h"
 
 DEFINE_LOG_CATEGORY(LogSpatialWorkerConnection);
 
 void USpatialWorkerConnection::FinishDestroy()
 {
-	if (WorkerConnection)
+	StopOpsProcessingThread();
+
+	OpListRecorder.Reset();
+	OpListReplayer.Reset();
+	MockConnection.Reset();
+
 	{
-		Worker_Connection_Destroy(WorkerConnection);
-		WorkerConnection = nullptr;
+		FScopeLock Lock(&ConnectionCriticalSection);
+		if (WorkerConnection)
+		{
+			Worker_Connection_Destroy(WorkerConnection);
+			WorkerConnection = nullptr;
+		}
 	}
 
 	if (WorkerLocator)
@@ -25,7 +39,16 @@ void USpatialWorkerConnection::FinishDestroy()
 
 void USpatialWorkerConnection::Connect(bool bInitAsClient)
 {
-	if (ShouldConnectWithLocator())
+	FString ReplayFilePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("replayOps"), ReplayFilePath))
+	{
+		ConnectToReplay(ReplayFilePath);
+	}
+	else if (bConnectToMock || FParse::Param(FCommandLine::Get(), TEXT("mockConnection")))
+	{
+		ConnectToMock(bInitAsClient);
+	}
+	else if (ShouldConnectWithLocator())
 	{
 		ConnectToLocator();
 	}
@@ -75,8 +98,7 @@ void USpatialWorkerConnection::ConnectToReceptionist(bool bConnectAsClient)
 		{
 			AsyncTask(ENamedThreads::GameThread, [this]
 			{
-				this->bIsConnected = true;
-				this->OnConnected.ExecuteIfBound();
+				this->OnConnectionSuccess();
 			});
 		}
 		else
@@ -184,8 +206,7 @@ void USpatialWorkerConnection::ConnectToLocator()
 			{
 				AsyncTask(ENamedThreads::GameThread, [SpatialConnection]
 				{
-					SpatialConnection->bIsConnected = true;
-					SpatialConnection->OnConnected.ExecuteIfBound();
+					SpatialConnection->OnConnectionSuccess();
 				});
 			}
 			else
@@ -196,6 +217,62 @@ void USpatialWorkerConnection::ConnectToLocator()
 	});
 }
 
+void USpatialWorkerConnection::ConnectToReplay(const FString& ReplayFilePath)
+{
+	OpListReplayer = MakeUnique<FSpatialOpListReplayer>(ReplayFilePath);
+	if (!OpListReplayer->IsValid())
+	{
+		OpListReplayer.Reset();
+		const FString ErrorMessage = FString::Printf(TEXT("Could not open op list recording %s"), *ReplayFilePath);
+		UE_LOG(LogSpatialWorkerConnection, Error, TEXT("Failed to connect to SpatialOS: %s"), *ErrorMessage);
+		OnConnectFailed.ExecuteIfBound(ErrorMessage);
+		return;
+	}
+
+	UE_LOG(LogSpatialWorkerConnection, Log, TEXT("Replaying op lists recorded by worker %s from %s."), *OpListReplayer->GetWorkerId(), *ReplayFilePath);
+
+	bReplayAsFastAsPossible = FParse::Param(FCommandLine::Get(), TEXT("replayOpsAsFastAsPossible"));
+	NumReplayedOpLists = 0;
+	NumReplayedOps = 0;
+	NextReplayRequestId = 1;
+	ReplayStartTime = FPlatformTime::Seconds();
+
+	AsyncTask(ENamedThreads::GameThread, [this]
+	{
+		this->OnConnectionSuccess();
+	});
+}
+
+void USpatialWorkerConnection::ConnectToMock(bool bConnectAsClient)
+{
+	if (ReceptionistConfig.WorkerType.IsEmpty())
+	{
+		ReceptionistConfig.WorkerType = bConnectAsClient ? SpatialConstants::ClientWorkerType : SpatialConstants::ServerWorkerType;
+	}
+
+	if (ReceptionistConfig.WorkerId.IsEmpty())
+	{
+		ReceptionistConfig.WorkerId = ReceptionistConfig.WorkerType + FGuid::NewGuid().ToString();
+	}
+
+	MockConnection = MakeUnique<FSpatialMockConnection>(ReceptionistConfig.WorkerType, ReceptionistConfig.WorkerId);
+
+	FString SnapshotPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("mockSnapshot="), SnapshotPath) && !MockConnection->LoadSnapshot(SnapshotPath))
+	{
+		MockConnection.Reset();
+		const FString ErrorMessage = FString::Printf(TEXT("Could not load snapshot %s into the mock connection"), *SnapshotPath);
+		UE_LOG(LogSpatialWorkerConnection, Error, TEXT("Failed to connect to SpatialOS: %s"), *ErrorMessage);
+		OnConnectFailed.ExecuteIfBound(ErrorMessage);
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [this]
+	{
+		this->OnConnectionSuccess();
+	});
+}
+
 bool USpatialWorkerConnection::ShouldConnectWithLocator()
 {
 	return !LocatorConfig.LoginToken.IsEmpty();
@@ -219,44 +296,332 @@ void USpatialWorkerConnection::GetAndPrintConnectionFailureMessage()
 	}
 }
 
-Worker_OpList* USpatialWorkerConnection::GetOpList()
+void USpatialWorkerConnection::OnConnectionSuccess()
+{
+	bIsConnected = true;
+
+	FString RecordFilePath;
+	if (OpListReplayer == nullptr && FParse::Value(FCommandLine::Get(), TEXT("recordOps"), RecordFilePath))
+	{
+		OpListRecorder = MakeUnique<FSpatialOpListRecorder>(RecordFilePath, GetWorkerId());
+		if (!OpListRecorder->IsValid())
+		{
+			OpListRecorder.Reset();
+		}
+	}
+
+	// Replayed and mocked op lists are already decoded, so there is nothing to gain from a worker thread.
+	if (OpListReplayer == nullptr && MockConnection == nullptr && !GetDefault<USpatialGDKSettings>()->bRunSpatialWorkerConnectionOnGameThread)
+	{
+		StartOpsProcessingThread();
+	}
+
+	OnConnected.ExecuteIfBound();
+}
+
+void USpatialWorkerConnection::StartOpsProcessingThread()
+{
+	check(OpsProcessingThread == nullptr);
+
+	OpsUpdateInterval = 1.0f / GetDefault<USpatialGDKSettings>()->OpsUpdateRate;
+	MaxQueuedOps = GetDefault<USpatialGDKSettings>()->MaxCarriedOverOps;
+	NumQueuedOps.Reset();
+	KeepRunning.AtomicSet(true);
+
+	OpsProcessingThread = FRunnableThread::Create(this, TEXT("SpatialWorkerConnectionWorker"), 0);
+	check(OpsProcessingThread);
+}
+
+void USpatialWorkerConnection::StopOpsProcessingThread()
+{
+	if (OpsProcessingThread == nullptr)
+	{
+		return;
+	}
+
+	// Kill calls Stop and waits for Run to return.
+	OpsProcessingThread->Kill(true);
+	delete OpsProcessingThread;
+	OpsProcessingThread = nullptr;
+
+	FSpatialOpList* OpList = nullptr;
+	while (OpListQueue.Dequeue(OpList))
+	{
+		delete OpList;
+	}
+}
+
+uint32 USpatialWorkerConnection::Run()
+{
+	while (KeepRunning)
+	{
+		FPlatformProcess::Sleep(OpsUpdateInterval);
+		QueueLatestOpList();
+	}
+
+	return 0;
+}
+
+void USpatialWorkerConnection::Stop()
+{
+	KeepRunning.AtomicSet(false);
+}
+
+void USpatialWorkerConnection::QueueLatestOpList()
+{
+	// While the game thread is behind, ops are left with the Worker SDK rather than queued here without limit. Once its own
+	// receive queue is full it stops reading from the network, which holds back the runtime in turn.
+	if (MaxQueuedOps > 0 && (uint32)NumQueuedOps.GetValue() > MaxQueuedOps)
+	{
+		return;
+	}
+
+	Worker_OpList* OpList = nullptr;
+	{
+		FScopeLock Lock(&ConnectionCriticalSection);
+		OpList = Worker_Connection_GetOpList(WorkerConnection, 0);
+	}
+
+	if (OpList->op_count == 0)
+	{
+		Worker_OpList_Destroy(OpList);
+		return;
+	}
+
+	RecordOpList(*OpList);
+
+	FSpatialOpList* SpatialOpList = new FSpatialOpList(OpList);
+	SpatialOpList->Decode(ComponentLayouts.Get());
+	NumQueuedOps.Add(OpList->op_count);
+	OpListQueue.Enqueue(SpatialOpList);
+}
+
+void USpatialWorkerConnection::RecordOpList(const Worker_OpList& OpList)
+{
+	if (OpListRecorder.IsValid() && OpList.op_count > 0)
+	{
+		OpListRecorder->RecordOpList(OpList);
+	}
+}
+
+TUniquePtr<FSpatialOpList> USpatialWorkerConnection::GetNextReplayedOpList()
+{
+	if (OpListReplayer->IsFinished())
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FSpatialOpList> OpList = OpListReplayer->ReadNextOpList(ComponentLayouts.Get());
+	if (OpList.IsValid())
+	{
+		NumReplayedOpLists++;
+		NumReplayedOps += OpList->OpList->op_count;
+	}
+
+	if (OpListReplayer->IsFinished())
+	{
+		const double ElapsedSeconds = FPlatformTime::Seconds() - ReplayStartTime;
+		UE_LOG(LogSpatialWorkerConnection, Display, TEXT("Finished replaying %d op lists (%d ops) in %.3f seconds (%.1f ops per second)."),
+			NumReplayedOpLists, NumReplayedOps, ElapsedSeconds, ElapsedSeconds > 0.0 ? NumReplayedOps / ElapsedSeconds : 0.0);
+	}
+
+	return OpList;
+}
+
+TArray<TUniquePtr<FSpatialOpList>> USpatialWorkerConnection::GetOpLists()
 {
-	return Worker_Connection_GetOpList(WorkerConnection, 0);
+	TArray<TUniquePtr<FSpatialOpList>> OpLists;
+
+	if (OpListReplayer.IsValid())
+	{
+		const double ReplayTime = FPlatformTime::Seconds() - ReplayStartTime;
+		while (!OpListReplayer->IsFinished() && (bReplayAsFastAsPossible || OpListReplayer->GetNextOpListTime() <= ReplayTime))
+		{
+			TUniquePtr<FSpatialOpList> OpList = GetNextReplayedOpList();
+			if (!OpList.IsValid())
+			{
+				break;
+			}
+			OpLists.Add(MoveTemp(OpList));
+		}
+	}
+	else if (MockConnection.IsValid())
+	{
+		if (TUniquePtr<FSpatialOpList> OpList = MockConnection->GetOpList(ComponentLayouts.Get()))
+		{
+			RecordOpList(*OpList->OpList);
+			OpLists.Add(MoveTemp(OpList));
+		}
+	}
+	else if (OpsProcessingThread == nullptr)
+	{
+		TUniquePtr<FSpatialOpList> OpList = MakeUnique<FSpatialOpList>(Worker_Connection_GetOpList(WorkerConnection, 0));
+		RecordOpList(*OpList->OpList);
+		OpList->Decode(ComponentLayouts.Get());
+		OpLists.Add(MoveTemp(OpList));
+	}
+	else
+	{
+		FSpatialOpList* OpList = nullptr;
+		while (OpListQueue.Dequeue(OpList))
+		{
+			NumQueuedOps.Subtract(OpList->OpList->op_count);
+			OpLists.Emplace(OpList);
+		}
+	}
+
+	return OpLists;
 }
 
 Worker_RequestId USpatialWorkerConnection::SendReserveEntityIdRequest()
 {
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->SendReserveEntityIdRequest();
+	}
+
+	if (OpListReplayer.IsValid())
+	{
+		return NextReplayRequestId++;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return 0;
+	}
+
 	return Worker_Connection_SendReserveEntityIdRequest(WorkerConnection, nullptr);
 }
 
+Worker_RequestId USpatialWorkerConnection::SendReserveEntityIdsRequest(uint32_t NumOfEntities)
+{
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->SendReserveEntityIdsRequest(NumOfEntities);
+	}
+
+	if (OpListReplayer.IsValid())
+	{
+		return NextReplayRequestId++;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return 0;
+	}
+
+	return Worker_Connection_SendReserveEntityIdsRequest(WorkerConnection, NumOfEntities, nullptr);
+}
+
 Worker_RequestId USpatialWorkerConnection::SendCreateEntityRequest(uint32_t ComponentCount, const Worker_ComponentData* Components, const Worker_EntityId* EntityId)
 {
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->SendCreateEntityRequest(ComponentCount, Components, EntityId);
+	}
+
+	if (OpListReplayer.IsValid())
+	{
+		return NextReplayRequestId++;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return 0;
+	}
+
 	return Worker_Connection_SendCreateEntityRequest(WorkerConnection, ComponentCount, Components, EntityId, nullptr);
 }
 
 Worker_RequestId USpatialWorkerConnection::SendDeleteEntityRequest(Worker_EntityId EntityId)
 {
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->SendDeleteEntityRequest(EntityId);
+	}
+
+	if (OpListReplayer.IsValid())
+	{
+		return NextReplayRequestId++;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return 0;
+	}
+
 	return Worker_Connection_SendDeleteEntityRequest(WorkerConnection, EntityId, nullptr);
 }
 
 void USpatialWorkerConnection::SendComponentUpdate(Worker_EntityId EntityId, const Worker_ComponentUpdate* ComponentUpdate)
 {
+	if (MockConnection.IsValid())
+	{
+		MockConnection->SendComponentUpdate(EntityId, ComponentUpdate);
+		return;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return;
+	}
+
 	Worker_Connection_SendComponentUpdate(WorkerConnection, EntityId, ComponentUpdate);
 }
 
 Worker_RequestId USpatialWorkerConnection::SendCommandRequest(Worker_EntityId EntityId, const Worker_CommandRequest* Request, uint32_t CommandId)
 {
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->SendCommandRequest(EntityId, Request, CommandId);
+	}
+
+	if (OpListReplayer.IsValid())
+	{
+		return NextReplayRequestId++;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return 0;
+	}
+
 	Worker_CommandParameters CommandParams{};
 	return Worker_Connection_SendCommandRequest(WorkerConnection, EntityId, Request, CommandId, nullptr, &CommandParams);
 }
 
 void USpatialWorkerConnection::SendCommandResponse(Worker_RequestId RequestId, const Worker_CommandResponse* Response)
 {
+	if (MockConnection.IsValid())
+	{
+		MockConnection->SendCommandResponse(RequestId, Response);
+		return;
+	}
+
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return;
+	}
+
 	return Worker_Connection_SendCommandResponse(WorkerConnection, RequestId, Response);
 }
 
 void USpatialWorkerConnection::SendLogMessage(const uint8_t Level, const char* LoggerName, const char* Message)
 {
+	// Log messages are sent from the output device's flush thread, so the connection is only checked under the lock FinishDestroy takes.
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return;
+	}
+
 	Worker_LogMessage LogMessage{};
 	LogMessage.level = Level;
 	LogMessage.logger_name = LoggerName;
@@ -267,10 +632,26 @@ void USpatialWorkerConnection::SendLogMessage(const uint8_t Level, const char* L
 
 void USpatialWorkerConnection::SendComponentInterest(Worker_EntityId EntityId, const TArray<Worker_InterestOverride>& ComponentInterest)
 {
+	FScopeLock Lock(&ConnectionCriticalSection);
+	if (WorkerConnection == nullptr)
+	{
+		return;
+	}
+
 	Worker_Connection_SendComponentInterest(WorkerConnection, EntityId, ComponentInterest.GetData(), ComponentInterest.Num());
 }
 
 FString USpatialWorkerConnection::GetWorkerId() const
 {
+	if (OpListReplayer.IsValid())
+	{
+		return OpListReplayer->GetWorkerId();
+	}
+
+	if (MockConnection.IsValid())
+	{
+		return MockConnection->GetWorkerId();
+	}
+
 	return FString(UTF8_TO_TCHAR(Worker_Connection_GetWorkerId(WorkerConnection)));
 }
@@ -8,7 +8,7 @@
 #include "EngineClasses/SpatialPackageMapClient.h"
 #include "Interop/Connection/SpatialWorkerConnection.h"
 #include "Interop/SpatialSender.h"
-#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
 #include "Schema/UnrealMetadata.h"
 #include "SpatialConstants.h"
 #include "Utils/EntityRegistry.h"
@@ -22,12 +22,15 @@ void UGlobalStateManager::Init(USpatialNetDriver* InNetDriver)
 	NetDriver = InNetDriver;
 	StaticComponentView = InNetDriver->StaticComponentView;
 	Sender = InNetDriver->Sender;
+	bSingletonActorsFound = false;
+	bSingletonEntityIdsDirty = false;
 }
 
 void UGlobalStateManager::ApplyData(const Worker_ComponentData& Data)
 {
 	Schema_Object* ComponentObject = Schema_GetComponentDataFields(Data.schema_type);
 	SingletonNameToEntityId = GetStringToEntityMapFromSchema(ComponentObject, 1);
+	OnSingletonNameToEntityIdChanged();
 }
 
 void UGlobalStateManager::ApplyUpdate(const Worker_ComponentUpdate& Update)
@@ -37,6 +40,25 @@ void UGlobalStateManager::ApplyUpdate(const Worker_ComponentUpdate& Update)
 	if (Schema_GetObjectCount(ComponentObject, 1) > 0)
 	{
 		SingletonNameToEntityId = GetStringToEntityMapFromSchema(ComponentObject, 1);
+		OnSingletonNameToEntityIdChanged();
+	}
+}
+
+void UGlobalStateManager::OnSingletonNameToEntityIdChanged()
+{
+	SingletonEntityIdToName.Reset();
+	for (const auto& Pair : SingletonNameToEntityId)
+	{
+		if (Pair.Value != SpatialConstants::INVALID_ENTITY_ID)
+		{
+			SingletonEntityIdToName.Add(Pair.Value, Pair.Key);
+		}
+
+		// A singleton class we haven't seen before has to be looked for in the world.
+		if (!SingletonClasses.Contains(Pair.Key))
+		{
+			bSingletonActorsFound = false;
+		}
 	}
 }
 
@@ -118,7 +140,16 @@ void UGlobalStateManager::ExecuteInitialSingletonActorReplication()
 
 void UGlobalStateManager::UpdateSingletonEntityId(const FString& ClassName, const Worker_EntityId SingletonEntityId)
 {
-	SingletonNameToEntityId[ClassName] = SingletonEntityId;
+	Worker_EntityId& EntityId = SingletonNameToEntityId[ClassName];
+	if (EntityId != SpatialConstants::INVALID_ENTITY_ID)
+	{
+		SingletonEntityIdToName.Remove(EntityId);
+	}
+	EntityId = SingletonEntityId;
+	if (SingletonEntityId != SpatialConstants::INVALID_ENTITY_ID)
+	{
+		SingletonEntityIdToName.Add(SingletonEntityId, ClassName);
+	}
 
 	if (!NetDriver->StaticComponentView->HasAuthority(SpatialConstants::GLOBAL_STATE_MANAGER, SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID))
 	{
@@ -126,6 +157,18 @@ void UGlobalStateManager::UpdateSingletonEntityId(const FString& ClassName, cons
 		return;
 	}
 
+	bSingletonEntityIdsDirty = true;
+}
+
+void UGlobalStateManager::FlushSingletonEntityIds()
+{
+	if (!bSingletonEntityIdsDirty)
+	{
+		return;
+	}
+	bSingletonEntityIdsDirty = false;
+
+	// An update replaces the whole map, so it is built once per tick however many singletons have changed, rather than once for each.
 	Worker_ComponentUpdate Update = {};
 	Update.component_id = SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID;
 	Update.schema_type = Schema_CreateComponentUpdate(SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID);
@@ -133,15 +176,63 @@ void UGlobalStateManager::UpdateSingletonEntityId(const FString& ClassName, cons
 
 	AddStringToEntityMapToSchema(UpdateObject, 1, SingletonNameToEntityId);
 
-	NetDriver->Connection->SendComponentUpdate(SpatialConstants::GLOBAL_STATE_MANAGER, &Update);
+	Sender->QueueComponentUpdate(SpatialConstants::GLOBAL_STATE_MANAGER, Update);
+}
+
+void UGlobalStateManager::FindSingletonActors()
+{
+	SingletonClassToActors.Reset();
+
+	for (const auto& Pair : SingletonNameToEntityId)
+	{
+		UClass*& SingletonActorClass = SingletonClasses.FindOrAdd(Pair.Key);
+		if (SingletonActorClass == nullptr)
+		{
+			SingletonActorClass = LoadObject<UClass>(nullptr, *Pair.Key);
+		}
+
+		if (SingletonActorClass != nullptr)
+		{
+			SingletonClassToActors.Add(SingletonActorClass);
+		}
+	}
+
+	// A single pass over the world for every singleton class. Actors count towards their superclasses too, as singletons can be subclassed.
+	for (TActorIterator<AActor> It(NetDriver->GetWorld()); It; ++It)
+	{
+		for (UClass* Class = It->GetClass(); Class != nullptr; Class = Class->GetSuperClass())
+		{
+			if (TArray<TWeakObjectPtr<AActor>>* Actors = SingletonClassToActors.Find(Class))
+			{
+				Actors->Add(*It);
+			}
+		}
+	}
+
+	// Singletons which haven't spawned yet have to be looked for again next time, so only keep the results once every one was found.
+	bSingletonActorsFound = true;
+	for (const auto& Pair : SingletonNameToEntityId)
+	{
+		UClass* SingletonActorClass = SingletonClasses.FindRef(Pair.Key);
+		if (SingletonActorClass == nullptr || SingletonClassToActors.FindChecked(SingletonActorClass).Num() == 0)
+		{
+			bSingletonActorsFound = false;
+			break;
+		}
+	}
 }
 
-void UGlobalStateManager::GetSingletonActorAndChannel(FString ClassName, AActor*& OutActor, USpatialActorChannel*& OutChannel)
+void UGlobalStateManager::GetSingletonActorAndChannel(const FString& ClassName, AActor*& OutActor, USpatialActorChannel*& OutChannel)
 {
 	OutActor = nullptr;
 	OutChannel = nullptr;
 
-	UClass* SingletonActorClass = LoadObject<UClass>(nullptr, *ClassName);
+	if (!bSingletonActorsFound)
+	{
+		FindSingletonActors();
+	}
+
+	UClass* SingletonActorClass = SingletonClasses.FindRef(ClassName);
 
 	if (SingletonActorClass == nullptr)
 	{
@@ -157,9 +248,7 @@ void UGlobalStateManager::GetSingletonActorAndChannel(FString ClassName, AActor*
 	}
 
 	// Class doesn't exist in our map, have to find actor and create channel
-	// Get Singleton Actor in world
-	TArray<AActor*> SingletonActorList;
-	UGameplayStatics::GetAllActorsOfClass(NetDriver->GetWorld(), SingletonActorClass, SingletonActorList);
+	const TArray<TWeakObjectPtr<AActor>>& SingletonActorList = SingletonClassToActors.FindChecked(SingletonActorClass);
 
 	if (SingletonActorList.Num() == 0)
 	{
@@ -173,7 +262,13 @@ void UGlobalStateManager::GetSingletonActorAndChannel(FString ClassName, AActor*
 		return;
 	}
 
-	OutActor = SingletonActorList[0];
+	OutActor = SingletonActorList[0].Get();
+	if (OutActor == nullptr)
+	{
+		UE_LOG(LogGlobalStateManager, Error, TEXT("Singleton Actor of type %s was destroyed."), *ClassName);
+		bSingletonActorsFound = false;
+		return;
+	}
 
 	USpatialNetConnection* Connection = Cast<USpatialNetConnection>(NetDriver->ClientConnections[0]);
 
@@ -186,12 +281,5 @@ void UGlobalStateManager::GetSingletonActorAndChannel(FString ClassName, AActor*
 
 bool UGlobalStateManager::IsSingletonEntity(Worker_EntityId EntityId)
 {
-	for (const auto& Pair : SingletonNameToEntityId)
-	{
-		if (Pair.Value == EntityId)
-		{
-			return true;
-		}
-	}
-	return false;
+	return SingletonEntityIdToName.Contains(EntityId);
 }
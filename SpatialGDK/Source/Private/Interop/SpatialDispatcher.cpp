@@ -2,113 +2,336 @@
 
 #include "Interop/SpatialDispatcher.h"
 
+#include "EngineClasses/SpatialActorChannel.h"
 #include "EngineClasses/SpatialNetConnection.h"
 #include "EngineClasses/SpatialNetDriver.h"
 #include "Interop/SpatialReceiver.h"
 #include "Interop/SpatialStaticComponentView.h"
+#include "SpatialGDKSettings.h"
 
 DEFINE_LOG_CATEGORY(LogSpatialView);
 
+DECLARE_CYCLE_STAT(TEXT("Dispatcher ProcessOps"), STAT_SpatialDispatcherProcessOps, STATGROUP_SpatialNet);
+DECLARE_CYCLE_STAT(TEXT("Dispatcher SpatialViewTick"), STAT_SpatialDispatcherViewTick, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dirty Channels Ticked"), STAT_SpatialDirtyChannelsTicked, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Channels Found Dirty By Sweep"), STAT_SpatialSweptChannels, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Channels"), STAT_SpatialActorChannels, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ops Processed"), STAT_SpatialOpsProcessed, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dispatcher Yields"), STAT_SpatialDispatcherYields, STATGROUP_SpatialNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Op Lists"), STAT_SpatialQueuedOpLists, STATGROUP_SpatialNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Carried Over Ops"), STAT_SpatialCarriedOverOps, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backed Up Ticks"), STAT_SpatialDispatcherBackedUpTicks, STATGROUP_SpatialNet);
+
 void USpatialDispatcher::Init(USpatialNetDriver* InNetDriver)
 {
 	NetDriver = InNetDriver;
 	Receiver = InNetDriver->Receiver;
 	StaticComponentView = InNetDriver->StaticComponentView;
+
+	NextOpIndex = 0;
+	NextComponentUpdateIndex = 0;
+	NumQueuedOpLists = 0;
+	QueuedOpCount = 0;
+	bLeavingCriticalSection = false;
+	bWasBackedUp = false;
+	BackedUpTicks = 0;
+	LastSweepTime = FPlatformTime::Seconds();
+}
+
+void USpatialDispatcher::BeginDestroy()
+{
+	FSpatialOpList* OpList = nullptr;
+	while (QueuedOpLists.Dequeue(OpList))
+	{
+		delete OpList;
+	}
+	CurrentOpList.Reset();
+
+	Super::BeginDestroy();
+}
+
+void USpatialDispatcher::QueueOpLists(TArray<TUniquePtr<FSpatialOpList>>&& OpLists)
+{
+	for (TUniquePtr<FSpatialOpList>& OpList : OpLists)
+	{
+		QueuedOpCount += OpList->OpList->op_count;
+		NumQueuedOpLists++;
+		QueuedOpLists.Enqueue(OpList.Release());
+	}
+}
+
+bool USpatialDispatcher::IsBackedUp() const
+{
+	const uint32 MaxCarriedOverOps = GetDefault<USpatialGDKSettings>()->MaxCarriedOverOps;
+	return MaxCarriedOverOps > 0 && QueuedOpCount > MaxCarriedOverOps;
 }
 
-void USpatialDispatcher::ProcessOps(Worker_OpList* OpList)
+void USpatialDispatcher::ProcessOps()
 {
-	TArray<Worker_Op*> QueuedComponentUpdateOps;
+	SCOPE_CYCLE_COUNTER(STAT_SpatialDispatcherProcessOps);
+
+	const float TimeBudgetMs = GetDefault<USpatialGDKSettings>()->OpsProcessingTimeBudgetMs;
+	const double Deadline = TimeBudgetMs > 0.0f ? FPlatformTime::Seconds() + TimeBudgetMs / 1000.0 : TNumericLimits<double>::Max();
 
-	for (size_t i = 0; i < OpList->op_count; ++i)
+	while (true)
 	{
-		Worker_Op* Op = &OpList->ops[i];
-		switch (Op->op_type)
+		if (!CurrentOpList.IsValid())
 		{
-		// Critical Section
-		case WORKER_OP_TYPE_CRITICAL_SECTION:
-			Receiver->OnCriticalSection(Op->critical_section.in_critical_section != 0);
-			break;
+			FSpatialOpList* OpList = nullptr;
+			if (!QueuedOpLists.Dequeue(OpList))
+			{
+				break;
+			}
+			CurrentOpList.Reset(OpList);
+			NumQueuedOpLists--;
+		}
 
-		// Entity Lifetime
-		case WORKER_OP_TYPE_ADD_ENTITY:
-			Receiver->OnAddEntity(Op->add_entity);
-			break;
-		case WORKER_OP_TYPE_REMOVE_ENTITY:
-			Receiver->OnRemoveEntity(Op->remove_entity);
-			StaticComponentView->OnRemoveEntity(Op->remove_entity);
+		if (!ProcessOpList(*CurrentOpList, Deadline))
+		{
+			INC_DWORD_STAT(STAT_SpatialDispatcherYields);
 			break;
+		}
 
-		// Components
-		case WORKER_OP_TYPE_ADD_COMPONENT:
-			StaticComponentView->OnAddComponent(Op->add_component);
-			Receiver->OnAddComponent(Op->add_component);
-			break;
-		case WORKER_OP_TYPE_REMOVE_COMPONENT:
-			break;
-		case WORKER_OP_TYPE_COMPONENT_UPDATE:
-			QueuedComponentUpdateOps.Add(Op);
-			StaticComponentView->OnComponentUpdate(Op->component_update);
-			break;
+		CurrentOpList.Reset();
+	}
 
-		// Commands
-		case WORKER_OP_TYPE_COMMAND_REQUEST:
-			Receiver->OnCommandRequest(Op->command_request);
-			break;
-		case WORKER_OP_TYPE_COMMAND_RESPONSE:
-			Receiver->OnCommandResponse(Op->command_response);
-			break;
+	SET_DWORD_STAT(STAT_SpatialQueuedOpLists, NumQueuedOpLists + (CurrentOpList.IsValid() ? 1 : 0));
+	SET_DWORD_STAT(STAT_SpatialCarriedOverOps, QueuedOpCount);
 
-		// Authority Change
-		case WORKER_OP_TYPE_AUTHORITY_CHANGE:
-			StaticComponentView->OnAuthorityChange(Op->authority_change);
-			Receiver->OnAuthorityChange(Op->authority_change);
-			break;
+	UpdateBackedUp();
 
-		// World Command Responses
-		case WORKER_OP_TYPE_RESERVE_ENTITY_ID_RESPONSE:
-			Receiver->OnReserveEntityIdResponse(Op->reserve_entity_id_response);
-			break;
-		case WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE:
-			break;
-		case WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE:
-			Receiver->OnCreateEntityIdResponse(Op->create_entity_response);
-			break;
-		case WORKER_OP_TYPE_DELETE_ENTITY_RESPONSE:
-			break;
-		case WORKER_OP_TYPE_ENTITY_QUERY_RESPONSE:
-			break;
+	SweepChannels();
+	TickDirtyChannels();
+}
 
-		case WORKER_OP_TYPE_FLAG_UPDATE:
-			break;
-		case WORKER_OP_TYPE_LOG_MESSAGE:
-			UE_LOG(LogSpatialView, Log, TEXT("SpatialOS Worker Log: %s"), UTF8_TO_TCHAR(Op->log_message.message));
-			break;
-		case WORKER_OP_TYPE_METRICS:
-			break;
-		case WORKER_OP_TYPE_DISCONNECT:
-			UE_LOG(LogSpatialView, Warning, TEXT("Disconnecting from SpatialOS: %s"), UTF8_TO_TCHAR(Op->disconnect.reason));
-			break;
+void USpatialDispatcher::UpdateBackedUp()
+{
+	const bool bBackedUp = IsBackedUp();
+	if (bBackedUp)
+	{
+		BackedUpTicks++;
+		INC_DWORD_STAT(STAT_SpatialDispatcherBackedUpTicks);
+	}
 
-		default:
-			break;
+	if (bBackedUp && !bWasBackedUp)
+	{
+		UE_LOG(LogSpatialView, Warning, TEXT("%u ops have been carried over, more than the limit of %u. No new op lists will be taken from the connection until they are processed."),
+			QueuedOpCount, GetDefault<USpatialGDKSettings>()->MaxCarriedOverOps);
+	}
+	else if (!bBackedUp && bWasBackedUp)
+	{
+		UE_LOG(LogSpatialView, Log, TEXT("Carried over ops are back under the limit after %u ticks."), BackedUpTicks);
+		BackedUpTicks = 0;
+	}
+
+	bWasBackedUp = bBackedUp;
+}
+
+bool USpatialDispatcher::ProcessOpList(FSpatialOpList& OpList, double Deadline)
+{
+	const uint32 OpCount = OpList.OpList->op_count;
+
+	// Always make progress by processing at least one op before checking the deadline.
+	// Critical sections can be split across calls as well: the receiver holds back the entities added in one until it ends,
+	// so an entity is still only observed once all of its initial components have been added.
+	while (bLeavingCriticalSection || NextOpIndex < OpCount)
+	{
+		if (bLeavingCriticalSection)
+		{
+			// Receiving every entity of a large checkout can take more than one tick by itself.
+			if (!Receiver->LeaveCriticalSection(Deadline))
+			{
+				return false;
+			}
+			bLeavingCriticalSection = false;
+		}
+		else
+		{
+			ProcessOp(OpList, NextOpIndex++);
+			--QueuedOpCount;
+			INC_DWORD_STAT(STAT_SpatialOpsProcessed);
+		}
+
+		if (FPlatformTime::Seconds() > Deadline)
+		{
+			return false;
 		}
 	}
 
-	for (Worker_Op* Op : QueuedComponentUpdateOps)
+	// Component updates are applied once every other op in the list has been processed.
+	while (NextComponentUpdateIndex < QueuedComponentUpdateOps.Num())
 	{
-		Receiver->OnComponentUpdate(Op->component_update);
+		const uint32 OpIndex = QueuedComponentUpdateOps[NextComponentUpdateIndex++];
+		const TSharedPtr<improbable::GeneratedComponentFields>* DecodedFields = OpList.DecodedGeneratedComponents.Find(OpIndex);
+		Receiver->OnComponentUpdate(OpList.OpList->ops[OpIndex].component_update, DecodedFields != nullptr ? DecodedFields->Get() : nullptr);
+
+		if (NextComponentUpdateIndex < QueuedComponentUpdateOps.Num() && FPlatformTime::Seconds() > Deadline)
+		{
+			return false;
+		}
 	}
 
 	Receiver->ProcessQueuedResolvedObjects();
 
-	// Check every channel for net ownership changes (determines ACL and component interest)
-	const FActorChannelMap& ChannelMap = NetDriver->GetSpatialOSNetConnection()->ActorChannelMap();
-	for (auto& Pair : ChannelMap)
+	QueuedComponentUpdateOps.Reset();
+	NextComponentUpdateIndex = 0;
+	NextOpIndex = 0;
+
+	return true;
+}
+
+void USpatialDispatcher::ProcessOp(FSpatialOpList& OpList, uint32 OpIndex)
+{
+	Worker_Op* Op = &OpList.OpList->ops[OpIndex];
+
+	switch (Op->op_type)
+	{
+	// Critical Section
+	case WORKER_OP_TYPE_CRITICAL_SECTION:
+		if (Op->critical_section.in_critical_section != 0)
+		{
+			Receiver->OnCriticalSection(true);
+		}
+		else
+		{
+			// Left by ProcessOpList, within the time budget.
+			bLeavingCriticalSection = true;
+		}
+		break;
+
+	// Entity Lifetime
+	case WORKER_OP_TYPE_ADD_ENTITY:
+		Receiver->OnAddEntity(Op->add_entity);
+		break;
+	case WORKER_OP_TYPE_REMOVE_ENTITY:
+		Receiver->OnRemoveEntity(Op->remove_entity);
+		StaticComponentView->OnRemoveEntity(Op->remove_entity);
+		break;
+
+	// Components
+	case WORKER_OP_TYPE_ADD_COMPONENT:
+		if (TUniquePtr<improbable::ComponentStorageBase>* DecodedData = OpList.DecodedComponents.Find(OpIndex))
+		{
+			StaticComponentView->OnAddComponent(Op->add_component, MoveTemp(*DecodedData));
+		}
+		else
+		{
+			StaticComponentView->OnAddComponent(Op->add_component);
+		}
+		if (TSharedPtr<improbable::GeneratedComponentFields>* DecodedFields = OpList.DecodedGeneratedComponents.Find(OpIndex))
+		{
+			Receiver->OnAddComponent(Op->add_component, *DecodedFields);
+		}
+		else
+		{
+			Receiver->OnAddComponent(Op->add_component);
+		}
+		break;
+	case WORKER_OP_TYPE_REMOVE_COMPONENT:
+		StaticComponentView->OnRemoveComponent(Op->remove_component);
+		break;
+	case WORKER_OP_TYPE_COMPONENT_UPDATE:
+		QueuedComponentUpdateOps.Add(OpIndex);
+		if (TUniquePtr<improbable::ComponentUpdateBase>* DecodedUpdate = OpList.DecodedUpdates.Find(OpIndex))
+		{
+			StaticComponentView->OnComponentUpdate(Op->component_update, DecodedUpdate->Get());
+		}
+		else
+		{
+			StaticComponentView->OnComponentUpdate(Op->component_update);
+		}
+		break;
+
+	// Commands
+	case WORKER_OP_TYPE_COMMAND_REQUEST:
+		Receiver->OnCommandRequest(Op->command_request);
+		break;
+	case WORKER_OP_TYPE_COMMAND_RESPONSE:
+		Receiver->OnCommandResponse(Op->command_response);
+		break;
+
+	// Authority Change
+	case WORKER_OP_TYPE_AUTHORITY_CHANGE:
+		StaticComponentView->OnAuthorityChange(Op->authority_change);
+		Receiver->OnAuthorityChange(Op->authority_change);
+		break;
+
+	// World Command Responses
+	case WORKER_OP_TYPE_RESERVE_ENTITY_ID_RESPONSE:
+		Receiver->OnReserveEntityIdResponse(Op->reserve_entity_id_response);
+		break;
+	case WORKER_OP_TYPE_RESERVE_ENTITY_IDS_RESPONSE:
+		Receiver->OnReserveEntityIdsResponse(Op->reserve_entity_ids_response);
+		break;
+	case WORKER_OP_TYPE_CREATE_ENTITY_RESPONSE:
+		Receiver->OnCreateEntityIdResponse(Op->create_entity_response);
+		break;
+	case WORKER_OP_TYPE_DELETE_ENTITY_RESPONSE:
+		break;
+	case WORKER_OP_TYPE_ENTITY_QUERY_RESPONSE:
+		break;
+
+	case WORKER_OP_TYPE_FLAG_UPDATE:
+		break;
+	case WORKER_OP_TYPE_LOG_MESSAGE:
+		UE_LOG(LogSpatialView, Log, TEXT("SpatialOS Worker Log: %s"), UTF8_TO_TCHAR(Op->log_message.message));
+		break;
+	case WORKER_OP_TYPE_METRICS:
+		break;
+	case WORKER_OP_TYPE_DISCONNECT:
+		UE_LOG(LogSpatialView, Warning, TEXT("Disconnecting from SpatialOS: %s"), UTF8_TO_TCHAR(Op->disconnect.reason));
+		break;
+
+	default:
+		break;
+	}
+}
+
+void USpatialDispatcher::TickDirtyChannels()
+{
+	// Only channels which have been marked dirty need to check for net ownership changes (determines ACL and component interest).
+	// The dirty set is swapped out first, so channels which need to retry can mark themselves again while being ticked.
+	SCOPE_CYCLE_COUNTER(STAT_SpatialDispatcherViewTick);
+
+	TSet<TWeakObjectPtr<USpatialActorChannel>> ChannelsToTick = MoveTemp(DirtyChannels);
+	DirtyChannels.Reset();
+
+	for (const TWeakObjectPtr<USpatialActorChannel>& Channel : ChannelsToTick)
 	{
-		if (USpatialActorChannel* Channel = Cast<USpatialActorChannel>(Pair.Value))
+		if (Channel.IsValid())
 		{
 			Channel->SpatialViewTick();
 		}
 	}
+
+	INC_DWORD_STAT_BY(STAT_SpatialDirtyChannelsTicked, ChannelsToTick.Num());
+	SET_DWORD_STAT(STAT_SpatialActorChannels, NetDriver->GetSpatialOSNetConnection()->ActorChannelMap().Num());
+}
+
+void USpatialDispatcher::SweepChannels()
+{
+	// Changes to ownership made on this worker are caught when the actor replicates, and replicated changes when they are received.
+	// This catches the rest, such as a change to the owner of an actor's owner, without checking every channel every tick.
+	const float SweepInterval = GetDefault<USpatialGDKSettings>()->OwnershipSweepInterval;
+	const double Now = FPlatformTime::Seconds();
+	if (SweepInterval <= 0.0f || Now - LastSweepTime < SweepInterval)
+	{
+		return;
+	}
+	LastSweepTime = Now;
+
+	for (auto& ChannelPair : NetDriver->GetSpatialOSNetConnection()->ActorChannelMap())
+	{
+		USpatialActorChannel* Channel = Cast<USpatialActorChannel>(ChannelPair.Value);
+		if (Channel != nullptr && Channel->NeedsViewTick())
+		{
+			DirtyChannels.Add(Channel);
+			INC_DWORD_STAT(STAT_SpatialSweptChannels);
+		}
+	}
+}
+
+void USpatialDispatcher::MarkChannelDirty(USpatialActorChannel* Channel)
+{
+	DirtyChannels.Add(Channel);
 }
@@ -2,7 +2,11 @@
 
 #include "Interop/SpatialOutputDevice.h"
 
+#include "HAL/RunnableThread.h"
+
 #include "Interop/Connection/SpatialWorkerConnection.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
 
 FSpatialOutputDevice::FSpatialOutputDevice(USpatialWorkerConnection* InConnection, FString LoggerName)
 {
@@ -10,12 +14,39 @@ FSpatialOutputDevice::FSpatialOutputDevice(USpatialWorkerConnection* InConnectio
 	Name = LoggerName;
 	FilterLevel = ELogVerbosity::Warning;
 
+	const USpatialGDKSettings* SpatialGDKSettings = GetDefault<USpatialGDKSettings>();
+	const int32 NumSlots = (int32)FMath::RoundUpToPowerOfTwo(FMath::Clamp<uint32>(SpatialGDKSettings->MaxQueuedLogMessages, 16, 65536));
+	Slots.SetNumUninitialized(NumSlots);
+	for (int32 i = 0; i < NumSlots; i++)
+	{
+		Slots[i].Sequence = i;
+	}
+	SlotMask = NumSlots - 1;
+	EnqueuePosition = 0;
+	DequeuePosition = 0;
+	CoalescedMessages.Reserve(NumSlots);
+	CoalescedMessageIndices.Reserve(NumSlots);
+
+	MessagesPerSecond = SpatialGDKSettings->LogMessagesPerSecondPerCategory;
+	MessageBurst = FMath::Max<double>(1.0, SpatialGDKSettings->LogMessageBurstPerCategory);
+
+	KeepRunning.AtomicSet(true);
+	FlushThread = FRunnableThread::Create(this, TEXT("SpatialOutputDeviceWorker"), 0, TPri_BelowNormal);
+	check(FlushThread);
+
 	FOutputDeviceRedirector::Get()->AddOutputDevice(this);
 }
 
 FSpatialOutputDevice::~FSpatialOutputDevice()
 {
 	FOutputDeviceRedirector::Get()->RemoveOutputDevice(this);
+
+	// Kill calls Stop and waits for Run to return.
+	FlushThread->Kill(true);
+	delete FlushThread;
+	FlushThread = nullptr;
+
+	FlushQueuedMessages();
 }
 
 void FSpatialOutputDevice::Serialize(const TCHAR* InData, ELogVerbosity::Type Verbosity, const class FName& Category)
@@ -25,10 +56,195 @@ void FSpatialOutputDevice::Serialize(const TCHAR* InData, ELogVerbosity::Type Ve
 		return;
 	}
 
-	if (Connection->IsConnected())
+	if (!Connection->IsConnected())
+	{
+		return;
+	}
+
+	// The process is about to exit, so don't leave this to the flush thread.
+	if (Verbosity == ELogVerbosity::Fatal)
+	{
+		SendLogMessage(Verbosity, InData);
+		return;
+	}
+
+	if (!EnqueueMessage(InData, Verbosity, Category))
+	{
+		NumDroppedMessages.Increment();
+	}
+}
+
+bool FSpatialOutputDevice::EnqueueMessage(const TCHAR* InData, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	// Claim the next slot, unless the flush thread hasn't consumed it yet. Positions wrap, so compare them as differences.
+	int32 Position = FPlatformAtomics::AtomicRead(&EnqueuePosition);
+	FLogMessageSlot* Slot;
+	for (;;)
+	{
+		Slot = &Slots[Position & SlotMask];
+		const int32 Difference = (int32)((uint32)FPlatformAtomics::AtomicRead(&Slot->Sequence) - (uint32)Position);
+		if (Difference == 0)
+		{
+			const int32 Claimed = FPlatformAtomics::InterlockedCompareExchange(&EnqueuePosition, (int32)((uint32)Position + 1), Position);
+			if (Claimed == Position)
+			{
+				break;
+			}
+			Position = Claimed;
+		}
+		else if (Difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			Position = FPlatformAtomics::AtomicRead(&EnqueuePosition);
+		}
+	}
+
+	FCString::Strncpy(Slot->Message, InData, MaxMessageLength);
+	Slot->Category = Category;
+	Slot->Verbosity = Verbosity;
+
+	// Publish the message to the flush thread.
+	FPlatformAtomics::InterlockedExchange(&Slot->Sequence, (int32)((uint32)Position + 1));
+	return true;
+}
+
+uint32 FSpatialOutputDevice::Run()
+{
+	while (KeepRunning)
 	{
-		Connection->SendLogMessage(ConvertLogLevelToSpatial(Verbosity), TCHAR_TO_UTF8(*Name), TCHAR_TO_UTF8(InData));
+		FPlatformProcess::Sleep(SpatialConstants::LOG_FLUSH_INTERVAL_SECONDS);
+		FlushQueuedMessages();
 	}
+
+	return 0;
+}
+
+void FSpatialOutputDevice::Stop()
+{
+	KeepRunning.AtomicSet(false);
+}
+
+void FSpatialOutputDevice::FlushQueuedMessages()
+{
+	// Identical messages queued since the last flush are sent once, with a count. Slots stay claimed until
+	// the end of the flush so their text can be used in place.
+	CoalescedMessages.Reset();
+	CoalescedMessageIndices.Reset();
+
+	int32 Position = DequeuePosition;
+	for (;;)
+	{
+		const FLogMessageSlot& Slot = Slots[Position & SlotMask];
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != (int32)((uint32)Position + 1))
+		{
+			break;
+		}
+		Position = (int32)((uint32)Position + 1);
+
+		const uint32 Hash = FCrc::StrCrc32(Slot.Message, GetTypeHash(Slot.Category) ^ (uint32)Slot.Verbosity);
+		if (const int32* Index = CoalescedMessageIndices.Find(Hash))
+		{
+			FCoalescedLogMessage& Existing = CoalescedMessages[*Index];
+			if (Existing.Slot->Category == Slot.Category && Existing.Slot->Verbosity == Slot.Verbosity && FCString::Strcmp(Existing.Slot->Message, Slot.Message) == 0)
+			{
+				Existing.Count++;
+				continue;
+			}
+		}
+		else
+		{
+			CoalescedMessageIndices.Add(Hash, CoalescedMessages.Num());
+		}
+
+		CoalescedMessages.Add(FCoalescedLogMessage{ &Slot, 1 });
+	}
+
+	SendCoalescedMessages();
+
+	// Hand the slots back to the producers.
+	for (; DequeuePosition != Position; DequeuePosition = (int32)((uint32)DequeuePosition + 1))
+	{
+		FPlatformAtomics::InterlockedExchange(&Slots[DequeuePosition & SlotMask].Sequence, (int32)((uint32)DequeuePosition + Slots.Num()));
+	}
+}
+
+void FSpatialOutputDevice::SendCoalescedMessages()
+{
+	if (!Connection->IsConnected())
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	for (const FCoalescedLogMessage& Message : CoalescedMessages)
+	{
+		const FLogMessageSlot& Slot = *Message.Slot;
+		FCategoryRateLimit* RateLimit = CategoryRateLimits.Find(Slot.Category);
+		if (RateLimit == nullptr)
+		{
+			RateLimit = &CategoryRateLimits.Add(Slot.Category, FCategoryRateLimit{ MessageBurst, Now, 0 });
+		}
+
+		if (!ConsumeToken(*RateLimit, Now))
+		{
+			RateLimit->NumSuppressed += Message.Count;
+			continue;
+		}
+
+		if (Message.Count > 1)
+		{
+			SendLogMessage(Slot.Verbosity, *FString::Printf(TEXT("%s (repeated %d times)"), Slot.Message, Message.Count));
+		}
+		else
+		{
+			SendLogMessage(Slot.Verbosity, Slot.Message);
+		}
+	}
+
+	// Report what was suppressed once the category has room again.
+	for (auto& CategoryRateLimit : CategoryRateLimits)
+	{
+		FCategoryRateLimit& RateLimit = CategoryRateLimit.Value;
+		if (RateLimit.NumSuppressed > 0 && ConsumeToken(RateLimit, Now))
+		{
+			SendLogMessage(ELogVerbosity::Warning, *FString::Printf(TEXT("%d messages in %s were suppressed by rate limiting."), RateLimit.NumSuppressed, *CategoryRateLimit.Key.ToString()));
+			RateLimit.NumSuppressed = 0;
+		}
+	}
+
+	const int32 NumDropped = NumDroppedMessages.Set(0);
+	if (NumDropped > 0)
+	{
+		SendLogMessage(ELogVerbosity::Warning, *FString::Printf(TEXT("%d messages were dropped as the log queue was full."), NumDropped));
+	}
+}
+
+bool FSpatialOutputDevice::ConsumeToken(FCategoryRateLimit& RateLimit, double Now) const
+{
+	if (MessagesPerSecond <= 0.0)
+	{
+		return true;
+	}
+
+	RateLimit.Tokens = FMath::Min(MessageBurst, RateLimit.Tokens + (Now - RateLimit.LastRefillTime) * MessagesPerSecond);
+	RateLimit.LastRefillTime = Now;
+
+	if (RateLimit.Tokens < 1.0)
+	{
+		return false;
+	}
+
+	RateLimit.Tokens -= 1.0;
+	return true;
+}
+
+void FSpatialOutputDevice::SendLogMessage(ELogVerbosity::Type Verbosity, const TCHAR* Message)
+{
+	Connection->SendLogMessage(ConvertLogLevelToSpatial(Verbosity), TCHAR_TO_UTF8(*Name), TCHAR_TO_UTF8(Message));
 }
 
 void FSpatialOutputDevice::AddRedirectCategory(const FName& Category)
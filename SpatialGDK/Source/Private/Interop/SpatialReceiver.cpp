@@ -3,7 +3,6 @@
 #include "Interop/SpatialReceiver.h"
 
 #include "GameFramework/PlayerController.h"
-#include "TimerManager.h"
 
 #include "EngineClasses/SpatialActorChannel.h"
 #include "EngineClasses/SpatialNetConnection.h"
@@ -16,6 +15,7 @@
 #include "Schema/Rotation.h"
 #include "Schema/UnrealMetadata.h"
 #include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
 #include "Utils/ComponentReader.h"
 #include "Utils/EntityRegistry.h"
 #include "Utils/RepLayoutUtils.h"
@@ -27,11 +27,14 @@ using namespace improbable;
 template <typename T>
 T* GetComponentData(USpatialReceiver& Receiver, Worker_EntityId EntityId)
 {
-	for (PendingAddComponentWrapper& PendingAddComponent : Receiver.PendingAddComponents)
+	if (TArray<PendingAddComponentWrapper>* PendingAddComponents = Receiver.PendingAddComponents.Find(EntityId))
 	{
-		if (PendingAddComponent.EntityId == EntityId && PendingAddComponent.ComponentId == T::ComponentId)
+		for (PendingAddComponentWrapper& PendingAddComponent : *PendingAddComponents)
 		{
-			return static_cast<T*>(PendingAddComponent.Data.Get());
+			if (PendingAddComponent.ComponentId == T::ComponentId)
+			{
+				return static_cast<T*>(PendingAddComponent.Data.Get());
+			}
 		}
 	}
 
@@ -48,6 +51,9 @@ void USpatialReceiver::Init(USpatialNetDriver* InNetDriver, FTimerManager* InTim
 	TypebindingManager = InNetDriver->TypebindingManager;
 	GlobalStateManager = InNetDriver->GlobalStateManager;
 	TimerManager = InTimerManager;
+
+	bInCriticalSection = false;
+	NextPendingAddEntityIndex = 0;
 }
 
 void USpatialReceiver::OnCriticalSection(bool InCriticalSection)
@@ -69,16 +75,25 @@ void USpatialReceiver::EnterCriticalSection()
 	bInCriticalSection = true;
 }
 
-void USpatialReceiver::LeaveCriticalSection()
+bool USpatialReceiver::LeaveCriticalSection(double Deadline)
 {
-	UE_LOG(LogSpatialReceiver, Verbose, TEXT("Leaving critical section."));
 	check(bInCriticalSection);
 
-	for (Worker_EntityId& PendingAddEntity : PendingAddEntities)
+	// Always receive at least one entity before checking the deadline.
+	while (NextPendingAddEntityIndex < PendingAddEntities.Num())
 	{
-		ReceiveActor(PendingAddEntity);
+		ReceiveActor(PendingAddEntities[NextPendingAddEntityIndex++]);
+
+		if (NextPendingAddEntityIndex < PendingAddEntities.Num() && FPlatformTime::Seconds() > Deadline)
+		{
+			UE_LOG(LogSpatialReceiver, Verbose, TEXT("Out of time leaving critical section, %d of %d entities received."),
+				NextPendingAddEntityIndex, PendingAddEntities.Num());
+			return false;
+		}
 	}
 
+	UE_LOG(LogSpatialReceiver, Verbose, TEXT("Leaving critical section."));
+
 	for (Worker_AuthorityChangeOp& PendingAuthorityChange : PendingAuthorityChanges)
 	{
 		HandleActorAuthority(PendingAuthorityChange);
@@ -92,9 +107,12 @@ void USpatialReceiver::LeaveCriticalSection()
 	// Mark that we've left the critical section.
 	bInCriticalSection = false;
 	PendingAddEntities.Empty();
+	NextPendingAddEntityIndex = 0;
 	PendingAddComponents.Empty();
 	PendingAuthorityChanges.Empty();
 	PendingRemoveEntities.Empty();
+
+	return true;
 }
 
 void USpatialReceiver::OnAddEntity(Worker_AddEntityOp& Op)
@@ -105,7 +123,7 @@ void USpatialReceiver::OnAddEntity(Worker_AddEntityOp& Op)
 	PendingAddEntities.Emplace(Op.entity_id);
 }
 
-void USpatialReceiver::OnAddComponent(Worker_AddComponentOp& Op)
+void USpatialReceiver::OnAddComponent(Worker_AddComponentOp& Op, const TSharedPtr<improbable::GeneratedComponentFields>& DecodedFields)
 {
 	UE_LOG(LogSpatialReceiver, Verbose, TEXT("AddComponent component ID: %u entity ID: %lld"),
 		Op.data.component_id, Op.entity_id);
@@ -138,7 +156,7 @@ void USpatialReceiver::OnAddComponent(Worker_AddComponentOp& Op)
 		break;
 	}
 
-	PendingAddComponents.Emplace(Op.entity_id, Op.data.component_id, Data);
+	PendingAddComponents.FindOrAdd(Op.entity_id).Emplace(Op.entity_id, Op.data.component_id, Data, DecodedFields);
 }
 
 void USpatialReceiver::OnRemoveEntity(Worker_RemoveEntityOp& Op)
@@ -162,6 +180,12 @@ void USpatialReceiver::OnAuthorityChange(Worker_AuthorityChangeOp& Op)
 // TODO UNR-640 - This function needs a pass once we introduce soft handover (AUTHORITY_LOSS_IMMINENT)
 void USpatialReceiver::HandleActorAuthority(Worker_AuthorityChangeOp& Op)
 {
+	// Authority determines whether the channel is responsible for updating the entity's ACL or component interest.
+	if (USpatialActorChannel* ActorChannel = NetDriver->GetActorChannelByEntityId(Op.entity_id))
+	{
+		ActorChannel->MarkViewDirty();
+	}
+
 	if (NetDriver->IsServer())
 	{
 		if (Op.component_id == SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID
@@ -193,11 +217,25 @@ void USpatialReceiver::HandleActorAuthority(Worker_AuthorityChangeOp& Op)
 					{
 						Actor->RemoteRole = ROLE_SimulatedProxy;
 					}
+
+					if (NetDriver->ActorGrid.IsValid())
+					{
+						if (USpatialActorChannel* ActorChannel = NetDriver->GetActorChannelByEntityId(Op.entity_id))
+						{
+							NetDriver->ActorGrid->AddOrUpdateActor(Actor, ActorChannel->GetActorSpatialPosition(Actor));
+						}
+					}
 				}
 				else if (Op.authority == WORKER_AUTHORITY_NOT_AUTHORITATIVE)
 				{
 					Actor->Role = ROLE_SimulatedProxy;
 					Actor->RemoteRole = ROLE_Authority;
+
+					// Only the actors this server replicates are prioritized.
+					if (NetDriver->ActorGrid.IsValid())
+					{
+						NetDriver->ActorGrid->RemoveActor(Actor);
+					}
 				}
 			}
 		}
@@ -337,11 +375,14 @@ void USpatialReceiver::ReceiveActor(Worker_EntityId EntityId)
 		// Apply initial replicated properties.
 		// This was moved to after FinishingSpawning because components existing only in blueprints aren't added until spawning is complete
 		// Potentially we could split out the initial actor state and the initial component state
-		for (PendingAddComponentWrapper& PendingAddComponent : PendingAddComponents)
+		if (TArray<PendingAddComponentWrapper>* EntityPendingAddComponents = PendingAddComponents.Find(EntityId))
 		{
-			if (PendingAddComponent.EntityId == EntityId && PendingAddComponent.Data.IsValid() && PendingAddComponent.Data->bIsDynamic)
+			for (PendingAddComponentWrapper& PendingAddComponent : *EntityPendingAddComponents)
 			{
-				ApplyComponentData(EntityId, *static_cast<improbable::DynamicComponent*>(PendingAddComponent.Data.Get())->Data, Channel);
+				if (PendingAddComponent.Data.IsValid() && PendingAddComponent.Data->bIsDynamic)
+				{
+					ApplyComponentData(EntityId, *static_cast<improbable::DynamicComponent*>(PendingAddComponent.Data.Get())->Data, Channel, PendingAddComponent.DecodedFields.Get());
+				}
 			}
 		}
 
@@ -461,7 +502,7 @@ void USpatialReceiver::CleanupDeletedEntity(Worker_EntityId EntityId)
 UClass* USpatialReceiver::GetNativeEntityClass(improbable::Metadata* Metadata)
 {
 	UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Metadata->EntityType);
-	return Class->IsChildOf<AActor>() ? Class : nullptr;
+	return Class != nullptr && Class->IsChildOf<AActor>() ? Class : nullptr;
 }
 
 // This function is only called for client and server workers who did not spawn the Actor
@@ -489,7 +530,7 @@ AActor* USpatialReceiver::CreateActor(improbable::Position* Position, improbable
 	return NewActor;
 }
 
-void USpatialReceiver::ApplyComponentData(Worker_EntityId EntityId, Worker_ComponentData& Data, USpatialActorChannel* Channel)
+void USpatialReceiver::ApplyComponentData(Worker_EntityId EntityId, Worker_ComponentData& Data, USpatialActorChannel* Channel, const improbable::GeneratedComponentFields* DecodedFields)
 {
 	UClass* Class = TypebindingManager->FindClassByComponentId(Data.component_id);
 	checkf(Class, TEXT("Component %d isn't hand-written and not present in ComponentToClassMap."), Data.component_id);
@@ -508,23 +549,25 @@ void USpatialReceiver::ApplyComponentData(Worker_EntityId EntityId, Worker_Compo
 
 	if (Data.component_id == Info->SingleClientComponent || Data.component_id == Info->MultiClientComponent)
 	{
-		FObjectReferencesMap& ObjectReferencesMap = UnresolvedRefsMap.FindOrAdd(ChannelObjectPair);
+		FObjectReferencesMap NewObjectReferencesMap;
+		FObjectReferencesMap* PendingObjectReferencesMap = FindPendingObjectReferences(ChannelObjectPair);
 		TSet<FUnrealObjectRef> UnresolvedRefs;
 
-		ComponentReader Reader(NetDriver, ObjectReferencesMap, UnresolvedRefs);
-		Reader.ApplyComponentData(Data, TargetObject, Channel, /* bIsHandover */ false);
+		ComponentReader Reader(NetDriver, PendingObjectReferencesMap ? *PendingObjectReferencesMap : NewObjectReferencesMap, UnresolvedRefs);
+		Reader.ApplyComponentData(Data, TargetObject, Channel, /* bIsHandover */ false, DecodedFields);
 
-		QueueIncomingRepUpdates(ChannelObjectPair, ObjectReferencesMap, UnresolvedRefs);
+		QueueIncomingRepUpdates(ChannelObjectPair, NewObjectReferencesMap, UnresolvedRefs);
 	}
 	else if (Data.component_id == Info->HandoverComponent)
 	{
-		FObjectReferencesMap& ObjectReferencesMap = UnresolvedRefsMap.FindOrAdd(ChannelObjectPair);
+		FObjectReferencesMap NewObjectReferencesMap;
+		FObjectReferencesMap* PendingObjectReferencesMap = FindPendingObjectReferences(ChannelObjectPair);
 		TSet<FUnrealObjectRef> UnresolvedRefs;
 
-		ComponentReader Reader(NetDriver, ObjectReferencesMap, UnresolvedRefs);
-		Reader.ApplyComponentData(Data, TargetObject, Channel, /* bIsHandover */ true);
+		ComponentReader Reader(NetDriver, PendingObjectReferencesMap ? *PendingObjectReferencesMap : NewObjectReferencesMap, UnresolvedRefs);
+		Reader.ApplyComponentData(Data, TargetObject, Channel, /* bIsHandover */ true, DecodedFields);
 
-		QueueIncomingRepUpdates(ChannelObjectPair, ObjectReferencesMap, UnresolvedRefs);
+		QueueIncomingRepUpdates(ChannelObjectPair, NewObjectReferencesMap, UnresolvedRefs);
 	}
 	else
 	{
@@ -532,7 +575,7 @@ void USpatialReceiver::ApplyComponentData(Worker_EntityId EntityId, Worker_Compo
 	}
 }
 
-void USpatialReceiver::OnComponentUpdate(Worker_ComponentUpdateOp& Op)
+void USpatialReceiver::OnComponentUpdate(Worker_ComponentUpdateOp& Op, const improbable::GeneratedComponentFields* DecodedFields)
 {
 	if (StaticComponentView->GetAuthority(Op.entity_id, Op.update.component_id) == WORKER_AUTHORITY_AUTHORITATIVE)
 	{
@@ -543,6 +586,11 @@ void USpatialReceiver::OnComponentUpdate(Worker_ComponentUpdateOp& Op)
 	switch (Op.update.component_id)
 	{
 	case SpatialConstants::ENTITY_ACL_COMPONENT_ID:
+		if (USpatialActorChannel* ActorChannel = NetDriver->GetActorChannelByEntityId(Op.entity_id))
+		{
+			ActorChannel->MarkViewDirty();
+		}
+		return;
 	case SpatialConstants::METADATA_COMPONENT_ID:
 	case SpatialConstants::POSITION_COMPONENT_ID:
 	case SpatialConstants::PERSISTENCE_COMPONENT_ID:
@@ -576,8 +624,11 @@ void USpatialReceiver::OnComponentUpdate(Worker_ComponentUpdateOp& Op)
 	{
 		if (UObject* TargetObject = GetTargetObjectFromChannelAndClass(ActorChannel, Class))
 		{
-			ApplyComponentUpdate(Op.update, TargetObject, ActorChannel, /* bIsHandover */ false);
+			ApplyComponentUpdate(Op.update, TargetObject, ActorChannel, /* bIsHandover */ false, DecodedFields);
 		}
+
+		// Replicated properties such as the Owner can change whether the Actor is net owned.
+		ActorChannel->MarkViewDirty();
 	}
 	else if (Op.update.component_id == Info->HandoverComponent)
 	{
@@ -588,7 +639,7 @@ void USpatialReceiver::OnComponentUpdate(Worker_ComponentUpdateOp& Op)
 		}
 		if (UObject* TargetObject = GetTargetObjectFromChannelAndClass(ActorChannel, Class))
 		{
-			ApplyComponentUpdate(Op.update, TargetObject, ActorChannel, /* bIsHandover */ true);
+			ApplyComponentUpdate(Op.update, TargetObject, ActorChannel, /* bIsHandover */ true, DecodedFields);
 		}
 	}
 	else if (Op.update.component_id == Info->RPCComponents[RPC_NetMulticast])
@@ -692,10 +743,6 @@ void USpatialReceiver::ReceiveCommandResponse(Worker_CommandResponseOp& Op)
 	{
 		if (ReliableRPC->Attempts < SpatialConstants::MAX_NUMBER_COMMAND_ATTEMPTS)
 		{
-			float WaitTime = SpatialConstants::GetCommandRetryWaitTimeSeconds(ReliableRPC->Attempts);
-			UE_LOG(LogSpatialReceiver, Log, TEXT("%s: retrying in %f seconds. Error code: %d Message: %s"),
-				*ReliableRPC->Function->GetName(), WaitTime, (int)Op.status_code, UTF8_TO_TCHAR(Op.message));
-
 			if (!ReliableRPC->TargetObject.IsValid())
 			{
 				UE_LOG(LogSpatialReceiver, Warning, TEXT("%s: target object was destroyed before we could deliver the RPC."),
@@ -703,12 +750,28 @@ void USpatialReceiver::ReceiveCommandResponse(Worker_CommandResponseOp& Op)
 				return;
 			}
 
-			// Queue retry
-			FTimerHandle RetryTimer;
-			TimerManager->SetTimer(RetryTimer, [this, ReliableRPC]()
+			float WaitTime = SpatialConstants::GetCommandRetryWaitTimeSeconds(ReliableRPC->Attempts);
+			const double RetryTime = FPlatformTime::Seconds() + WaitTime;
+			if (ReliableRPC->Deadline > 0.0 && RetryTime > ReliableRPC->Deadline)
+			{
+				UE_LOG(LogSpatialReceiver, Error, TEXT("%s: giving up, as a retry would be after its deadline (%d attempts). Error code: %d Message: %s"),
+					*ReliableRPC->Function->GetName(), ReliableRPC->Attempts, (int)Op.status_code, UTF8_TO_TCHAR(Op.message));
+				return;
+			}
+
+			const uint32 MaxReliableRPCRetries = GetDefault<USpatialGDKSettings>()->MaxReliableRPCRetries;
+			if (MaxReliableRPCRetries > 0 && ReliableRPCRetries.Num() >= (int32)MaxReliableRPCRetries)
 			{
-				Sender->SendRPC(ReliableRPC);
-			}, WaitTime, false);
+				UE_LOG(LogSpatialReceiver, Error, TEXT("%s: giving up, as %u reliable RPC retries are already queued. Error code: %d Message: %s"),
+					*ReliableRPC->Function->GetName(), MaxReliableRPCRetries, (int)Op.status_code, UTF8_TO_TCHAR(Op.message));
+				return;
+			}
+
+			UE_LOG(LogSpatialReceiver, Log, TEXT("%s: retrying in %f seconds. Error code: %d Message: %s"),
+				*ReliableRPC->Function->GetName(), WaitTime, (int)Op.status_code, UTF8_TO_TCHAR(Op.message));
+
+			// Queue retry
+			ReliableRPCRetries.HeapPush(FReliableRPCRetry(RetryTime, ReliableRPC));
 		}
 		else
 		{
@@ -718,16 +781,28 @@ void USpatialReceiver::ReceiveCommandResponse(Worker_CommandResponseOp& Op)
 	}
 }
 
-void USpatialReceiver::ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, USpatialActorChannel* Channel, bool bIsHandover)
+void USpatialReceiver::ProcessReliableRPCRetries()
+{
+	const double Now = FPlatformTime::Seconds();
+	while (ReliableRPCRetries.Num() > 0 && ReliableRPCRetries.HeapTop().RetryTime <= Now)
+	{
+		TSharedRef<FPendingRPCParams> ReliableRPC = ReliableRPCRetries.HeapTop().Params;
+		ReliableRPCRetries.HeapPopDiscard(false);
+		Sender->SendRPC(ReliableRPC);
+	}
+}
+
+void USpatialReceiver::ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, USpatialActorChannel* Channel, bool bIsHandover, const improbable::GeneratedComponentFields* DecodedFields)
 {
 	FChannelObjectPair ChannelObjectPair(Channel, TargetObject);
 
-	FObjectReferencesMap& ObjectReferencesMap = UnresolvedRefsMap.FindOrAdd(ChannelObjectPair);
+	FObjectReferencesMap NewObjectReferencesMap;
+	FObjectReferencesMap* PendingObjectReferencesMap = FindPendingObjectReferences(ChannelObjectPair);
 	TSet<FUnrealObjectRef> UnresolvedRefs;
-	ComponentReader Reader(NetDriver, ObjectReferencesMap, UnresolvedRefs);
-	Reader.ApplyComponentUpdate(ComponentUpdate, TargetObject, Channel, bIsHandover);
+	ComponentReader Reader(NetDriver, PendingObjectReferencesMap ? *PendingObjectReferencesMap : NewObjectReferencesMap, UnresolvedRefs);
+	Reader.ApplyComponentUpdate(ComponentUpdate, TargetObject, Channel, bIsHandover, DecodedFields);
 
-	QueueIncomingRepUpdates(ChannelObjectPair, ObjectReferencesMap, UnresolvedRefs);
+	QueueIncomingRepUpdates(ChannelObjectPair, NewObjectReferencesMap, UnresolvedRefs);
 }
 
 void USpatialReceiver::ReceiveMulticastUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, const TArray<UFunction*>& RPCArray)
@@ -741,23 +816,22 @@ void USpatialReceiver::ReceiveMulticastUpdate(const Worker_ComponentUpdate& Comp
 		{
 			Schema_Object* EventData = Schema_IndexObject(EventsObject, EventIndex, i);
 
-			TArray<uint8> PayloadData = GetPayloadFromSchema(EventData, 1);
-			// A bit hacky, we should probably include the number of bits with the data instead.
-			int64 CountBits = PayloadData.Num() * 8;
+			int64 CountBits = 0;
+			const uint8* PayloadData = GetPayloadFromSchema(EventData, 1, CountBits);
 
 			ApplyRPC(TargetObject, Function, PayloadData, CountBits);
 		}
 	}
 }
 
-void USpatialReceiver::ApplyRPC(UObject* TargetObject, UFunction* Function, TArray<uint8>& PayloadData, int64 CountBits)
+void USpatialReceiver::ApplyRPC(UObject* TargetObject, UFunction* Function, const uint8* PayloadData, int64 CountBits)
 {
 	uint8* Parms = (uint8*)FMemory_Alloca(Function->ParmsSize);
 	FMemory::Memzero(Parms, Function->ParmsSize);
 
 	TSet<FUnrealObjectRef> UnresolvedRefs;
 
-	FSpatialNetBitReader PayloadReader(PackageMap, PayloadData.GetData(), CountBits, UnresolvedRefs);
+	FSpatialNetBitReader PayloadReader(PackageMap, PayloadData, CountBits, UnresolvedRefs);
 
 	TSharedPtr<FRepLayout> RepLayout = NetDriver->GetFunctionRepLayout(Function);
 	RepLayout_ReceivePropertiesForRPC(*RepLayout, PayloadReader, Parms);
@@ -792,23 +866,17 @@ UObject* USpatialReceiver::GetTargetObjectFromChannelAndClass(USpatialActorChann
 	{
 		FClassInfo* ActorInfo = TypebindingManager->FindClassInfoByClass(Channel->Actor->GetClass());
 		check(ActorInfo);
-		if (!ActorInfo->SubobjectClasses.Contains(Class))
+		const int32* SubobjectIndex = ActorInfo->SubobjectIndices.Find(Class);
+		if (SubobjectIndex == nullptr)
 		{
 			UE_LOG(LogSpatialReceiver, Warning, TEXT("No target object for Class %s on Actor %s probably caused by dynamic component"),
 				*Class->GetName(), *Channel->Actor->GetName());
 			return nullptr;
 		}
 
-		TArray<UObject*> DefaultSubobjects;
-		Channel->Actor->GetDefaultSubobjects(DefaultSubobjects);
-		UObject** FoundSubobject = DefaultSubobjects.FindByPredicate([Class](const UObject* Obj)
-		{
-			return Obj->GetClass() == Class;
-		});
-
-		if (FoundSubobject != nullptr)
+		if (UObject* FoundSubobject = Channel->GetResolvedSubobject(*SubobjectIndex))
 		{
-			TargetObject = *FoundSubobject;
+			TargetObject = FoundSubobject;
 		}
 		else
 		{
@@ -829,6 +897,11 @@ void USpatialReceiver::OnReserveEntityIdResponse(Worker_ReserveEntityIdResponseO
 	}
 }
 
+void USpatialReceiver::OnReserveEntityIdsResponse(Worker_ReserveEntityIdsResponseOp& Op)
+{
+	Sender->OnReserveEntityIdsResponse(Op);
+}
+
 void USpatialReceiver::OnCreateEntityIdResponse(Worker_CreateEntityResponseOp& Op)
 {
 	if (USpatialActorChannel* Channel = PopPendingActorRequest(Op.request_id))
@@ -880,28 +953,136 @@ void USpatialReceiver::ResolvePendingOperations(UObject* Object, const FUnrealOb
 	}
 }
 
-void USpatialReceiver::QueueIncomingRepUpdates(FChannelObjectPair ChannelObjectPair, const FObjectReferencesMap& ObjectReferencesMap, const TSet<FUnrealObjectRef>& UnresolvedRefs)
+FObjectReferencesMap* USpatialReceiver::FindPendingObjectReferences(const FChannelObjectPair& ChannelObjectPair)
 {
+	const FUnresolvedRefHandle* Handle = PendingRepUpdateHandles.Find(ChannelObjectPair);
+	if (Handle == nullptr)
+	{
+		return nullptr;
+	}
+
+	FPendingIncomingRepUpdate* PendingRepUpdate = PendingRepUpdates.Find(*Handle);
+	return PendingRepUpdate ? &PendingRepUpdate->ObjectReferencesMap : nullptr;
+}
+
+void USpatialReceiver::QueueIncomingRepUpdates(const FChannelObjectPair& ChannelObjectPair, FObjectReferencesMap& NewObjectReferencesMap, const TSet<FUnrealObjectRef>& UnresolvedRefs)
+{
+	FUnresolvedRefHandle Handle = PendingRepUpdateHandles.FindRef(ChannelObjectPair);
+	if (FPendingIncomingRepUpdate* PendingRepUpdate = PendingRepUpdates.Find(Handle))
+	{
+		// The update was read into the existing entry, which may now have nothing left to resolve.
+		if (PendingRepUpdate->ObjectReferencesMap.Num() == 0)
+		{
+			RemovePendingRepUpdate(Handle);
+			return;
+		}
+	}
+	else
+	{
+		if (NewObjectReferencesMap.Num() == 0)
+		{
+			PendingRepUpdateHandles.Remove(ChannelObjectPair);
+			return;
+		}
+
+		USpatialActorChannel* Channel = ChannelObjectPair.Key.Get();
+		Handle = PendingRepUpdates.Add(Channel ? Channel->Actor : nullptr, FPendingIncomingRepUpdate(ChannelObjectPair, MoveTemp(NewObjectReferencesMap)), FPlatformTime::Seconds());
+		PendingRepUpdateHandles.Add(ChannelObjectPair, Handle);
+	}
+
 	for (const FUnrealObjectRef& UnresolvedRef : UnresolvedRefs)
 	{
 		UE_LOG(LogSpatialReceiver, Log, TEXT("Added pending incoming property for object ref: %s, target object: %s"), *UnresolvedRef.ToString(), *ChannelObjectPair.Value->GetName());
-		IncomingRefsMap.FindOrAdd(UnresolvedRef).Add(ChannelObjectPair);
+		PendingRepUpdates.AddKey(Handle, UnresolvedRef);
+	}
+}
+
+void USpatialReceiver::RemovePendingRepUpdate(FUnresolvedRefHandle Handle)
+{
+	if (FPendingIncomingRepUpdate* PendingRepUpdate = PendingRepUpdates.Find(Handle))
+	{
+		PendingRepUpdateHandles.Remove(PendingRepUpdate->ChannelObjectPair);
+		PendingRepUpdates.Remove(Handle);
 	}
+}
 
-	if (ObjectReferencesMap.Num() == 0)
+void USpatialReceiver::RemovePendingRepUpdateHandle(FUnresolvedRefHandle Handle, const FPendingIncomingRepUpdate& PendingRepUpdate)
+{
+	// Only forget the handle if it is still the one waiting for this object, rather than one that has replaced it.
+	const FUnresolvedRefHandle* CurrentHandle = PendingRepUpdateHandles.Find(PendingRepUpdate.ChannelObjectPair);
+	if (CurrentHandle != nullptr && *CurrentHandle == Handle)
 	{
-		UnresolvedRefsMap.Remove(ChannelObjectPair);
+		PendingRepUpdateHandles.Remove(PendingRepUpdate.ChannelObjectPair);
 	}
 }
 
-void USpatialReceiver::QueueIncomingRPC(const TSet<FUnrealObjectRef>& UnresolvedRefs, UObject* TargetObject, UFunction* Function, const TArray<uint8>& PayloadData, int64 CountBits)
+void USpatialReceiver::QueueIncomingRPC(const TSet<FUnrealObjectRef>& UnresolvedRefs, UObject* TargetObject, UFunction* Function, const uint8* PayloadData, int64 CountBits)
 {
-	TSharedPtr<FPendingIncomingRPC> IncomingRPC = MakeShared<FPendingIncomingRPC>(UnresolvedRefs, TargetObject, Function, PayloadData, CountBits);
+	AActor* OwningActor = TargetObject->IsA<AActor>() ? Cast<AActor>(TargetObject) : TargetObject->GetTypedOuter<AActor>();
+
+	// The payload is usually owned by the op being processed, so FPendingIncomingRPC takes a copy of it.
+	FUnresolvedRefHandle Handle = PendingIncomingRPCs.Add(OwningActor, FPendingIncomingRPC(TargetObject, Function, PayloadData, CountBits), FPlatformTime::Seconds());
 
 	for (const FUnrealObjectRef& UnresolvedRef : UnresolvedRefs)
 	{
-		FIncomingRPCArray& IncomingRPCArray = IncomingRPCMap.FindOrAdd(UnresolvedRef);
-		IncomingRPCArray.Add(IncomingRPC);
+		PendingIncomingRPCs.AddKey(Handle, UnresolvedRef);
+	}
+}
+
+void USpatialReceiver::DropPendingOperations(AActor* Actor)
+{
+	const int32 NumRepUpdatesDropped = PendingRepUpdates.RemoveOwner(Actor, [this](FUnresolvedRefHandle Handle, FPendingIncomingRepUpdate& PendingRepUpdate)
+	{
+		RemovePendingRepUpdateHandle(Handle, PendingRepUpdate);
+	});
+
+	int32 NumReliableRPCsDropped = 0;
+	const int32 NumRPCsDropped = PendingIncomingRPCs.RemoveOwner(Actor, [&NumReliableRPCsDropped](FUnresolvedRefHandle Handle, FPendingIncomingRPC& PendingRPC)
+	{
+		if (PendingRPC.Function->FunctionFlags & FUNC_NetReliable)
+		{
+			NumReliableRPCsDropped++;
+		}
+	});
+
+	if (NumReliableRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialReceiver, Warning, TEXT("Actor %s destroyed with unresolved incoming references: dropped %d property updates and %d RPCs, %d of them reliable."),
+			*Actor->GetName(), NumRepUpdatesDropped, NumRPCsDropped, NumReliableRPCsDropped);
+	}
+	else if (NumRepUpdatesDropped > 0 || NumRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialReceiver, Verbose, TEXT("Actor %s destroyed with unresolved incoming references: dropped %d property updates and %d RPCs."),
+			*Actor->GetName(), NumRepUpdatesDropped, NumRPCsDropped);
+	}
+}
+
+void USpatialReceiver::RemoveExpiredPendingOperations()
+{
+	const USpatialGDKSettings* SpatialGDKSettings = GetDefault<USpatialGDKSettings>();
+	const double Now = FPlatformTime::Seconds();
+	const double Timeout = SpatialGDKSettings->UnresolvedReferenceTimeout;
+	const int32 MaxEntries = (int32)SpatialGDKSettings->MaxUnresolvedOperations;
+
+	const int32 NumRepUpdatesDropped = PendingRepUpdates.RemoveExpired(Now, Timeout, MaxEntries, [this](FUnresolvedRefHandle Handle, FPendingIncomingRepUpdate& PendingRepUpdate)
+	{
+		RemovePendingRepUpdateHandle(Handle, PendingRepUpdate);
+	});
+
+	const int32 NumRPCsDropped = PendingIncomingRPCs.RemoveExpired(Now, Timeout, MaxEntries, [](FUnresolvedRefHandle Handle, FPendingIncomingRPC& PendingRPC)
+	{
+		// The sender relies on reliable RPCs arriving, so losing one is an error rather than part of the summary below.
+		if (PendingRPC.Function->FunctionFlags & FUNC_NetReliable)
+		{
+			UE_LOG(LogSpatialReceiver, Error, TEXT("Dropped reliable RPC %s on %s, because its object references could not be resolved in time."),
+				*PendingRPC.Function->GetName(), *GetNameSafe(PendingRPC.TargetObject.Get()));
+		}
+	});
+
+	if (NumRepUpdatesDropped > 0 || NumRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialReceiver, Warning, TEXT("Dropped %d incoming property updates and %d RPCs whose object references could not be resolved in time."),
+			NumRepUpdatesDropped, NumRPCsDropped);
 	}
 }
 
@@ -920,25 +1101,27 @@ void USpatialReceiver::ResolveIncomingOperations(UObject* Object, const FUnrealO
 	// TODO: queue up resolved objects since they were resolved during process ops
 	// and then resolve all of them at the end of process ops - UNR:582
 
-	TSet<FChannelObjectPair>* TargetObjectSet = IncomingRefsMap.Find(ObjectRef);
-	if (!TargetObjectSet)
+	TArray<FUnresolvedRefHandle> Handles;
+	PendingRepUpdates.ResolveKey(ObjectRef, Handles);
+	if (Handles.Num() == 0)
 	{
 		return;
 	}
 
 	UE_LOG(LogSpatialReceiver, Log, TEXT("Resolving incoming operations depending on object ref %s, resolved object: %s"), *ObjectRef.ToString(), *Object->GetName());
 
-	for (FChannelObjectPair& ChannelObjectPair : *TargetObjectSet)
+	for (FUnresolvedRefHandle Handle : Handles)
 	{
-		FObjectReferencesMap* UnresolvedRefs = UnresolvedRefsMap.Find(ChannelObjectPair);
-		if (!UnresolvedRefs)
+		FPendingIncomingRepUpdate* PendingRepUpdate = PendingRepUpdates.Find(Handle);
+		if (!PendingRepUpdate)
 		{
 			continue;
 		}
 
+		const FChannelObjectPair ChannelObjectPair = PendingRepUpdate->ChannelObjectPair;
 		if (!ChannelObjectPair.Key.IsValid() || !ChannelObjectPair.Value.IsValid())
 		{
-			UnresolvedRefsMap.Remove(ChannelObjectPair);
+			RemovePendingRepUpdate(Handle);
 			continue;
 		}
 
@@ -952,49 +1135,53 @@ void USpatialReceiver::ResolveIncomingOperations(UObject* Object, const FUnrealO
 		FRepLayout& RepLayout = DependentChannel->GetObjectRepLayout(ReplicatingObject);
 		FRepStateStaticBuffer& ShadowData = DependentChannel->GetObjectStaticBuffer(ReplicatingObject);
 
-		ResolveObjectReferences(RepLayout, ReplicatingObject, *UnresolvedRefs, ShadowData.GetData(), (uint8*)ReplicatingObject, ShadowData.Num(), RepNotifies, bSomeObjectsWereMapped, bStillHasUnresolved);
+		ResolveObjectReferences(RepLayout, ReplicatingObject, PendingRepUpdate->ObjectReferencesMap, ShadowData.GetData(), (uint8*)ReplicatingObject, ShadowData.Num(), RepNotifies, bSomeObjectsWereMapped, bStillHasUnresolved);
 
-		if (bSomeObjectsWereMapped)
+		// Done before the rep notifies are called, in case they cause more updates to be queued for this object.
+		if (!bStillHasUnresolved)
 		{
-			UE_LOG(LogSpatialReceiver, Log, TEXT("Resolved for target object %s"), *ReplicatingObject->GetName());
-			DependentChannel->PostReceiveSpatialUpdate(ReplicatingObject, RepNotifies);
+			RemovePendingRepUpdate(Handle);
 		}
 
-		if (!bStillHasUnresolved)
+		if (bSomeObjectsWereMapped)
 		{
-			UnresolvedRefsMap.Remove(ChannelObjectPair);
+			UE_LOG(LogSpatialReceiver, Log, TEXT("Resolved for target object %s"), *ReplicatingObject->GetName());
+			DependentChannel->PostReceiveSpatialUpdate(ReplicatingObject, RepNotifies);
 		}
 	}
-
-	IncomingRefsMap.Remove(ObjectRef);
 }
 
 void USpatialReceiver::ResolveIncomingRPCs(UObject* Object, const FUnrealObjectRef& ObjectRef)
 {
-	FIncomingRPCArray* IncomingRPCArray = IncomingRPCMap.Find(ObjectRef);
-	if (!IncomingRPCArray)
+	TArray<FUnresolvedRefHandle> Handles;
+	PendingIncomingRPCs.ResolveKey(ObjectRef, Handles);
+	if (Handles.Num() == 0)
 	{
 		return;
 	}
 
 	UE_LOG(LogSpatialReceiver, Log, TEXT("Resolving incoming RPCs depending on object ref %s, resolved object: %s"), *ObjectRef.ToString(), *Object->GetName());
 
-	for (const TSharedPtr<FPendingIncomingRPC>& IncomingRPC : *IncomingRPCArray)
+	for (FUnresolvedRefHandle Handle : Handles)
 	{
-		if (!IncomingRPC->TargetObject.IsValid())
+		FPendingIncomingRPC* PendingRPC = PendingIncomingRPCs.Find(Handle);
+		if (!PendingRPC || PendingIncomingRPCs.NumKeys(Handle) > 0)
 		{
-			// The target object has been destroyed before this RPC was resolved
 			continue;
 		}
 
-		IncomingRPC->UnresolvedRefs.Remove(ObjectRef);
-		if (IncomingRPC->UnresolvedRefs.Num() == 0)
+		// Applying the RPC can queue more, so take it out of the table first.
+		FPendingIncomingRPC IncomingRPC = MoveTemp(*PendingRPC);
+		PendingIncomingRPCs.Remove(Handle);
+
+		if (!IncomingRPC.TargetObject.IsValid())
 		{
-			ApplyRPC(IncomingRPC->TargetObject.Get(), IncomingRPC->Function, IncomingRPC->PayloadData, IncomingRPC->CountBits);
+			// The target object has been destroyed before this RPC was resolved
+			continue;
 		}
-	}
 
-	IncomingRPCMap.Remove(ObjectRef);
+		ApplyRPC(IncomingRPC.TargetObject.Get(), IncomingRPC.Function, IncomingRPC.PayloadData.GetData(), IncomingRPC.CountBits);
+	}
 }
 
 void USpatialReceiver::ResolveObjectReferences(FRepLayout& RepLayout, UObject* ReplicatedObject, FObjectReferencesMap& ObjectReferencesMap, uint8* RESTRICT StoredData, uint8* RESTRICT Data, int32 MaxAbsOffset, TArray<UProperty*>& RepNotifies, bool& bOutSomeObjectsWereMapped, bool& bOutStillHasUnresolved)
@@ -1116,9 +1303,8 @@ void USpatialReceiver::ReceiveRPCCommandRequest(const Worker_CommandRequest& Com
 {
 	Schema_Object* RequestObject = Schema_GetCommandRequestObject(CommandRequest.schema_type);
 
-	TArray<uint8> PayloadData = GetPayloadFromSchema(RequestObject, 1);
-	// A bit hacky, we should probably include the number of bits with the data instead.
-	int64 CountBits = PayloadData.Num() * 8;
+	int64 CountBits = 0;
+	const uint8* PayloadData = GetPayloadFromSchema(RequestObject, 1, CountBits);
 
 	ApplyRPC(TargetObject, Function, PayloadData, CountBits);
 }
@@ -14,18 +14,60 @@
 #include "Schema/StandardLibrary.h"
 #include "Schema/UnrealMetadata.h"
 #include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
 #include "Utils/ComponentFactory.h"
 #include "Utils/EntityRegistry.h"
 #include "Utils/RepLayoutUtils.h"
 
 DEFINE_LOG_CATEGORY(LogSpatialSender);
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Component Updates Sent"), STAT_SpatialComponentUpdatesSent, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Component Updates Merged"), STAT_SpatialComponentUpdatesMerged, STATGROUP_SpatialNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Component Update Bytes Saved"), STAT_SpatialComponentUpdateBytesSaved, STATGROUP_SpatialNet);
+
 using namespace improbable;
 
+namespace
+{
+// Returns the IDs of every field an update either sets or clears.
+TArray<Schema_FieldId> GetUpdatedFieldIds(const Worker_ComponentUpdate& Update)
+{
+	Schema_Object* Fields = Schema_GetComponentUpdateFields(Update.schema_type);
+
+	TArray<Schema_FieldId> FieldIds;
+	FieldIds.SetNumUninitialized(Schema_GetUniqueFieldIdCount(Fields));
+	Schema_GetUniqueFieldIds(Fields, FieldIds.GetData());
+
+	TArray<Schema_FieldId> ClearedIds;
+	ClearedIds.SetNumUninitialized(Schema_GetComponentUpdateClearedFieldCount(Update.schema_type));
+	Schema_GetComponentUpdateClearedFieldList(Update.schema_type, ClearedIds.GetData());
+
+	FieldIds.Append(ClearedIds);
+	return FieldIds;
+}
+
+bool HasEvents(const Worker_ComponentUpdate& Update)
+{
+	return Schema_GetUniqueFieldIdCount(Schema_GetComponentUpdateEvents(Update.schema_type)) > 0;
+}
+
+// Forgets the handle of a pending update which has been dropped, unless a newer update to the same property has replaced it.
+void RemovePendingUpdateHandle(TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle>& PendingUpdateHandles, FUnresolvedRefHandle Handle, const FPendingOutgoingRepUpdate& Update)
+{
+	const FOutgoingRepUpdateKey UpdateKey(Update.ChannelObjectPair, Update.Handle);
+	const FUnresolvedRefHandle* CurrentHandle = PendingUpdateHandles.Find(UpdateKey);
+	if (CurrentHandle != nullptr && *CurrentHandle == Handle)
+	{
+		PendingUpdateHandles.Remove(UpdateKey);
+	}
+}
+}
+
 FPendingRPCParams::FPendingRPCParams(UObject* InTargetObject, UFunction* InFunction, void* InParameters)
 	: TargetObject(InTargetObject)
 	, Function(InFunction)
 	, Attempts(0)
+	, Deadline(0.0)
 {
 	Parameters.SetNumZeroed(Function->ParmsSize);
 
@@ -52,6 +94,15 @@ void USpatialSender::Init(USpatialNetDriver* InNetDriver)
 	Receiver = InNetDriver->Receiver;
 	PackageMap = InNetDriver->PackageMap;
 	TypebindingManager = InNetDriver->TypebindingManager;
+
+	EntityPoolRequestId = 0;
+	bEntityPoolRequestInFlight = false;
+
+	// Only servers create entities, so only they need a pool of entity IDs.
+	if (NetDriver->IsServer())
+	{
+		RefillEntityPool(GetDefault<USpatialGDKSettings>()->EntityPoolInitialReservationCount);
+	}
 }
 
 Worker_RequestId USpatialSender::CreateEntity(USpatialActorChannel* Channel)
@@ -147,20 +198,13 @@ Worker_RequestId USpatialSender::CreateEntity(USpatialActorChannel* Channel)
 		ComponentDatas.Add(ComponentFactory::CreateEmptyComponentData(Info->RPCComponents[RPCType]));
 	}
 
-	TArray<UObject*> DefaultSubobjects;
-	Actor->GetDefaultSubobjects(DefaultSubobjects);
-
-	for (UClass* SubobjectClass : Info->SubobjectClasses)
+	for (const auto& SubobjectIndexPair : Info->SubobjectIndices)
 	{
-		FClassInfo* SubobjectInfo = TypebindingManager->FindClassInfoByClass(SubobjectClass);
+		FClassInfo* SubobjectInfo = TypebindingManager->FindClassInfoByClass(SubobjectIndexPair.Key);
 		check(SubobjectInfo);
 
-		UObject** FoundSubobject = DefaultSubobjects.FindByPredicate([SubobjectClass](const UObject* Obj)
-		{
-			return Obj->GetClass() == SubobjectClass;
-		});
-		check(FoundSubobject);
-		UObject* Subobject = *FoundSubobject;
+		UObject* Subobject = Channel->GetResolvedSubobject(SubobjectIndexPair.Value);
+		check(Subobject);
 
 		FRepChangeState SubobjectRepChanges = Channel->CreateInitialRepChangeState(Subobject);
 		FHandoverChangeState SubobjectHandoverChanges = Channel->CreateInitialHandoverChangeState(SubobjectInfo);
@@ -244,7 +288,7 @@ void USpatialSender::SendComponentUpdates(UObject* Object, USpatialActorChannel*
 			continue;
 		}
 
-		Connection->SendComponentUpdate(EntityId, &Update);
+		QueueComponentUpdate(EntityId, Update);
 	}
 }
 
@@ -295,7 +339,7 @@ void USpatialSender::SendPositionUpdate(Worker_EntityId EntityId, const FVector&
 #endif
 
 	Worker_ComponentUpdate Update = improbable::Position::CreatePositionUpdate(improbable::Coordinates::FromFVector(Location));
-	Connection->SendComponentUpdate(EntityId, &Update);
+	QueueComponentUpdate(EntityId, Update);
 }
 
 void USpatialSender::SendRotationUpdate(Worker_EntityId EntityId, const FRotator& Rotation)
@@ -309,7 +353,122 @@ void USpatialSender::SendRotationUpdate(Worker_EntityId EntityId, const FRotator
 #endif
 
 	Worker_ComponentUpdate Update = improbable::Rotation(Rotation).CreateRotationUpdate();
-	Connection->SendComponentUpdate(EntityId, &Update);
+	QueueComponentUpdate(EntityId, Update);
+}
+
+void USpatialSender::QueueComponentUpdate(Worker_EntityId EntityId, Worker_ComponentUpdate& Update)
+{
+	Worker_ComponentUpdate* PendingUpdate = PendingComponentUpdates.Find(FEntityComponentKey(EntityId, Update.component_id));
+	if (PendingUpdate == nullptr)
+	{
+		PendingComponentUpdates.Add(FEntityComponentKey(EntityId, Update.component_id), Update);
+		return;
+	}
+
+	if (HasEvents(*PendingUpdate) || HasEvents(Update))
+	{
+		// Events can't be merged without changing what receivers see, so send the earlier update as it is.
+		Connection->SendComponentUpdate(EntityId, PendingUpdate);
+		INC_DWORD_STAT(STAT_SpatialComponentUpdatesSent);
+		*PendingUpdate = Update;
+		return;
+	}
+
+	TArray<Schema_FieldId> PendingFieldIds = GetUpdatedFieldIds(*PendingUpdate);
+	TArray<Schema_FieldId> NewFieldIds = GetUpdatedFieldIds(Update);
+
+	bool bNewUpdateCoversPending = true;
+	bool bUpdatesOverlap = false;
+	for (Schema_FieldId FieldId : PendingFieldIds)
+	{
+		if (NewFieldIds.Contains(FieldId))
+		{
+			bUpdatesOverlap = true;
+		}
+		else
+		{
+			bNewUpdateCoversPending = false;
+		}
+	}
+
+	if (bNewUpdateCoversPending)
+	{
+		// Every field in the pending update is overwritten, so it can be dropped.
+		INC_DWORD_STAT(STAT_SpatialComponentUpdatesMerged);
+		INC_DWORD_STAT_BY(STAT_SpatialComponentUpdateBytesSaved, Schema_GetWriteBufferLength(Schema_GetComponentUpdateFields(PendingUpdate->schema_type)));
+		Schema_DestroyComponentUpdate(PendingUpdate->schema_type);
+		*PendingUpdate = Update;
+	}
+	else if (!bUpdatesOverlap)
+	{
+		// The updates touch different fields, so the new fields can simply be added to the pending update.
+		Schema_Object* NewFields = Schema_GetComponentUpdateFields(Update.schema_type);
+		const uint32 Length = Schema_GetWriteBufferLength(NewFields);
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(Length);
+		Schema_WriteToBuffer(NewFields, Buffer.GetData());
+
+		if (Length > 0 && !Schema_MergeFromBuffer(Schema_GetComponentUpdateFields(PendingUpdate->schema_type), Buffer.GetData(), Length))
+		{
+			UE_LOG(LogSpatialSender, Error, TEXT("Failed to merge component update. Sending separately. Component Id: %d, entity: %lld"), Update.component_id, EntityId);
+			Connection->SendComponentUpdate(EntityId, PendingUpdate);
+			INC_DWORD_STAT(STAT_SpatialComponentUpdatesSent);
+			*PendingUpdate = Update;
+			return;
+		}
+
+		TArray<Schema_FieldId> ClearedIds;
+		ClearedIds.SetNumUninitialized(Schema_GetComponentUpdateClearedFieldCount(Update.schema_type));
+		Schema_GetComponentUpdateClearedFieldList(Update.schema_type, ClearedIds.GetData());
+		for (Schema_FieldId FieldId : ClearedIds)
+		{
+			Schema_AddComponentUpdateClearedField(PendingUpdate->schema_type, FieldId);
+		}
+
+		INC_DWORD_STAT(STAT_SpatialComponentUpdatesMerged);
+		Schema_DestroyComponentUpdate(Update.schema_type);
+	}
+	else
+	{
+		// Some, but not all, of the pending fields are overwritten. Send the earlier update so none of its other fields are lost.
+		Connection->SendComponentUpdate(EntityId, PendingUpdate);
+		INC_DWORD_STAT(STAT_SpatialComponentUpdatesSent);
+		*PendingUpdate = Update;
+	}
+}
+
+void USpatialSender::BeginDestroy()
+{
+	// Updates queued since the last flush own their schema data, and the connection may already be gone, so they can't be sent.
+	for (auto& Pair : PendingComponentUpdates)
+	{
+		Schema_DestroyComponentUpdate(Pair.Value.schema_type);
+	}
+	PendingComponentUpdates.Empty();
+
+	Super::BeginDestroy();
+}
+
+void USpatialSender::FlushComponentUpdates()
+{
+	for (auto& Pair : PendingComponentUpdates)
+	{
+		const Worker_EntityId EntityId = Pair.Key.Key;
+		Worker_ComponentUpdate& Update = Pair.Value;
+
+		// Authority may have been lost since the update was queued.
+		if (!StaticComponentView->HasAuthority(EntityId, Update.component_id))
+		{
+			UE_LOG(LogSpatialSender, Verbose, TEXT("Lost authority before sending component update. Update will not be sent. Component Id: %d, entity: %lld"), Update.component_id, EntityId);
+			Schema_DestroyComponentUpdate(Update.schema_type);
+			continue;
+		}
+
+		Connection->SendComponentUpdate(EntityId, &Update);
+		INC_DWORD_STAT(STAT_SpatialComponentUpdatesSent);
+	}
+
+	PendingComponentUpdates.Empty();
 }
 
 void USpatialSender::SendRPC(TSharedRef<FPendingRPCParams> Params)
@@ -348,6 +507,10 @@ void USpatialSender::SendRPC(TSharedRef<FPendingRPCParams> Params)
 			if (Params->Function->HasAnyFunctionFlags(FUNC_NetReliable))
 			{
 				// The number of attempts is used to determine the delay in case the command times out and we need to resend it.
+				if (Params->Attempts == 0 && GetDefault<USpatialGDKSettings>()->ReliableRPCTimeout > 0.0f)
+				{
+					Params->Deadline = FPlatformTime::Seconds() + GetDefault<USpatialGDKSettings>()->ReliableRPCTimeout;
+				}
 				Params->Attempts++;
 				Receiver->AddPendingReliableRPC(RequestId, Params);
 			}
@@ -390,71 +553,139 @@ void USpatialSender::SendReserveEntityIdRequest(USpatialActorChannel* Channel)
 	Receiver->AddPendingActorRequest(RequestId, Channel);
 }
 
-void USpatialSender::SendCreateEntityRequest(USpatialActorChannel* Channel)
+void USpatialSender::ReserveEntityId(USpatialActorChannel* Channel)
 {
-	UE_LOG(LogSpatialSender, Log, TEXT("Sending create entity request for %s"), *Channel->Actor->GetName());
-
-	FSoftClassPath ActorClassPath(Channel->Actor->GetClass());
+	const Worker_EntityId EntityId = TakeReservedEntityId();
+	if (EntityId == SpatialConstants::INVALID_ENTITY_ID)
+	{
+		// The pool has run dry, so fall back to reserving this entity on its own.
+		SendReserveEntityIdRequest(Channel);
+		return;
+	}
 
-	Worker_RequestId RequestId = CreateEntity(Channel);
-	Receiver->AddPendingActorRequest(RequestId, Channel);
+	UE_LOG(LogSpatialSender, Verbose, TEXT("Took entity id %lld from the pool for %s"), EntityId, *Channel->Actor->GetName());
+	Channel->OnEntityIdReserved(EntityId);
 }
 
-void USpatialSender::SendDeleteEntityRequest(Worker_EntityId EntityId)
+Worker_EntityId USpatialSender::TakeReservedEntityId()
 {
-	Connection->SendDeleteEntityRequest(EntityId);
+	if (ReservedEntityIds.Num() == 0)
+	{
+		RefillEntityPool(GetDefault<USpatialGDKSettings>()->EntityPoolRefreshCount);
+		return SpatialConstants::INVALID_ENTITY_ID;
+	}
+
+	FEntityRange& Range = ReservedEntityIds[0];
+	const Worker_EntityId EntityId = Range.NextEntityId++;
+	if (Range.NextEntityId > Range.LastEntityId)
+	{
+		ReservedEntityIds.RemoveAt(0);
+	}
+
+	if (GetNumReservedEntityIds() < GetDefault<USpatialGDKSettings>()->EntityPoolRefreshThreshold)
+	{
+		RefillEntityPool(GetDefault<USpatialGDKSettings>()->EntityPoolRefreshCount);
+	}
+
+	return EntityId;
 }
 
-void USpatialSender::ResetOutgoingUpdate(USpatialActorChannel* DependentChannel, UObject* ReplicatedObject, int16 Handle, bool bIsHandover)
+void USpatialSender::RefillEntityPool(uint32 NumOfEntities)
 {
-	check(DependentChannel);
-	check(ReplicatedObject);
-	const FChannelObjectPair ChannelObjectPair(DependentChannel, ReplicatedObject);
+	if (bEntityPoolRequestInFlight || NumOfEntities == 0)
+	{
+		return;
+	}
 
-	// Choose the correct container based on whether it's handover or not
-	FChannelToHandleToUnresolved& PropertyToUnresolved = bIsHandover ? HandoverPropertyToUnresolved : RepPropertyToUnresolved;
-	FOutgoingRepUpdates& ObjectToUnresolved = bIsHandover ? HandoverObjectToUnresolved : RepObjectToUnresolved;
+	UE_LOG(LogSpatialSender, Log, TEXT("Sending reserve entity Ids request for %u entities"), NumOfEntities);
+	EntityPoolRequestId = Connection->SendReserveEntityIdsRequest(NumOfEntities);
+	bEntityPoolRequestInFlight = EntityPoolRequestId != 0;
+}
 
-	FHandleToUnresolved* HandleToUnresolved = PropertyToUnresolved.Find(ChannelObjectPair);
-	if (HandleToUnresolved == nullptr)
+void USpatialSender::OnReserveEntityIdsResponse(const Worker_ReserveEntityIdsResponseOp& Op)
+{
+	if (!bEntityPoolRequestInFlight || Op.request_id != EntityPoolRequestId)
 	{
 		return;
 	}
 
-	FUnresolvedEntry* UnresolvedPtr = HandleToUnresolved->Find(Handle);
-	if (UnresolvedPtr == nullptr)
+	bEntityPoolRequestInFlight = false;
+
+	if (Op.status_code != WORKER_STATUS_CODE_SUCCESS)
 	{
+		// The next entity taken from the pool will request a new batch.
+		UE_LOG(LogSpatialSender, Warning, TEXT("Failed to reserve entity ids for the entity pool. Reason: %s"), UTF8_TO_TCHAR(Op.message));
 		return;
 	}
 
-	FUnresolvedEntry& Unresolved = *UnresolvedPtr;
+	if (Op.number_of_entity_ids == 0)
+	{
+		return;
+	}
 
-	check(Unresolved.IsValid());
+	UE_LOG(LogSpatialSender, Log, TEXT("Reserved %u entity ids for the entity pool, starting at %lld"), Op.number_of_entity_ids, Op.first_entity_id);
 
-	UE_LOG(LogSpatialSender, Log, TEXT("Resetting pending outgoing array depending on channel: %s, object: %s, handle: %d."),
-		*DependentChannel->GetName(), *ReplicatedObject->GetName(), Handle);
+	FEntityRange Range;
+	Range.NextEntityId = Op.first_entity_id;
+	Range.LastEntityId = Op.first_entity_id + Op.number_of_entity_ids - 1;
+	ReservedEntityIds.Add(Range);
+}
 
-	for (const UObject* UnresolvedObject : *Unresolved)
+int64 USpatialSender::GetNumReservedEntityIds() const
+{
+	int64 NumReservedEntityIds = 0;
+	for (const FEntityRange& Range : ReservedEntityIds)
 	{
-		FChannelToHandleToUnresolved& ChannelToUnresolved = ObjectToUnresolved.FindChecked(UnresolvedObject);
-		FHandleToUnresolved& OtherHandleToUnresolved = ChannelToUnresolved.FindChecked(ChannelObjectPair);
+		NumReservedEntityIds += Range.LastEntityId - Range.NextEntityId + 1;
+	}
+	return NumReservedEntityIds;
+}
+
+void USpatialSender::SendCreateEntityRequest(USpatialActorChannel* Channel)
+{
+	UE_LOG(LogSpatialSender, Log, TEXT("Sending create entity request for %s"), *Channel->Actor->GetName());
+
+	FSoftClassPath ActorClassPath(Channel->Actor->GetClass());
 
-		OtherHandleToUnresolved.Remove(Handle);
-		if (OtherHandleToUnresolved.Num() == 0)
+	Worker_RequestId RequestId = CreateEntity(Channel);
+	Receiver->AddPendingActorRequest(RequestId, Channel);
+}
+
+void USpatialSender::SendDeleteEntityRequest(Worker_EntityId EntityId)
+{
+	// There's no point sending updates for an entity which is about to be deleted.
+	for (auto It = PendingComponentUpdates.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Key == EntityId)
 		{
-			ChannelToUnresolved.Remove(ChannelObjectPair);
-			if (ChannelToUnresolved.Num() == 0)
-			{
-				ObjectToUnresolved.Remove(UnresolvedObject);
-			}
+			Schema_DestroyComponentUpdate(It.Value().schema_type);
+			It.RemoveCurrent();
 		}
 	}
 
-	HandleToUnresolved->Remove(Handle);
-	if (HandleToUnresolved->Num() == 0)
+	Connection->SendDeleteEntityRequest(EntityId);
+}
+
+void USpatialSender::ResetOutgoingUpdate(USpatialActorChannel* DependentChannel, UObject* ReplicatedObject, int16 Handle, bool bIsHandover)
+{
+	check(DependentChannel);
+	check(ReplicatedObject);
+	const FOutgoingRepUpdateKey UpdateKey(FChannelObjectPair(DependentChannel, ReplicatedObject), Handle);
+
+	// Choose the correct container based on whether it's handover or not
+	TUnresolvedRefTable<const UObject*, FPendingOutgoingRepUpdate>& PendingUpdates = bIsHandover ? PendingHandoverUpdates : PendingRepUpdates;
+	TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle>& PendingUpdateHandles = bIsHandover ? PendingHandoverUpdateHandles : PendingRepUpdateHandles;
+
+	FUnresolvedRefHandle PendingHandle;
+	if (!PendingUpdateHandles.RemoveAndCopyValue(UpdateKey, PendingHandle) || !PendingUpdates.IsValid(PendingHandle))
 	{
-		PropertyToUnresolved.Remove(ChannelObjectPair);
+		return;
 	}
+
+	UE_LOG(LogSpatialSender, Log, TEXT("Resetting pending outgoing array depending on channel: %s, object: %s, handle: %d."),
+		*DependentChannel->GetName(), *ReplicatedObject->GetName(), Handle);
+
+	PendingUpdates.Remove(PendingHandle);
 }
 
 void USpatialSender::QueueOutgoingUpdate(USpatialActorChannel* DependentChannel, UObject* ReplicatedObject, int16 Handle, const TSet<const UObject*>& UnresolvedObjects, bool bIsHandover)
@@ -463,28 +694,22 @@ void USpatialSender::QueueOutgoingUpdate(USpatialActorChannel* DependentChannel,
 	check(ReplicatedObject);
 	FChannelObjectPair ChannelObjectPair(DependentChannel, ReplicatedObject);
 
+	// A newer value of the property replaces whatever was waiting to be sent.
+	ResetOutgoingUpdate(DependentChannel, ReplicatedObject, Handle, bIsHandover);
+
 	UE_LOG(LogSpatialSender, Log, TEXT("Added pending outgoing property: channel: %s, object: %s, handle: %d. Depending on objects:"),
 		*DependentChannel->GetName(), *ReplicatedObject->GetName(), Handle);
 
 	// Choose the correct container based on whether it's handover or not
-	FChannelToHandleToUnresolved& PropertyToUnresolved = bIsHandover ? HandoverPropertyToUnresolved : RepPropertyToUnresolved;
-	FOutgoingRepUpdates& ObjectToUnresolved = bIsHandover ? HandoverObjectToUnresolved : RepObjectToUnresolved;
+	TUnresolvedRefTable<const UObject*, FPendingOutgoingRepUpdate>& PendingUpdates = bIsHandover ? PendingHandoverUpdates : PendingRepUpdates;
+	TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle>& PendingUpdateHandles = bIsHandover ? PendingHandoverUpdateHandles : PendingRepUpdateHandles;
 
-	FUnresolvedEntry Unresolved = MakeShared<TSet<const UObject*>>();
-	*Unresolved = UnresolvedObjects;
-
-	FHandleToUnresolved& HandleToUnresolved = PropertyToUnresolved.FindOrAdd(ChannelObjectPair);
-	if (HandleToUnresolved.Find(Handle))
-	{
-		HandleToUnresolved.Remove(Handle);
-	}
-	HandleToUnresolved.Add(Handle, Unresolved);
+	FUnresolvedRefHandle PendingHandle = PendingUpdates.Add(DependentChannel->Actor, FPendingOutgoingRepUpdate{ ChannelObjectPair, (uint16)Handle }, FPlatformTime::Seconds());
+	PendingUpdateHandles.Add(FOutgoingRepUpdateKey(ChannelObjectPair, Handle), PendingHandle);
 
 	for (const UObject* UnresolvedObject : UnresolvedObjects)
 	{
-		FHandleToUnresolved& AnotherHandleToUnresolved = ObjectToUnresolved.FindOrAdd(UnresolvedObject).FindOrAdd(ChannelObjectPair);
-		check(!AnotherHandleToUnresolved.Find(Handle));
-		AnotherHandleToUnresolved.Add(Handle, Unresolved);
+		PendingUpdates.AddKey(PendingHandle, UnresolvedObject);
 
 		// Following up on the previous log: listing the unresolved objects
 		UE_LOG(LogSpatialSender, Log, TEXT("- %s"), *UnresolvedObject->GetName());
@@ -495,7 +720,75 @@ void USpatialSender::QueueOutgoingRPC(const UObject* UnresolvedObject, TSharedRe
 {
 	check(UnresolvedObject);
 	UE_LOG(LogSpatialSender, Log, TEXT("Added pending outgoing RPC depending on object: %s, target: %s, function: %s"), *UnresolvedObject->GetName(), *Params->TargetObject->GetName(), *Params->Function->GetName());
-	OutgoingRPCs.FindOrAdd(UnresolvedObject).Add(Params);
+
+	UObject* TargetObject = Params->TargetObject.Get();
+	AActor* OwningActor = TargetObject->IsA<AActor>() ? Cast<AActor>(TargetObject) : TargetObject->GetTypedOuter<AActor>();
+
+	FUnresolvedRefHandle PendingHandle = PendingOutgoingRPCs.Add(OwningActor, MoveTemp(Params), FPlatformTime::Seconds());
+	PendingOutgoingRPCs.AddKey(PendingHandle, UnresolvedObject);
+}
+
+void USpatialSender::DropPendingOperations(AActor* Actor)
+{
+	const int32 NumUpdatesDropped = PendingRepUpdates.RemoveOwner(Actor, [this](FUnresolvedRefHandle Handle, FPendingOutgoingRepUpdate& Update)
+	{
+		RemovePendingUpdateHandle(PendingRepUpdateHandles, Handle, Update);
+	}) + PendingHandoverUpdates.RemoveOwner(Actor, [this](FUnresolvedRefHandle Handle, FPendingOutgoingRepUpdate& Update)
+	{
+		RemovePendingUpdateHandle(PendingHandoverUpdateHandles, Handle, Update);
+	});
+
+	int32 NumReliableRPCsDropped = 0;
+	const int32 NumRPCsDropped = PendingOutgoingRPCs.RemoveOwner(Actor, [&NumReliableRPCsDropped](FUnresolvedRefHandle Handle, TSharedRef<FPendingRPCParams>& Params)
+	{
+		if (Params->Function->FunctionFlags & FUNC_NetReliable)
+		{
+			NumReliableRPCsDropped++;
+		}
+	});
+
+	if (NumReliableRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialSender, Warning, TEXT("Actor %s destroyed with unresolved outgoing references: dropped %d property updates and %d RPCs, %d of them reliable."),
+			*Actor->GetName(), NumUpdatesDropped, NumRPCsDropped, NumReliableRPCsDropped);
+	}
+	else if (NumUpdatesDropped > 0 || NumRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialSender, Verbose, TEXT("Actor %s destroyed with unresolved outgoing references: dropped %d property updates and %d RPCs."),
+			*Actor->GetName(), NumUpdatesDropped, NumRPCsDropped);
+	}
+}
+
+void USpatialSender::RemoveExpiredPendingOperations()
+{
+	const USpatialGDKSettings* SpatialGDKSettings = GetDefault<USpatialGDKSettings>();
+	const double Now = FPlatformTime::Seconds();
+	const double Timeout = SpatialGDKSettings->UnresolvedReferenceTimeout;
+	const int32 MaxEntries = (int32)SpatialGDKSettings->MaxUnresolvedOperations;
+
+	const int32 NumUpdatesDropped = PendingRepUpdates.RemoveExpired(Now, Timeout, MaxEntries, [this](FUnresolvedRefHandle Handle, FPendingOutgoingRepUpdate& Update)
+	{
+		RemovePendingUpdateHandle(PendingRepUpdateHandles, Handle, Update);
+	}) + PendingHandoverUpdates.RemoveExpired(Now, Timeout, MaxEntries, [this](FUnresolvedRefHandle Handle, FPendingOutgoingRepUpdate& Update)
+	{
+		RemovePendingUpdateHandle(PendingHandoverUpdateHandles, Handle, Update);
+	});
+
+	const int32 NumRPCsDropped = PendingOutgoingRPCs.RemoveExpired(Now, Timeout, MaxEntries, [](FUnresolvedRefHandle Handle, TSharedRef<FPendingRPCParams>& Params)
+	{
+		// The caller relies on reliable RPCs arriving, so losing one is an error rather than part of the summary below.
+		if (Params->Function->FunctionFlags & FUNC_NetReliable)
+		{
+			UE_LOG(LogSpatialSender, Error, TEXT("Dropped reliable RPC %s on %s, because its object references could not be resolved in time."),
+				*Params->Function->GetName(), *GetNameSafe(Params->TargetObject.Get()));
+		}
+	});
+
+	if (NumUpdatesDropped > 0 || NumRPCsDropped > 0)
+	{
+		UE_LOG(LogSpatialSender, Warning, TEXT("Dropped %d outgoing property updates and %d RPCs whose object references could not be resolved in time."),
+			NumUpdatesDropped, NumRPCsDropped);
+	}
 }
 
 Worker_CommandRequest USpatialSender::CreateRPCCommandRequest(UObject* TargetObject, UFunction* Function, void* Parameters, Worker_ComponentId ComponentId, Schema_FieldId CommandIndex, Worker_EntityId& OutEntityId, const UObject*& OutUnresolvedObject)
@@ -580,93 +873,89 @@ void USpatialSender::SendCommandResponse(Worker_RequestId request_id, Worker_Com
 void USpatialSender::ResolveOutgoingOperations(UObject* Object, bool bIsHandover)
 {
 	// Choose the correct container based on whether it's handover or not
-	FChannelToHandleToUnresolved& PropertyToUnresolved = bIsHandover ? HandoverPropertyToUnresolved : RepPropertyToUnresolved;
-	FOutgoingRepUpdates& ObjectToUnresolved = bIsHandover ? HandoverObjectToUnresolved : RepObjectToUnresolved;
+	TUnresolvedRefTable<const UObject*, FPendingOutgoingRepUpdate>& PendingUpdates = bIsHandover ? PendingHandoverUpdates : PendingRepUpdates;
+	TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle>& PendingUpdateHandles = bIsHandover ? PendingHandoverUpdateHandles : PendingRepUpdateHandles;
 
-	FChannelToHandleToUnresolved* ChannelToUnresolved = ObjectToUnresolved.Find(Object);
-	if (!ChannelToUnresolved)
-	{
-		return;
-	}
+	TArray<FUnresolvedRefHandle> Handles;
+	PendingUpdates.ResolveKey(Object, Handles);
+
+	// Group the properties which no longer depend on anything, so each object is sent a single update.
+	TMap<FChannelObjectPair, TArray<uint16>> ResolvedPropertyHandles;
 
-	for (auto& ChannelProperties : *ChannelToUnresolved)
+	for (FUnresolvedRefHandle PendingHandle : Handles)
 	{
-		FChannelObjectPair& ChannelObjectPair = ChannelProperties.Key;
-		if (!ChannelObjectPair.Key.IsValid() || !ChannelObjectPair.Value.IsValid())
+		FPendingOutgoingRepUpdate* PendingUpdate = PendingUpdates.Find(PendingHandle);
+		if (!PendingUpdate || PendingUpdates.NumKeys(PendingHandle) > 0)
 		{
 			continue;
 		}
 
-		USpatialActorChannel* DependentChannel = ChannelObjectPair.Key.Get();
-		UObject* ReplicatingObject = ChannelObjectPair.Value.Get();
-		FHandleToUnresolved& HandleToUnresolved = ChannelProperties.Value;
-
-		TArray<uint16> PropertyHandles;
+		const FChannelObjectPair ChannelObjectPair = PendingUpdate->ChannelObjectPair;
+		const uint16 Handle = PendingUpdate->Handle;
+		PendingUpdateHandles.Remove(FOutgoingRepUpdateKey(ChannelObjectPair, Handle));
+		PendingUpdates.Remove(PendingHandle);
 
-		for (auto& HandleUnresolvedPair : HandleToUnresolved)
+		if (!ChannelObjectPair.Key.IsValid() || !ChannelObjectPair.Value.IsValid())
 		{
-			uint16 Handle = HandleUnresolvedPair.Key;
-			FUnresolvedEntry& Unresolved = HandleUnresolvedPair.Value;
-
-			Unresolved->Remove(Object);
-			if (Unresolved->Num() == 0)
-			{
-				PropertyHandles.Add(Handle);
+			continue;
+		}
 
-				// Hack to figure out if this property is an array to add extra handles
-				if (!bIsHandover && DependentChannel->IsDynamicArrayHandle(ReplicatingObject, Handle))
-				{
-					PropertyHandles.Add(0);
-					PropertyHandles.Add(0);
-				}
+		TArray<uint16>& PropertyHandles = ResolvedPropertyHandles.FindOrAdd(ChannelObjectPair);
+		PropertyHandles.Add(Handle);
 
-				FHandleToUnresolved& AnotherHandleToUnresolved = PropertyToUnresolved.FindChecked(ChannelObjectPair);
-				AnotherHandleToUnresolved.Remove(Handle);
-				if (AnotherHandleToUnresolved.Num() == 0)
-				{
-					PropertyToUnresolved.Remove(ChannelObjectPair);
-				}
-			}
+		// Hack to figure out if this property is an array to add extra handles
+		if (!bIsHandover && ChannelObjectPair.Key->IsDynamicArrayHandle(ChannelObjectPair.Value.Get(), Handle))
+		{
+			PropertyHandles.Add(0);
+			PropertyHandles.Add(0);
 		}
+	}
+
+	for (auto& ChannelProperties : ResolvedPropertyHandles)
+	{
+		USpatialActorChannel* DependentChannel = ChannelProperties.Key.Key.Get();
+		UObject* ReplicatingObject = ChannelProperties.Key.Value.Get();
+		TArray<uint16>& PropertyHandles = ChannelProperties.Value;
 
-		if (PropertyHandles.Num() > 0)
+		if (bIsHandover)
 		{
-			if (bIsHandover)
-			{
-				SendComponentUpdates(ReplicatingObject, DependentChannel, nullptr, &PropertyHandles);
-			}
-			else
-			{
-				// End with zero to indicate the end of the list of handles.
-				PropertyHandles.Add(0);
-				FRepChangeState RepChangeState = { PropertyHandles, DependentChannel->GetObjectRepLayout(ReplicatingObject) };
-				SendComponentUpdates(ReplicatingObject, DependentChannel, &RepChangeState, nullptr);
-			}
+			SendComponentUpdates(ReplicatingObject, DependentChannel, nullptr, &PropertyHandles);
+		}
+		else
+		{
+			// End with zero to indicate the end of the list of handles.
+			PropertyHandles.Add(0);
+			FRepChangeState RepChangeState = { PropertyHandles, DependentChannel->GetObjectRepLayout(ReplicatingObject) };
+			SendComponentUpdates(ReplicatingObject, DependentChannel, &RepChangeState, nullptr);
 		}
 	}
-
-	ObjectToUnresolved.Remove(Object);
 }
 
 void USpatialSender::ResolveOutgoingRPCs(UObject* Object)
 {
-	TArray<TSharedRef<FPendingRPCParams>>* RPCList = OutgoingRPCs.Find(Object);
-	if (RPCList)
+	TArray<FUnresolvedRefHandle> Handles;
+	PendingOutgoingRPCs.ResolveKey(Object, Handles);
+
+	for (FUnresolvedRefHandle PendingHandle : Handles)
 	{
-		for (TSharedRef<FPendingRPCParams>& RPCParams : *RPCList)
+		TSharedRef<FPendingRPCParams>* PendingRPC = PendingOutgoingRPCs.Find(PendingHandle);
+		if (!PendingRPC)
 		{
-			if (!RPCParams->TargetObject.IsValid())
-			{
-				// The target object was destroyed before we could send the RPC.
-				continue;
-			}
+			continue;
+		}
+
+		// SendRPC can queue the RPC again if it depends on another unresolved object, so take it out of the table first.
+		TSharedRef<FPendingRPCParams> RPCParams = *PendingRPC;
+		PendingOutgoingRPCs.Remove(PendingHandle);
 
-			// We can guarantee that SendRPC won't populate OutgoingRPCs[Object] whilst we're iterating through it,
-			// because Object has been resolved when we call ResolveOutgoingRPCs.
-			UE_LOG(LogSpatialSender, Log, TEXT("Resolving outgoing RPC depending on object: %s, target: %s, function: %s"), *Object->GetName(), *RPCParams->TargetObject->GetName(), *RPCParams->Function->GetName());
-			SendRPC(RPCParams);
+		if (!RPCParams->TargetObject.IsValid())
+		{
+			// The target object was destroyed before we could send the RPC.
+			continue;
 		}
-		OutgoingRPCs.Remove(Object);
+
+		UE_LOG(LogSpatialSender, Log, TEXT("Resolving outgoing RPC depending on object: %s, target: %s, function: %s"), *Object->GetName(), *RPCParams->TargetObject->GetName(), *RPCParams->Function->GetName());
+		SendRPC(RPCParams);
 	}
 }
 
@@ -738,6 +1027,6 @@ bool USpatialSender::UpdateEntityACLs(AActor* Actor, Worker_EntityId EntityId)
 
 	Worker_ComponentUpdate Update = EntityACL->CreateEntityAclUpdate();
 
-	Connection->SendComponentUpdate(EntityId, &Update);
+	QueueComponentUpdate(EntityId, Update);
 	return true;
 }
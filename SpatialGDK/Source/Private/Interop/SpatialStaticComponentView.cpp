@@ -2,14 +2,13 @@
 
 #include "Interop/SpatialStaticComponentView.h"
 
+#include "Interop/Connection/SpatialOpList.h"
+
 Worker_Authority USpatialStaticComponentView::GetAuthority(Worker_EntityId EntityId, Worker_ComponentId ComponentId)
 {
-	if (TMap<Worker_ComponentId, Worker_Authority>* ComponentAuthorityMap = EntityComponentAuthorityMap.Find(EntityId))
+	if (const Worker_Authority* Authority = ComponentAuthority.Find(FEntityComponentId{ EntityId, ComponentId }))
 	{
-		if (Worker_Authority* Authority = ComponentAuthorityMap->Find(ComponentId))
-		{
-			return *Authority;
-		}
+		return *Authority;
 	}
 
 	return WORKER_AUTHORITY_NOT_AUTHORITATIVE;
@@ -21,56 +20,144 @@ bool USpatialStaticComponentView::HasAuthority(Worker_EntityId EntityId, Worker_
 	return GetAuthority(EntityId, ComponentId) == WORKER_AUTHORITY_AUTHORITATIVE;
 }
 
+int32 USpatialStaticComponentView::FindOrAddEntitySlot(Worker_EntityId EntityId)
+{
+	if (const int32* Slot = EntitySlots.Find(EntityId))
+	{
+		return *Slot;
+	}
+
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		// Growing the chunked arrays only ever adds chunks, so pointers to existing component data stay valid.
+		Slot = EntityAuthorityComponents.AddDefaulted();
+		EntityAclStorage.AddElement(TOptional<improbable::EntityAcl>());
+		MetadataStorage.AddElement(TOptional<improbable::Metadata>());
+		PositionStorage.AddElement(TOptional<improbable::Position>());
+		PersistenceStorage.AddElement(TOptional<improbable::Persistence>());
+		RotationStorage.AddElement(TOptional<improbable::Rotation>());
+		UnrealMetadataStorage.AddElement(TOptional<improbable::UnrealMetadata>());
+	}
+
+	EntitySlots.Add(EntityId, Slot);
+	return Slot;
+}
+
 template <typename T>
-T* USpatialStaticComponentView::GetComponentData(Worker_EntityId EntityId)
+void USpatialStaticComponentView::SetComponentData(int32 Slot, TUniquePtr<improbable::ComponentStorageBase> Data)
+{
+	GetStorage(static_cast<T*>(nullptr))[Slot] = MoveTemp(static_cast<improbable::ComponentStorage<T>*>(Data.Get())->Get());
+}
+
+void USpatialStaticComponentView::OnAddComponent(const Worker_AddComponentOp& Op, TUniquePtr<improbable::ComponentStorageBase> Data)
 {
-	if (TMap<Worker_ComponentId, TUniquePtr<ComponentStorageBase>>* ComponentStorageMap = EntityComponentMap.Find(EntityId))
+	// Data is normally decoded ahead of dispatch, but decode it here if that didn't happen.
+	if (!Data.IsValid())
 	{
-		if (TUniquePtr<improbable::ComponentStorageBase>* Component = ComponentStorageMap->Find(T::ComponentId))
+		Data = improbable::CreateStaticComponentStorage(Op.data);
+		if (!Data.IsValid())
 		{
-			return &(static_cast<improbable::ComponentStorage<T>*>(Component->Get())->Get());
+			return;
 		}
 	}
 
-	return nullptr;
-}
+	const int32 Slot = FindOrAddEntitySlot(Op.entity_id);
 
-void USpatialStaticComponentView::OnAddComponent(const Worker_AddComponentOp& Op)
-{
-	TUniquePtr<improbable::ComponentStorageBase> Data;
 	switch (Op.data.component_id)
 	{
 	case SpatialConstants::ENTITY_ACL_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::EntityAcl>>(Op.data);
+		SetComponentData<improbable::EntityAcl>(Slot, MoveTemp(Data));
 		break;
 	case SpatialConstants::METADATA_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::Metadata>>(Op.data);
+		SetComponentData<improbable::Metadata>(Slot, MoveTemp(Data));
 		break;
 	case SpatialConstants::POSITION_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::Position>>(Op.data);
+		SetComponentData<improbable::Position>(Slot, MoveTemp(Data));
 		break;
 	case SpatialConstants::PERSISTENCE_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::Persistence>>(Op.data);
+		SetComponentData<improbable::Persistence>(Slot, MoveTemp(Data));
 		break;
 	case SpatialConstants::ROTATION_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::Rotation>>(Op.data);
+		SetComponentData<improbable::Rotation>(Slot, MoveTemp(Data));
 		break;
 	case SpatialConstants::UNREAL_METADATA_COMPONENT_ID:
-		Data = MakeUnique<improbable::ComponentStorage<improbable::UnrealMetadata>>(Op.data);
+		SetComponentData<improbable::UnrealMetadata>(Slot, MoveTemp(Data));
 		break;
 	default:
+		checkNoEntry();
+		break;
+	}
+}
+
+void USpatialStaticComponentView::OnRemoveComponent(const Worker_RemoveComponentOp& Op)
+{
+	const int32* Slot = EntitySlots.Find(Op.entity_id);
+	if (Slot == nullptr)
+	{
 		return;
 	}
 
-	EntityComponentMap.FindOrAdd(Op.entity_id).FindOrAdd(Op.data.component_id) = std::move(Data);
+	switch (Op.component_id)
+	{
+	case SpatialConstants::ENTITY_ACL_COMPONENT_ID:
+		EntityAclStorage[*Slot].Reset();
+		break;
+	case SpatialConstants::METADATA_COMPONENT_ID:
+		MetadataStorage[*Slot].Reset();
+		break;
+	case SpatialConstants::POSITION_COMPONENT_ID:
+		PositionStorage[*Slot].Reset();
+		break;
+	case SpatialConstants::PERSISTENCE_COMPONENT_ID:
+		PersistenceStorage[*Slot].Reset();
+		break;
+	case SpatialConstants::ROTATION_COMPONENT_ID:
+		RotationStorage[*Slot].Reset();
+		break;
+	case SpatialConstants::UNREAL_METADATA_COMPONENT_ID:
+		UnrealMetadataStorage[*Slot].Reset();
+		break;
+	default:
+		break;
+	}
+
+	// We can't be authoritative over a component that isn't there.
+	if (ComponentAuthority.Remove(FEntityComponentId{ Op.entity_id, Op.component_id }) > 0)
+	{
+		EntityAuthorityComponents[*Slot].RemoveSwap(Op.component_id);
+	}
 }
 
 void USpatialStaticComponentView::OnRemoveEntity(const Worker_RemoveEntityOp& Op)
 {
-	EntityComponentMap.Remove(Op.entity_id);
+	int32 Slot;
+	if (!EntitySlots.RemoveAndCopyValue(Op.entity_id, Slot))
+	{
+		return;
+	}
+
+	for (Worker_ComponentId ComponentId : EntityAuthorityComponents[Slot])
+	{
+		ComponentAuthority.Remove(FEntityComponentId{ Op.entity_id, ComponentId });
+	}
+	EntityAuthorityComponents[Slot].Reset();
+
+	EntityAclStorage[Slot].Reset();
+	MetadataStorage[Slot].Reset();
+	PositionStorage[Slot].Reset();
+	PersistenceStorage[Slot].Reset();
+	RotationStorage[Slot].Reset();
+	UnrealMetadataStorage[Slot].Reset();
+
+	FreeSlots.Add(Slot);
 }
 
-void USpatialStaticComponentView::OnComponentUpdate(const Worker_ComponentUpdateOp& Op)
+void USpatialStaticComponentView::OnComponentUpdate(const Worker_ComponentUpdateOp& Op, const improbable::ComponentUpdateBase* DecodedUpdate)
 {
 	improbable::Component* Component = nullptr;
 
@@ -89,12 +176,33 @@ void USpatialStaticComponentView::OnComponentUpdate(const Worker_ComponentUpdate
 		return;
 	}
 
-	if (Component) {
+	if (Component == nullptr)
+	{
+		return;
+	}
+
+	if (DecodedUpdate != nullptr)
+	{
+		DecodedUpdate->ApplyTo(*Component);
+	}
+	else
+	{
 		Component->ApplyComponentUpdate(Op.update);
 	}
 }
 
 void USpatialStaticComponentView::OnAuthorityChange(const Worker_AuthorityChangeOp& Op)
 {
-	EntityComponentAuthorityMap.FindOrAdd(Op.entity_id).FindOrAdd(Op.component_id) = (Worker_Authority)Op.authority;
+	const int32 Slot = FindOrAddEntitySlot(Op.entity_id);
+
+	const FEntityComponentId Key{ Op.entity_id, Op.component_id };
+	if (Worker_Authority* Authority = ComponentAuthority.Find(Key))
+	{
+		*Authority = static_cast<Worker_Authority>(Op.authority);
+	}
+	else
+	{
+		ComponentAuthority.Add(Key, static_cast<Worker_Authority>(Op.authority));
+		EntityAuthorityComponents[Slot].Add(Op.component_id);
+	}
 }
@@ -5,14 +5,178 @@
 #include "AssetRegistryModule.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/NetDriver.h"
 #include "Engine/SCS_Node.h"
 #include "GameFramework/Actor.h"
 #include "Misc/MessageDialog.h"
+#include "Net/RepLayout.h"
 #include "UObject/Class.h"
 #include "UObject/UObjectIterator.h"
 
-void USpatialTypebindingManager::Init()
+#include "Utils/SchemaStructUtils.h"
+
+ESchemaPropertyKind GetSchemaPropertyKind(UProperty* Property)
+{
+	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		return IsSchemaStruct(StructProperty->Struct) ? ESchemaPropertyKind::SchemaStruct : ESchemaPropertyKind::Struct;
+	}
+	else if (Property->IsA<UBoolProperty>())
+	{
+		return ESchemaPropertyKind::Bool;
+	}
+	else if (Property->IsA<UFloatProperty>())
+	{
+		return ESchemaPropertyKind::Float;
+	}
+	else if (Property->IsA<UDoubleProperty>())
+	{
+		return ESchemaPropertyKind::Double;
+	}
+	else if (Property->IsA<UInt8Property>())
+	{
+		return ESchemaPropertyKind::Int8;
+	}
+	else if (Property->IsA<UInt16Property>())
+	{
+		return ESchemaPropertyKind::Int16;
+	}
+	else if (Property->IsA<UIntProperty>())
+	{
+		return ESchemaPropertyKind::Int32;
+	}
+	else if (Property->IsA<UInt64Property>())
+	{
+		return ESchemaPropertyKind::Int64;
+	}
+	else if (Property->IsA<UByteProperty>())
+	{
+		return ESchemaPropertyKind::Byte;
+	}
+	else if (Property->IsA<UUInt16Property>())
+	{
+		return ESchemaPropertyKind::UInt16;
+	}
+	else if (Property->IsA<UUInt32Property>())
+	{
+		return ESchemaPropertyKind::UInt32;
+	}
+	else if (Property->IsA<UUInt64Property>())
+	{
+		return ESchemaPropertyKind::UInt64;
+	}
+	else if (Property->IsA<UObjectPropertyBase>())
+	{
+		return ESchemaPropertyKind::Object;
+	}
+	else if (Property->IsA<UNameProperty>())
+	{
+		return ESchemaPropertyKind::Name;
+	}
+	else if (Property->IsA<UStrProperty>())
+	{
+		return ESchemaPropertyKind::String;
+	}
+	else if (Property->IsA<UTextProperty>())
+	{
+		return ESchemaPropertyKind::Text;
+	}
+	else if (Property->IsA<UArrayProperty>())
+	{
+		return ESchemaPropertyKind::Array;
+	}
+	else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		// Larger enums are stored the same way as their underlying type.
+		return EnumProperty->ElementSize < 4 ? ESchemaPropertyKind::SmallEnum : GetSchemaPropertyKind(EnumProperty->GetUnderlyingProperty());
+	}
+
+	return ESchemaPropertyKind::Unknown;
+}
+
+FSchemaPropertyHandler CreateSchemaPropertyHandler(UProperty* Property)
+{
+	FSchemaPropertyHandler Handler;
+	Handler.Kind = GetSchemaPropertyKind(Property);
+	Handler.InnerKind = ESchemaPropertyKind::Unknown;
+	Handler.ElementSize = Property->ElementSize;
+	Handler.Property = Property;
+
+	if (Handler.Kind == ESchemaPropertyKind::Array)
+	{
+		UProperty* Inner = Cast<UArrayProperty>(Property)->Inner;
+		Handler.InnerKind = GetSchemaPropertyKind(Inner);
+		Handler.ElementSize = Inner->ElementSize;
+	}
+
+	if (Handler.Kind == ESchemaPropertyKind::SchemaStruct || Handler.InnerKind == ESchemaPropertyKind::SchemaStruct)
+	{
+		TSharedPtr<TArray<FSchemaPropertyHandler>> StructFields = MakeShared<TArray<FSchemaPropertyHandler>>();
+		UProperty* ValueProperty = Handler.Kind == ESchemaPropertyKind::Array ? Cast<UArrayProperty>(Property)->Inner : Property;
+		for (UProperty* FieldProperty : GetSchemaStructProperties(Cast<UStructProperty>(ValueProperty)->Struct))
+		{
+			StructFields->Add(CreateSchemaPropertyHandler(FieldProperty));
+		}
+		Handler.StructFields = StructFields;
+	}
+
+	return Handler;
+}
+
+namespace
 {
+
+ESchemaPropertyKind GetFieldKind(const FSchemaPropertyHandler& Handler)
+{
+	return Handler.Kind == ESchemaPropertyKind::Array ? Handler.InnerKind : Handler.Kind;
+}
+
+// Handover structs which are schema types get a handle for each of their fields, recursively, so a change to one field
+// only sends that field. The schema generator gives them a schema field each, in the same order.
+void AddHandoverProperty(FClassInfo& Info, UProperty* Property, int32 Offset, int32 ArrayIdx)
+{
+	UStructProperty* StructProperty = Cast<UStructProperty>(Property);
+	if (StructProperty != nullptr && IsSchemaStruct(StructProperty->Struct))
+	{
+		for (UProperty* FieldProperty : GetSchemaStructProperties(StructProperty->Struct))
+		{
+			// Schema structs have no static arrays, so each field is compared and shadowed on its own.
+			AddHandoverProperty(Info, FieldProperty, Offset + FieldProperty->GetOffset_ForGC(), 0);
+		}
+		return;
+	}
+
+	FHandoverPropertyInfo HandoverInfo;
+	HandoverInfo.Handle = Info.HandoverProperties.Num() + 1; // 1-based index
+	HandoverInfo.Offset = Offset;
+	HandoverInfo.ArrayIdx = ArrayIdx;
+	HandoverInfo.Property = Property;
+	HandoverInfo.Handler = CreateSchemaPropertyHandler(Property);
+
+	Info.HandoverProperties.Add(HandoverInfo);
+}
+
+} // ::
+
+void FSpatialComponentLayouts::Add(Worker_ComponentId ComponentId, TArray<ESchemaPropertyKind>&& FieldKinds)
+{
+	TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe> Layout = MakeShared<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe>(MoveTemp(FieldKinds));
+
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	Layouts.Add(ComponentId, Layout);
+}
+
+TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe> FSpatialComponentLayouts::Find(Worker_ComponentId ComponentId) const
+{
+	FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+	const TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe>* Layout = Layouts.Find(ComponentId);
+	return Layout != nullptr ? *Layout : nullptr;
+}
+
+void USpatialTypebindingManager::Init(UNetDriver* InNetDriver)
+{
+	NetDriver = InNetDriver;
+
 	TSoftObjectPtr<USchemaDatabase> SchemaDatabasePtr(FSoftObjectPath(TEXT("/Game/Spatial/SchemaDatabase.SchemaDatabase")));
 	SchemaDatabasePtr.LoadSynchronous();
 	SchemaDatabase = SchemaDatabasePtr.Get();
@@ -87,17 +251,11 @@ void USpatialTypebindingManager::CreateTypebindings()
 			{
 				for (int32 ArrayIdx = 0; ArrayIdx < PropertyIt->ArrayDim; ++ArrayIdx)
 				{
-					FHandoverPropertyInfo HandoverInfo;
-					HandoverInfo.Handle = Info.HandoverProperties.Num() + 1; // 1-based index
-					HandoverInfo.Offset = Property->GetOffset_ForGC() + Property->ElementSize * ArrayIdx;
-					HandoverInfo.ArrayIdx = ArrayIdx;
-					HandoverInfo.Property = Property;
-
-					Info.HandoverProperties.Add(HandoverInfo);
+					AddHandoverProperty(Info, Property, Property->GetOffset_ForGC() + Property->ElementSize * ArrayIdx, ArrayIdx);
 				}
 			}
 		}
-		
+
 		Info.SingleClientComponent = SchemaDatabase->ClassToSchema[Class].SingleClientRepData;
 		ComponentToClassMap.Add(Info.SingleClientComponent, Class);
 
@@ -107,6 +265,13 @@ void USpatialTypebindingManager::CreateTypebindings()
 		Info.HandoverComponent = SchemaDatabase->ClassToSchema[Class].HandoverData;
 		ComponentToClassMap.Add(Info.HandoverComponent, Class);
 
+		TArray<ESchemaPropertyKind> HandoverFieldKinds;
+		for (const FHandoverPropertyInfo& HandoverInfo : Info.HandoverProperties)
+		{
+			HandoverFieldKinds.Add(GetFieldKind(HandoverInfo.Handler));
+		}
+		ComponentLayouts->Add(Info.HandoverComponent, MoveTemp(HandoverFieldKinds));
+
 		Info.RPCComponents[RPC_Client] = SchemaDatabase->ClassToSchema[Class].ClientRPCs;
 		ComponentToClassMap.Add(Info.RPCComponents[RPC_Client], Class);
 
@@ -155,11 +320,51 @@ void USpatialTypebindingManager::CreateTypebindings()
 
 		ClassInfoMap.Add(Class, Info);
 	}
+
+	// Subobjects' handover properties are only known once every class has been bound.
+	for (auto& ClassInfoPair : ClassInfoMap)
+	{
+		FindHandoverSubobjects(ClassInfoPair.Value);
+	}
 }
 
 FClassInfo* USpatialTypebindingManager::FindClassInfoByClass(UClass* Class)
 {
-	return ClassInfoMap.Find(Class);
+	FClassInfo* Info = ClassInfoMap.Find(Class);
+	if (Info != nullptr && !Info->bRepPropertiesBound)
+	{
+		BindRepProperties(Class, *Info);
+	}
+	return Info;
+}
+
+// Building a class's rep layout is expensive, and most supported classes are never replicated by any one worker, so their
+// rep properties are only bound when the class is first used.
+void USpatialTypebindingManager::BindRepProperties(UClass* Class, FClassInfo& Info)
+{
+	TSharedPtr<FRepLayout> RepLayout = NetDriver->GetObjectClassRepLayout(Class);
+	for (int32 HandleIndex = 0; HandleIndex < RepLayout->BaseHandleToCmdIndex.Num(); ++HandleIndex)
+	{
+		const FRepLayoutCmd& Cmd = RepLayout->Cmds[RepLayout->BaseHandleToCmdIndex[HandleIndex].CmdIndex];
+
+		FRepPropertyInfo RepInfo;
+		RepInfo.Handle = HandleIndex + 1; // 1-based index
+		RepInfo.Offset = Cmd.Offset;
+		RepInfo.Handler = CreateSchemaPropertyHandler(Cmd.Property);
+
+		Info.RepProperties.Add(RepInfo);
+	}
+
+	// Both rep components use the class's rep handles as their field ids.
+	TArray<ESchemaPropertyKind> RepFieldKinds;
+	for (const FRepPropertyInfo& RepInfo : Info.RepProperties)
+	{
+		RepFieldKinds.Add(GetFieldKind(RepInfo.Handler));
+	}
+	ComponentLayouts->Add(Info.SingleClientComponent, TArray<ESchemaPropertyKind>(RepFieldKinds));
+	ComponentLayouts->Add(Info.MultiClientComponent, MoveTemp(RepFieldKinds));
+
+	Info.bRepPropertiesBound = true;
 }
 
 FClassInfo* USpatialTypebindingManager::FindClassInfoByComponentId(Worker_ComponentId ComponentId)
@@ -179,36 +384,20 @@ bool USpatialTypebindingManager::IsSupportedClass(UClass* Class)
 	return SupportedClasses.Contains(Class);
 }
 
-TArray<UObject*> USpatialTypebindingManager::GetHandoverSubobjects(AActor* Actor)
+void USpatialTypebindingManager::FindHandoverSubobjects(FClassInfo& ClassInfo)
 {
-	FClassInfo* Info = FindClassInfoByClass(Actor->GetClass());
-	check(Info);
-
-	TArray<UObject*> DefaultSubobjects;
-	Actor->GetDefaultSubobjects(DefaultSubobjects);
-
-	TArray<UObject*> FoundSubobjects;
-
-	for (UClass* SubobjectClass : Info->SubobjectClasses)
+	for (const auto& SubobjectIndexPair : ClassInfo.SubobjectIndices)
 	{
-		FClassInfo* SubobjectInfo = FindClassInfoByClass(SubobjectClass);
+		// Only handover properties are needed, so this doesn't bind the subobject's rep properties.
+		FClassInfo* SubobjectInfo = ClassInfoMap.Find(SubobjectIndexPair.Key);
 		check(SubobjectInfo);
 
-		if (SubobjectInfo->HandoverProperties.Num() == 0)
+		// Not interested in this component if it has no handover properties
+		if (SubobjectInfo->HandoverProperties.Num() > 0)
 		{
-			// Not interested in this component if it has no handover properties
-			continue;
+			ClassInfo.HandoverSubobjectIndices.Add(SubobjectIndexPair.Value);
 		}
-
-		UObject** FoundSubobject = DefaultSubobjects.FindByPredicate([SubobjectClass](const UObject* Obj)
-		{
-			return Obj->GetClass() == SubobjectClass;
-		});
-		check(FoundSubobject);
-		FoundSubobjects.Add(*FoundSubobject);
 	}
-
-	return FoundSubobjects;
 }
 
 void USpatialTypebindingManager::AddSubobjectClass(FClassInfo& ClassInfo, UClass* Class)
@@ -221,5 +410,6 @@ void USpatialTypebindingManager::AddSubobjectClass(FClassInfo& ClassInfo, UClass
 		};
 		
 		ClassInfo.SubobjectClasses.Add(Class);
+		ClassInfo.SubobjectIndices.Add(Class, ClassInfo.SubobjectIndices.Num());
 	}
 }
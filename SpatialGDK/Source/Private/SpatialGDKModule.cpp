@@ -2,6 +2,8 @@
 
 #include "SpatialGDKModule.h"
 
+#include "SpatialGDKSettings.h"
+
 #define LOCTEXT_NAMESPACE "FSpatialGDKModule"
 
 DEFINE_LOG_CATEGORY(LogSpatialGDKModule);
@@ -10,10 +12,51 @@ IMPLEMENT_MODULE(FSpatialGDKModule, SpatialGDK)
 
 void FSpatialGDKModule::StartupModule()
 {
+	RegisterSettings();
 }
 
 void FSpatialGDKModule::ShutdownModule()
 {
+	if (UObjectInitialized())
+	{
+		UnregisterSettings();
+	}
+}
+
+void FSpatialGDKModule::RegisterSettings()
+{
+	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
+	{
+		ISettingsContainerPtr SettingsContainer = SettingsModule->GetContainer("Project");
+
+		SettingsContainer->DescribeCategory("SpatialGDK", LOCTEXT("RuntimeWDCategoryName", "SpatialOS Unreal GDK"),
+			LOCTEXT("RuntimeWDCategoryDescription", "Configuration for the SpatialOS Unreal GDK"));
+
+		ISettingsSectionPtr SettingsSection = SettingsModule->RegisterSettings("Project", "SpatialGDK", "Runtime",
+			LOCTEXT("RuntimeGeneralSettingsName", "Runtime"),
+			LOCTEXT("RuntimeGeneralSettingsDescription", "Runtime configuration for the SpatialOS Unreal GDK."),
+			GetMutableDefault<USpatialGDKSettings>());
+
+		if (SettingsSection.IsValid())
+		{
+			SettingsSection->OnModified().BindRaw(this, &FSpatialGDKModule::HandleSettingsSaved);
+		}
+	}
+}
+
+void FSpatialGDKModule::UnregisterSettings()
+{
+	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
+	{
+		SettingsModule->UnregisterSettings("Project", "SpatialGDK", "Runtime");
+	}
+}
+
+bool FSpatialGDKModule::HandleSettingsSaved()
+{
+	GetMutableDefault<USpatialGDKSettings>()->SaveConfig();
+
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,41 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "SpatialGDKSettings.h"
+
+USpatialGDKSettings::USpatialGDKSettings(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bRunSpatialWorkerConnectionOnGameThread(false)
+	, OpsUpdateRate(1000.0f)
+	, OpsProcessingTimeBudgetMs(10.0f)
+	, MaxCarriedOverOps(100000)
+	, HandoverFullCompareInterval(0.0f)
+	, OwnershipSweepInterval(1.0f)
+	, EntityPoolInitialReservationCount(3000)
+	, EntityPoolRefreshThreshold(1000)
+	, EntityPoolRefreshCount(2000)
+	, MaxActorReplicationsPerTick(0)
+	, ActorGridCellSize(10000.0f)
+	, PlayerPriorityDistance(20000.0f)
+	, NearPlayerPriorityMultiplier(4.0f)
+	, MaxUnresolvedOperations(10000)
+	, UnresolvedReferenceTimeout(0.0f)
+	, MaxReliableRPCRetries(10000)
+	, ReliableRPCTimeout(0.0f)
+	, MaxQueuedLogMessages(2048)
+	, LogMessagesPerSecondPerCategory(10.0f)
+	, LogMessageBurstPerCategory(50.0f)
+{
+}
+
+const FSpatialTransformReplicationSettings& USpatialGDKSettings::GetTransformReplicationSettings(UClass* Class) const
+{
+	for (UClass* CurrentClass = Class; CurrentClass != nullptr; CurrentClass = CurrentClass->GetSuperClass())
+	{
+		if (const FSpatialTransformReplicationSettings* Override = TransformReplicationOverrides.Find(TSoftClassPtr<AActor>(CurrentClass)))
+		{
+			return *Override;
+		}
+	}
+
+	return DefaultTransformReplication;
+}
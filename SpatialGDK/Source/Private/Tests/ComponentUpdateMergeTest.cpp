@@ -0,0 +1,211 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialSender.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+// A component with three uint32 fields, which this server can write to on every test entity.
+const Worker_ComponentId TEST_COMPONENT_ID = 1000000;
+const Schema_FieldId FIELD_A = 1;
+const Schema_FieldId FIELD_B = 2;
+const Schema_FieldId FIELD_C = 3;
+
+const int32 NUM_TEST_ENTITIES = 1000;
+const int32 MAX_TICKS_TO_AUTHORITY = 10;
+
+// Each of the benchmark's updates sets one of the test fields in turn, as several properties changing over a tick would.
+const int32 NUM_BENCHMARK_UPDATES_PER_ENTITY = 9;
+
+Worker_ComponentUpdate CreateTestUpdate(const TMap<Schema_FieldId, uint32>& Fields)
+{
+	Worker_ComponentUpdate Update = {};
+	Update.component_id = TEST_COMPONENT_ID;
+	Update.schema_type = Schema_CreateComponentUpdate(TEST_COMPONENT_ID);
+
+	Schema_Object* UpdateFields = Schema_GetComponentUpdateFields(Update.schema_type);
+	for (const TPair<Schema_FieldId, uint32>& Field : Fields)
+	{
+		Schema_AddUint32(UpdateFields, Field.Key, Field.Value);
+	}
+
+	return Update;
+}
+
+// The fields of every test component update the mock has echoed back since it was last asked, by entity, in the order they were sent.
+TMap<Worker_EntityId, TArray<TMap<Schema_FieldId, uint32>>> TakeSentUpdates(FSpatialMockServerWorld& Server)
+{
+	TMap<Worker_EntityId, TArray<TMap<Schema_FieldId, uint32>>> SentUpdates;
+
+	TUniquePtr<FSpatialOpList> OpList = Server.NetDriver->Connection->GetMockConnection()->GetOpList();
+	if (!OpList.IsValid())
+	{
+		return SentUpdates;
+	}
+
+	for (uint32 i = 0; i < OpList->OpList->op_count; i++)
+	{
+		const Worker_Op& Op = OpList->OpList->ops[i];
+		if (Op.op_type != WORKER_OP_TYPE_COMPONENT_UPDATE || Op.component_update.update.component_id != TEST_COMPONENT_ID)
+		{
+			continue;
+		}
+
+		Schema_Object* UpdateFields = Schema_GetComponentUpdateFields(Op.component_update.update.schema_type);
+		TMap<Schema_FieldId, uint32>& Fields = SentUpdates.FindOrAdd(Op.component_update.entity_id).AddDefaulted_GetRef();
+		for (Schema_FieldId FieldId : { FIELD_A, FIELD_B, FIELD_C })
+		{
+			if (Schema_GetUint32Count(UpdateFields, FieldId) > 0)
+			{
+				Fields.Add(FieldId, Schema_GetUint32(UpdateFields, FieldId));
+			}
+		}
+	}
+
+	return SentUpdates;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialComponentUpdateMergeTest, "SpatialGDK.NetDriver.MockConnection.ComponentUpdateMerging", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialComponentUpdateMergeTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	TArray<Worker_EntityId> EntityIds;
+	for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+	{
+		EntityIds.Add(FIRST_TEST_ENTITY_ID + i);
+		Server.CreateEntity(FIRST_TEST_ENTITY_ID + i, FVector::ZeroVector, { TEST_COMPONENT_ID });
+	}
+	if (!TestTrue(TEXT("The server is authoritative over every test entity"), Server.TickUntilAuthoritative(EntityIds, MAX_TICKS_TO_AUTHORITY)))
+	{
+		return false;
+	}
+
+	USpatialSender* Sender = Server.NetDriver->Sender;
+	FSpatialMockConnection* MockConnection = Server.NetDriver->Connection->GetMockConnection();
+
+	// Queues the given updates to every test entity, flushes them, and checks what each entity was sent.
+	auto CheckMerging = [this, &Server, &EntityIds, Sender, MockConnection](const TCHAR* What, const TArray<TMap<Schema_FieldId, uint32>>& Queued, const TArray<TMap<Schema_FieldId, uint32>>& Expected)
+	{
+		TakeSentUpdates(Server);
+		const int32 NumUpdatesBefore = MockConnection->GetStats().NumComponentUpdates;
+
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			for (const TMap<Schema_FieldId, uint32>& Fields : Queued)
+			{
+				Worker_ComponentUpdate Update = CreateTestUpdate(Fields);
+				Sender->QueueComponentUpdate(EntityId, Update);
+			}
+		}
+		Sender->FlushComponentUpdates();
+
+		if (!TestEqual(FString::Printf(TEXT("%s: the number of updates sent"), What), MockConnection->GetStats().NumComponentUpdates - NumUpdatesBefore, Expected.Num() * EntityIds.Num()))
+		{
+			return false;
+		}
+
+		const TMap<Worker_EntityId, TArray<TMap<Schema_FieldId, uint32>>> SentUpdates = TakeSentUpdates(Server);
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			const TArray<TMap<Schema_FieldId, uint32>>* Sent = SentUpdates.Find(EntityId);
+			if (!TestNotNull(FString::Printf(TEXT("%s: entity %lld is sent updates"), What, EntityId), Sent) ||
+				!TestEqual(FString::Printf(TEXT("%s: the number of updates sent to entity %lld"), What, EntityId), Sent->Num(), Expected.Num()))
+			{
+				return false;
+			}
+
+			for (int32 i = 0; i < Expected.Num(); i++)
+			{
+				if (!TestTrue(FString::Printf(TEXT("%s: update %d to entity %lld has the expected fields"), What, i, EntityId), (*Sent)[i].OrderIndependentCompareEqual(Expected[i])))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	};
+
+	// Updates to different fields are merged into one.
+	CheckMerging(TEXT("Non-overlapping updates"),
+		{ { { FIELD_A, 1 } }, { { FIELD_B, 2 } }, { { FIELD_C, 3 } } },
+		{ { { FIELD_A, 1 }, { FIELD_B, 2 }, { FIELD_C, 3 } } });
+
+	// An update which overwrites every field of the queued one replaces it.
+	CheckMerging(TEXT("Covering updates"),
+		{ { { FIELD_A, 4 } }, { { FIELD_A, 5 }, { FIELD_B, 6 } } },
+		{ { { FIELD_A, 5 }, { FIELD_B, 6 } } });
+
+	// An update which overwrites only some fields of the queued one can't be merged, so the queued one is sent first.
+	CheckMerging(TEXT("Partly overlapping updates"),
+		{ { { FIELD_A, 7 }, { FIELD_B, 8 } }, { { FIELD_B, 9 }, { FIELD_C, 10 } } },
+		{ { { FIELD_A, 7 }, { FIELD_B, 8 } }, { { FIELD_B, 9 }, { FIELD_C, 10 } } });
+
+	// Benchmark: several single-field updates to every entity in a tick, queued and merged against sent one by one.
+	const Schema_FieldId BenchmarkFields[] = { FIELD_A, FIELD_B, FIELD_C };
+	auto CreateBenchmarkUpdate = [&BenchmarkFields](int32 UpdateIndex)
+	{
+		return CreateTestUpdate({ { BenchmarkFields[UpdateIndex % ARRAY_COUNT(BenchmarkFields)], (uint32)UpdateIndex } });
+	};
+
+	TakeSentUpdates(Server);
+	int32 NumUpdatesBefore = MockConnection->GetStats().NumComponentUpdates;
+	const double QueuedStartTime = FPlatformTime::Seconds();
+	for (int32 UpdateIndex = 0; UpdateIndex < NUM_BENCHMARK_UPDATES_PER_ENTITY; UpdateIndex++)
+	{
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			Worker_ComponentUpdate Update = CreateBenchmarkUpdate(UpdateIndex);
+			Sender->QueueComponentUpdate(EntityId, Update);
+		}
+	}
+	Sender->FlushComponentUpdates();
+	const double QueuedSeconds = FPlatformTime::Seconds() - QueuedStartTime;
+	const int32 NumQueuedUpdatesSent = MockConnection->GetStats().NumComponentUpdates - NumUpdatesBefore;
+
+	TakeSentUpdates(Server);
+	NumUpdatesBefore = MockConnection->GetStats().NumComponentUpdates;
+	const double DirectStartTime = FPlatformTime::Seconds();
+	for (int32 UpdateIndex = 0; UpdateIndex < NUM_BENCHMARK_UPDATES_PER_ENTITY; UpdateIndex++)
+	{
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			Worker_ComponentUpdate Update = CreateBenchmarkUpdate(UpdateIndex);
+			Server.NetDriver->Connection->SendComponentUpdate(EntityId, &Update);
+		}
+	}
+	const double DirectSeconds = FPlatformTime::Seconds() - DirectStartTime;
+	const int32 NumDirectUpdatesSent = MockConnection->GetStats().NumComponentUpdates - NumUpdatesBefore;
+	TakeSentUpdates(Server);
+
+	TestEqual(TEXT("A tick's worth of single-field updates to an entity are sent as one"), NumQueuedUpdatesSent, NUM_TEST_ENTITIES);
+	TestEqual(TEXT("Without queueing every update is sent"), NumDirectUpdatesSent, NUM_TEST_ENTITIES * NUM_BENCHMARK_UPDATES_PER_ENTITY);
+
+	AddInfo(FString::Printf(TEXT("Queued %d single-field updates to each of %d entities in a tick: sent %d updates in %.3f ms. Sending them directly sent %d updates in %.3f ms."),
+		NUM_BENCHMARK_UPDATES_PER_ENTITY, NUM_TEST_ENTITIES, NumQueuedUpdatesSent, 1000.0 * QueuedSeconds, NumDirectUpdatesSent, 1000.0 * DirectSeconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
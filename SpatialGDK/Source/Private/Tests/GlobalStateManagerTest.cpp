@@ -0,0 +1,152 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/GlobalStateManager.h"
+#include "Interop/SpatialSender.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "Utils/SchemaUtils.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_SINGLETON_ENTITY_ID = 1 << 20;
+
+const int32 NUM_TEST_SINGLETONS = 500;
+const int32 MAX_TICKS_TO_AUTHORITY = 10;
+
+FString SingletonClassName(int32 Index)
+{
+	return FString::Printf(TEXT("/Script/SpatialGDKTest.TestSingleton%d"), Index);
+}
+
+// Creates the GSM entity with an empty singleton map, writable by this server.
+void CreateGlobalStateManager(FSpatialMockServerWorld& Server)
+{
+	const WorkerRequirementSet ServerRequirementSet = { WorkerAttributeSet{ SpatialConstants::ServerWorkerType } };
+
+	WriteAclMap ComponentWriteAcl;
+	ComponentWriteAcl.Add(SpatialConstants::POSITION_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(SpatialConstants::ENTITY_ACL_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID, ServerRequirementSet);
+
+	Worker_ComponentData GlobalStateManagerData = {};
+	GlobalStateManagerData.component_id = SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID;
+	GlobalStateManagerData.schema_type = Schema_CreateComponentData(SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID);
+
+	TArray<Worker_ComponentData> Components;
+	Components.Add(improbable::Position(improbable::Coordinates::FromFVector(FVector::ZeroVector)).CreatePositionData());
+	Components.Add(improbable::Metadata(TEXT("GlobalStateManager")).CreateMetadataData());
+	Components.Add(improbable::EntityAcl(ServerRequirementSet, ComponentWriteAcl).CreateEntityAclData());
+	Components.Add(GlobalStateManagerData);
+
+	const Worker_EntityId EntityId = SpatialConstants::GLOBAL_STATE_MANAGER;
+	Server.NetDriver->Connection->SendCreateEntityRequest(Components.Num(), Components.GetData(), &EntityId);
+}
+
+Worker_ComponentUpdate CreateSingletonMapUpdate(StringToEntityMap& SingletonNameToEntityId)
+{
+	Worker_ComponentUpdate Update = {};
+	Update.component_id = SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID;
+	Update.schema_type = Schema_CreateComponentUpdate(SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID);
+	improbable::AddStringToEntityMapToSchema(Schema_GetComponentUpdateFields(Update.schema_type), 1, SingletonNameToEntityId);
+	return Update;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGlobalStateManagerSingletonsTest, "SpatialGDK.NetDriver.MockConnection.GlobalStateManagerSingletons", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGlobalStateManagerSingletonsTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	CreateGlobalStateManager(Server);
+	if (!TestTrue(TEXT("The server is authoritative over the GSM"), Server.TickUntilAuthoritative({ SpatialConstants::GLOBAL_STATE_MANAGER }, MAX_TICKS_TO_AUTHORITY)) ||
+		!TestTrue(TEXT("The server can write the singleton map"), Server.NetDriver->StaticComponentView->HasAuthority(SpatialConstants::GLOBAL_STATE_MANAGER, SpatialConstants::GLOBAL_STATE_MANAGER_COMPONENT_ID)))
+	{
+		return false;
+	}
+
+	UGlobalStateManager* GlobalStateManager = Server.NetDriver->GlobalStateManager;
+
+	// The singleton classes are known to every worker up front, with no entities yet, as they would be after loading a snapshot.
+	StringToEntityMap SingletonNameToEntityId;
+	for (int32 i = 0; i < NUM_TEST_SINGLETONS; i++)
+	{
+		SingletonNameToEntityId.Add(SingletonClassName(i), SpatialConstants::INVALID_ENTITY_ID);
+	}
+
+	Worker_ComponentUpdate InitialUpdate = CreateSingletonMapUpdate(SingletonNameToEntityId);
+	const double ApplyStartTime = FPlatformTime::Seconds();
+	GlobalStateManager->ApplyUpdate(InitialUpdate);
+	const double ApplySeconds = FPlatformTime::Seconds() - ApplyStartTime;
+	Schema_DestroyComponentUpdate(InitialUpdate.schema_type);
+
+	// Every singleton gets its entity in the same tick, as happens when a server starts up.
+	const FSpatialMockConnectionStats StatsBefore = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	const double UpdateStartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NUM_TEST_SINGLETONS; i++)
+	{
+		GlobalStateManager->UpdateSingletonEntityId(SingletonClassName(i), FIRST_SINGLETON_ENTITY_ID + i);
+	}
+	GlobalStateManager->FlushSingletonEntityIds();
+	Server.NetDriver->Sender->FlushComponentUpdates();
+	const double UpdateSeconds = FPlatformTime::Seconds() - UpdateStartTime;
+	const FSpatialMockConnectionStats StatsAfter = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+
+	TestEqual(TEXT("All the singletons of a tick are sent in a single GSM update"), StatsAfter.NumComponentUpdates - StatsBefore.NumComponentUpdates, 1);
+	TestEqual(TEXT("The GSM update is accepted"), StatsAfter.NumRejectedComponentUpdates - StatsBefore.NumRejectedComponentUpdates, 0);
+
+	// Nothing changed since, so nothing more is sent.
+	GlobalStateManager->FlushSingletonEntityIds();
+	Server.NetDriver->Sender->FlushComponentUpdates();
+	TestEqual(TEXT("An unchanged map isn't sent again"), Server.NetDriver->Connection->GetMockConnection()->GetStats().NumComponentUpdates, StatsAfter.NumComponentUpdates);
+
+	const double LookupStartTime = FPlatformTime::Seconds();
+	int32 NumSingletonEntities = 0;
+	for (int32 i = 0; i < NUM_TEST_SINGLETONS; i++)
+	{
+		NumSingletonEntities += GlobalStateManager->IsSingletonEntity(FIRST_SINGLETON_ENTITY_ID + i) ? 1 : 0;
+	}
+	const double LookupSeconds = FPlatformTime::Seconds() - LookupStartTime;
+
+	TestEqual(TEXT("Every singleton entity is recognized"), NumSingletonEntities, NUM_TEST_SINGLETONS);
+	TestFalse(TEXT("Other entities aren't singletons"), GlobalStateManager->IsSingletonEntity(FIRST_SINGLETON_ENTITY_ID + NUM_TEST_SINGLETONS));
+
+	// For comparison, what it costs to build and send the whole map once for every singleton, as was done before updates were batched.
+	uint32 MapBytes = 0;
+	const double BaselineStartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NUM_TEST_SINGLETONS; i++)
+	{
+		SingletonNameToEntityId[SingletonClassName(i)] = FIRST_SINGLETON_ENTITY_ID + i;
+		Worker_ComponentUpdate Update = CreateSingletonMapUpdate(SingletonNameToEntityId);
+		MapBytes = Schema_GetWriteBufferLength(Schema_GetComponentUpdateFields(Update.schema_type));
+		Schema_DestroyComponentUpdate(Update.schema_type);
+	}
+	const double BaselineSeconds = FPlatformTime::Seconds() - BaselineStartTime;
+
+	AddInfo(FString::Printf(TEXT("Applied a map of %d singletons in %.3f ms, and looked each of them up by entity in %.3f ms."),
+		NUM_TEST_SINGLETONS, 1000.0 * ApplySeconds, 1000.0 * LookupSeconds));
+	AddInfo(FString::Printf(TEXT("Gave %d singletons their entities in %.3f ms, sending 1 update of %u bytes. Building one full map per singleton takes %.3f ms, for %d updates of up to %u bytes."),
+		NUM_TEST_SINGLETONS, 1000.0 * UpdateSeconds, MapBytes, 1000.0 * BaselineSeconds, NUM_TEST_SINGLETONS, MapBytes));
+
+	// The world isn't ticked again: the echoed update would have the server look for the test singletons' classes, which don't exist.
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
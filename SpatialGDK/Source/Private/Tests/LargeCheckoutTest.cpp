@@ -0,0 +1,105 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialDispatcher.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+const int32 NUM_CHECKOUT_ENTITIES = 10000;
+const float TEST_TIME_BUDGET_MS = 2.0f;
+
+struct FCheckoutTimings
+{
+	int32 NumProcessOpsCalls = 0;
+	double TotalSeconds = 0.0;
+	double MaxCallSeconds = 0.0;
+};
+
+// Has the mock add NumEntities entities in a single critical section, as the runtime does when a worker first checks out a
+// populated deployment, then calls ProcessOps as the net driver would once a tick until all of it has been processed.
+FCheckoutTimings ProcessCheckout(FSpatialMockServerWorld& Server, Worker_EntityId FirstEntityId, int32 NumEntities, float TimeBudgetMs)
+{
+	GetMutableDefault<USpatialGDKSettings>()->OpsProcessingTimeBudgetMs = TimeBudgetMs;
+
+	FSpatialMockConnection* MockConnection = Server.NetDriver->Connection->GetMockConnection();
+	MockConnection->BeginCheckout();
+	for (int32 i = 0; i < NumEntities; i++)
+	{
+		Server.CreateEntity(FirstEntityId + i, FVector(i * 100.0f, 0.0f, 0.0f));
+	}
+	MockConnection->EndCheckout();
+
+	USpatialDispatcher* Dispatcher = Server.NetDriver->Dispatcher;
+	Dispatcher->QueueOpLists(Server.NetDriver->Connection->GetOpLists());
+
+	FCheckoutTimings Timings;
+	while (Dispatcher->HasQueuedOpLists())
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Dispatcher->ProcessOps();
+		const double CallSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Timings.NumProcessOpsCalls++;
+		Timings.TotalSeconds += CallSeconds;
+		Timings.MaxCallSeconds = FMath::Max(Timings.MaxCallSeconds, CallSeconds);
+	}
+
+	return Timings;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialLargeCheckoutTest, "SpatialGDK.Dispatcher.LargeCheckout", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialLargeCheckoutTest::RunTest(const FString& Parameters)
+{
+	// The server world puts the time budget back as it was when it is destroyed.
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const FCheckoutTimings Budgeted = ProcessCheckout(Server, FIRST_TEST_ENTITY_ID, NUM_CHECKOUT_ENTITIES, TEST_TIME_BUDGET_MS);
+	const FCheckoutTimings Unbudgeted = ProcessCheckout(Server, FIRST_TEST_ENTITY_ID + NUM_CHECKOUT_ENTITIES, NUM_CHECKOUT_ENTITIES, 0.0f);
+
+	// The whole checkout is one critical section, so it can only have been spread over several ticks by yielding inside it.
+	TestTrue(TEXT("A checkout over the time budget is spread over several ticks"), Budgeted.NumProcessOpsCalls > 1);
+	TestEqual(TEXT("Without a time budget a checkout is processed in a single tick"), Unbudgeted.NumProcessOpsCalls, 1);
+	TestTrue(TEXT("No tick spends much longer than the time budget processing a checkout"), Budgeted.MaxCallSeconds < Unbudgeted.MaxCallSeconds / 2.0);
+
+	// Each checkout ends up in the view whole, however many ticks it took.
+	USpatialStaticComponentView* StaticComponentView = Server.NetDriver->StaticComponentView;
+	for (int32 i = 0; i < 2 * NUM_CHECKOUT_ENTITIES; i++)
+	{
+		const Worker_EntityId EntityId = FIRST_TEST_ENTITY_ID + i;
+		if (!TestNotNull(FString::Printf(TEXT("Entity %lld has a Position"), EntityId), StaticComponentView->GetComponentData<improbable::Position>(EntityId)) ||
+			!TestTrue(FString::Printf(TEXT("The server is authoritative over the Position of entity %lld"), EntityId), StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID)))
+		{
+			return false;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("A checkout of %d entities took %.3f ms in a single tick without a time budget."),
+		NUM_CHECKOUT_ENTITIES, 1000.0 * Unbudgeted.TotalSeconds));
+	AddInfo(FString::Printf(TEXT("With a %.1f ms budget it took %.3f ms over %d ticks, the longest of them %.3f ms."),
+		TEST_TIME_BUDGET_MS, 1000.0 * Budgeted.TotalSeconds, Budgeted.NumProcessOpsCalls, 1000.0 * Budgeted.MaxCallSeconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
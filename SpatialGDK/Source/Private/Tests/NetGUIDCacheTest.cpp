@@ -0,0 +1,150 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "EngineClasses/SpatialNetDriver.h"
+#include "EngineClasses/SpatialPackageMapClient.h"
+#include "SpatialConstants.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "UObject/improbable/UnrealObjectRef.h"
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+const int32 NUM_TEST_OBJECTS = 10000;
+const int32 NUM_LOOKUP_ROUNDS = 10;
+
+const TCHAR* TEST_PACKAGE_PATH = TEXT("/Game/Maps/NetGUIDCacheTestMap");
+
+// Refs as they arrive from the network for stably named objects in a level: a path, with the level's package as the outer.
+FUnrealObjectRef CreateStablyNamedRef(const FString& Path, const FUnrealObjectRef& OuterRef)
+{
+	FUnrealObjectRef ObjectRef(0, 0);
+	ObjectRef.Path = Path;
+	ObjectRef.Outer = OuterRef;
+	return ObjectRef;
+}
+
+FUnrealObjectRef CreatePackageRef()
+{
+	return CreateStablyNamedRef(TEST_PACKAGE_PATH, SpatialConstants::NULL_OBJECT_REF);
+}
+
+FString TestObjectPath(int32 Index)
+{
+	return FString::Printf(TEXT("NetGUIDCacheTestMap:PersistentLevel.TestObject_%d"), Index);
+}
+
+// What the cache used to do for each lookup: remap the paths of the ref and its outers, then look the whole ref up.
+FUnrealObjectRef NetworkRemapObjectRefPaths(UNetDriver* NetDriver, const FUnrealObjectRef& ObjectRef)
+{
+	FUnrealObjectRef RemappedObjectRef = ObjectRef;
+	if (RemappedObjectRef.Path.IsSet())
+	{
+		FString RemappedPath = RemappedObjectRef.Path.GetValue();
+		GEngine->NetworkRemapPath(NetDriver, RemappedPath, true);
+		RemappedObjectRef.Path = RemappedPath;
+	}
+	if (RemappedObjectRef.Outer.IsSet())
+	{
+		RemappedObjectRef.Outer = NetworkRemapObjectRefPaths(NetDriver, RemappedObjectRef.Outer.GetValue());
+	}
+	return RemappedObjectRef;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialNetGUIDCacheTest, "SpatialGDK.PackageMap.NetGUIDCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialNetGUIDCacheTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	USpatialPackageMapClient* PackageMap = Server.NetDriver->PackageMap;
+	const FUnrealObjectRef PackageRef = CreatePackageRef();
+
+	// A ref whose outer is on an entity this worker hasn't checked out can't be resolved, and mustn't be mistaken for a top level object of the same name.
+	const FUnrealObjectRef UnresolvedOuterRef = CreateStablyNamedRef(TestObjectPath(0), FUnrealObjectRef(FIRST_TEST_ENTITY_ID, 0));
+	const FUnrealObjectRef TopLevelRef = CreateStablyNamedRef(TestObjectPath(0), SpatialConstants::NULL_OBJECT_REF);
+	TestFalse(TEXT("A ref with an unresolved outer isn't resolved"), PackageMap->GetNetGUIDFromUnrealObjectRef(UnresolvedOuterRef).IsValid());
+	const FNetworkGUID TopLevelGUID = PackageMap->GetNetGUIDFromUnrealObjectRef(TopLevelRef);
+	TestTrue(TEXT("A top level ref is resolved"), TopLevelGUID.IsValid());
+	TestFalse(TEXT("A ref with an unresolved outer doesn't resolve to the top level object of the same name"), PackageMap->GetNetGUIDFromUnrealObjectRef(UnresolvedOuterRef).IsValid());
+
+	// Refs are resolved the first time they are seen, to the same NetGUID every time, and map back to the same path.
+	TArray<FUnrealObjectRef> ObjectRefs;
+	for (int32 i = 0; i < NUM_TEST_OBJECTS; i++)
+	{
+		ObjectRefs.Add(CreateStablyNamedRef(TestObjectPath(i), PackageRef));
+	}
+
+	TArray<FNetworkGUID> NetGUIDs;
+	const double RegisterStartTime = FPlatformTime::Seconds();
+	for (const FUnrealObjectRef& ObjectRef : ObjectRefs)
+	{
+		NetGUIDs.Add(PackageMap->GetNetGUIDFromUnrealObjectRef(ObjectRef));
+	}
+	const double RegisterSeconds = FPlatformTime::Seconds() - RegisterStartTime;
+
+	TSet<FNetworkGUID> UniqueNetGUIDs(NetGUIDs);
+	TestEqual(TEXT("Every object gets its own NetGUID"), UniqueNetGUIDs.Num(), NUM_TEST_OBJECTS);
+	TestFalse(TEXT("An object in a level doesn't get the NetGUID of a top level object of the same name"), UniqueNetGUIDs.Contains(TopLevelGUID));
+
+	for (int32 i = 0; i < NUM_TEST_OBJECTS; i++)
+	{
+		const FUnrealObjectRef RegisteredRef = PackageMap->GetUnrealObjectRefFromNetGUID(NetGUIDs[i]);
+		if (!TestTrue(FString::Printf(TEXT("Object %d maps back to its path"), i), RegisteredRef.Path.IsSet() && RegisteredRef.Path.GetValue() == TestObjectPath(i)))
+		{
+			return false;
+		}
+	}
+
+	// Benchmark: looking up refs that are already cached, against remapping their paths and looking up the whole ref, as was done before.
+	int32 NumMismatches = 0;
+	const double LookupStartTime = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < NUM_LOOKUP_ROUNDS; Round++)
+	{
+		for (int32 i = 0; i < NUM_TEST_OBJECTS; i++)
+		{
+			NumMismatches += PackageMap->GetNetGUIDFromUnrealObjectRef(ObjectRefs[i]) == NetGUIDs[i] ? 0 : 1;
+		}
+	}
+	const double LookupSeconds = FPlatformTime::Seconds() - LookupStartTime;
+	TestEqual(TEXT("Cached refs resolve to the NetGUIDs they were first given"), NumMismatches, 0);
+
+	TMap<FUnrealObjectRef, FNetworkGUID> BaselineRefToNetGUID;
+	for (int32 i = 0; i < NUM_TEST_OBJECTS; i++)
+	{
+		BaselineRefToNetGUID.Add(NetworkRemapObjectRefPaths(Server.NetDriver, ObjectRefs[i]), NetGUIDs[i]);
+	}
+
+	int32 NumBaselineHits = 0;
+	const double BaselineStartTime = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < NUM_LOOKUP_ROUNDS; Round++)
+	{
+		for (int32 i = 0; i < NUM_TEST_OBJECTS; i++)
+		{
+			NumBaselineHits += BaselineRefToNetGUID.Contains(NetworkRemapObjectRefPaths(Server.NetDriver, ObjectRefs[i])) ? 1 : 0;
+		}
+	}
+	const double BaselineSeconds = FPlatformTime::Seconds() - BaselineStartTime;
+	TestEqual(TEXT("The baseline finds every ref"), NumBaselineHits, NUM_LOOKUP_ROUNDS * NUM_TEST_OBJECTS);
+
+	AddInfo(FString::Printf(TEXT("Resolved %d new stably named refs in %.3f ms."), NUM_TEST_OBJECTS, 1000.0 * RegisterSeconds));
+	AddInfo(FString::Printf(TEXT("Looked up %d cached refs in %.3f ms. Remapping their paths and looking up whole refs took %.3f ms."),
+		NUM_LOOKUP_ROUNDS * NUM_TEST_OBJECTS, 1000.0 * LookupSeconds, 1000.0 * BaselineSeconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,310 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialOpList.h"
+#include "Interop/SpatialTypebindingManager.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "Utils/SchemaUtils.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+// Stand-ins for a class's generated component, and one whose class hasn't been bound yet so has no layout.
+const Worker_ComponentId TEST_COMPONENT_ID = 1000000;
+const Worker_ComponentId TEST_UNBOUND_COMPONENT_ID = 1000001;
+
+// The test component's fields, as a bound class's would be.
+const Schema_FieldId NAME_FIELD_ID = 1;
+const Schema_FieldId TAG_FIELD_ID = 2;
+const Schema_FieldId TARGET_FIELD_ID = 3;
+const Schema_FieldId SCORE_FIELD_ID = 4;
+const Schema_FieldId ALIASES_FIELD_ID = 5;
+const int32 NUM_TEST_ALIASES = 4;
+
+const int32 NUM_TEST_ENTITIES = 1000;
+const int32 NUM_TEST_UPDATES = 10;
+
+FString TestName(int32 EntityIndex, int32 Update)
+{
+	return FString::Printf(TEXT("TestPlayer_%d_%d"), EntityIndex, Update);
+}
+
+FString TestAlias(int32 EntityIndex, int32 AliasIndex)
+{
+	return FString::Printf(TEXT("TestAlias_%d_%d"), EntityIndex, AliasIndex);
+}
+
+FUnrealObjectRef TestTarget(int32 EntityIndex, int32 Update)
+{
+	FUnrealObjectRef ObjectRef(FIRST_TEST_ENTITY_ID + (EntityIndex + Update) % NUM_TEST_ENTITIES, 0);
+	// Stably named refs carry a path and an outer, which are the expensive part to read.
+	if (Update % 2 == 0)
+	{
+		FUnrealObjectRef OuterRef(0, 0);
+		OuterRef.Path = FString(TEXT("/Game/Maps/TestMap"));
+		ObjectRef.Path = FString::Printf(TEXT("TestTarget_%d"), Update);
+		ObjectRef.Outer = OuterRef;
+	}
+	return ObjectRef;
+}
+
+void WriteTestFields(Schema_Object* Object, int32 EntityIndex, int32 Update)
+{
+	improbable::AddStringToSchema(Object, NAME_FIELD_ID, TestName(EntityIndex, Update));
+	improbable::AddObjectRefToSchema(Object, TARGET_FIELD_ID, TestTarget(EntityIndex, Update));
+	Schema_AddInt32(Object, SCORE_FIELD_ID, Update);
+}
+
+Worker_ComponentData CreateTestComponentData(Worker_ComponentId ComponentId, int32 EntityIndex)
+{
+	Worker_ComponentData Data = {};
+	Data.component_id = ComponentId;
+	Data.schema_type = Schema_CreateComponentData(ComponentId);
+	Schema_Object* Object = Schema_GetComponentDataFields(Data.schema_type);
+
+	WriteTestFields(Object, EntityIndex, 0);
+	improbable::AddStringToSchema(Object, TAG_FIELD_ID, TEXT("TestTag"));
+	for (int32 i = 0; i < NUM_TEST_ALIASES; i++)
+	{
+		improbable::AddStringToSchema(Object, ALIASES_FIELD_ID, TestAlias(EntityIndex, i));
+	}
+	return Data;
+}
+
+// Every other update clears the aliases, as an update which empties an array does.
+Worker_ComponentUpdate CreateTestComponentUpdate(int32 EntityIndex, int32 Update)
+{
+	Worker_ComponentUpdate ComponentUpdate = {};
+	ComponentUpdate.component_id = TEST_COMPONENT_ID;
+	ComponentUpdate.schema_type = Schema_CreateComponentUpdate(TEST_COMPONENT_ID);
+	WriteTestFields(Schema_GetComponentUpdateFields(ComponentUpdate.schema_type), EntityIndex, Update);
+	if (Update % 2 == 1)
+	{
+		Schema_AddComponentUpdateClearedField(ComponentUpdate.schema_type, ALIASES_FIELD_ID);
+	}
+	return ComponentUpdate;
+}
+
+// Creates the test entities, then updates each of them several times, as a server replicating to this worker would.
+// Returns how long fetching and decoding the resulting op lists took.
+double RunTestTraffic(const FSpatialComponentLayouts* ComponentLayouts, TArray<TUniquePtr<FSpatialOpList>>& OutOpLists)
+{
+	FSpatialMockConnection Connection(SpatialConstants::ServerWorkerType, TEXT("OpListDecodeWorker"));
+	double DecodeSeconds = 0.0;
+
+	auto TakeOpList = [&Connection, ComponentLayouts, &OutOpLists, &DecodeSeconds]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		TUniquePtr<FSpatialOpList> OpList = Connection.GetOpList(ComponentLayouts);
+		DecodeSeconds += FPlatformTime::Seconds() - StartTime;
+		if (OpList.IsValid())
+		{
+			OutOpLists.Add(MoveTemp(OpList));
+		}
+	};
+
+	const WorkerRequirementSet ServerRequirementSet = { WorkerAttributeSet{ SpatialConstants::ServerWorkerType } };
+	WriteAclMap ComponentWriteAcl;
+	ComponentWriteAcl.Add(SpatialConstants::POSITION_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(SpatialConstants::ENTITY_ACL_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(TEST_COMPONENT_ID, ServerRequirementSet);
+
+	for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+	{
+		const Worker_EntityId EntityId = FIRST_TEST_ENTITY_ID + i;
+
+		TArray<Worker_ComponentData> Components;
+		Components.Add(improbable::Position(improbable::Coordinates::FromFVector(FVector::ZeroVector)).CreatePositionData());
+		Components.Add(improbable::Metadata(TEXT("SpatialOpListDecodeTestEntity")).CreateMetadataData());
+		Components.Add(improbable::EntityAcl(ServerRequirementSet, ComponentWriteAcl).CreateEntityAclData());
+		Components.Add(CreateTestComponentData(TEST_COMPONENT_ID, i));
+		Components.Add(CreateTestComponentData(TEST_UNBOUND_COMPONENT_ID, i));
+		Connection.SendCreateEntityRequest(Components.Num(), Components.GetData(), &EntityId);
+	}
+	TakeOpList();
+
+	for (int32 Update = 1; Update <= NUM_TEST_UPDATES; Update++)
+	{
+		for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+		{
+			Worker_ComponentUpdate ComponentUpdate = CreateTestComponentUpdate(i, Update);
+			Connection.SendComponentUpdate(FIRST_TEST_ENTITY_ID + i, &ComponentUpdate);
+		}
+		TakeOpList();
+	}
+
+	return DecodeSeconds;
+}
+
+Schema_Object* GetFields(const Worker_Op& Op)
+{
+	return Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT ? Schema_GetComponentDataFields(Op.add_component.data.schema_type) : Schema_GetComponentUpdateFields(Op.component_update.update.schema_type);
+}
+
+Worker_ComponentId GetComponentId(const Worker_Op& Op)
+{
+	return Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT ? Op.add_component.data.component_id : Op.component_update.update.component_id;
+}
+
+bool IsTestComponentOp(const Worker_Op& Op)
+{
+	return (Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT || Op.op_type == WORKER_OP_TYPE_COMPONENT_UPDATE) && GetComponentId(Op) == TEST_COMPONENT_ID;
+}
+
+// Reads the test component's strings and object refs straight from schema, as ComponentReader does on the game thread for
+// components which weren't decoded. Returns a count of what was read, so the reads can't be optimized away.
+int32 ReadTestFieldsFromSchema(const TArray<TUniquePtr<FSpatialOpList>>& OpLists)
+{
+	int32 NumRead = 0;
+	for (const TUniquePtr<FSpatialOpList>& OpList : OpLists)
+	{
+		for (uint32 i = 0; i < OpList->OpList->op_count; i++)
+		{
+			const Worker_Op& Op = OpList->OpList->ops[i];
+			if (!IsTestComponentOp(Op))
+			{
+				continue;
+			}
+
+			Schema_Object* Object = GetFields(Op);
+			NumRead += improbable::IndexStringFromSchema(Object, NAME_FIELD_ID, 0).Len();
+			NumRead += improbable::IndexObjectRefFromSchema(Object, TARGET_FIELD_ID, 0).Path.IsSet() ? 1 : 0;
+			for (uint32 j = 0; j < Schema_GetBytesCount(Object, ALIASES_FIELD_ID); j++)
+			{
+				NumRead += improbable::IndexStringFromSchema(Object, ALIASES_FIELD_ID, j).Len();
+			}
+		}
+	}
+	return NumRead;
+}
+
+// The same reads, from the fields decoded ahead of dispatch.
+int32 ReadTestFieldsFromDecoded(const TArray<TUniquePtr<FSpatialOpList>>& OpLists)
+{
+	int32 NumRead = 0;
+	for (const TUniquePtr<FSpatialOpList>& OpList : OpLists)
+	{
+		for (const auto& DecodedPair : OpList->DecodedGeneratedComponents)
+		{
+			const improbable::GeneratedComponentFields& Fields = *DecodedPair.Value;
+			NumRead += Fields.Strings[NAME_FIELD_ID][0].Len();
+			NumRead += Fields.ObjectRefs[TARGET_FIELD_ID][0].Path.IsSet() ? 1 : 0;
+			if (const TArray<FString>* Aliases = Fields.Strings.Find(ALIASES_FIELD_ID))
+			{
+				for (const FString& Alias : *Aliases)
+				{
+					NumRead += Alias.Len();
+				}
+			}
+		}
+	}
+	return NumRead;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialOpListDecodeTest, "SpatialGDK.Dispatcher.OpListDecode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialOpListDecodeTest::RunTest(const FString& Parameters)
+{
+	FSpatialComponentLayouts ComponentLayouts;
+	ComponentLayouts.Add(TEST_COMPONENT_ID, { ESchemaPropertyKind::String, ESchemaPropertyKind::Name, ESchemaPropertyKind::Object, ESchemaPropertyKind::Int32, ESchemaPropertyKind::String });
+
+	// The same traffic, decoded with only the static components, and then with the generated ones as well.
+	TArray<TUniquePtr<FSpatialOpList>> StaticOpLists;
+	const double StaticDecodeSeconds = RunTestTraffic(nullptr, StaticOpLists);
+	TArray<TUniquePtr<FSpatialOpList>> DecodedOpLists;
+	const double FullDecodeSeconds = RunTestTraffic(&ComponentLayouts, DecodedOpLists);
+
+	if (!TestEqual(TEXT("Every update is in its own op list"), DecodedOpLists.Num(), NUM_TEST_UPDATES + 1))
+	{
+		return false;
+	}
+
+	int32 NumDecoded = 0;
+	for (int32 Update = 0; Update <= NUM_TEST_UPDATES; Update++)
+	{
+		const FSpatialOpList& OpList = *DecodedOpLists[Update];
+		TestEqual(TEXT("Static components are still decoded as before"), OpList.DecodedComponents.Num() + OpList.DecodedUpdates.Num(), StaticOpLists[Update]->DecodedComponents.Num() + StaticOpLists[Update]->DecodedUpdates.Num());
+
+		for (uint32 i = 0; i < OpList.OpList->op_count; i++)
+		{
+			const Worker_Op& Op = OpList.OpList->ops[i];
+			const TSharedPtr<improbable::GeneratedComponentFields>* Decoded = OpList.DecodedGeneratedComponents.Find(i);
+			if (!IsTestComponentOp(Op))
+			{
+				if (!TestNull(TEXT("Only components with a layout are decoded"), Decoded))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (!TestNotNull(TEXT("Every op for a component with a layout is decoded"), Decoded))
+			{
+				return false;
+			}
+			NumDecoded++;
+
+			const improbable::GeneratedComponentFields& Fields = **Decoded;
+			const Worker_EntityId EntityId = Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT ? Op.add_component.entity_id : Op.component_update.entity_id;
+			const int32 EntityIndex = EntityId - FIRST_TEST_ENTITY_ID;
+			const TArray<FString>* Names = Fields.Strings.Find(NAME_FIELD_ID);
+			const TArray<FUnrealObjectRef>* Targets = Fields.ObjectRefs.Find(TARGET_FIELD_ID);
+
+			if (!TestTrue(TEXT("Every field present is listed"), Fields.FieldIds.Contains(NAME_FIELD_ID) && Fields.FieldIds.Contains(TARGET_FIELD_ID) && Fields.FieldIds.Contains(SCORE_FIELD_ID)) ||
+				!TestTrue(TEXT("Strings are decoded"), Names != nullptr && Names->Num() == 1 && (*Names)[0] == TestName(EntityIndex, Update)) ||
+				!TestTrue(TEXT("Object refs are decoded with their path and outer"), Targets != nullptr && Targets->Num() == 1 && (*Targets)[0] == TestTarget(EntityIndex, Update)) ||
+				!TestFalse(TEXT("Other kinds of field are left to be read when they are applied"), Fields.Strings.Contains(SCORE_FIELD_ID) || Fields.ObjectRefs.Contains(SCORE_FIELD_ID)))
+			{
+				return false;
+			}
+
+			if (Op.op_type == WORKER_OP_TYPE_ADD_COMPONENT)
+			{
+				const TArray<FString>* Tags = Fields.Strings.Find(TAG_FIELD_ID);
+				const TArray<FString>* Aliases = Fields.Strings.Find(ALIASES_FIELD_ID);
+				if (!TestTrue(TEXT("Names are decoded as strings"), Tags != nullptr && Tags->Num() == 1 && (*Tags)[0] == TEXT("TestTag")) ||
+					!TestTrue(TEXT("Every element of an array is decoded"), Aliases != nullptr && Aliases->Num() == NUM_TEST_ALIASES && (*Aliases)[NUM_TEST_ALIASES - 1] == TestAlias(EntityIndex, NUM_TEST_ALIASES - 1)))
+				{
+					return false;
+				}
+			}
+			else if (!TestEqual(TEXT("Cleared fields are listed"), Fields.ClearedFieldIds.Contains(ALIASES_FIELD_ID), Update % 2 == 1))
+			{
+				return false;
+			}
+		}
+	}
+	TestEqual(TEXT("Every op for the test component is decoded"), NumDecoded, NUM_TEST_ENTITIES * (NUM_TEST_UPDATES + 1));
+
+	// What the game thread saves: converting the strings and object refs as they are applied, against finding them already converted.
+	const double SchemaReadStartTime = FPlatformTime::Seconds();
+	const int32 NumReadFromSchema = ReadTestFieldsFromSchema(DecodedOpLists);
+	const double SchemaReadSeconds = FPlatformTime::Seconds() - SchemaReadStartTime;
+
+	const double DecodedReadStartTime = FPlatformTime::Seconds();
+	const int32 NumReadFromDecoded = ReadTestFieldsFromDecoded(DecodedOpLists);
+	const double DecodedReadSeconds = FPlatformTime::Seconds() - DecodedReadStartTime;
+
+	TestEqual(TEXT("The decoded fields hold what the schema objects do"), NumReadFromDecoded, NumReadFromSchema);
+
+	AddInfo(FString::Printf(TEXT("Fetched and decoded %d op lists in %.3f ms with only static components decoded, and %.3f ms with %d generated components and updates decoded as well. This is done on the op list thread."),
+		DecodedOpLists.Num(), 1000.0 * StaticDecodeSeconds, 1000.0 * FullDecodeSeconds, NumDecoded));
+	AddInfo(FString::Printf(TEXT("Reading their strings and object refs on the game thread took %.3f ms from schema, and %.3f ms once decoded."),
+		1000.0 * SchemaReadSeconds, 1000.0 * DecodedReadSeconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,173 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/OpListRecording.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/SpatialDispatcher.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+const int32 NUM_TEST_ENTITIES = 1000;
+const int32 NUM_TEST_MOVES = 10;
+// Every this many entities is deleted at the end of the recording.
+const int32 DELETED_ENTITY_STRIDE = 10;
+
+FVector TestLocation(int32 EntityIndex, int32 Move)
+{
+	return FVector(EntityIndex * 100.0f, Move * 100.0f, 0.0f);
+}
+
+// Records a server creating the test entities, moving each of them several times, then deleting some of them.
+// Every op list is taken from a mock connection as soon as the requests that caused it have been sent.
+void RecordTestOpLists(const FString& FilePath)
+{
+	FSpatialMockConnection Connection(SpatialConstants::ServerWorkerType, TEXT("OpListRecordingWorker"));
+	FSpatialOpListRecorder Recorder(FilePath, Connection.GetWorkerId());
+
+	auto RecordOpList = [&Connection, &Recorder]()
+	{
+		if (TUniquePtr<FSpatialOpList> OpList = Connection.GetOpList())
+		{
+			Recorder.RecordOpList(*OpList->OpList);
+		}
+	};
+
+	const WorkerRequirementSet ServerRequirementSet = { WorkerAttributeSet{ SpatialConstants::ServerWorkerType } };
+	WriteAclMap ComponentWriteAcl;
+	ComponentWriteAcl.Add(SpatialConstants::POSITION_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(SpatialConstants::ENTITY_ACL_COMPONENT_ID, ServerRequirementSet);
+
+	for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+	{
+		const Worker_EntityId EntityId = FIRST_TEST_ENTITY_ID + i;
+
+		TArray<Worker_ComponentData> Components;
+		Components.Add(improbable::Position(improbable::Coordinates::FromFVector(TestLocation(i, 0))).CreatePositionData());
+		Components.Add(improbable::Metadata(TEXT("SpatialOpListReplayTestEntity")).CreateMetadataData());
+		Components.Add(improbable::EntityAcl(ServerRequirementSet, ComponentWriteAcl).CreateEntityAclData());
+		Connection.SendCreateEntityRequest(Components.Num(), Components.GetData(), &EntityId);
+	}
+	RecordOpList();
+
+	for (int32 Move = 1; Move <= NUM_TEST_MOVES; Move++)
+	{
+		for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+		{
+			Worker_ComponentUpdate Update = improbable::Position::CreatePositionUpdate(improbable::Coordinates::FromFVector(TestLocation(i, Move)));
+			Connection.SendComponentUpdate(FIRST_TEST_ENTITY_ID + i, &Update);
+		}
+		RecordOpList();
+	}
+
+	for (int32 i = 0; i < NUM_TEST_ENTITIES; i += DELETED_ENTITY_STRIDE)
+	{
+		Connection.SendDeleteEntityRequest(FIRST_TEST_ENTITY_ID + i);
+	}
+	RecordOpList();
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialOpListReplayTest, "SpatialGDK.Dispatcher.OpListReplay", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialOpListReplayTest::RunTest(const FString& Parameters)
+{
+	const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("SpatialOpListReplayTest.oplist"));
+	ON_SCOPE_EXIT
+	{
+		IFileManager::Get().Delete(*FilePath);
+	};
+
+	// Every queued op is processed by a single ProcessOps when there is no time budget.
+	USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+	const float OldOpsProcessingTimeBudgetMs = Settings->OpsProcessingTimeBudgetMs;
+	ON_SCOPE_EXIT
+	{
+		Settings->OpsProcessingTimeBudgetMs = OldOpsProcessingTimeBudgetMs;
+	};
+	Settings->OpsProcessingTimeBudgetMs = 0.0f;
+
+	RecordTestOpLists(FilePath);
+
+	FSpatialOpListReplayer Replayer(FilePath);
+	if (!TestTrue(TEXT("The recording can be opened for replay"), Replayer.IsValid()))
+	{
+		return false;
+	}
+
+	const double ReadStartTime = FPlatformTime::Seconds();
+	TArray<TUniquePtr<FSpatialOpList>> OpLists;
+	int32 NumOps = 0;
+	while (TUniquePtr<FSpatialOpList> OpList = Replayer.ReadNextOpList())
+	{
+		NumOps += OpList->OpList->op_count;
+		OpLists.Add(MoveTemp(OpList));
+	}
+	const double ReadSeconds = FPlatformTime::Seconds() - ReadStartTime;
+
+	TestTrue(TEXT("The whole recording is read back"), Replayer.IsFinished());
+	TestEqual(TEXT("Every recorded op list is replayed"), OpLists.Num(), NUM_TEST_MOVES + 2);
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const int32 NumOpLists = OpLists.Num();
+	const double DispatchStartTime = FPlatformTime::Seconds();
+	Server.NetDriver->Dispatcher->QueueOpLists(MoveTemp(OpLists));
+	Server.NetDriver->Dispatcher->ProcessOps();
+	const double DispatchSeconds = FPlatformTime::Seconds() - DispatchStartTime;
+
+	// The view ends up as the recording worker's did: every entity it kept is at its last location, and this server has authority over it.
+	USpatialStaticComponentView* StaticComponentView = Server.NetDriver->StaticComponentView;
+	for (int32 i = 0; i < NUM_TEST_ENTITIES; i++)
+	{
+		const Worker_EntityId EntityId = FIRST_TEST_ENTITY_ID + i;
+		const improbable::Position* Position = StaticComponentView->GetComponentData<improbable::Position>(EntityId);
+
+		if (i % DELETED_ENTITY_STRIDE == 0)
+		{
+			if (!TestNull(FString::Printf(TEXT("Deleted entity %lld has left the view"), EntityId), Position))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if (!TestNotNull(FString::Printf(TEXT("Entity %lld has a Position"), EntityId), Position) ||
+			!TestEqual(FString::Printf(TEXT("Entity %lld is at its last recorded location"), EntityId), improbable::Coordinates::ToFVector(Position->Coords), TestLocation(i, NUM_TEST_MOVES)) ||
+			!TestNotNull(FString::Printf(TEXT("Entity %lld has Metadata"), EntityId), StaticComponentView->GetComponentData<improbable::Metadata>(EntityId)) ||
+			!TestTrue(FString::Printf(TEXT("The server is authoritative over the Position of entity %lld"), EntityId), StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID)))
+		{
+			return false;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Read and decoded %d op lists (%d ops) in %.3f seconds (%.1f ops per second)."),
+		NumOpLists, NumOps, ReadSeconds, NumOps / FMath::Max(ReadSeconds, SMALL_NUMBER)));
+	AddInfo(FString::Printf(TEXT("Dispatched %d ops in %.3f seconds (%.1f ops per second)."),
+		NumOps, DispatchSeconds, NumOps / FMath::Max(DispatchSeconds, SMALL_NUMBER)));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
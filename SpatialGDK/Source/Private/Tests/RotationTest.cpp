@@ -0,0 +1,89 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+
+#include "Schema/Rotation.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+const int32 NUM_TEST_ROTATIONS = 10000;
+const int32 RANDOM_SEED = 0x207A7E;
+
+// Half of one 16-bit step, plus what a float loses holding angles of a few hundred degrees.
+const float MAX_ROTATION_ERROR = 180.0f / 65536.0f + KINDA_SMALL_NUMBER;
+
+// FRotator::Equals compares each axis after normalizing the difference, so angles that wrapped around still match.
+bool CheckRoundTrip(FAutomationTestBase& Test, const FRotator& Source)
+{
+	improbable::Rotation Written(Source);
+	Worker_ComponentData Data = Written.CreateRotationData();
+	improbable::Rotation FromData(Data);
+	Schema_DestroyComponentData(Data.schema_type);
+
+	improbable::Rotation FromUpdate;
+	Worker_ComponentUpdate Update = Written.CreateRotationUpdate();
+	FromUpdate.ApplyComponentUpdate(Update);
+	Schema_DestroyComponentUpdate(Update.schema_type);
+
+	const FRotator DataRotator = FromData.ToFRotator();
+	const FRotator UpdateRotator = FromUpdate.ToFRotator();
+	return Test.TestTrue(FString::Printf(TEXT("%s is within %f degrees after a round trip through component data, read back as %s"), *Source.ToString(), MAX_ROTATION_ERROR, *DataRotator.ToString()),
+			DataRotator.Equals(Source, MAX_ROTATION_ERROR))
+		&& Test.TestTrue(FString::Printf(TEXT("%s is read back the same from a component update"), *Source.ToString()),
+			UpdateRotator == DataRotator);
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRotationPackErrorBoundTest, "SpatialGDK.Schema.Rotation.PackErrorBound", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRotationPackErrorBoundTest::RunTest(const FString& Parameters)
+{
+	// The axis wraps, and the angles either side of a step boundary.
+	const float Step = 360.0f / 65536.0f;
+	const TArray<FRotator> EdgeCases = {
+		FRotator(0.0f, 0.0f, 0.0f),
+		FRotator(359.999f, -0.001f, 360.0f),
+		FRotator(-180.0f, 180.0f, 90.0f),
+		FRotator(Step * 0.5f, Step * 0.49f, Step * 0.51f),
+		FRotator(-Step * 0.5f, 360.0f - Step * 0.49f, 1000.0f),
+	};
+
+	for (const FRotator& Rotator : EdgeCases)
+	{
+		if (!CheckRoundTrip(*this, Rotator))
+		{
+			return false;
+		}
+	}
+
+	FRandomStream Random(RANDOM_SEED);
+	for (int32 i = 0; i < NUM_TEST_ROTATIONS; i++)
+	{
+		const FRotator Rotator(Random.FRandRange(-720.0f, 720.0f), Random.FRandRange(-720.0f, 720.0f), Random.FRandRange(-720.0f, 720.0f));
+		if (!CheckRoundTrip(*this, Rotator))
+		{
+			return false;
+		}
+	}
+
+	// Unpacked axes are always normalized to [0, 360).
+	improbable::Rotation Unpacked;
+	Unpacked.Unpack(improbable::Rotation(FRotator(-90.0f, 450.0f, -0.001f)).Pack());
+	TestTrue(TEXT("Unpacked axes are in [0, 360)"),
+		Unpacked.Pitch >= 0.0f && Unpacked.Pitch < 360.0f && Unpacked.Yaw >= 0.0f && Unpacked.Yaw < 360.0f && Unpacked.Roll >= 0.0f && Unpacked.Roll < 360.0f);
+
+	// Only 48 of the 64 bits are used, which keeps the varint to at most 7 bytes.
+	TestTrue(TEXT("Packed rotations fit in 48 bits"), (improbable::Rotation(FRotator(359.99f, 359.99f, 359.99f)).Pack() >> 48) == 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
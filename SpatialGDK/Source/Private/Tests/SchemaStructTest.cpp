@@ -0,0 +1,207 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/SpatialTypebindingManager.h"
+#include "Tests/SchemaStructTestTypes.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "Utils/ComponentFactory.h"
+#include "Utils/ComponentReader.h"
+#include "Utils/SchemaStructUtils.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+const Worker_ComponentId TEST_COMPONENT_ID = 1000000;
+const int32 NUM_TEST_ELEMENTS = 64;
+
+// Quaternions are only compared up to sign and float precision, since FQuat's NetSerialize normalizes them and drops W.
+const float TRANSFORM_TOLERANCE = 1.e-4f;
+
+FSchemaStructTestData MakeTestData()
+{
+	FSchemaStructTestData Data;
+	for (int32 i = 0; i < NUM_TEST_ELEMENTS; i++)
+	{
+		const float Value = static_cast<float>(i);
+		Data.Vectors.Add(FVector(Value, -Value * 0.5f, Value * 1000.25f));
+		Data.Transforms.Add(FTransform(FRotator(Value, Value * 2.0f, -Value * 3.0f), FVector(Value * 10.0f, Value, -Value), FVector(1.0f + Value * 0.01f)));
+	}
+
+	// The extremes a float field has to carry unchanged.
+	Data.Vectors.Add(FVector(MAX_flt, -MAX_flt, SMALL_NUMBER));
+
+	Data.Transform = FTransform(FRotator(10.0f, 20.0f, 30.0f), FVector(100.0f, 200.0f, 300.0f));
+
+	return Data;
+}
+
+// The same handler, but with the elements written as bytes by their rep layout or NetSerialize, as they were before
+// structs were generated as schema types.
+FSchemaPropertyHandler CreateBytesArrayHandler(const FSchemaPropertyHandler& Handler)
+{
+	FSchemaPropertyHandler BytesHandler = Handler;
+	BytesHandler.InnerKind = ESchemaPropertyKind::Struct;
+	BytesHandler.StructFields.Reset();
+	return BytesHandler;
+}
+
+// The size of a component with just the property Handler describes, at Data, written to it.
+uint32 GetWrittenSize(improbable::ComponentFactory& Factory, const FSchemaPropertyHandler& Handler, const uint8* Data)
+{
+	Schema_ComponentData* ComponentData = Schema_CreateComponentData(TEST_COMPONENT_ID);
+	Schema_Object* ComponentObject = Schema_GetComponentDataFields(ComponentData);
+
+	TSet<const UObject*> UnresolvedObjects;
+	Factory.AddProperty(ComponentObject, 1, Handler, Data, UnresolvedObjects, nullptr);
+
+	const uint32 Size = Schema_GetWriteBufferLength(ComponentObject);
+	Schema_DestroyComponentData(ComponentData);
+	return Size;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSchemaStructArrayRoundTripTest, "SpatialGDK.Schema.SchemaStruct.ArrayRoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSchemaStructArrayRoundTripTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	UScriptStruct* TestStruct = FSchemaStructTestData::StaticStruct();
+	UArrayProperty* VectorsProperty = FindField<UArrayProperty>(TestStruct, GET_MEMBER_NAME_CHECKED(FSchemaStructTestData, Vectors));
+	UArrayProperty* TransformsProperty = FindField<UArrayProperty>(TestStruct, GET_MEMBER_NAME_CHECKED(FSchemaStructTestData, Transforms));
+	if (!TestNotNull(TEXT("Vectors property"), VectorsProperty) || !TestNotNull(TEXT("Transforms property"), TransformsProperty))
+	{
+		return false;
+	}
+
+	const FSchemaPropertyHandler VectorsHandler = CreateSchemaPropertyHandler(VectorsProperty);
+	const FSchemaPropertyHandler TransformsHandler = CreateSchemaPropertyHandler(TransformsProperty);
+	TestTrue(TEXT("FVector is written as a schema type"), VectorsHandler.Kind == ESchemaPropertyKind::Array && VectorsHandler.InnerKind == ESchemaPropertyKind::SchemaStruct);
+	TestTrue(TEXT("FTransform is written as a schema type"), TransformsHandler.Kind == ESchemaPropertyKind::Array && TransformsHandler.InnerKind == ESchemaPropertyKind::SchemaStruct);
+
+	FSchemaStructTestData Source = MakeTestData();
+	FSchemaStructTestData Destination;
+
+	Worker_ComponentData ComponentData = {};
+	ComponentData.component_id = TEST_COMPONENT_ID;
+	ComponentData.schema_type = Schema_CreateComponentData(TEST_COMPONENT_ID);
+	Schema_Object* ComponentObject = Schema_GetComponentDataFields(ComponentData.schema_type);
+
+	FUnresolvedObjectsMap RepUnresolvedObjectsMap;
+	FUnresolvedObjectsMap HandoverUnresolvedObjectsMap;
+	improbable::ComponentFactory Factory(RepUnresolvedObjectsMap, HandoverUnresolvedObjectsMap, Server.NetDriver);
+
+	TSet<const UObject*> UnresolvedObjects;
+	Factory.AddProperty(ComponentObject, 1, VectorsHandler, VectorsProperty->ContainerPtrToValuePtr<uint8>(&Source), UnresolvedObjects, nullptr);
+	Factory.AddProperty(ComponentObject, 2, TransformsHandler, TransformsProperty->ContainerPtrToValuePtr<uint8>(&Source), UnresolvedObjects, nullptr);
+	TestEqual(TEXT("Structs without object references have nothing to resolve"), UnresolvedObjects.Num(), 0);
+	TestEqual(TEXT("Every vector is written"), static_cast<int32>(Schema_GetObjectCount(ComponentObject, 1)), Source.Vectors.Num());
+	TestEqual(TEXT("Every transform is written"), static_cast<int32>(Schema_GetObjectCount(ComponentObject, 2)), Source.Transforms.Num());
+
+	FObjectReferencesMap ObjectReferencesMap;
+	TSet<FUnrealObjectRef> UnresolvedRefs;
+	improbable::ComponentReader Reader(Server.NetDriver, ObjectReferencesMap, UnresolvedRefs);
+
+	Reader.ApplyField(ComponentObject, 1, VectorsHandler, VectorsProperty->ContainerPtrToValuePtr<uint8>(&Destination), VectorsProperty->GetOffset_ForInternal(), 0);
+	Reader.ApplyField(ComponentObject, 2, TransformsHandler, TransformsProperty->ContainerPtrToValuePtr<uint8>(&Destination), TransformsProperty->GetOffset_ForInternal(), 1);
+	TestEqual(TEXT("No references are left waiting to resolve"), ObjectReferencesMap.Num() + UnresolvedRefs.Num(), 0);
+
+	Schema_DestroyComponentData(ComponentData.schema_type);
+
+	if (TestEqual(TEXT("Every vector is read back"), Destination.Vectors.Num(), Source.Vectors.Num()))
+	{
+		for (int32 i = 0; i < Source.Vectors.Num(); i++)
+		{
+			if (!TestTrue(FString::Printf(TEXT("Vector %d is read back unchanged"), i), Destination.Vectors[i] == Source.Vectors[i]))
+			{
+				break;
+			}
+		}
+	}
+
+	if (TestEqual(TEXT("Every transform is read back"), Destination.Transforms.Num(), Source.Transforms.Num()))
+	{
+		for (int32 i = 0; i < Source.Transforms.Num(); i++)
+		{
+			if (!TestTrue(FString::Printf(TEXT("Transform %d is read back"), i), Destination.Transforms[i].Equals(Source.Transforms[i], TRANSFORM_TOLERANCE)))
+			{
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSchemaStructBandwidthTest, "SpatialGDK.Schema.SchemaStruct.Bandwidth", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSchemaStructBandwidthTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	UScriptStruct* TestStruct = FSchemaStructTestData::StaticStruct();
+	UArrayProperty* VectorsProperty = FindField<UArrayProperty>(TestStruct, GET_MEMBER_NAME_CHECKED(FSchemaStructTestData, Vectors));
+	UArrayProperty* TransformsProperty = FindField<UArrayProperty>(TestStruct, GET_MEMBER_NAME_CHECKED(FSchemaStructTestData, Transforms));
+	UStructProperty* TransformProperty = FindField<UStructProperty>(TestStruct, GET_MEMBER_NAME_CHECKED(FSchemaStructTestData, Transform));
+	if (!TestNotNull(TEXT("Vectors property"), VectorsProperty) || !TestNotNull(TEXT("Transforms property"), TransformsProperty) || !TestNotNull(TEXT("Transform property"), TransformProperty))
+	{
+		return false;
+	}
+
+	FUnresolvedObjectsMap RepUnresolvedObjectsMap;
+	FUnresolvedObjectsMap HandoverUnresolvedObjectsMap;
+	improbable::ComponentFactory Factory(RepUnresolvedObjectsMap, HandoverUnresolvedObjectsMap, Server.NetDriver);
+
+	const FSchemaStructTestData Source = MakeTestData();
+	const uint8* VectorsData = VectorsProperty->ContainerPtrToValuePtr<uint8>(&Source);
+	const uint8* TransformsData = TransformsProperty->ContainerPtrToValuePtr<uint8>(&Source);
+	const uint8* TransformData = TransformProperty->ContainerPtrToValuePtr<uint8>(&Source);
+
+	// Arrays of structs, as schema types against as bytes.
+	const FSchemaPropertyHandler VectorsHandler = CreateSchemaPropertyHandler(VectorsProperty);
+	const FSchemaPropertyHandler TransformsHandler = CreateSchemaPropertyHandler(TransformsProperty);
+	const uint32 SchemaVectorsSize = GetWrittenSize(Factory, VectorsHandler, VectorsData);
+	const uint32 BytesVectorsSize = GetWrittenSize(Factory, CreateBytesArrayHandler(VectorsHandler), VectorsData);
+	const uint32 SchemaTransformsSize = GetWrittenSize(Factory, TransformsHandler, TransformsData);
+	const uint32 BytesTransformsSize = GetWrittenSize(Factory, CreateBytesArrayHandler(TransformsHandler), TransformsData);
+
+	// A handover transform whose translation has moved along X: the whole struct, as it was written before handover schema
+	// structs were split into their fields, against only the field which changed.
+	UStructProperty* TranslationProperty = FindField<UStructProperty>(TBaseStructure<FTransform>::Get(), TEXT("Translation"));
+	UProperty* TranslationXProperty = FindField<UProperty>(TBaseStructure<FVector>::Get(), GET_MEMBER_NAME_CHECKED(FVector, X));
+	if (!TestNotNull(TEXT("Translation property"), TranslationProperty) || !TestNotNull(TEXT("X property"), TranslationXProperty))
+	{
+		return false;
+	}
+	TestTrue(TEXT("FTransform is a schema struct"), IsSchemaStruct(TBaseStructure<FTransform>::Get()));
+	TestTrue(TEXT("FTransform's translation is one of its schema fields"), GetSchemaStructProperties(TBaseStructure<FTransform>::Get()).Contains(TranslationProperty));
+
+	const uint8* TranslationXData = TranslationXProperty->ContainerPtrToValuePtr<uint8>(TranslationProperty->ContainerPtrToValuePtr<uint8>(TransformData));
+	const uint32 WholeTransformSize = GetWrittenSize(Factory, CreateSchemaPropertyHandler(TransformProperty), TransformData);
+	const uint32 ChangedFieldSize = GetWrittenSize(Factory, CreateSchemaPropertyHandler(TranslationXProperty), TranslationXData);
+
+	TestTrue(TEXT("Changing one field of a handover struct sends less than the whole struct"), ChangedFieldSize < WholeTransformSize);
+
+	AddInfo(FString::Printf(TEXT("%d vectors: %u bytes as schema types, %u bytes as bytes."), Source.Vectors.Num(), SchemaVectorsSize, BytesVectorsSize));
+	AddInfo(FString::Printf(TEXT("%d transforms: %u bytes as schema types, %u bytes as bytes."), Source.Transforms.Num(), SchemaTransformsSize, BytesTransformsSize));
+	AddInfo(FString::Printf(TEXT("A handover transform whose translation moved along X: %u bytes for the changed field, %u bytes for the whole struct."), ChangedFieldSize, WholeTransformSize));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
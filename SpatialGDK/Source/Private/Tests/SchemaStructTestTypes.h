@@ -0,0 +1,24 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "SchemaStructTestTypes.generated.h"
+
+// Properties for the schema struct automation tests to write and read back, as they would be on a replicated actor.
+USTRUCT()
+struct FSchemaStructTestData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FVector> Vectors;
+
+	UPROPERTY()
+	TArray<FTransform> Transforms;
+
+	// Written as handover properties are, with a field for each of its fields.
+	UPROPERTY()
+	FTransform Transform;
+};
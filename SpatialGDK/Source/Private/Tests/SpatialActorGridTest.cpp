@@ -0,0 +1,232 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GameFramework/Actor.h"
+#include "UObject/Package.h"
+#include "Utils/SpatialActorGrid.h"
+
+namespace
+{
+
+const float TEST_CELL_SIZE = 5000.0f;
+const float TEST_PLAYER_DISTANCE = 10000.0f;
+
+// Actors are spread out so that there are about as many in each cell however many there are, as in a world that grows with its population.
+const float TEST_AREA_PER_ACTOR = 1000.0f * 1000.0f;
+
+const int32 NUM_UNIT_TEST_ACTORS = 1000;
+const int32 NUM_TEST_PLAYERS = 16;
+
+// The number of actors to benchmark with can be given as the test's parameters, e.g. "10000 50000".
+const int32 DEFAULT_NUM_BENCHMARK_ACTORS[] = { 10000, 50000 };
+
+struct FTestActors
+{
+	TArray<AActor*> Actors;
+	TArray<FVector> Locations;
+	float HalfWorldSize = 0.0f;
+};
+
+FTestActors CreateTestActors(int32 NumActors, FRandomStream& Random)
+{
+	FTestActors TestActors;
+	TestActors.HalfWorldSize = FMath::Sqrt(NumActors * TEST_AREA_PER_ACTOR) / 2.0f;
+
+	for (int32 i = 0; i < NumActors; i++)
+	{
+		TestActors.Actors.Add(NewObject<AActor>(GetTransientPackage()));
+		TestActors.Locations.Add(FVector(Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), 0.0f));
+	}
+
+	return TestActors;
+}
+
+void DestroyTestActors(FTestActors& TestActors)
+{
+	for (AActor* Actor : TestActors.Actors)
+	{
+		Actor->MarkPendingKill();
+	}
+	TestActors.Actors.Empty();
+}
+
+TArray<FVector> CreatePlayerLocations(const FTestActors& TestActors, FRandomStream& Random)
+{
+	TArray<FVector> PlayerLocations;
+	for (int32 i = 0; i < NUM_TEST_PLAYERS; i++)
+	{
+		PlayerLocations.Add(FVector(Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), 0.0f));
+	}
+	return PlayerLocations;
+}
+
+// What the net driver did before the grid: check every actor against every player.
+void GatherActorsNearByScanning(const FTestActors& TestActors, const TArray<FVector>& PlayerLocations, float HalfExtent, TSet<AActor*>& OutActors)
+{
+	for (int32 i = 0; i < TestActors.Actors.Num(); i++)
+	{
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			if (FMath::Abs(TestActors.Locations[i].X - PlayerLocation.X) <= HalfExtent && FMath::Abs(TestActors.Locations[i].Y - PlayerLocation.Y) <= HalfExtent)
+			{
+				OutActors.Add(TestActors.Actors[i]);
+				break;
+			}
+		}
+	}
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialActorGridTest, "SpatialGDK.NetDriver.ActorGrid.GatherActorsNear", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialActorGridTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0);
+	FTestActors TestActors = CreateTestActors(NUM_UNIT_TEST_ACTORS, Random);
+
+	FSpatialActorGrid Grid(TEST_CELL_SIZE);
+	for (int32 i = 0; i < TestActors.Actors.Num(); i++)
+	{
+		Grid.AddOrUpdateActor(TestActors.Actors[i], TestActors.Locations[i]);
+	}
+	TestEqual(TEXT("Every actor added is in the grid"), Grid.Num(), NUM_UNIT_TEST_ACTORS);
+
+	// Gathering finds every actor in range, and nothing further away than the cells that overlap the range.
+	auto CheckGather = [this, &Grid, &TestActors, &Random](const TCHAR* What)
+	{
+		const TArray<FVector> PlayerLocations = CreatePlayerLocations(TestActors, Random);
+
+		TSet<AActor*> Gathered;
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			Grid.GatherActorsNear(PlayerLocation, TEST_PLAYER_DISTANCE, Gathered);
+		}
+
+		TSet<AActor*> InRange;
+		GatherActorsNearByScanning(TestActors, PlayerLocations, TEST_PLAYER_DISTANCE, InRange);
+
+		TSet<AActor*> InOverlappingCells;
+		GatherActorsNearByScanning(TestActors, PlayerLocations, TEST_PLAYER_DISTANCE + TEST_CELL_SIZE, InOverlappingCells);
+
+		TestTrue(FString::Printf(TEXT("%s: every actor in range is gathered"), What), InRange.Difference(Gathered).Num() == 0);
+		TestTrue(FString::Printf(TEXT("%s: no actor outside the overlapping cells is gathered"), What), Gathered.Difference(InOverlappingCells).Num() == 0);
+	};
+
+	CheckGather(TEXT("After adding"));
+
+	// Move half of the actors somewhere else.
+	for (int32 i = 0; i < TestActors.Actors.Num(); i += 2)
+	{
+		TestActors.Locations[i] = FVector(Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), Random.FRandRange(-TestActors.HalfWorldSize, TestActors.HalfWorldSize), 0.0f);
+		Grid.AddOrUpdateActor(TestActors.Actors[i], TestActors.Locations[i]);
+	}
+	TestEqual(TEXT("Moving actors doesn't add them again"), Grid.Num(), NUM_UNIT_TEST_ACTORS);
+	CheckGather(TEXT("After moving"));
+
+	// Remove a third of them, twice over to check removing an actor that isn't there does nothing.
+	TArray<AActor*> RemovedActors;
+	for (int32 i = TestActors.Actors.Num() - 1; i >= 0; i -= 3)
+	{
+		RemovedActors.Add(TestActors.Actors[i]);
+		Grid.RemoveActor(TestActors.Actors[i]);
+		Grid.RemoveActor(TestActors.Actors[i]);
+		TestActors.Actors.RemoveAt(i);
+		TestActors.Locations.RemoveAt(i);
+	}
+	TestEqual(TEXT("Removed actors are no longer in the grid"), Grid.Num(), TestActors.Actors.Num());
+	CheckGather(TEXT("After removing"));
+
+	TSet<AActor*> Everything;
+	Grid.GatherActorsNear(FVector::ZeroVector, TestActors.HalfWorldSize + TEST_CELL_SIZE, Everything);
+	TestEqual(TEXT("Gathering the whole world finds every actor left"), Everything.Num(), TestActors.Actors.Num());
+	for (AActor* RemovedActor : RemovedActors)
+	{
+		if (!TestFalse(TEXT("Removed actors are never gathered"), Everything.Contains(RemovedActor)))
+		{
+			break;
+		}
+	}
+
+	DestroyTestActors(TestActors);
+	for (AActor* RemovedActor : RemovedActors)
+	{
+		RemovedActor->MarkPendingKill();
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialActorGridBenchmark, "SpatialGDK.NetDriver.ActorGrid.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialActorGridBenchmark::RunTest(const FString& Parameters)
+{
+	TArray<int32> NumActorsToBenchmark;
+	TArray<FString> NumActorsStrings;
+	Parameters.ParseIntoArrayWS(NumActorsStrings);
+	for (const FString& NumActorsString : NumActorsStrings)
+	{
+		if (NumActorsString.IsNumeric() && FCString::Atoi(*NumActorsString) > 0)
+		{
+			NumActorsToBenchmark.Add(FCString::Atoi(*NumActorsString));
+		}
+	}
+	if (NumActorsToBenchmark.Num() == 0)
+	{
+		NumActorsToBenchmark.Append(DEFAULT_NUM_BENCHMARK_ACTORS, ARRAY_COUNT(DEFAULT_NUM_BENCHMARK_ACTORS));
+	}
+
+	for (int32 NumActors : NumActorsToBenchmark)
+	{
+		FRandomStream Random(NumActors);
+		FTestActors TestActors = CreateTestActors(NumActors, Random);
+		const TArray<FVector> PlayerLocations = CreatePlayerLocations(TestActors, Random);
+
+		FSpatialActorGrid Grid(TEST_CELL_SIZE);
+		const double BuildStartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumActors; i++)
+		{
+			Grid.AddOrUpdateActor(TestActors.Actors[i], TestActors.Locations[i]);
+		}
+		const double BuildSeconds = FPlatformTime::Seconds() - BuildStartTime;
+
+		// Every actor moves a little, as they would between ticks. Only some of them cross into another cell.
+		for (FVector& Location : TestActors.Locations)
+		{
+			Location += FVector(Random.FRandRange(-500.0f, 500.0f), Random.FRandRange(-500.0f, 500.0f), 0.0f);
+		}
+		const double UpdateStartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumActors; i++)
+		{
+			Grid.AddOrUpdateActor(TestActors.Actors[i], TestActors.Locations[i]);
+		}
+		const double UpdateSeconds = FPlatformTime::Seconds() - UpdateStartTime;
+
+		TSet<AActor*> Gathered;
+		const double GatherStartTime = FPlatformTime::Seconds();
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			Grid.GatherActorsNear(PlayerLocation, TEST_PLAYER_DISTANCE, Gathered);
+		}
+		const double GatherSeconds = FPlatformTime::Seconds() - GatherStartTime;
+
+		TSet<AActor*> Scanned;
+		const double ScanStartTime = FPlatformTime::Seconds();
+		GatherActorsNearByScanning(TestActors, PlayerLocations, TEST_PLAYER_DISTANCE, Scanned);
+		const double ScanSeconds = FPlatformTime::Seconds() - ScanStartTime;
+
+		TestTrue(FString::Printf(TEXT("%d actors: the grid finds every actor the scan does"), NumActors), Scanned.Difference(Gathered).Num() == 0);
+
+		AddInfo(FString::Printf(TEXT("%d actors: added to the grid in %.3f ms, moved in %.3f ms. Gathered the %d near %d players in %.3f ms, where scanning every actor took %.3f ms to find %d."),
+			NumActors, 1000.0 * BuildSeconds, 1000.0 * UpdateSeconds, Gathered.Num(), NUM_TEST_PLAYERS, 1000.0 * GatherSeconds, 1000.0 * ScanSeconds, Scanned.Num()));
+
+		DestroyTestActors(TestActors);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,285 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Info.h"
+#include "UObject/UObjectIterator.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialSender.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Interop/SpatialTypebindingManager.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "Utils/EntityRegistry.h"
+
+namespace
+{
+
+// Small enough that the test crosses the refresh threshold and then drains the pool completely.
+const uint32 TEST_INITIAL_RESERVATION_COUNT = 1000;
+const uint32 TEST_REFRESH_THRESHOLD = 300;
+const uint32 TEST_REFRESH_COUNT = 500;
+
+const int32 MAX_TICKS_TO_REFILL = 5;
+const int32 MAX_TICKS_TO_AUTHORITY = 10;
+
+const int32 NUM_BENCHMARK_ACTORS = 1000;
+const int32 MAX_TICKS_TO_CREATE_ACTORS = 20;
+
+// The sender reads the pool settings when it starts, so they have to be set before the net driver connects.
+class FScopedEntityPoolSettings
+{
+public:
+	FScopedEntityPoolSettings(uint32 InitialReservationCount, uint32 RefreshThreshold, uint32 RefreshCount)
+	{
+		USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+		OldInitialReservationCount = Settings->EntityPoolInitialReservationCount;
+		OldRefreshThreshold = Settings->EntityPoolRefreshThreshold;
+		OldRefreshCount = Settings->EntityPoolRefreshCount;
+
+		Settings->EntityPoolInitialReservationCount = InitialReservationCount;
+		Settings->EntityPoolRefreshThreshold = RefreshThreshold;
+		Settings->EntityPoolRefreshCount = RefreshCount;
+	}
+
+	~FScopedEntityPoolSettings()
+	{
+		USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+		Settings->EntityPoolInitialReservationCount = OldInitialReservationCount;
+		Settings->EntityPoolRefreshThreshold = OldRefreshThreshold;
+		Settings->EntityPoolRefreshCount = OldRefreshCount;
+	}
+
+private:
+	uint32 OldInitialReservationCount;
+	uint32 OldRefreshThreshold;
+	uint32 OldRefreshCount;
+};
+
+// Any actor class in the schema database that can be spawned on its own, or null if there isn't one.
+UClass* FindReplicatedActorClass(USpatialNetDriver* NetDriver)
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->IsChildOf<AActor>() && !Class->IsChildOf<AInfo>() && !Class->IsChildOf<AController>() &&
+			!Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists) &&
+			!Class->HasAnySpatialClassFlags(SPATIALCLASS_Singleton) &&
+			Class->GetDefaultObject<AActor>()->GetIsReplicated() &&
+			NetDriver->TypebindingManager->IsSupportedClass(Class))
+		{
+			return Class;
+		}
+	}
+
+	return nullptr;
+}
+
+struct FActorCreationTimings
+{
+	bool bAllCreated = false;
+	int32 NumTicks = 0;
+	double Seconds = 0.0;
+	int32 NumResponses = 0;
+};
+
+// Spawns NumActors actors of ActorClass and ticks the server, which replicates them through their actor channels, until it is
+// authoritative over an entity for each of them.
+FActorCreationTimings CreateActors(FSpatialMockServerWorld& Server, UClass* ActorClass, int32 NumActors)
+{
+	FSpatialMockConnection* MockConnection = Server.NetDriver->Connection->GetMockConnection();
+	const int32 NumResponsesBefore = MockConnection->GetStats().NumResponses;
+
+	TArray<AActor*> Actors;
+	for (int32 i = 0; i < NumActors; i++)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Actors.Add(Server.World->SpawnActor<AActor>(ActorClass, FVector(i * 100.0f, 0.0f, 0.0f), FRotator::ZeroRotator, SpawnParameters));
+	}
+
+	FActorCreationTimings Timings;
+	const double StartTime = FPlatformTime::Seconds();
+	while (!Timings.bAllCreated && Timings.NumTicks < MAX_TICKS_TO_CREATE_ACTORS)
+	{
+		Server.Tick();
+		Timings.NumTicks++;
+
+		Timings.bAllCreated = true;
+		for (AActor* Actor : Actors)
+		{
+			const Worker_EntityId EntityId = Server.NetDriver->GetEntityRegistry()->GetEntityIdFromActor(Actor);
+			if (EntityId == SpatialConstants::INVALID_ENTITY_ID || !Server.NetDriver->StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID))
+			{
+				Timings.bAllCreated = false;
+				break;
+			}
+		}
+	}
+	Timings.Seconds = FPlatformTime::Seconds() - StartTime;
+	Timings.NumResponses = MockConnection->GetStats().NumResponses - NumResponsesBefore;
+
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+
+	return Timings;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialEntityPoolTest, "SpatialGDK.NetDriver.MockConnection.EntityPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialEntityPoolTest::RunTest(const FString& Parameters)
+{
+	FScopedEntityPoolSettings PoolSettings(TEST_INITIAL_RESERVATION_COUNT, TEST_REFRESH_THRESHOLD, TEST_REFRESH_COUNT);
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	USpatialSender* Sender = Server.NetDriver->Sender;
+
+	auto TickUntilRefilled = [this, &Server, Sender]()
+	{
+		for (int32 TickCount = 0; TickCount < MAX_TICKS_TO_REFILL && Sender->IsEntityPoolRequestInFlight(); TickCount++)
+		{
+			Server.Tick();
+		}
+		return TestFalse(TEXT("The reservation for the pool is answered"), Sender->IsEntityPoolRequestInFlight());
+	};
+
+	TSet<Worker_EntityId> TakenEntityIds;
+	auto TakeEntityId = [this, Sender, &TakenEntityIds]()
+	{
+		const Worker_EntityId EntityId = Sender->TakeReservedEntityId();
+		if (EntityId != SpatialConstants::INVALID_ENTITY_ID)
+		{
+			bool bAlreadyTaken = false;
+			TakenEntityIds.Add(EntityId, &bAlreadyTaken);
+			TestFalse(FString::Printf(TEXT("Entity id %lld is only handed out once"), EntityId), bAlreadyTaken);
+		}
+		return EntityId;
+	};
+
+	// The server reserves its initial batch as soon as it connects.
+	if (!TickUntilRefilled())
+	{
+		return false;
+	}
+	TestEqual(TEXT("The initial batch fills the pool"), (int32)Sender->GetNumReservedEntityIds(), (int32)TEST_INITIAL_RESERVATION_COUNT);
+
+	// Taking ids doesn't ask for more until the pool drops below the threshold, and then asks exactly once.
+	const double StartTime = FPlatformTime::Seconds();
+	while (Sender->GetNumReservedEntityIds() >= TEST_REFRESH_THRESHOLD)
+	{
+		if (!TestFalse(TEXT("No batch is requested while the pool is above the threshold"), Sender->IsEntityPoolRequestInFlight()) ||
+			!TestNotEqual(TEXT("Ids are taken from the pool while it has some"), TakeEntityId(), (Worker_EntityId)SpatialConstants::INVALID_ENTITY_ID))
+		{
+			return false;
+		}
+	}
+	TestTrue(TEXT("A batch is requested once the pool drops below the threshold"), Sender->IsEntityPoolRequestInFlight());
+
+	const Worker_RequestId RefillRequestId = Sender->GetEntityPoolRequestId();
+	TakeEntityId();
+	TestTrue(TEXT("Only one batch is requested at a time"), Sender->GetEntityPoolRequestId() == RefillRequestId);
+
+	const int64 NumLeftBeforeRefill = Sender->GetNumReservedEntityIds();
+	if (!TickUntilRefilled())
+	{
+		return false;
+	}
+	TestEqual(TEXT("The refresh batch is added to what was left"), (int32)Sender->GetNumReservedEntityIds(), (int32)(NumLeftBeforeRefill + TEST_REFRESH_COUNT));
+
+	// Draining the pool hands out every reserved id, then reports that it's empty until the next batch arrives.
+	while (TakeEntityId() != SpatialConstants::INVALID_ENTITY_ID)
+	{
+	}
+	TestEqual(TEXT("The pool is only empty once every id has been taken"), (int32)Sender->GetNumReservedEntityIds(), 0);
+	TestTrue(TEXT("A batch is on its way when the pool runs dry"), Sender->IsEntityPoolRequestInFlight());
+
+	if (!TickUntilRefilled())
+	{
+		return false;
+	}
+	TestEqual(TEXT("The pool recovers after running dry"), (int32)Sender->GetNumReservedEntityIds(), (int32)TEST_REFRESH_COUNT);
+
+	// Entities can be created with the taken ids straight away, and none of them clash with an existing entity.
+	const FSpatialMockConnectionStats StatsBefore = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	for (Worker_EntityId EntityId : TakenEntityIds)
+	{
+		Server.CreateEntity(EntityId, FVector::ZeroVector);
+	}
+	TestTrue(TEXT("The server is authoritative over every entity created with a pooled id"), Server.TickUntilAuthoritative(TakenEntityIds.Array(), MAX_TICKS_TO_AUTHORITY));
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const FSpatialMockConnectionStats StatsAfter = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	TestEqual(TEXT("Every pooled id creates a new entity"), StatsAfter.NumEntitiesCreated - StatsBefore.NumEntitiesCreated, TakenEntityIds.Num());
+
+	AddInfo(FString::Printf(TEXT("Took %d entity ids from the pool and created their entities in %.3f seconds (%.1f entities per second)."),
+		TakenEntityIds.Num(), ElapsedSeconds, TakenEntityIds.Num() / FMath::Max(ElapsedSeconds, SMALL_NUMBER)));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialEntityPoolActorCreationTest, "SpatialGDK.NetDriver.MockConnection.EntityPoolActorCreation", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialEntityPoolActorCreationTest::RunTest(const FString& Parameters)
+{
+	// Replicates the same number of new actors with entity ids taken from the pool, and with the pool turned off so that each
+	// actor reserves its own id first, as it did before there was a pool.
+	auto RunBenchmark = [this](const TCHAR* What, uint32 InitialReservationCount, uint32 RefreshCount, FActorCreationTimings& OutTimings)
+	{
+		FScopedEntityPoolSettings PoolSettings(InitialReservationCount, InitialReservationCount / 2, RefreshCount);
+		FSpatialMockServerWorld Server;
+		if (!Server.IsConnected(*this))
+		{
+			return false;
+		}
+
+		UClass* ActorClass = FindReplicatedActorClass(Server.NetDriver);
+		if (ActorClass == nullptr)
+		{
+			AddWarning(TEXT("The schema database has no actor class this test can spawn, so there is nothing to replicate. Generate schema for the project first."));
+			return false;
+		}
+
+		for (int32 TickCount = 0; TickCount < MAX_TICKS_TO_REFILL && Server.NetDriver->Sender->IsEntityPoolRequestInFlight(); TickCount++)
+		{
+			Server.Tick();
+		}
+
+		OutTimings = CreateActors(Server, ActorClass, NUM_BENCHMARK_ACTORS);
+		return TestTrue(FString::Printf(TEXT("%s: every actor is given an entity"), What), OutTimings.bAllCreated);
+	};
+
+	FActorCreationTimings Pooled;
+	FActorCreationTimings Unpooled;
+	if (!RunBenchmark(TEXT("Pooled"), NUM_BENCHMARK_ACTORS, NUM_BENCHMARK_ACTORS, Pooled) ||
+		!RunBenchmark(TEXT("One at a time"), 0, 0, Unpooled))
+	{
+		return true;
+	}
+
+	TestTrue(TEXT("Pooled ids save each actor a reservation round trip"), Pooled.NumResponses < Unpooled.NumResponses);
+
+	AddInfo(FString::Printf(TEXT("Created %d actors with pooled entity ids in %.3f ms over %d ticks, with %d responses from the mock."),
+		NUM_BENCHMARK_ACTORS, 1000.0 * Pooled.Seconds, Pooled.NumTicks, Pooled.NumResponses));
+	AddInfo(FString::Printf(TEXT("Reserving an id for each actor on its own took %.3f ms over %d ticks, with %d responses from the mock."),
+		1000.0 * Unpooled.Seconds, Unpooled.NumTicks, Unpooled.NumResponses));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,224 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Info.h"
+#include "UObject/UObjectIterator.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Interop/SpatialTypebindingManager.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "Utils/EntityRegistry.h"
+
+namespace
+{
+
+const int32 NUM_TEST_ACTORS = 1000;
+const int32 MAX_TICKS_TO_CREATE_ACTORS = 20;
+const int32 NUM_BENCHMARK_TICKS = 30;
+
+// Long enough that no periodic full compare happens during the test.
+const float TEST_FULL_COMPARE_INTERVAL = 1000.0f;
+
+// Shorter than a tick, so that a full compare is due every time an actor replicates.
+const float TEST_SHORT_FULL_COMPARE_INTERVAL = 0.01f;
+
+class FScopedHandoverFullCompareInterval
+{
+public:
+	FScopedHandoverFullCompareInterval(float Interval)
+	{
+		OldInterval = GetDefault<USpatialGDKSettings>()->HandoverFullCompareInterval;
+		GetMutableDefault<USpatialGDKSettings>()->HandoverFullCompareInterval = Interval;
+	}
+
+	~FScopedHandoverFullCompareInterval()
+	{
+		GetMutableDefault<USpatialGDKSettings>()->HandoverFullCompareInterval = OldInterval;
+	}
+
+private:
+	float OldInterval;
+};
+
+// Any actor class in the schema database that can be spawned on its own and has a numeric handover property, along with that property.
+UClass* FindHandoverActorClass(USpatialNetDriver* NetDriver, const FHandoverPropertyInfo*& OutNumericProperty)
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (!Class->IsChildOf<AActor>() || Class->IsChildOf<AInfo>() || Class->IsChildOf<AController>() ||
+			Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists) ||
+			Class->HasAnySpatialClassFlags(SPATIALCLASS_Singleton) ||
+			!Class->GetDefaultObject<AActor>()->GetIsReplicated() ||
+			!NetDriver->TypebindingManager->IsSupportedClass(Class))
+		{
+			continue;
+		}
+
+		FClassInfo* Info = NetDriver->TypebindingManager->FindClassInfoByClass(Class);
+		for (const FHandoverPropertyInfo& PropertyInfo : Info->HandoverProperties)
+		{
+			UNumericProperty* NumericProperty = Cast<UNumericProperty>(PropertyInfo.Property);
+			if (NumericProperty != nullptr && !NumericProperty->IsEnum())
+			{
+				OutNumericProperty = &PropertyInfo;
+				return Class;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void ChangeNumericProperty(AActor* Actor, const FHandoverPropertyInfo& PropertyInfo)
+{
+	UNumericProperty* NumericProperty = static_cast<UNumericProperty*>(PropertyInfo.Property);
+	uint8* Data = (uint8*)Actor + PropertyInfo.Offset;
+	if (NumericProperty->IsFloatingPoint())
+	{
+		NumericProperty->SetFloatingPointPropertyValue(Data, NumericProperty->GetFloatingPointPropertyValue(Data) + 1.0);
+	}
+	else
+	{
+		NumericProperty->SetIntPropertyValue(Data, NumericProperty->GetSignedIntPropertyValue(Data) + 1);
+	}
+}
+
+// The entities the mock has echoed a handover component update back for since it was last asked, with how many each.
+TMap<Worker_EntityId, int32> TakeHandoverUpdates(FSpatialMockServerWorld& Server, Worker_ComponentId HandoverComponentId)
+{
+	TMap<Worker_EntityId, int32> Updates;
+
+	TUniquePtr<FSpatialOpList> OpList = Server.NetDriver->Connection->GetMockConnection()->GetOpList();
+	if (!OpList.IsValid())
+	{
+		return Updates;
+	}
+
+	for (uint32 i = 0; i < OpList->OpList->op_count; i++)
+	{
+		const Worker_Op& Op = OpList->OpList->ops[i];
+		if (Op.op_type == WORKER_OP_TYPE_COMPONENT_UPDATE && Op.component_update.update.component_id == HandoverComponentId)
+		{
+			Updates.FindOrAdd(Op.component_update.entity_id)++;
+		}
+	}
+
+	return Updates;
+}
+
+// Ticks the server NumTicks times, returning how long it took.
+double TimeTicks(FSpatialMockServerWorld& Server, int32 NumTicks)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumTicks; i++)
+	{
+		Server.Tick();
+	}
+	return FPlatformTime::Seconds() - StartTime;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialHandoverCompareTest, "SpatialGDK.NetDriver.MockConnection.HandoverCompare", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialHandoverCompareTest::RunTest(const FString& Parameters)
+{
+	FScopedHandoverFullCompareInterval ScopedInterval(0.0f);
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const FHandoverPropertyInfo* NumericProperty = nullptr;
+	UClass* ActorClass = FindHandoverActorClass(Server.NetDriver, NumericProperty);
+	if (ActorClass == nullptr)
+	{
+		AddWarning(TEXT("No replicated actor class with a numeric handover property is in the schema database, so handover compares can't be tested."));
+		return true;
+	}
+	const Worker_ComponentId HandoverComponentId = Server.NetDriver->TypebindingManager->FindClassInfoByClass(ActorClass)->HandoverComponent;
+
+	TArray<AActor*> Actors;
+	for (int32 i = 0; i < NUM_TEST_ACTORS; i++)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Actors.Add(Server.World->SpawnActor<AActor>(ActorClass, FVector(i * 100.0f, 0.0f, 0.0f), FRotator::ZeroRotator, SpawnParameters));
+	}
+
+	TArray<Worker_EntityId> EntityIds;
+	for (int32 Tick = 0; Tick < MAX_TICKS_TO_CREATE_ACTORS && EntityIds.Num() < NUM_TEST_ACTORS; Tick++)
+	{
+		Server.Tick();
+
+		EntityIds.Reset();
+		for (AActor* Actor : Actors)
+		{
+			const Worker_EntityId EntityId = Server.NetDriver->GetEntityRegistry()->GetEntityIdFromActor(Actor);
+			if (EntityId == SpatialConstants::INVALID_ENTITY_ID || !Server.NetDriver->StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID))
+			{
+				break;
+			}
+			EntityIds.Add(EntityId);
+		}
+	}
+	if (!TestEqual(TEXT("The server is authoritative over an entity for every test actor"), EntityIds.Num(), NUM_TEST_ACTORS))
+	{
+		return false;
+	}
+
+	// Benchmark: replicating actors whose handover properties haven't changed, comparing all of them every time against only when a full compare is due.
+	// The ops the mock echoes back are taken by the next tick, so only those of the last tick are left to check.
+	Server.Tick();
+	const double FullCompareSeconds = TimeTicks(Server, NUM_BENCHMARK_TICKS);
+	GetMutableDefault<USpatialGDKSettings>()->HandoverFullCompareInterval = TEST_FULL_COMPARE_INTERVAL;
+	const double DirtyCompareSeconds = TimeTicks(Server, NUM_BENCHMARK_TICKS);
+	TestEqual(TEXT("Nothing is sent for unchanged handover properties"), TakeHandoverUpdates(Server, HandoverComponentId).Num(), 0);
+
+	// Between full compares, a change to a handover property is only sent once something says the actor may have changed.
+	AActor* UnmarkedActor = Actors[0];
+	AActor* ForcedActor = Actors[1];
+	AActor* MarkedActor = Actors[2];
+	for (AActor* Actor : { UnmarkedActor, ForcedActor, MarkedActor })
+	{
+		ChangeNumericProperty(Actor, *NumericProperty);
+	}
+	ForcedActor->ForceNetUpdate();
+	Server.NetDriver->MarkHandoverDirty(MarkedActor);
+	Server.Tick();
+
+	const TMap<Worker_EntityId, int32> Updates = TakeHandoverUpdates(Server, HandoverComponentId);
+	TestFalse(TEXT("An unmarked change waits for the next full compare"), Updates.Contains(EntityIds[0]));
+	TestEqual(TEXT("A change is sent after ForceNetUpdate"), Updates.FindRef(EntityIds[1]), 1);
+	TestEqual(TEXT("A change is sent after MarkHandoverDirty"), Updates.FindRef(EntityIds[2]), 1);
+
+	// The safety net picks up the unmarked change once a full compare is due.
+	GetMutableDefault<USpatialGDKSettings>()->HandoverFullCompareInterval = TEST_SHORT_FULL_COMPARE_INTERVAL;
+	Server.Tick();
+	TestEqual(TEXT("An unmarked change is sent by the next full compare"), TakeHandoverUpdates(Server, HandoverComponentId).FindRef(EntityIds[0]), 1);
+
+	AddInfo(FString::Printf(TEXT("%d ticks replicating %d %s actors: %.3f ms comparing every handover property each time, %.3f ms comparing only dirty objects."),
+		NUM_BENCHMARK_TICKS, NUM_TEST_ACTORS, *ActorClass->GetName(), 1000.0 * FullCompareSeconds, 1000.0 * DirtyCompareSeconds));
+
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
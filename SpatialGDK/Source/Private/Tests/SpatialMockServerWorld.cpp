@@ -0,0 +1,132 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Tests/SpatialMockServerWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+
+FSpatialMockServerWorld::FSpatialMockServerWorld()
+{
+	// Tests count on a tick processing every op the mock has answered with, so the time budget is lifted while the world exists.
+	// Tests of the budget itself set it once the world has been created, as it is read on every tick.
+	USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+	OldOpsProcessingTimeBudgetMs = Settings->OpsProcessingTimeBudgetMs;
+	Settings->OpsProcessingTimeBudgetMs = 0.0f;
+
+	World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// The net driver connects to the mock rather than SpatialOS when the world's URL asks it to.
+	World->URL.AddOption(TEXT("mockConnection"));
+
+	NetDriver = NewObject<USpatialNetDriver>(GetTransientPackage());
+	NetDriver->AddToRoot();
+	NetDriver->NetDriverName = NAME_GameNetDriver;
+	NetDriver->SetWorld(World);
+	World->SetNetDriver(NetDriver);
+
+	if (!NetDriver->InitListen(World, World->URL, false, InitError) && InitError.IsEmpty())
+	{
+		InitError = TEXT("InitListen failed.");
+	}
+}
+
+FSpatialMockServerWorld::~FSpatialMockServerWorld()
+{
+	World->SetNetDriver(nullptr);
+	NetDriver->Shutdown();
+	NetDriver->SetWorld(nullptr);
+	NetDriver->RemoveFromRoot();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	GetMutableDefault<USpatialGDKSettings>()->OpsProcessingTimeBudgetMs = OldOpsProcessingTimeBudgetMs;
+}
+
+bool FSpatialMockServerWorld::IsConnected(FAutomationTestBase& Test) const
+{
+	if (!InitError.IsEmpty())
+	{
+		Test.AddError(FString::Printf(TEXT("The net driver failed to start: %s"), *InitError));
+		return false;
+	}
+
+	if (NetDriver->Connection == nullptr || !NetDriver->Connection->IsConnected() || NetDriver->Connection->GetMockConnection() == nullptr)
+	{
+		Test.AddError(TEXT("The net driver didn't connect to the mock connection."));
+		return false;
+	}
+
+	return true;
+}
+
+void FSpatialMockServerWorld::Tick(float DeltaSeconds)
+{
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+}
+
+void FSpatialMockServerWorld::CreateEntity(Worker_EntityId EntityId, const FVector& Location, const TArray<Worker_ComponentId>& ExtraComponentIds)
+{
+	const WorkerRequirementSet ServerRequirementSet = { WorkerAttributeSet{ SpatialConstants::ServerWorkerType } };
+
+	WriteAclMap ComponentWriteAcl;
+	ComponentWriteAcl.Add(SpatialConstants::POSITION_COMPONENT_ID, ServerRequirementSet);
+	ComponentWriteAcl.Add(SpatialConstants::ENTITY_ACL_COMPONENT_ID, ServerRequirementSet);
+
+	TArray<Worker_ComponentData> Components;
+	Components.Add(improbable::Position(improbable::Coordinates::FromFVector(Location)).CreatePositionData());
+	Components.Add(improbable::Metadata(TEXT("SpatialMockTestEntity")).CreateMetadataData());
+
+	for (Worker_ComponentId ComponentId : ExtraComponentIds)
+	{
+		ComponentWriteAcl.Add(ComponentId, ServerRequirementSet);
+
+		Worker_ComponentData Data = {};
+		Data.component_id = ComponentId;
+		Data.schema_type = Schema_CreateComponentData(ComponentId);
+		Components.Add(Data);
+	}
+
+	Components.Add(improbable::EntityAcl(ServerRequirementSet, ComponentWriteAcl).CreateEntityAclData());
+
+	NetDriver->Connection->SendCreateEntityRequest(Components.Num(), Components.GetData(), &EntityId);
+}
+
+bool FSpatialMockServerWorld::TickUntilAuthoritative(const TArray<Worker_EntityId>& EntityIds, int32 MaxTicks)
+{
+	for (int32 TickCount = 0; TickCount < MaxTicks; TickCount++)
+	{
+		Tick();
+
+		bool bAllAuthoritative = true;
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			if (!NetDriver->StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID))
+			{
+				bAllAuthoritative = false;
+				break;
+			}
+		}
+
+		if (bAllAuthoritative)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
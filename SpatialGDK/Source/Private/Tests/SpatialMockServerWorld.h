@@ -0,0 +1,46 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <WorkerSDK/improbable/c_worker.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UWorld;
+class USpatialNetDriver;
+class FAutomationTestBase;
+
+// A game world with a listening SpatialOS net driver connected to an in-process FSpatialMockConnection,
+// as a headless server started with -mockConnection would have. Used by automation tests to drive the net driver.
+class FSpatialMockServerWorld
+{
+public:
+	FSpatialMockServerWorld();
+	~FSpatialMockServerWorld();
+
+	// Returns false, and adds an error to the test, if the net driver didn't connect to the mock.
+	bool IsConnected(FAutomationTestBase& Test) const;
+
+	void Tick(float DeltaSeconds = 1.0f / 30.0f);
+
+	// Creates an entity with just the standard components, so no actor is spawned for it. This server can write to its Position.
+	// Each of ExtraComponentIds is added with empty data, and can be written to by this server too.
+	void CreateEntity(Worker_EntityId EntityId, const FVector& Location, const TArray<Worker_ComponentId>& ExtraComponentIds = TArray<Worker_ComponentId>());
+
+	// Ticks until this server is authoritative over the Position of every given entity. Returns false if it doesn't happen within MaxTicks.
+	bool TickUntilAuthoritative(const TArray<Worker_EntityId>& EntityIds, int32 MaxTicks);
+
+	UWorld* World;
+	USpatialNetDriver* NetDriver;
+
+	FSpatialMockServerWorld(const FSpatialMockServerWorld& Other) = delete;
+	FSpatialMockServerWorld& operator=(const FSpatialMockServerWorld& Other) = delete;
+
+private:
+	FString InitError;
+	float OldOpsProcessingTimeBudgetMs;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
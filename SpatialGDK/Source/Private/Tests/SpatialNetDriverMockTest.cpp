@@ -0,0 +1,268 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ScopeExit.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialReceiver.h"
+#include "Interop/SpatialSender.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Schema/StandardLibrary.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId FIRST_TEST_ENTITY_ID = 1 << 20;
+
+const int32 DEFAULT_NUM_TEST_ENTITIES = 1000;
+const int32 MAX_TICKS_TO_AUTHORITY = 10;
+
+// This server is authoritative over this component on every entity in the RPC test, so the mock delivers commands on it back here.
+const Worker_ComponentId TEST_COMMAND_COMPONENT_ID = 1000000;
+
+// How many entities to test with: the test's parameters if they are a number, otherwise -MockTestEntities=<N> on the command line,
+// otherwise DEFAULT_NUM_TEST_ENTITIES.
+int32 GetNumTestEntities(const FString& Parameters)
+{
+	int32 NumEntities = DEFAULT_NUM_TEST_ENTITIES;
+	if (Parameters.IsNumeric())
+	{
+		NumEntities = FCString::Atoi(*Parameters);
+	}
+	else
+	{
+		FParse::Value(FCommandLine::Get(), TEXT("MockTestEntities="), NumEntities);
+	}
+	return FMath::Max(NumEntities, 1);
+}
+
+TArray<Worker_EntityId> CreateTestEntities(FSpatialMockServerWorld& Server, int32 NumEntities, const TArray<Worker_ComponentId>& ExtraComponentIds = TArray<Worker_ComponentId>())
+{
+	TArray<Worker_EntityId> EntityIds;
+	for (int32 i = 0; i < NumEntities; i++)
+	{
+		const Worker_EntityId EntityId = FIRST_TEST_ENTITY_ID + i;
+		Server.CreateEntity(EntityId, FVector::ZeroVector, ExtraComponentIds);
+		EntityIds.Add(EntityId);
+	}
+	return EntityIds;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialNetDriverMockEntityCreationTest, "SpatialGDK.NetDriver.MockConnection.EntityCreation", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialNetDriverMockEntityCreationTest::RunTest(const FString& Parameters)
+{
+	const int32 NumEntities = GetNumTestEntities(Parameters);
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TArray<Worker_EntityId> EntityIds = CreateTestEntities(Server, NumEntities);
+	const bool bAllAuthoritative = Server.TickUntilAuthoritative(EntityIds, MAX_TICKS_TO_AUTHORITY);
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestTrue(TEXT("The server is authoritative over every entity it created"), bAllAuthoritative);
+
+	for (Worker_EntityId EntityId : EntityIds)
+	{
+		if (!TestNotNull(TEXT("Entity has a Position"), Server.NetDriver->StaticComponentView->GetComponentData<improbable::Position>(EntityId)))
+		{
+			break;
+		}
+	}
+
+	const FSpatialMockConnectionStats Stats = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	AddInfo(FString::Printf(TEXT("Created %d entities and received authority over them in %.3f seconds (%.1f entities per second). Create responses took %.3f ms on average, %.3f ms at most."),
+		NumEntities, ElapsedSeconds, NumEntities / FMath::Max(ElapsedSeconds, SMALL_NUMBER),
+		1000.0 * Stats.AverageResponseLatency, 1000.0 * Stats.MaxResponseLatency));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialNetDriverMockPositionUpdateTest, "SpatialGDK.NetDriver.MockConnection.PositionUpdates", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialNetDriverMockPositionUpdateTest::RunTest(const FString& Parameters)
+{
+	const int32 NumEntities = GetNumTestEntities(Parameters);
+	const int32 NumRounds = 100;
+	const int32 MaxTicksPerRound = 5;
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const TArray<Worker_EntityId> EntityIds = CreateTestEntities(Server, NumEntities);
+	if (!TestTrue(TEXT("The server is authoritative over every entity it created"), Server.TickUntilAuthoritative(EntityIds, MAX_TICKS_TO_AUTHORITY)))
+	{
+		return false;
+	}
+
+	USpatialStaticComponentView* StaticComponentView = Server.NetDriver->StaticComponentView;
+
+	// Each round moves every entity, and ticks until every move has been sent by the net driver and received back from the mock.
+	double TotalSeconds = 0.0;
+	double MaxRoundSeconds = 0.0;
+	int32 TotalTicks = 0;
+	int32 MaxRoundTicks = 0;
+	for (int32 Round = 1; Round <= NumRounds; Round++)
+	{
+		const FVector Location(Round * 100.0f, 0.0f, 0.0f);
+		const double RoundStartTime = FPlatformTime::Seconds();
+
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			Server.NetDriver->Sender->SendPositionUpdate(EntityId, Location);
+		}
+
+		int32 RoundTicks = 0;
+		int32 NumMoved = 0;
+		while (NumMoved < EntityIds.Num() && RoundTicks < MaxTicksPerRound)
+		{
+			Server.Tick();
+			RoundTicks++;
+
+			NumMoved = 0;
+			for (Worker_EntityId EntityId : EntityIds)
+			{
+				const improbable::Position* Position = StaticComponentView->GetComponentData<improbable::Position>(EntityId);
+				if (Position != nullptr && Position->Coords.X == Location.X)
+				{
+					NumMoved++;
+				}
+			}
+		}
+
+		if (!TestEqual(FString::Printf(TEXT("Entities moved in round %d"), Round), NumMoved, EntityIds.Num()))
+		{
+			return false;
+		}
+
+		const double RoundSeconds = FPlatformTime::Seconds() - RoundStartTime;
+		TotalSeconds += RoundSeconds;
+		MaxRoundSeconds = FMath::Max(MaxRoundSeconds, RoundSeconds);
+		TotalTicks += RoundTicks;
+		MaxRoundTicks = FMath::Max(MaxRoundTicks, RoundTicks);
+	}
+
+	const FSpatialMockConnectionStats Stats = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	TestEqual(TEXT("No component updates were rejected"), Stats.NumRejectedComponentUpdates, 0);
+
+	const int32 NumUpdates = NumEntities * NumRounds;
+	AddInfo(FString::Printf(TEXT("Sent and received %d position updates in %.3f seconds (%.1f updates per second)."),
+		NumUpdates, TotalSeconds, NumUpdates / FMath::Max(TotalSeconds, SMALL_NUMBER)));
+	AddInfo(FString::Printf(TEXT("Round trip for %d updates: %.3f ms and %.1f ticks on average, %.3f ms and %d ticks at most."),
+		NumEntities, 1000.0 * TotalSeconds / NumRounds, (float)TotalTicks / NumRounds, 1000.0 * MaxRoundSeconds, MaxRoundTicks));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialNetDriverMockRPCRoundTripTest, "SpatialGDK.NetDriver.MockConnection.RPCRoundTrips", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialNetDriverMockRPCRoundTripTest::RunTest(const FString& Parameters)
+{
+	const int32 NumEntities = GetNumTestEntities(Parameters);
+	const int32 NumRounds = 10;
+	const int32 MaxTicksPerRound = 5;
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	const TArray<Worker_EntityId> EntityIds = CreateTestEntities(Server, NumEntities, { TEST_COMMAND_COMPONENT_ID });
+	if (!TestTrue(TEXT("The server is authoritative over every entity it created"), Server.TickUntilAuthoritative(EntityIds, MAX_TICKS_TO_AUTHORITY)))
+	{
+		return false;
+	}
+
+	UFunction* Function = APlayerController::StaticClass()->FindFunctionByName(TEXT("ClientReset"));
+	if (!TestNotNull(TEXT("Test RPC"), Function))
+	{
+		return false;
+	}
+
+	// The test entities have no actors, so the receiver answers every request with an empty response, warning each time.
+	const ELogVerbosity::Type OldReceiverVerbosity = LogSpatialReceiver.GetVerbosity();
+	ON_SCOPE_EXIT
+	{
+		LogSpatialReceiver.SetVerbosity(OldReceiverVerbosity);
+	};
+	LogSpatialReceiver.SetVerbosity(ELogVerbosity::Error);
+
+	USpatialReceiver* Receiver = Server.NetDriver->Receiver;
+	TArray<uint8> RPCParameters;
+	RPCParameters.SetNumZeroed(Function->ParmsSize);
+
+	// Each round sends a reliable RPC to every entity, the way USpatialSender::SendRPC does, and ticks until every one of them has
+	// been delivered back to this server as a command request, answered, and the response received.
+	const FSpatialMockConnectionStats StatsBefore = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	double TotalSeconds = 0.0;
+	double MaxRoundSeconds = 0.0;
+	int32 TotalTicks = 0;
+	int32 MaxRoundTicks = 0;
+	for (int32 Round = 1; Round <= NumRounds; Round++)
+	{
+		const double RoundStartTime = FPlatformTime::Seconds();
+
+		for (Worker_EntityId EntityId : EntityIds)
+		{
+			Worker_CommandRequest Request = {};
+			Request.component_id = TEST_COMMAND_COMPONENT_ID;
+			Request.schema_type = Schema_CreateCommandRequest(TEST_COMMAND_COMPONENT_ID, 1);
+			const Worker_RequestId RequestId = Server.NetDriver->Connection->SendCommandRequest(EntityId, &Request, 1);
+			Receiver->AddPendingReliableRPC(RequestId, MakeShared<FPendingRPCParams>(Server.NetDriver, Function, RPCParameters.GetData()));
+		}
+
+		int32 RoundTicks = 0;
+		while (Receiver->GetNumPendingReliableRPCs() > 0 && RoundTicks < MaxTicksPerRound)
+		{
+			Server.Tick();
+			RoundTicks++;
+		}
+
+		if (!TestEqual(FString::Printf(TEXT("Every RPC in round %d is answered"), Round), Receiver->GetNumPendingReliableRPCs(), 0))
+		{
+			return false;
+		}
+
+		const double RoundSeconds = FPlatformTime::Seconds() - RoundStartTime;
+		TotalSeconds += RoundSeconds;
+		MaxRoundSeconds = FMath::Max(MaxRoundSeconds, RoundSeconds);
+		TotalTicks += RoundTicks;
+		MaxRoundTicks = FMath::Max(MaxRoundTicks, RoundTicks);
+	}
+
+	const FSpatialMockConnectionStats StatsAfter = Server.NetDriver->Connection->GetMockConnection()->GetStats();
+	const int32 NumRPCs = NumEntities * NumRounds;
+	TestEqual(TEXT("Every RPC is sent as one command request"), StatsAfter.NumCommandRequests - StatsBefore.NumCommandRequests, NumRPCs);
+
+	AddInfo(FString::Printf(TEXT("Made %d RPC round trips in %.3f seconds (%.1f round trips per second)."),
+		NumRPCs, TotalSeconds, NumRPCs / FMath::Max(TotalSeconds, SMALL_NUMBER)));
+	AddInfo(FString::Printf(TEXT("Round trip for %d RPCs: %.3f ms and %.1f ticks on average, %.3f ms and %d ticks at most. Responses took %.3f ms on average, %.3f ms at most."),
+		NumEntities, 1000.0 * TotalSeconds / NumRounds, (float)TotalTicks / NumRounds, 1000.0 * MaxRoundSeconds, MaxRoundTicks,
+		1000.0 * StatsAfter.AverageResponseLatency, 1000.0 * StatsAfter.MaxResponseLatency));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
+
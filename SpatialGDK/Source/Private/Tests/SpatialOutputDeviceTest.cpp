@@ -0,0 +1,269 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/SpatialOutputDevice.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+namespace
+{
+
+const int32 NUM_STORM_THREADS = 8;
+const int32 NUM_STORM_MESSAGES_PER_THREAD = 20000;
+// Small enough for the storm to overflow it between flushes.
+const uint32 TEST_RING_SIZE = 1024;
+
+const int32 NUM_REPEATED_MESSAGES = 1000;
+
+const int32 NUM_RATE_LIMITED_MESSAGES = 1000;
+const float TEST_MESSAGES_PER_SECOND = 10.0f;
+const float TEST_MESSAGE_BURST = 50.0f;
+
+const double FLUSH_TIMEOUT_SECONDS = 5.0;
+
+// Keeps what the output device would have sent to SpatialOS. It is registered with the log like any other, so it also sees
+// whatever else is logged while the test runs; the test only looks at its own messages.
+class FCapturingSpatialOutputDevice : public FSpatialOutputDevice
+{
+public:
+	FCapturingSpatialOutputDevice(USpatialWorkerConnection* InConnection)
+		: FSpatialOutputDevice(InConnection, TEXT("SpatialOutputDeviceTest"))
+	{
+	}
+
+	// Waits until the flush thread has sent everything queued so far. Returns false if it doesn't within the timeout.
+	bool WaitUntilFlushed()
+	{
+		const double Timeout = FPlatformTime::Seconds() + FLUSH_TIMEOUT_SECONDS;
+		while (FPlatformAtomics::AtomicRead(&EnqueuePosition) != FPlatformAtomics::AtomicRead((volatile int32*)&DequeuePosition))
+		{
+			if (FPlatformTime::Seconds() > Timeout)
+			{
+				return false;
+			}
+			FPlatformProcess::Sleep(SpatialConstants::LOG_FLUSH_INTERVAL_SECONDS);
+		}
+
+		// Suppressed and dropped message counts are reported on a later flush than the messages themselves, once the category
+		// has a token for them again.
+		FPlatformProcess::Sleep(5.0f * SpatialConstants::LOG_FLUSH_INTERVAL_SECONDS);
+		return true;
+	}
+
+	TArray<FString> GetSentMessages()
+	{
+		FScopeLock Lock(&SentMessagesCriticalSection);
+		return SentMessages;
+	}
+
+protected:
+	void SendLogMessage(ELogVerbosity::Type Verbosity, const TCHAR* Message) override
+	{
+		FScopeLock Lock(&SentMessagesCriticalSection);
+		SentMessages.Add(Message);
+	}
+
+private:
+	FCriticalSection SentMessagesCriticalSection;
+	TArray<FString> SentMessages;
+};
+
+// The number N in a message ending "(repeated N times)", or 1 if it doesn't.
+int32 GetRepeatCount(const FString& Message)
+{
+	int32 RepeatedIndex = Message.Find(TEXT(" (repeated "), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+	return RepeatedIndex == INDEX_NONE ? 1 : FCString::Atoi(*Message + RepeatedIndex + 11);
+}
+
+// The number N in a message starting "N <Suffix>", summed over every such message.
+int32 SumReportedCounts(const TArray<FString>& Messages, const TCHAR* Suffix)
+{
+	int32 Count = 0;
+	for (const FString& Message : Messages)
+	{
+		if (Message.Contains(Suffix, ESearchCase::CaseSensitive))
+		{
+			Count += FCString::Atoi(*Message);
+		}
+	}
+	return Count;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialOutputDeviceTest, "SpatialGDK.OutputDevice.LogStorm", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialOutputDeviceTest::RunTest(const FString& Parameters)
+{
+	// The output device reads its settings when it is created.
+	USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+	const uint32 OldMaxQueuedLogMessages = Settings->MaxQueuedLogMessages;
+	const float OldLogMessagesPerSecondPerCategory = Settings->LogMessagesPerSecondPerCategory;
+	const float OldLogMessageBurstPerCategory = Settings->LogMessageBurstPerCategory;
+	ON_SCOPE_EXIT
+	{
+		Settings->MaxQueuedLogMessages = OldMaxQueuedLogMessages;
+		Settings->LogMessagesPerSecondPerCategory = OldLogMessagesPerSecondPerCategory;
+		Settings->LogMessageBurstPerCategory = OldLogMessageBurstPerCategory;
+	};
+
+	// Messages are only forwarded while the connection is up.
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	Settings->MaxQueuedLogMessages = TEST_RING_SIZE;
+	Settings->LogMessagesPerSecondPerCategory = 0.0f;
+
+	// A storm of distinct messages from many threads at once. The ring overflows, and whatever doesn't fit is counted as dropped.
+	{
+		FCapturingSpatialOutputDevice OutputDevice(Server.NetDriver->Connection);
+		const FName Category(TEXT("LogSpatialOutputDeviceStorm"));
+
+		TArray<TFuture<double>> Threads;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 ThreadIndex = 0; ThreadIndex < NUM_STORM_THREADS; ThreadIndex++)
+		{
+			Threads.Add(Async<double>(EAsyncExecution::Thread, [&OutputDevice, &Category, ThreadIndex]()
+			{
+				double MaxCallSeconds = 0.0;
+				for (int32 i = 0; i < NUM_STORM_MESSAGES_PER_THREAD; i++)
+				{
+					const FString Message = FString::Printf(TEXT("Storm thread %d message %d"), ThreadIndex, i);
+					const double CallStartTime = FPlatformTime::Seconds();
+					OutputDevice.Serialize(*Message, ELogVerbosity::Warning, Category);
+					MaxCallSeconds = FMath::Max(MaxCallSeconds, FPlatformTime::Seconds() - CallStartTime);
+				}
+				return MaxCallSeconds;
+			}));
+		}
+		double MaxCallSeconds = 0.0;
+		for (TFuture<double>& Thread : Threads)
+		{
+			MaxCallSeconds = FMath::Max(MaxCallSeconds, Thread.Get());
+		}
+		const double StormSeconds = FPlatformTime::Seconds() - StartTime;
+
+		if (!TestTrue(TEXT("The storm is flushed"), OutputDevice.WaitUntilFlushed()))
+		{
+			return false;
+		}
+
+		const TArray<FString> SentMessages = OutputDevice.GetSentMessages();
+		TSet<FString> SentStormMessages;
+		for (const FString& Message : SentMessages)
+		{
+			if (Message.StartsWith(TEXT("Storm thread "), ESearchCase::CaseSensitive))
+			{
+				bool bAlreadySent = false;
+				SentStormMessages.Add(Message, &bAlreadySent);
+				if (!TestFalse(FString::Printf(TEXT("'%s' is only sent once"), *Message), bAlreadySent))
+				{
+					return false;
+				}
+			}
+		}
+
+		const int32 NumStormMessages = NUM_STORM_THREADS * NUM_STORM_MESSAGES_PER_THREAD;
+		const int32 NumDropped = SumReportedCounts(SentMessages, TEXT(" messages were dropped as the log queue was full."));
+		TestTrue(TEXT("Some of the storm is dropped once the ring is full"), NumDropped > 0);
+		// Anything else logged during the storm may have been dropped too.
+		TestTrue(TEXT("Every message of the storm is either sent or counted as dropped"), SentStormMessages.Num() + NumDropped >= NumStormMessages);
+
+		AddInfo(FString::Printf(TEXT("%d threads logged %d messages in %.3f ms (%.0f ns per message, the slowest call %.3f ms). %d were sent and %d dropped with a ring of %u."),
+			NUM_STORM_THREADS, NumStormMessages, 1000.0 * StormSeconds, 1.0e9 * StormSeconds * NUM_STORM_THREADS / NumStormMessages, 1000.0 * MaxCallSeconds,
+			SentStormMessages.Num(), NumDropped, TEST_RING_SIZE));
+	}
+
+	// The same message logged over and over is sent once per flush, with a count.
+	{
+		FCapturingSpatialOutputDevice OutputDevice(Server.NetDriver->Connection);
+		const FName Category(TEXT("LogSpatialOutputDeviceRepeated"));
+		const TCHAR* RepeatedMessage = TEXT("Repeated test message");
+
+		for (int32 i = 0; i < NUM_REPEATED_MESSAGES; i++)
+		{
+			OutputDevice.Serialize(RepeatedMessage, ELogVerbosity::Warning, Category);
+			// Spread over a few flushes, so the ring never fills up.
+			if (i % (TEST_RING_SIZE / 2) == 0)
+			{
+				FPlatformProcess::Sleep(SpatialConstants::LOG_FLUSH_INTERVAL_SECONDS);
+			}
+		}
+
+		if (!TestTrue(TEXT("The repeated messages are flushed"), OutputDevice.WaitUntilFlushed()))
+		{
+			return false;
+		}
+
+		int32 NumSent = 0;
+		int32 NumRepeats = 0;
+		for (const FString& Message : OutputDevice.GetSentMessages())
+		{
+			if (Message.StartsWith(RepeatedMessage, ESearchCase::CaseSensitive))
+			{
+				NumSent++;
+				NumRepeats += GetRepeatCount(Message);
+			}
+		}
+
+		TestEqual(TEXT("Every repeat of the message is counted"), NumRepeats, NUM_REPEATED_MESSAGES);
+		TestTrue(TEXT("Repeats are coalesced rather than sent one by one"), NumSent < NUM_REPEATED_MESSAGES / 10);
+
+		AddInfo(FString::Printf(TEXT("%d repeats of a message were sent as %d messages."), NUM_REPEATED_MESSAGES, NumSent));
+	}
+
+	// A category logging faster than its rate gets its burst, then a token per refill, and a count of what was suppressed.
+	Settings->LogMessagesPerSecondPerCategory = TEST_MESSAGES_PER_SECOND;
+	Settings->LogMessageBurstPerCategory = TEST_MESSAGE_BURST;
+	{
+		FCapturingSpatialOutputDevice OutputDevice(Server.NetDriver->Connection);
+		const FName Category(TEXT("LogSpatialOutputDeviceRateLimited"));
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NUM_RATE_LIMITED_MESSAGES; i++)
+		{
+			OutputDevice.Serialize(*FString::Printf(TEXT("Rate limited message %d"), i), ELogVerbosity::Warning, Category);
+			if (i % (TEST_RING_SIZE / 2) == 0)
+			{
+				FPlatformProcess::Sleep(SpatialConstants::LOG_FLUSH_INTERVAL_SECONDS);
+			}
+		}
+
+		if (!TestTrue(TEXT("The rate limited messages are flushed"), OutputDevice.WaitUntilFlushed()))
+		{
+			return false;
+		}
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const TArray<FString> SentMessages = OutputDevice.GetSentMessages();
+		int32 NumSent = 0;
+		for (const FString& Message : SentMessages)
+		{
+			NumSent += Message.StartsWith(TEXT("Rate limited message "), ESearchCase::CaseSensitive) ? 1 : 0;
+		}
+		const int32 NumSuppressed = SumReportedCounts(SentMessages, *FString::Printf(TEXT(" messages in %s were suppressed by rate limiting."), *Category.ToString()));
+
+		TestTrue(TEXT("The category gets at least its burst"), NumSent >= (int32)TEST_MESSAGE_BURST);
+		TestTrue(TEXT("The category gets no more than its burst and rate allow"), NumSent <= (int32)(TEST_MESSAGE_BURST + ElapsedSeconds * TEST_MESSAGES_PER_SECOND) + 1);
+		TestEqual(TEXT("Every message of the category is either sent or counted as suppressed"), NumSent + NumSuppressed, NUM_RATE_LIMITED_MESSAGES);
+
+		AddInfo(FString::Printf(TEXT("%d messages logged in %.3f s at a limit of %.0f per second with a burst of %.0f: %d were sent and %d suppressed."),
+			NUM_RATE_LIMITED_MESSAGES, ElapsedSeconds, TEST_MESSAGES_PER_SECOND, TEST_MESSAGE_BURST, NumSent, NumSuppressed));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
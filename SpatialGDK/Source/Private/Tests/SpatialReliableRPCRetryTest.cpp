@@ -0,0 +1,184 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GameFramework/PlayerController.h"
+#include "Misc/ScopeExit.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialReceiver.h"
+#include "Interop/SpatialSender.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// Well clear of the ids the mock hands out, so they can't clash with entities the net driver creates itself.
+const Worker_EntityId TEST_ENTITY_ID = 1 << 20;
+
+// No worker is authoritative over this component, so the mock times out every command sent to it, as the runtime would.
+const Worker_ComponentId TEST_COMMAND_COMPONENT_ID = 1000000;
+
+const int32 NUM_TEST_RPCS = 1000;
+const int32 MAX_TICKS_TO_AUTHORITY = 10;
+const int32 MAX_TICKS_TO_RESPOND = 5;
+
+// The attempts the test RPCs have already made. Each waits twice as long as the one before it to be retried.
+const uint32 FIRST_TEST_ATTEMPTS = 2;
+const uint32 LAST_TEST_ATTEMPTS = 4;
+
+bool IsRetryHeap(const TArray<FReliableRPCRetry>& Retries)
+{
+	for (int32 i = 1; i < Retries.Num(); i++)
+	{
+		if (Retries[i] < Retries[(i - 1) / 2])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialReliableRPCRetryTest, "SpatialGDK.NetDriver.MockConnection.ReliableRPCRetries", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialReliableRPCRetryTest::RunTest(const FString& Parameters)
+{
+	USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+	const uint32 OldMaxReliableRPCRetries = Settings->MaxReliableRPCRetries;
+	ON_SCOPE_EXIT
+	{
+		Settings->MaxReliableRPCRetries = OldMaxReliableRPCRetries;
+	};
+	// No limit until the limit itself is tested, so every test RPC can be queued.
+	Settings->MaxReliableRPCRetries = 0;
+
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	Server.CreateEntity(TEST_ENTITY_ID, FVector::ZeroVector);
+	if (!TestTrue(TEXT("The server is authoritative over the test entity"), Server.TickUntilAuthoritative({ TEST_ENTITY_ID }, MAX_TICKS_TO_AUTHORITY)))
+	{
+		return false;
+	}
+
+	UFunction* Function = APlayerController::StaticClass()->FindFunctionByName(TEXT("ClientReset"));
+	if (!TestNotNull(TEXT("Test RPC"), Function))
+	{
+		return false;
+	}
+	TestTrue(TEXT("The test RPC is reliable"), Function->HasAnyFunctionFlags(FUNC_NetReliable));
+
+	USpatialReceiver* Receiver = Server.NetDriver->Receiver;
+	TArray<uint8> RPCParameters;
+	RPCParameters.SetNumZeroed(Function->ParmsSize);
+
+	// Sends a command the mock will fail, and registers it as a reliable RPC the way USpatialSender::SendRPC does.
+	auto SendFailingRPC = [&Server, Receiver, Function, &RPCParameters](UObject* TargetObject, uint32 Attempts, double Deadline)
+	{
+		Worker_CommandRequest Request = {};
+		Request.component_id = TEST_COMMAND_COMPONENT_ID;
+		Request.schema_type = Schema_CreateCommandRequest(TEST_COMMAND_COMPONENT_ID, 1);
+		const Worker_RequestId RequestId = Server.NetDriver->Connection->SendCommandRequest(TEST_ENTITY_ID, &Request, 1);
+
+		TSharedRef<FPendingRPCParams> Params = MakeShared<FPendingRPCParams>(TargetObject, Function, RPCParameters.GetData());
+		Params->Attempts = Attempts;
+		Params->Deadline = Deadline;
+		Receiver->AddPendingReliableRPC(RequestId, Params);
+	};
+
+	auto TickUntilResponded = [this, &Server, Receiver]()
+	{
+		for (int32 TickCount = 0; TickCount < MAX_TICKS_TO_RESPOND && Receiver->GetNumPendingReliableRPCs() > 0; TickCount++)
+		{
+			Server.Tick();
+		}
+		return TestEqual(TEXT("Every failed command is answered"), Receiver->GetNumPendingReliableRPCs(), 0);
+	};
+
+	// Failed commands are queued for retry, after a wait that doubles with each attempt. The targets are never replicated,
+	// so when they come due the retries are taken off the queue without sending anything.
+	UObject* TargetObject = Server.NetDriver;
+	TArray<int32> NumRPCsByAttempts;
+	NumRPCsByAttempts.SetNumZeroed(LAST_TEST_ATTEMPTS + 1);
+
+	const double SendTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NUM_TEST_RPCS; i++)
+	{
+		const uint32 Attempts = FIRST_TEST_ATTEMPTS + i % (LAST_TEST_ATTEMPTS - FIRST_TEST_ATTEMPTS + 1);
+		SendFailingRPC(TargetObject, Attempts, 0.0);
+		NumRPCsByAttempts[Attempts]++;
+	}
+
+	if (!TickUntilResponded())
+	{
+		return false;
+	}
+	const double RespondedTime = FPlatformTime::Seconds();
+
+	TestEqual(TEXT("Every failed reliable RPC is queued for retry"), Receiver->GetReliableRPCRetries().Num(), NUM_TEST_RPCS);
+	TestTrue(TEXT("Retries are kept in a heap ordered by retry time"), IsRetryHeap(Receiver->GetReliableRPCRetries()));
+
+	for (const FReliableRPCRetry& Retry : Receiver->GetReliableRPCRetries())
+	{
+		const float WaitTime = SpatialConstants::GetCommandRetryWaitTimeSeconds(Retry.Params->Attempts);
+		if (!TestTrue(FString::Printf(TEXT("An RPC which has made %d attempts is retried %f seconds after it fails"), Retry.Params->Attempts, WaitTime),
+			Retry.RetryTime >= SendTime + WaitTime && Retry.RetryTime <= RespondedTime + WaitTime))
+		{
+			break;
+		}
+	}
+
+	TestEqual(TEXT("The earliest retry is on top"), Receiver->GetReliableRPCRetries().HeapTop().Params->Attempts, (int32)FIRST_TEST_ATTEMPTS);
+
+	// Only the retries that have come due are taken, earliest first.
+	FPlatformProcess::Sleep(SpatialConstants::GetCommandRetryWaitTimeSeconds(FIRST_TEST_ATTEMPTS) + 0.1f);
+	Receiver->ProcessReliableRPCRetries();
+	TestEqual(TEXT("Only the retries which are due are taken"), Receiver->GetReliableRPCRetries().Num(), NUM_TEST_RPCS - NumRPCsByAttempts[FIRST_TEST_ATTEMPTS]);
+	TestTrue(TEXT("The heap is still ordered after taking retries"), IsRetryHeap(Receiver->GetReliableRPCRetries()));
+
+	// The rest would come due while the test carries on, so start the remaining checks from an empty queue.
+	Receiver->ClearReliableRPCRetries();
+
+	// RPCs which have run out of attempts, run out of time, or whose target has been destroyed are dropped rather than retried.
+	UObject* DestroyedTarget = NewObject<UObject>(GetTransientPackage());
+	SendFailingRPC(TargetObject, SpatialConstants::MAX_NUMBER_COMMAND_ATTEMPTS, 0.0);
+	SendFailingRPC(TargetObject, FIRST_TEST_ATTEMPTS, FPlatformTime::Seconds());
+	SendFailingRPC(DestroyedTarget, FIRST_TEST_ATTEMPTS, 0.0);
+	DestroyedTarget->MarkPendingKill();
+
+	if (!TickUntilResponded())
+	{
+		return false;
+	}
+	TestEqual(TEXT("RPCs out of attempts, past their deadline, or with a destroyed target aren't retried"), Receiver->GetReliableRPCRetries().Num(), 0);
+
+	// Once the queue is full, further failures are dropped rather than queued.
+	const int32 MaxRetries = 10;
+	Settings->MaxReliableRPCRetries = MaxRetries;
+	for (int32 i = 0; i < MaxRetries * 2; i++)
+	{
+		SendFailingRPC(TargetObject, LAST_TEST_ATTEMPTS, 0.0);
+	}
+
+	if (!TickUntilResponded())
+	{
+		return false;
+	}
+	TestEqual(TEXT("No more retries are queued than the configured maximum"), Receiver->GetReliableRPCRetries().Num(), MaxRetries);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,258 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "UObject/UObjectIterator.h"
+
+#include "EngineClasses/SpatialNetDriver.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialWorkerConnection.h"
+#include "Interop/SpatialStaticComponentView.h"
+#include "Interop/SpatialTypebindingManager.h"
+#include "Schema/Rotation.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKSettings.h"
+#include "Tests/SpatialMockServerWorld.h"
+#include "Utils/EntityRegistry.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+const int32 NUM_TEST_ACTORS = 100;
+const int32 MAX_TICKS_TO_CREATE_ACTORS = 20;
+
+// Each actor moves and turns a little every tick for a couple of seconds, then stops.
+const int32 NUM_MOVING_TICKS = 60;
+const int32 NUM_RESTING_TICKS = 5;
+const float TEST_TICK_SECONDS = 1.0f / 30.0f;
+const FVector MOVE_PER_TICK(37.0f, 11.0f, 0.0f);
+const float YAW_PER_TICK = 2.0f;
+
+// Rotation is sent quantized to 16 bits per axis, and positions go through double precision metres.
+const float MAX_ROTATION_ERROR = 360.0f / 65536.0f;
+const float MAX_POSITION_ERROR = 0.01f;
+
+class FScopedDefaultTransformReplication
+{
+public:
+	FScopedDefaultTransformReplication(float PositionThreshold, float RotationThreshold, float MaxUpdateRate)
+	{
+		USpatialGDKSettings* Settings = GetMutableDefault<USpatialGDKSettings>();
+		OldSettings = Settings->DefaultTransformReplication;
+		Settings->DefaultTransformReplication.PositionThreshold = PositionThreshold;
+		Settings->DefaultTransformReplication.RotationThreshold = RotationThreshold;
+		Settings->DefaultTransformReplication.MaxUpdateRate = MaxUpdateRate;
+	}
+
+	~FScopedDefaultTransformReplication()
+	{
+		GetMutableDefault<USpatialGDKSettings>()->DefaultTransformReplication = OldSettings;
+	}
+
+private:
+	FSpatialTransformReplicationSettings OldSettings;
+};
+
+// Any actor class in the schema database that can be spawned on its own, has no transform overrides, and isn't a pawn, whose
+// position would also be sent for its controller. Null if there isn't one.
+UClass* FindMovableActorClass(USpatialNetDriver* NetDriver)
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->IsChildOf<AActor>() && !Class->IsChildOf<AInfo>() && !Class->IsChildOf<AController>() && !Class->IsChildOf<APawn>() &&
+			!Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists) &&
+			!Class->HasAnySpatialClassFlags(SPATIALCLASS_Singleton) &&
+			Class->GetDefaultObject<AActor>()->GetIsReplicated() &&
+			&GetDefault<USpatialGDKSettings>()->GetTransformReplicationSettings(Class) == &GetDefault<USpatialGDKSettings>()->DefaultTransformReplication &&
+			NetDriver->TypebindingManager->IsSupportedClass(Class))
+		{
+			return Class;
+		}
+	}
+
+	return nullptr;
+}
+
+struct FSentTransforms
+{
+	int32 NumPositionUpdates = 0;
+	int32 NumRotationUpdates = 0;
+	uint32 NumBytes = 0;
+
+	// The last position and rotation sent for each entity.
+	TMap<Worker_EntityId, FVector> Positions;
+	TMap<Worker_EntityId, FRotator> Rotations;
+};
+
+// Adds the Position and Rotation updates the mock has echoed back since it was last asked to Sent.
+void TakeTransformUpdates(FSpatialMockServerWorld& Server, FSentTransforms& Sent)
+{
+	TUniquePtr<FSpatialOpList> OpList = Server.NetDriver->Connection->GetMockConnection()->GetOpList();
+	if (!OpList.IsValid())
+	{
+		return;
+	}
+
+	for (uint32 i = 0; i < OpList->OpList->op_count; i++)
+	{
+		const Worker_Op& Op = OpList->OpList->ops[i];
+		if (Op.op_type != WORKER_OP_TYPE_COMPONENT_UPDATE)
+		{
+			continue;
+		}
+
+		const Worker_ComponentUpdate& Update = Op.component_update.update;
+		if (Update.component_id == SpatialConstants::POSITION_COMPONENT_ID)
+		{
+			improbable::Position Position;
+			Position.ApplyComponentUpdate(Update);
+			Sent.Positions.Add(Op.component_update.entity_id, improbable::Coordinates::ToFVector(Position.Coords));
+			Sent.NumPositionUpdates++;
+		}
+		else if (Update.component_id == SpatialConstants::ROTATION_COMPONENT_ID)
+		{
+			improbable::Rotation Rotation;
+			Rotation.ApplyComponentUpdate(Update);
+			Sent.Rotations.Add(Op.component_update.entity_id, Rotation.ToFRotator());
+			Sent.NumRotationUpdates++;
+		}
+		else
+		{
+			continue;
+		}
+
+		Sent.NumBytes += Schema_GetWriteBufferLength(Schema_GetComponentUpdateFields(Update.schema_type));
+	}
+}
+
+// Spawns actors of ActorClass with the given transform replication settings, moves them for a while and then leaves them at rest.
+// Returns everything sent for their transforms, or false if they couldn't be created.
+bool MoveActors(FAutomationTestBase& Test, FSpatialMockServerWorld& Server, UClass* ActorClass, const TCHAR* What,
+	float PositionThreshold, float RotationThreshold, float MaxUpdateRate, FSentTransforms& OutSent)
+{
+	FScopedDefaultTransformReplication ScopedSettings(PositionThreshold, RotationThreshold, MaxUpdateRate);
+
+	TArray<AActor*> Actors;
+	for (int32 i = 0; i < NUM_TEST_ACTORS; i++)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Actors.Add(Server.World->SpawnActor<AActor>(ActorClass, FVector(0.0f, i * 1000.0f, 0.0f), FRotator::ZeroRotator, SpawnParameters));
+	}
+
+	TArray<Worker_EntityId> EntityIds;
+	for (int32 Tick = 0; Tick < MAX_TICKS_TO_CREATE_ACTORS && EntityIds.Num() < NUM_TEST_ACTORS; Tick++)
+	{
+		Server.Tick(TEST_TICK_SECONDS);
+
+		EntityIds.Reset();
+		for (AActor* Actor : Actors)
+		{
+			const Worker_EntityId EntityId = Server.NetDriver->GetEntityRegistry()->GetEntityIdFromActor(Actor);
+			if (EntityId == SpatialConstants::INVALID_ENTITY_ID || !Server.NetDriver->StaticComponentView->HasAuthority(EntityId, SpatialConstants::POSITION_COMPONENT_ID))
+			{
+				break;
+			}
+			EntityIds.Add(EntityId);
+		}
+	}
+	if (!Test.TestEqual(FString::Printf(TEXT("%s: the server is authoritative over an entity for every test actor"), What), EntityIds.Num(), NUM_TEST_ACTORS))
+	{
+		return false;
+	}
+
+	// What was sent while they were created isn't part of the measurement. The mock's echoes are taken after every tick, before the next one can.
+	FSentTransforms Discarded;
+	TakeTransformUpdates(Server, Discarded);
+
+	for (int32 Tick = 0; Tick < NUM_MOVING_TICKS + NUM_RESTING_TICKS; Tick++)
+	{
+		if (Tick < NUM_MOVING_TICKS)
+		{
+			for (AActor* Actor : Actors)
+			{
+				Actor->SetActorLocationAndRotation(Actor->GetActorLocation() + MOVE_PER_TICK, Actor->GetActorRotation() + FRotator(0.0f, YAW_PER_TICK, 0.0f));
+			}
+		}
+
+		Server.Tick(TEST_TICK_SECONDS);
+		TakeTransformUpdates(Server, OutSent);
+	}
+
+	// Wherever they were last sent, every actor's entity ends up where the actor came to rest.
+	for (int32 i = 0; i < NUM_TEST_ACTORS; i++)
+	{
+		const FVector* SentPosition = OutSent.Positions.Find(EntityIds[i]);
+		const FRotator* SentRotation = OutSent.Rotations.Find(EntityIds[i]);
+		if (!Test.TestTrue(FString::Printf(TEXT("%s: actor %d's resting position is sent"), What, i), SentPosition != nullptr && SentPosition->Equals(Actors[i]->GetActorLocation(), MAX_POSITION_ERROR)) ||
+			!Test.TestTrue(FString::Printf(TEXT("%s: actor %d's resting rotation is sent"), What, i), SentRotation != nullptr && SentRotation->Equals(Actors[i]->GetActorRotation(), MAX_ROTATION_ERROR)))
+		{
+			break;
+		}
+	}
+
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+
+	return true;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpatialTransformUpdateTest, "SpatialGDK.NetDriver.MockConnection.TransformUpdates", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSpatialTransformUpdateTest::RunTest(const FString& Parameters)
+{
+	FSpatialMockServerWorld Server;
+	if (!Server.IsConnected(*this))
+	{
+		return false;
+	}
+
+	UClass* ActorClass = FindMovableActorClass(Server.NetDriver);
+	if (ActorClass == nullptr)
+	{
+		AddWarning(TEXT("No replicated actor class which can move on its own is in the schema database, so transform updates can't be tested."));
+		return true;
+	}
+
+	// Benchmark: the updates and bytes sent for the same movement with every change sent, with the default thresholds, and with those and an update rate limit.
+	const FSpatialTransformReplicationSettings Defaults;
+	FSentTransforms Unfiltered;
+	FSentTransforms Thresholded;
+	FSentTransforms RateLimited;
+	if (!MoveActors(*this, Server, ActorClass, TEXT("No thresholds"), 0.0f, 0.0f, 0.0f, Unfiltered) ||
+		!MoveActors(*this, Server, ActorClass, TEXT("Default thresholds"), Defaults.PositionThreshold, Defaults.RotationThreshold, 0.0f, Thresholded) ||
+		!MoveActors(*this, Server, ActorClass, TEXT("Default thresholds at 5 updates a second"), Defaults.PositionThreshold, Defaults.RotationThreshold, 5.0f, RateLimited))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("The thresholds send fewer updates than sending every change"), Thresholded.NumPositionUpdates + Thresholded.NumRotationUpdates < Unfiltered.NumPositionUpdates + Unfiltered.NumRotationUpdates);
+	TestTrue(TEXT("The update rate limit sends fewer updates than the thresholds alone"), RateLimited.NumPositionUpdates + RateLimited.NumRotationUpdates < Thresholded.NumPositionUpdates + Thresholded.NumRotationUpdates);
+
+	auto Describe = [](const TCHAR* What, const FSentTransforms& Sent)
+	{
+		return FString::Printf(TEXT("%s: %d position and %d rotation updates, %u bytes."), What, Sent.NumPositionUpdates, Sent.NumRotationUpdates, Sent.NumBytes);
+	};
+	AddInfo(FString::Printf(TEXT("%d %s actors moving for %d ticks, then resting:"), NUM_TEST_ACTORS, *ActorClass->GetName(), NUM_MOVING_TICKS));
+	AddInfo(Describe(TEXT("Every change"), Unfiltered));
+	AddInfo(Describe(TEXT("Default thresholds"), Thresholded));
+	AddInfo(Describe(TEXT("Default thresholds at 5 updates a second"), RateLimited));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
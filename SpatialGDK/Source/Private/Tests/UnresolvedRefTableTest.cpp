@@ -0,0 +1,305 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+
+#include "Utils/UnresolvedRefTable.h"
+
+namespace
+{
+
+using FTestTable = TUnresolvedRefTable<int32, int32>;
+
+const int32 NUM_SOAK_OPERATIONS = 100000;
+const int32 NUM_TEST_OWNERS = 16;
+const int32 NUM_TEST_KEYS = 64;
+const int32 MAX_DEAD_HANDLES = 256;
+const int32 RANDOM_SEED = 0x5EED;
+
+// The table never dereferences its owners, so any distinct pointers will do.
+const UObject* TestOwner(int32 OwnerIndex)
+{
+	return reinterpret_cast<const UObject*>(static_cast<UPTRINT>(OwnerIndex + 1) * 16);
+}
+
+// What the table should contain, kept the slow and obvious way.
+struct FModelEntry
+{
+	FUnresolvedRefHandle Handle;
+	const UObject* Owner;
+	double Time;
+	int32 Value;
+	TArray<int32> Keys;
+};
+
+class FTableModel
+{
+public:
+	// Entries in the order they were added, which is also oldest first.
+	TArray<FModelEntry> Entries;
+	// For each key, the entries waiting on it in the order they started waiting.
+	TMap<int32, TArray<FUnresolvedRefHandle>> KeyLists;
+	// Handles of removed entries, which must never find anything again.
+	TArray<FUnresolvedRefHandle> DeadHandles;
+
+	int32 IndexOf(FUnresolvedRefHandle Handle) const
+	{
+		return Entries.IndexOfByPredicate([Handle](const FModelEntry& Entry) { return Entry.Handle == Handle; });
+	}
+
+	void AddKey(int32 EntryIndex, int32 Key)
+	{
+		FModelEntry& Entry = Entries[EntryIndex];
+		if (!Entry.Keys.Contains(Key))
+		{
+			Entry.Keys.Add(Key);
+			KeyLists.FindOrAdd(Key).Add(Entry.Handle);
+		}
+	}
+
+	TArray<FUnresolvedRefHandle> ResolveKey(int32 Key)
+	{
+		TArray<FUnresolvedRefHandle> Handles;
+		if (KeyLists.RemoveAndCopyValue(Key, Handles))
+		{
+			for (FUnresolvedRefHandle Handle : Handles)
+			{
+				Entries[IndexOf(Handle)].Keys.Remove(Key);
+			}
+		}
+		return Handles;
+	}
+
+	void RemoveAt(int32 EntryIndex)
+	{
+		const FModelEntry& Entry = Entries[EntryIndex];
+		for (int32 Key : Entry.Keys)
+		{
+			TArray<FUnresolvedRefHandle>& KeyList = KeyLists.FindChecked(Key);
+			KeyList.Remove(Entry.Handle);
+			if (KeyList.Num() == 0)
+			{
+				KeyLists.Remove(Key);
+			}
+		}
+
+		if (DeadHandles.Num() < MAX_DEAD_HANDLES)
+		{
+			DeadHandles.Add(Entry.Handle);
+		}
+		Entries.RemoveAt(EntryIndex);
+	}
+};
+
+// Removed entries as reported by the table's callback, in the order it was called.
+struct FRemovedEntry
+{
+	FUnresolvedRefHandle Handle;
+	int32 Value;
+};
+
+bool RemovedEntriesMatch(FAutomationTestBase& Test, const TCHAR* What, const TArray<FRemovedEntry>& Removed, const TArray<FModelEntry>& Expected)
+{
+	if (!Test.TestEqual(FString::Printf(TEXT("%s: one callback per removed entry"), What), Removed.Num(), Expected.Num()))
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < Removed.Num(); i++)
+	{
+		if (!Test.TestTrue(FString::Printf(TEXT("%s: entries are removed oldest first, with their values"), What),
+			Removed[i].Handle == Expected[i].Handle && Removed[i].Value == Expected[i].Value))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool TableMatchesModel(FAutomationTestBase& Test, FTestTable& Table, const FTableModel& Model)
+{
+	if (!Test.TestEqual(TEXT("The table holds as many entries as the model"), Table.Num(), Model.Entries.Num()))
+	{
+		return false;
+	}
+
+	for (const FModelEntry& Entry : Model.Entries)
+	{
+		const int32* Value = Table.Find(Entry.Handle);
+		if (!Test.TestTrue(TEXT("Live entries are found with their values"), Value != nullptr && *Value == Entry.Value) ||
+			!Test.TestEqual(TEXT("Live entries wait on the keys they were given"), Table.NumKeys(Entry.Handle), Entry.Keys.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (FUnresolvedRefHandle Handle : Model.DeadHandles)
+	{
+		if (!Test.TestFalse(TEXT("Handles of removed entries are invalid, even once their slot is reused"), Table.IsValid(Handle)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnresolvedRefTableSoakTest, "SpatialGDK.Utils.UnresolvedRefTable.Soak", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FUnresolvedRefTableSoakTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(RANDOM_SEED);
+	FTestTable Table;
+	FTableModel Model;
+
+	double Now = 0.0;
+	int32 NextValue = 0;
+	int32 NumTimedOut = 0;
+	int32 NumOverCapacity = 0;
+
+	for (int32 Operation = 0; Operation < NUM_SOAK_OPERATIONS; Operation++)
+	{
+		Now += Random.FRandRange(0.0f, 0.01f);
+
+		const int32 Roll = Random.RandRange(0, 99);
+		if (Roll < 40)
+		{
+			// Add an entry waiting on a few keys, as the sender and receiver do.
+			const UObject* Owner = TestOwner(Random.RandRange(0, NUM_TEST_OWNERS - 1));
+			const int32 Value = NextValue++;
+			const FUnresolvedRefHandle Handle = Table.Add(Owner, int32(Value), Now);
+
+			Model.Entries.Add(FModelEntry{ Handle, Owner, Now, Value, {} });
+			const int32 NumKeys = Random.RandRange(1, 3);
+			for (int32 i = 0; i < NumKeys; i++)
+			{
+				const int32 Key = Random.RandRange(0, NUM_TEST_KEYS - 1);
+				Table.AddKey(Handle, Key);
+				Model.AddKey(Model.Entries.Num() - 1, Key);
+			}
+		}
+		else if (Roll < 55 && Model.Entries.Num() > 0)
+		{
+			// Make an older entry wait on another key, possibly one it already waits on.
+			const int32 EntryIndex = Random.RandRange(0, Model.Entries.Num() - 1);
+			const int32 Key = Random.RandRange(0, NUM_TEST_KEYS - 1);
+			Table.AddKey(Model.Entries[EntryIndex].Handle, Key);
+			Model.AddKey(EntryIndex, Key);
+		}
+		else if (Roll < 75)
+		{
+			// Resolve a key, then remove the entries that have nothing left to wait on, as the receiver does.
+			const int32 Key = Random.RandRange(0, NUM_TEST_KEYS - 1);
+			TArray<FUnresolvedRefHandle> Handles;
+			Table.ResolveKey(Key, Handles);
+			const TArray<FUnresolvedRefHandle> ExpectedHandles = Model.ResolveKey(Key);
+			if (!TestTrue(TEXT("Resolving a key returns the entries waiting on it, in the order they started waiting"), Handles == ExpectedHandles))
+			{
+				return false;
+			}
+
+			for (FUnresolvedRefHandle Handle : Handles)
+			{
+				if (Table.NumKeys(Handle) == 0)
+				{
+					Table.Remove(Handle);
+					Model.RemoveAt(Model.IndexOf(Handle));
+				}
+			}
+		}
+		else if (Roll < 85 && Model.Entries.Num() > 0)
+		{
+			// Remove an entry directly. Removing it twice must do nothing.
+			const int32 EntryIndex = Random.RandRange(0, Model.Entries.Num() - 1);
+			const FUnresolvedRefHandle Handle = Model.Entries[EntryIndex].Handle;
+			Table.Remove(Handle);
+			Table.Remove(Handle);
+			Model.RemoveAt(EntryIndex);
+		}
+		else if (Roll < 90)
+		{
+			// Destroy an owner.
+			const UObject* Owner = TestOwner(Random.RandRange(0, NUM_TEST_OWNERS - 1));
+
+			TArray<FModelEntry> Expected;
+			for (int32 i = Model.Entries.Num() - 1; i >= 0; i--)
+			{
+				if (Model.Entries[i].Owner == Owner)
+				{
+					Expected.Insert(Model.Entries[i], 0);
+					Model.RemoveAt(i);
+				}
+			}
+
+			TArray<FRemovedEntry> Removed;
+			const int32 NumRemoved = Table.RemoveOwner(Owner, [&Removed](FUnresolvedRefHandle Handle, int32& Value)
+			{
+				Removed.Add(FRemovedEntry{ Handle, Value });
+			});
+
+			if (!TestEqual(TEXT("RemoveOwner returns the number of entries removed"), NumRemoved, Expected.Num()) ||
+				!RemovedEntriesMatch(*this, TEXT("RemoveOwner"), Removed, Expected))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// Expire entries, sometimes by age and sometimes by capacity.
+			const double Timeout = Random.RandRange(0, 1) ? Random.FRandRange(0.5f, 5.0f) : 0.0;
+			const int32 MaxEntries = Random.RandRange(0, 1) ? Random.RandRange(1, 256) : 0;
+
+			TArray<FModelEntry> Expected;
+			while (Model.Entries.Num() > 0)
+			{
+				const bool bTimedOut = Timeout > 0.0 && Now - Model.Entries[0].Time > Timeout;
+				const bool bOverCapacity = MaxEntries > 0 && Model.Entries.Num() > MaxEntries;
+				if (!bTimedOut && !bOverCapacity)
+				{
+					break;
+				}
+
+				NumTimedOut += bTimedOut ? 1 : 0;
+				NumOverCapacity += bTimedOut ? 0 : 1;
+				Expected.Add(Model.Entries[0]);
+				Model.RemoveAt(0);
+			}
+
+			TArray<FRemovedEntry> Removed;
+			const int32 NumRemoved = Table.RemoveExpired(Now, Timeout, MaxEntries, [&Removed](FUnresolvedRefHandle Handle, int32& Value)
+			{
+				Removed.Add(FRemovedEntry{ Handle, Value });
+			});
+
+			if (!TestEqual(TEXT("RemoveExpired returns the number of entries removed"), NumRemoved, Expected.Num()) ||
+				!RemovedEntriesMatch(*this, TEXT("RemoveExpired"), Removed, Expected))
+			{
+				return false;
+			}
+		}
+
+		if (!TableMatchesModel(*this, Table, Model))
+		{
+			AddInfo(FString::Printf(TEXT("Mismatch after operation %d"), Operation));
+			return false;
+		}
+	}
+
+	TestTrue(TEXT("The soak expired entries by age"), NumTimedOut > 0);
+	TestTrue(TEXT("The soak expired entries by capacity"), NumOverCapacity > 0);
+
+	// Draining the table leaves nothing behind.
+	const int32 NumLeft = Model.Entries.Num();
+	TestEqual(TEXT("Expiring everything removes every entry"), Table.RemoveExpired(Now + 1.0, 0.5, 0, [](FUnresolvedRefHandle Handle, int32& Value) {}), NumLeft);
+	TestEqual(TEXT("The table is empty"), Table.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -27,6 +27,9 @@ bool ComponentFactory::FillSchemaObject(Schema_Object* ComponentObject, UObject*
 	// Populate the replicated data component updates from the replicated property changelist.
 	if (Changes.RepChanged.Num() > 0)
 	{
+		FClassInfo* Info = TypebindingManager->FindClassInfoByClass(Object->GetClass());
+		check(Info);
+
 		FChangelistIterator ChangelistIterator(Changes.RepChanged, 0);
 		FRepHandleIterator HandleIterator(ChangelistIterator, Changes.RepLayout.Cmds, Changes.RepLayout.BaseHandleToCmdIndex, 0, 1, 0, Changes.RepLayout.Cmds.Num() - 1);
 		while (HandleIterator.NextHandle())
@@ -36,10 +39,13 @@ bool ComponentFactory::FillSchemaObject(Schema_Object* ComponentObject, UObject*
 
 			if (GetGroupFromCondition(Parent.Condition) == PropertyGroup)
 			{
-				const uint8* Data = (uint8*)Object + Cmd.Offset;
+				check(HandleIterator.Handle > 0 && HandleIterator.Handle - 1 < Info->RepProperties.Num());
+				const FRepPropertyInfo& PropertyInfo = Info->RepProperties[HandleIterator.Handle - 1];
+
+				const uint8* Data = (uint8*)Object + PropertyInfo.Offset;
 				TSet<const UObject*> UnresolvedObjects;
 
-				AddProperty(ComponentObject, HandleIterator.Handle, Cmd.Property, Data, UnresolvedObjects, ClearedIds);
+				AddProperty(ComponentObject, HandleIterator.Handle, PropertyInfo.Handler, Data, UnresolvedObjects, ClearedIds);
 
 				if (UnresolvedObjects.Num() == 0)
 				{
@@ -86,7 +92,7 @@ bool ComponentFactory::FillHandoverSchemaObject(Schema_Object* ComponentObject,
 		const uint8* Data = (uint8*)Object + PropertyInfo.Offset;
 		TSet<const UObject*> UnresolvedObjects;
 
-		AddProperty(ComponentObject, ChangedHandle, PropertyInfo.Property, Data, UnresolvedObjects, ClearedIds);
+		AddProperty(ComponentObject, ChangedHandle, PropertyInfo.Handler, Data, UnresolvedObjects, ClearedIds);
 
 		if (UnresolvedObjects.Num() == 0)
 		{
@@ -108,11 +114,35 @@ bool ComponentFactory::FillHandoverSchemaObject(Schema_Object* ComponentObject,
 	return bWroteSomething;
 }
 
-void ComponentFactory::AddProperty(Schema_Object* Object, Schema_FieldId FieldId, UProperty* Property, const uint8* Data, TSet<const UObject*>& UnresolvedObjects, TArray<Schema_FieldId>* ClearedIds)
+void ComponentFactory::AddProperty(Schema_Object* Object, Schema_FieldId FieldId, const FSchemaPropertyHandler& Handler, const uint8* Data, TSet<const UObject*>& UnresolvedObjects, TArray<Schema_FieldId>* ClearedIds)
 {
-	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	if (Handler.Kind == ESchemaPropertyKind::Array)
+	{
+		UArrayProperty* ArrayProperty = static_cast<UArrayProperty*>(Handler.Property);
+		FScriptArrayHelper ArrayHelper(ArrayProperty, Data);
+		for (int i = 0; i < ArrayHelper.Num(); i++)
+		{
+			AddPropertyValue(Object, FieldId, Handler.InnerKind, ArrayProperty->Inner, Handler.StructFields.Get(), ArrayHelper.GetRawPtr(i), UnresolvedObjects);
+		}
+
+		if (ArrayHelper.Num() == 0 && ClearedIds)
+		{
+			ClearedIds->Add(FieldId);
+		}
+	}
+	else
 	{
-		UScriptStruct* Struct = StructProperty->Struct;
+		AddPropertyValue(Object, FieldId, Handler.Kind, Handler.Property, Handler.StructFields.Get(), Data, UnresolvedObjects);
+	}
+}
+
+void ComponentFactory::AddPropertyValue(Schema_Object* Object, Schema_FieldId FieldId, ESchemaPropertyKind Kind, UProperty* Property, const TArray<FSchemaPropertyHandler>* StructFields, const uint8* Data, TSet<const UObject*>& UnresolvedObjects)
+{
+	switch (Kind)
+	{
+	case ESchemaPropertyKind::Struct:
+	{
+		UScriptStruct* Struct = static_cast<UStructProperty*>(Property)->Struct;
 		FSpatialNetBitWriter ValueDataWriter(PackageMap, UnresolvedObjects);
 		bool bHasUnmapped = false;
 
@@ -135,53 +165,59 @@ void ComponentFactory::AddProperty(Schema_Object* Object, Schema_FieldId FieldId
 		}
 
 		AddPayloadToSchema(Object, FieldId, ValueDataWriter);
+		break;
 	}
-	else if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
-	{
-		Schema_AddBool(Object, FieldId, (uint8)BoolProperty->GetPropertyValue(Data));
-	}
-	else if (UFloatProperty* FloatProperty = Cast<UFloatProperty>(Property))
-	{
-		Schema_AddFloat(Object, FieldId, FloatProperty->GetPropertyValue(Data));
-	}
-	else if (UDoubleProperty* DoubleProperty = Cast<UDoubleProperty>(Property))
-	{
-		Schema_AddDouble(Object, FieldId, DoubleProperty->GetPropertyValue(Data));
-	}
-	else if (UInt8Property* Int8Property = Cast<UInt8Property>(Property))
-	{
-		Schema_AddInt32(Object, FieldId, (int32)Int8Property->GetPropertyValue(Data));
-	}
-	else if (UInt16Property* Int16Property = Cast<UInt16Property>(Property))
-	{
-		Schema_AddInt32(Object, FieldId, (int32)Int16Property->GetPropertyValue(Data));
-	}
-	else if (UIntProperty* IntProperty = Cast<UIntProperty>(Property))
-	{
-		Schema_AddInt32(Object, FieldId, IntProperty->GetPropertyValue(Data));
-	}
-	else if (UInt64Property* Int64Property = Cast<UInt64Property>(Property))
-	{
-		Schema_AddInt64(Object, FieldId, Int64Property->GetPropertyValue(Data));
-	}
-	else if (UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
-	{
-		Schema_AddUint32(Object, FieldId, (uint32)ByteProperty->GetPropertyValue(Data));
-	}
-	else if (UUInt16Property* UInt16Property = Cast<UUInt16Property>(Property))
-	{
-		Schema_AddUint32(Object, FieldId, (uint32)UInt16Property->GetPropertyValue(Data));
-	}
-	else if (UUInt32Property* UInt32Property = Cast<UUInt32Property>(Property))
-	{
-		Schema_AddUint32(Object, FieldId, UInt32Property->GetPropertyValue(Data));
-	}
-	else if (UUInt64Property* UInt64Property = Cast<UUInt64Property>(Property))
+	case ESchemaPropertyKind::SchemaStruct:
 	{
-		Schema_AddUint64(Object, FieldId, UInt64Property->GetPropertyValue(Data));
+		check(StructFields);
+		Schema_Object* StructObject = Schema_AddObject(Object, FieldId);
+		for (int32 i = 0; i < StructFields->Num(); i++)
+		{
+			const FSchemaPropertyHandler& FieldHandler = (*StructFields)[i];
+			// Empty arrays are left out of the object, so they don't need clearing.
+			AddProperty(StructObject, i + 1, FieldHandler, FieldHandler.Property->ContainerPtrToValuePtr<uint8>(Data), UnresolvedObjects, nullptr);
+		}
+		break;
 	}
-	else if (UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+	case ESchemaPropertyKind::Bool:
+		Schema_AddBool(Object, FieldId, (uint8)static_cast<UBoolProperty*>(Property)->GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Float:
+		Schema_AddFloat(Object, FieldId, UFloatProperty::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Double:
+		Schema_AddDouble(Object, FieldId, UDoubleProperty::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Int8:
+		Schema_AddInt32(Object, FieldId, (int32)UInt8Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Int16:
+		Schema_AddInt32(Object, FieldId, (int32)UInt16Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Int32:
+		Schema_AddInt32(Object, FieldId, UIntProperty::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Int64:
+		Schema_AddInt64(Object, FieldId, UInt64Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Byte:
+		Schema_AddUint32(Object, FieldId, (uint32)UByteProperty::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::UInt16:
+		Schema_AddUint32(Object, FieldId, (uint32)UUInt16Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::UInt32:
+		Schema_AddUint32(Object, FieldId, UUInt32Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::UInt64:
+		Schema_AddUint64(Object, FieldId, UUInt64Property::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::SmallEnum:
+		Schema_AddUint32(Object, FieldId, Property->ElementSize == 1 ? (uint32)*Data : (uint32)*reinterpret_cast<const uint16*>(Data));
+		break;
+	case ESchemaPropertyKind::Object:
 	{
+		UObjectPropertyBase* ObjectProperty = static_cast<UObjectPropertyBase*>(Property);
 		FUnrealObjectRef ObjectRef = SpatialConstants::NULL_OBJECT_REF;
 
 		UObject* ObjectValue = ObjectProperty->GetObjectPropertyValue(Data);
@@ -220,46 +256,20 @@ void ComponentFactory::AddProperty(Schema_Object* Object, Schema_FieldId FieldId
 		}
 
 		AddObjectRefToSchema(Object, FieldId, ObjectRef);
+		break;
 	}
-	else if (UNameProperty* NameProperty = Cast<UNameProperty>(Property))
-	{
-		AddStringToSchema(Object, FieldId, NameProperty->GetPropertyValue(Data).ToString());
-	}
-	else if (UStrProperty* StrProperty = Cast<UStrProperty>(Property))
-	{
-		AddStringToSchema(Object, FieldId, StrProperty->GetPropertyValue(Data));
-	}
-	else if (UTextProperty* TextProperty = Cast<UTextProperty>(Property))
-	{
-		AddStringToSchema(Object, FieldId, TextProperty->GetPropertyValue(Data).ToString());
-	}
-	else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
-	{
-		FScriptArrayHelper ArrayHelper(ArrayProperty, Data);
-		for (int i = 0; i < ArrayHelper.Num(); i++)
-		{
-			AddProperty(Object, FieldId, ArrayProperty->Inner, ArrayHelper.GetRawPtr(i), UnresolvedObjects, ClearedIds);
-		}
-
-		if (ArrayHelper.Num() == 0 && ClearedIds)
-		{
-			ClearedIds->Add(FieldId);
-		}
-	}
-	else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
-	{
-		if (EnumProperty->ElementSize < 4)
-		{
-			Schema_AddUint32(Object, FieldId, (uint32)EnumProperty->GetUnderlyingProperty()->GetUnsignedIntPropertyValue(Data));
-		}
-		else
-		{
-			AddProperty(Object, FieldId, EnumProperty->GetUnderlyingProperty(), Data, UnresolvedObjects, ClearedIds);
-		}
-	}
-	else
-	{
+	case ESchemaPropertyKind::Name:
+		AddStringToSchema(Object, FieldId, UNameProperty::GetPropertyValue(Data).ToString());
+		break;
+	case ESchemaPropertyKind::String:
+		AddStringToSchema(Object, FieldId, UStrProperty::GetPropertyValue(Data));
+		break;
+	case ESchemaPropertyKind::Text:
+		AddStringToSchema(Object, FieldId, UTextProperty::GetPropertyValue(Data).ToString());
+		break;
+	default:
 		checkf(false, TEXT("Tried to add unknown property in field %d"), FieldId);
+		break;
 	}
 }
 
@@ -404,9 +414,13 @@ void ComponentFactory::AssignUnrealObjectRefToContext(UProperty* Property, const
 		UStruct* Owner = Cast<UStruct>(Outer);
 		const FString ContextName = Property->GetName() + TEXT("_SpatialOSContext");
 		UProperty* ContextProperty = Owner->FindPropertyByName(*ContextName);
-		const int32 PropertyOffsetDiff = ContextProperty->GetOffset_ForInternal() - Property->GetOffset_ForInternal();
-		FUnrealObjectRef& Context = *(reinterpret_cast<FUnrealObjectRef*>(const_cast<uint8*>(Data) + PropertyOffsetDiff));
-		Context = ObjectRef;
+		// Only properties declared with a context have one, e.g. none of the fields of schema structs do.
+		if (ContextProperty != nullptr)
+		{
+			const int32 PropertyOffsetDiff = ContextProperty->GetOffset_ForInternal() - Property->GetOffset_ForInternal();
+			FUnrealObjectRef& Context = *(reinterpret_cast<FUnrealObjectRef*>(const_cast<uint8*>(Data) + PropertyOffsetDiff));
+			Context = ObjectRef;
+		}
 	}
 }
 
@@ -22,49 +22,78 @@ ComponentReader::ComponentReader(USpatialNetDriver* InNetDriver, FObjectReferenc
 	, TypebindingManager(InNetDriver->TypebindingManager)
 	, RootObjectReferencesMap(InObjectReferencesMap)
 	, UnresolvedRefs(InUnresolvedRefs)
+	, DecodedFields(nullptr)
+	, DecodedObject(nullptr)
 {
 }
 
-void ComponentReader::ApplyComponentData(const Worker_ComponentData& ComponentData, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover)
+void ComponentReader::ApplyComponentData(const Worker_ComponentData& ComponentData, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover, const GeneratedComponentFields* InDecodedFields)
 {
 	Schema_Object* ComponentObject = Schema_GetComponentDataFields(ComponentData.schema_type);
 
+	DecodedFields = InDecodedFields;
+	DecodedObject = ComponentObject;
+
+	TArray<Schema_FieldId> UpdateFields;
+	if (DecodedFields == nullptr)
+	{
+		UpdateFields.SetNumUninitialized(Schema_GetUniqueFieldIdCount(ComponentObject));
+		Schema_GetUniqueFieldIds(ComponentObject, UpdateFields.GetData());
+	}
+
 	if (bIsHandover)
 	{
-		ApplyHandoverSchemaObject(ComponentObject, Object, Channel, true);
+		ApplyHandoverSchemaObject(ComponentObject, DecodedFields != nullptr ? DecodedFields->FieldIds : UpdateFields, Object, Channel, true);
 	}
 	else
 	{
-		ApplySchemaObject(ComponentObject, Object, Channel, true);
+		ApplySchemaObject(ComponentObject, DecodedFields != nullptr ? DecodedFields->FieldIds : UpdateFields, Object, Channel, true);
 	}
+
+	DecodedFields = nullptr;
+	DecodedObject = nullptr;
 }
 
-void ComponentReader::ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover)
+void ComponentReader::ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover, const GeneratedComponentFields* InDecodedFields)
 {
 	Schema_Object* ComponentObject = Schema_GetComponentUpdateFields(ComponentUpdate.schema_type);
 
-	TArray<Schema_FieldId> ClearedIds;
-	ClearedIds.SetNum(Schema_GetComponentUpdateClearedFieldCount(ComponentUpdate.schema_type));
-	Schema_GetComponentUpdateClearedFieldList(ComponentUpdate.schema_type, ClearedIds.GetData());
+	DecodedFields = InDecodedFields;
+	DecodedObject = ComponentObject;
+
+	TArray<Schema_FieldId> UpdateFields;
+	TSet<Schema_FieldId> ClearedIds;
+	if (DecodedFields == nullptr)
+	{
+		UpdateFields.SetNumUninitialized(Schema_GetUniqueFieldIdCount(ComponentObject));
+		Schema_GetUniqueFieldIds(ComponentObject, UpdateFields.GetData());
+
+		TArray<Schema_FieldId> ClearedIdList;
+		ClearedIdList.SetNumUninitialized(Schema_GetComponentUpdateClearedFieldCount(ComponentUpdate.schema_type));
+		Schema_GetComponentUpdateClearedFieldList(ComponentUpdate.schema_type, ClearedIdList.GetData());
+		ClearedIds.Append(ClearedIdList);
+	}
+
+	const TArray<Schema_FieldId>& Fields = DecodedFields != nullptr ? DecodedFields->FieldIds : UpdateFields;
+	const TSet<Schema_FieldId>& Cleared = DecodedFields != nullptr ? DecodedFields->ClearedFieldIds : ClearedIds;
 
 	if (bIsHandover)
 	{
-		ApplyHandoverSchemaObject(ComponentObject, Object, Channel, false, &ClearedIds);
+		ApplyHandoverSchemaObject(ComponentObject, Fields, Object, Channel, false, &Cleared);
 	}
 	else
 	{
-		ApplySchemaObject(ComponentObject, Object, Channel, false, &ClearedIds);
+		ApplySchemaObject(ComponentObject, Fields, Object, Channel, false, &Cleared);
 	}
+
+	DecodedFields = nullptr;
+	DecodedObject = nullptr;
 }
 
-void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, TArray<Schema_FieldId>* ClearedIds)
+void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, const TArray<Schema_FieldId>& UpdateFields, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, const TSet<Schema_FieldId>* ClearedIds)
 {
 	bool bAutonomousProxy = Channel->IsClientAutonomousProxy();
 
-	TArray<uint32> UpdateFields;
-	UpdateFields.SetNum(Schema_GetUniqueFieldIdCount(ComponentObject));
-	Schema_GetUniqueFieldIds(ComponentObject, UpdateFields.GetData());
-
 	if (UpdateFields.Num() == 0)
 	{
 		return;
@@ -75,6 +104,9 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 		return;
 	}
 
+	FClassInfo* ClassInfo = TypebindingManager->FindClassInfoByClass(Object->GetClass());
+	check(ClassInfo);
+
 	FObjectReplicator& Replicator = Channel->PreReceiveSpatialUpdate(Object);
 
 	TSharedPtr<FRepState> RepState = Replicator.RepState;
@@ -87,6 +119,7 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 	FSpatialConditionMapFilter ConditionMap(Channel, bAutonomousProxy);
 
 	TArray<UProperty*> RepNotifies;
+	TBitArray<> RefreshedParents(false, Parents.Num());
 
 	for (uint32 FieldId : UpdateFields)
 	{
@@ -94,6 +127,7 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 		check(FieldId > 0 && (int)FieldId - 1 < BaseHandleToCmdIndex.Num());
 		const FRepLayoutCmd& Cmd = Cmds[BaseHandleToCmdIndex[FieldId - 1].CmdIndex];
 		const FRepParentCmd& Parent = Parents[Cmd.ParentIndex];
+		const FSchemaPropertyHandler& Handler = ClassInfo->RepProperties[FieldId - 1].Handler;
 
 		if (NetDriver->IsServer() || ConditionMap.IsRelevant(Parent.Condition))
 		{
@@ -102,11 +136,30 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 
 			uint8* Data = (uint8*)Object + SwappedCmd.Offset;
 
-			if (bIsInitialData || GetPropertyCount(ComponentObject, FieldId, Cmd.Property) > 0 || ClearedIds->Find(FieldId) != INDEX_NONE)
+			if (bIsInitialData || GetPropertyCount(ComponentObject, FieldId, Handler) > 0 || ClearedIds->Contains(FieldId))
 			{
+				// Store the value we're about to overwrite in the shadow data, so RepNotifies can compare against it.
+				// Only the properties touched by this update are copied, rather than the whole object.
+				if (Parent.Property->HasAnyPropertyFlags(CPF_RepNotify))
+				{
+					// A RepNotify's old value is the whole root property from the shadow data, so for a flattened struct
+					// refresh all of it before its first field is applied, not just the fields this update touches.
+					if (!RefreshedParents[Cmd.ParentIndex])
+					{
+						RefreshedParents[Cmd.ParentIndex] = true;
+						const FRepParentCmd& SwappedParent = (!bIsAuthServer && Parent.RoleSwapIndex != -1) ? Parents[Parent.RoleSwapIndex] : Parent;
+						SwappedParent.Property->CopySingleValue(SwappedParent.Property->ContainerPtrToValuePtr<uint8>(RepState->StaticBuffer.GetData(), SwappedParent.ArrayIndex),
+							SwappedParent.Property->ContainerPtrToValuePtr<uint8>(Object, SwappedParent.ArrayIndex));
+					}
+				}
+				else
+				{
+					Cmd.Property->CopySingleValue(RepState->StaticBuffer.GetData() + SwappedCmd.Offset, Data);
+				}
+
 				if (Cmd.Type == ERepLayoutCmdType::DynamicArray)
 				{
-					UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Cmd.Property);
+					UArrayProperty* ArrayProperty = static_cast<UArrayProperty*>(Cmd.Property);
 					bool bProcessedArray = false;
 
 					// Check if this is a FastArraySerializer array so we can simulate the FFastArraySerializerItem PreReplicatedRemove and PostReplicatedAdd calls.
@@ -119,7 +172,7 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 							// Populate array with existing data so compare will incorporate non-replicated entities
 							Cmd.Property->CopyCompleteValue((void*)&TempArray, Data);
 
-							ApplyArray(ComponentObject, FieldId, RootObjectReferencesMap, ArrayProperty, (uint8*)&TempArray, SwappedCmd.Offset, Cmd.ParentIndex);
+							ApplyArray(ComponentObject, FieldId, RootObjectReferencesMap, Handler, (uint8*)&TempArray, SwappedCmd.Offset, Cmd.ParentIndex);
 							bProcessedArray = true;
 
 							if (!Cmd.Property->Identical((void*)&TempArray, Data))
@@ -140,12 +193,12 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 
 					if (!bProcessedArray)
 					{
-						ApplyArray(ComponentObject, FieldId, RootObjectReferencesMap, ArrayProperty, Data, SwappedCmd.Offset, Cmd.ParentIndex);
+						ApplyArray(ComponentObject, FieldId, RootObjectReferencesMap, Handler, Data, SwappedCmd.Offset, Cmd.ParentIndex);
 					}
 				}
 				else
 				{
-					ApplyProperty(ComponentObject, FieldId, RootObjectReferencesMap, 0, Cmd.Property, Data, SwappedCmd.Offset, Cmd.ParentIndex);
+					ApplyProperty(ComponentObject, FieldId, RootObjectReferencesMap, 0, Handler.Kind, Cmd.Property, Handler.StructFields.Get(), Data, SwappedCmd.Offset, Cmd.ParentIndex);
 				}
 
 				if (Cmd.Property->GetFName() == NAME_RemoteRole)
@@ -174,12 +227,8 @@ void ComponentReader::ApplySchemaObject(Schema_Object* ComponentObject, UObject*
 	Channel->PostReceiveSpatialUpdate(Object, RepNotifies);
 }
 
-void ComponentReader::ApplyHandoverSchemaObject(Schema_Object* ComponentObject, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, TArray<Schema_FieldId>* ClearedIds)
+void ComponentReader::ApplyHandoverSchemaObject(Schema_Object* ComponentObject, const TArray<Schema_FieldId>& UpdateFields, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, const TSet<Schema_FieldId>* ClearedIds)
 {
-	TArray<uint32> UpdateFields;
-	UpdateFields.SetNum(Schema_GetUniqueFieldIdCount(ComponentObject));
-	Schema_GetUniqueFieldIds(ComponentObject, UpdateFields.GetData());
-
 	if (UpdateFields.Num() == 0)
 	{
 		return;
@@ -198,92 +247,127 @@ void ComponentReader::ApplyHandoverSchemaObject(Schema_Object* ComponentObject,
 
 		uint8* Data = (uint8*)Object + PropertyInfo.Offset;
 
-		if (bIsInitialData || GetPropertyCount(ComponentObject, FieldId, PropertyInfo.Property) > 0 || ClearedIds->Find(FieldId) != INDEX_NONE)
+		if (bIsInitialData || GetPropertyCount(ComponentObject, FieldId, PropertyInfo.Handler) > 0 || ClearedIds->Contains(FieldId))
 		{
-			if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(PropertyInfo.Property))
-			{
-				ApplyArray(ComponentObject, FieldId, RootObjectReferencesMap, ArrayProperty, Data, PropertyInfo.Offset, -1);
-			}
-			else
-			{
-				ApplyProperty(ComponentObject, FieldId, RootObjectReferencesMap, 0, PropertyInfo.Property, Data, PropertyInfo.Offset, -1);
-			}
+			ApplyField(ComponentObject, FieldId, PropertyInfo.Handler, Data, PropertyInfo.Offset, -1);
 		}
 	}
 
 	Channel->PostReceiveSpatialUpdate(Object, TArray<UProperty*>());
 }
 
-void ComponentReader::ApplyProperty(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, uint32 Index, UProperty* Property, uint8* Data, int32 Offset, int32 ParentIndex)
+void ComponentReader::ApplyField(Schema_Object* Object, Schema_FieldId FieldId, const FSchemaPropertyHandler& Handler, uint8* Data, int32 Offset, int32 ParentIndex)
 {
-	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	if (Handler.Kind == ESchemaPropertyKind::Array)
 	{
-		TArray<uint8> ValueData = IndexPayloadFromSchema(Object, FieldId, Index);
-		// A bit hacky, we should probably include the number of bits with the data instead.
-		int64 CountBits = ValueData.Num() * 8;
+		ApplyArray(Object, FieldId, RootObjectReferencesMap, Handler, Data, Offset, ParentIndex);
+	}
+	else
+	{
+		ApplyProperty(Object, FieldId, RootObjectReferencesMap, 0, Handler.Kind, Handler.Property, Handler.StructFields.Get(), Data, Offset, ParentIndex);
+	}
+}
+
+void ComponentReader::ApplyProperty(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, uint32 Index, ESchemaPropertyKind Kind, UProperty* Property, const TArray<FSchemaPropertyHandler>* StructFields, uint8* Data, int32 Offset, int32 ParentIndex)
+{
+	switch (Kind)
+	{
+	case ESchemaPropertyKind::Struct:
+	{
+		int64 CountBits = 0;
+		const uint8* ValueData = IndexPayloadFromSchema(Object, FieldId, Index, CountBits);
 		TSet<FUnrealObjectRef> NewUnresolvedRefs;
-		FSpatialNetBitReader ValueDataReader(PackageMap, ValueData.GetData(), CountBits, NewUnresolvedRefs);
+		FSpatialNetBitReader ValueDataReader(PackageMap, ValueData, CountBits, NewUnresolvedRefs);
 		bool bHasUnmapped = false;
 
-		ReadStructProperty(ValueDataReader, StructProperty, NetDriver, Data, bHasUnmapped);
+		ReadStructProperty(ValueDataReader, static_cast<UStructProperty*>(Property), NetDriver, Data, bHasUnmapped);
 
 		if (bHasUnmapped)
 		{
-			InObjectReferencesMap.Add(Offset, FObjectReferences(ValueData, CountBits, NewUnresolvedRefs, ParentIndex, Property));
+			// The payload is owned by the schema object, so keep a copy to read again once the references resolve.
+			TArray<uint8> ValueDataCopy(ValueData, FMath::DivideAndRoundUp<int64>(CountBits, 8));
+			InObjectReferencesMap.Add(Offset, FObjectReferences(ValueDataCopy, CountBits, NewUnresolvedRefs, ParentIndex, Property));
 			UnresolvedRefs.Append(NewUnresolvedRefs);
 		}
 		else if (InObjectReferencesMap.Find(Offset))
 		{
 			InObjectReferencesMap.Remove(Offset);
 		}
+		break;
 	}
-	else if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
-	{
-		BoolProperty->SetPropertyValue(Data, Schema_IndexBool(Object, FieldId, Index) != 0);
-	}
-	else if (UFloatProperty* FloatProperty = Cast<UFloatProperty>(Property))
-	{
-		FloatProperty->SetPropertyValue(Data, Schema_IndexFloat(Object, FieldId, Index));
-	}
-	else if (UDoubleProperty* DoubleProperty = Cast<UDoubleProperty>(Property))
-	{
-		DoubleProperty->SetPropertyValue(Data, Schema_IndexDouble(Object, FieldId, Index));
-	}
-	else if (UInt8Property* Int8Property = Cast<UInt8Property>(Property))
+	case ESchemaPropertyKind::SchemaStruct:
 	{
-		Int8Property->SetPropertyValue(Data, (int8)Schema_IndexInt32(Object, FieldId, Index));
-	}
-	else if (UInt16Property* Int16Property = Cast<UInt16Property>(Property))
-	{
-		Int16Property->SetPropertyValue(Data, (int16)Schema_IndexInt32(Object, FieldId, Index));
-	}
-	else if (UIntProperty* IntProperty = Cast<UIntProperty>(Property))
-	{
-		IntProperty->SetPropertyValue(Data, Schema_IndexInt32(Object, FieldId, Index));
-	}
-	else if (UInt64Property* Int64Property = Cast<UInt64Property>(Property))
-	{
-		Int64Property->SetPropertyValue(Data, Schema_IndexInt64(Object, FieldId, Index));
-	}
-	else if (UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
-	{
-		ByteProperty->SetPropertyValue(Data, (uint8)Schema_IndexUint32(Object, FieldId, Index));
-	}
-	else if (UUInt16Property* UInt16Property = Cast<UUInt16Property>(Property))
-	{
-		UInt16Property->SetPropertyValue(Data, (uint16)Schema_IndexUint32(Object, FieldId, Index));
-	}
-	else if (UUInt32Property* UInt32Property = Cast<UUInt32Property>(Property))
-	{
-		UInt32Property->SetPropertyValue(Data, Schema_IndexUint32(Object, FieldId, Index));
-	}
-	else if (UUInt64Property* UInt64Property = Cast<UUInt64Property>(Property))
-	{
-		UInt64Property->SetPropertyValue(Data, Schema_IndexUint64(Object, FieldId, Index));
+		check(StructFields);
+		Schema_Object* StructObject = Schema_IndexObject(Object, FieldId, Index);
+		for (int32 i = 0; i < StructFields->Num(); i++)
+		{
+			const FSchemaPropertyHandler& FieldHandler = (*StructFields)[i];
+			uint8* FieldData = FieldHandler.Property->ContainerPtrToValuePtr<uint8>(Data);
+			// Unresolved references are keyed by offset, so fields are keyed by their offset from the same base as the struct.
+			const int32 FieldOffset = Offset + FieldHandler.Property->GetOffset_ForInternal();
+
+			if (FieldHandler.Kind == ESchemaPropertyKind::Array)
+			{
+				ApplyArray(StructObject, i + 1, InObjectReferencesMap, FieldHandler, FieldData, FieldOffset, ParentIndex);
+			}
+			else
+			{
+				ApplyProperty(StructObject, i + 1, InObjectReferencesMap, 0, FieldHandler.Kind, FieldHandler.Property, FieldHandler.StructFields.Get(), FieldData, FieldOffset, ParentIndex);
+			}
+		}
+		break;
+	}
+	case ESchemaPropertyKind::Bool:
+		static_cast<UBoolProperty*>(Property)->SetPropertyValue(Data, Schema_IndexBool(Object, FieldId, Index) != 0);
+		break;
+	case ESchemaPropertyKind::Float:
+		UFloatProperty::SetPropertyValue(Data, Schema_IndexFloat(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Double:
+		UDoubleProperty::SetPropertyValue(Data, Schema_IndexDouble(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Int8:
+		UInt8Property::SetPropertyValue(Data, (int8)Schema_IndexInt32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Int16:
+		UInt16Property::SetPropertyValue(Data, (int16)Schema_IndexInt32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Int32:
+		UIntProperty::SetPropertyValue(Data, Schema_IndexInt32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Int64:
+		UInt64Property::SetPropertyValue(Data, Schema_IndexInt64(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::Byte:
+		UByteProperty::SetPropertyValue(Data, (uint8)Schema_IndexUint32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::UInt16:
+		UUInt16Property::SetPropertyValue(Data, (uint16)Schema_IndexUint32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::UInt32:
+		UUInt32Property::SetPropertyValue(Data, Schema_IndexUint32(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::UInt64:
+		UUInt64Property::SetPropertyValue(Data, Schema_IndexUint64(Object, FieldId, Index));
+		break;
+	case ESchemaPropertyKind::SmallEnum:
+	{
+		const uint32 Value = Schema_IndexUint32(Object, FieldId, Index);
+		if (Property->ElementSize == 1)
+		{
+			*Data = (uint8)Value;
+		}
+		else
+		{
+			*reinterpret_cast<uint16*>(Data) = (uint16)Value;
+		}
+		break;
 	}
-	else if (UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+	case ESchemaPropertyKind::Object:
 	{
-		FUnrealObjectRef ObjectRef = IndexObjectRefFromSchema(Object, FieldId, Index);
+		UObjectPropertyBase* ObjectProperty = static_cast<UObjectPropertyBase*>(Property);
+		const FUnrealObjectRef* DecodedObjectRef = FindDecodedObjectRef(Object, FieldId, Index);
+		FUnrealObjectRef ObjectRef = DecodedObjectRef != nullptr ? *DecodedObjectRef : IndexObjectRefFromSchema(Object, FieldId, Index);
 		check(ObjectRef != SpatialConstants::UNRESOLVED_OBJECT_REF);
 		bool bUnresolved = false;
 
@@ -327,47 +411,49 @@ void ComponentReader::ApplyProperty(Schema_Object* Object, Schema_FieldId FieldI
 			UStruct* Owner = Cast<UStruct>(Outer);
 			const FString ContextName = Property->GetName() + TEXT("_SpatialOSContext");
 			UProperty* ContextProperty = Owner->FindPropertyByName(*ContextName);
-			const int32 PropertyOffsetDiff = ContextProperty->GetOffset_ForInternal() - Property->GetOffset_ForInternal();
-			FUnrealObjectRef& Context = *(reinterpret_cast<FUnrealObjectRef*>(const_cast<uint8*>(Data) + PropertyOffsetDiff));
-			Context = ObjectRef;
+			// Only properties declared with a context have one, e.g. none of the fields of schema structs do.
+			if (ContextProperty != nullptr)
+			{
+				const int32 PropertyOffsetDiff = ContextProperty->GetOffset_ForInternal() - Property->GetOffset_ForInternal();
+				FUnrealObjectRef& Context = *(reinterpret_cast<FUnrealObjectRef*>(const_cast<uint8*>(Data) + PropertyOffsetDiff));
+				Context = ObjectRef;
+			}
 		}
 
 		if (!bUnresolved && InObjectReferencesMap.Find(Offset))
 		{
 			InObjectReferencesMap.Remove(Offset);
 		}
+		break;
 	}
-	else if (UNameProperty* NameProperty = Cast<UNameProperty>(Property))
-	{
-		NameProperty->SetPropertyValue(Data, FName(*IndexStringFromSchema(Object, FieldId, Index)));
-	}
-	else if (UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+	case ESchemaPropertyKind::Name:
 	{
-		StrProperty->SetPropertyValue(Data, IndexStringFromSchema(Object, FieldId, Index));
+		const FString* DecodedString = FindDecodedString(Object, FieldId, Index);
+		UNameProperty::SetPropertyValue(Data, FName(DecodedString != nullptr ? **DecodedString : *IndexStringFromSchema(Object, FieldId, Index)));
+		break;
 	}
-	else if (UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+	case ESchemaPropertyKind::String:
 	{
-		TextProperty->SetPropertyValue(Data, FText::FromString(IndexStringFromSchema(Object, FieldId, Index)));
+		const FString* DecodedString = FindDecodedString(Object, FieldId, Index);
+		UStrProperty::SetPropertyValue(Data, DecodedString != nullptr ? *DecodedString : IndexStringFromSchema(Object, FieldId, Index));
+		break;
 	}
-	else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	case ESchemaPropertyKind::Text:
 	{
-		if (EnumProperty->ElementSize < 4)
-		{
-			EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(Data, (uint64)Schema_IndexUint32(Object, FieldId, Index));
-		}
-		else
-		{
-			ApplyProperty(Object, FieldId, InObjectReferencesMap, Index, EnumProperty->GetUnderlyingProperty(), Data, Offset, ParentIndex);
-		}
+		const FString* DecodedString = FindDecodedString(Object, FieldId, Index);
+		UTextProperty::SetPropertyValue(Data, FText::FromString(DecodedString != nullptr ? *DecodedString : IndexStringFromSchema(Object, FieldId, Index)));
+		break;
 	}
-	else
-	{
+	default:
 		checkf(false, TEXT("Tried to read unknown property in field %d"), FieldId);
+		break;
 	}
 }
 
-void ComponentReader::ApplyArray(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, UArrayProperty* Property, uint8* Data, int32 Offset, int32 ParentIndex)
+void ComponentReader::ApplyArray(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, const FSchemaPropertyHandler& Handler, uint8* Data, int32 Offset, int32 ParentIndex)
 {
+	UArrayProperty* Property = static_cast<UArrayProperty*>(Handler.Property);
+
 	FObjectReferencesMap* ArrayObjectReferences;
 	bool bNewArrayMap = false;
 	if (FObjectReferences* ExistingEntry = InObjectReferencesMap.Find(Offset))
@@ -384,13 +470,13 @@ void ComponentReader::ApplyArray(Schema_Object* Object, Schema_FieldId FieldId,
 
 	FScriptArrayHelper ArrayHelper(Property, Data);
 
-	int Count = GetPropertyCount(Object, FieldId, Property->Inner);
+	int Count = GetPropertyCount(Object, FieldId, Handler);
 	ArrayHelper.Resize(Count);
 
 	for (int i = 0; i < Count; i++)
 	{
-		int32 ElementOffset = i * Property->Inner->ElementSize;
-		ApplyProperty(Object, FieldId, *ArrayObjectReferences, i, Property->Inner, ArrayHelper.GetRawPtr(i), ElementOffset, ParentIndex);
+		int32 ElementOffset = i * Handler.ElementSize;
+		ApplyProperty(Object, FieldId, *ArrayObjectReferences, i, Handler.InnerKind, Property->Inner, Handler.StructFields.Get(), ArrayHelper.GetRawPtr(i), ElementOffset, ParentIndex);
 	}
 
 	if (ArrayObjectReferences->Num() > 0)
@@ -414,92 +500,67 @@ void ComponentReader::ApplyArray(Schema_Object* Object, Schema_FieldId FieldId,
 	}
 }
 
-uint32 ComponentReader::GetPropertyCount(const Schema_Object* Object, Schema_FieldId FieldId, UProperty* Property)
+uint32 ComponentReader::GetPropertyCount(const Schema_Object* Object, Schema_FieldId FieldId, const FSchemaPropertyHandler& Handler)
 {
-	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	// Arrays are stored as a list of their elements.
+	const ESchemaPropertyKind Kind = Handler.Kind == ESchemaPropertyKind::Array ? Handler.InnerKind : Handler.Kind;
+
+	switch (Kind)
 	{
+	case ESchemaPropertyKind::Name:
+	case ESchemaPropertyKind::String:
+	case ESchemaPropertyKind::Text:
 		return Schema_GetBytesCount(Object, FieldId);
-	}
-	else if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
-	{
+	case ESchemaPropertyKind::Bool:
 		return Schema_GetBoolCount(Object, FieldId);
-	}
-	else if (UFloatProperty* FloatProperty = Cast<UFloatProperty>(Property))
-	{
+	case ESchemaPropertyKind::Float:
 		return Schema_GetFloatCount(Object, FieldId);
-	}
-	else if (UDoubleProperty* DoubleProperty = Cast<UDoubleProperty>(Property))
-	{
+	case ESchemaPropertyKind::Double:
 		return Schema_GetDoubleCount(Object, FieldId);
-	}
-	else if (UInt8Property* Int8Property = Cast<UInt8Property>(Property))
-	{
-		return Schema_GetInt32Count(Object, FieldId);
-	}
-	else if (UInt16Property* Int16Property = Cast<UInt16Property>(Property))
-	{
-		return Schema_GetInt32Count(Object, FieldId);
-	}
-	else if (UIntProperty* IntProperty = Cast<UIntProperty>(Property))
-	{
+	case ESchemaPropertyKind::Int8:
+	case ESchemaPropertyKind::Int16:
+	case ESchemaPropertyKind::Int32:
 		return Schema_GetInt32Count(Object, FieldId);
-	}
-	else if (UInt64Property* Int64Property = Cast<UInt64Property>(Property))
-	{
+	case ESchemaPropertyKind::Int64:
 		return Schema_GetInt64Count(Object, FieldId);
-	}
-	else if (UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
-	{
+	case ESchemaPropertyKind::Byte:
+	case ESchemaPropertyKind::UInt16:
+	case ESchemaPropertyKind::UInt32:
+	case ESchemaPropertyKind::SmallEnum:
 		return Schema_GetUint32Count(Object, FieldId);
-	}
-	else if (UUInt16Property* UInt16Property = Cast<UUInt16Property>(Property))
-	{
-		return Schema_GetUint32Count(Object, FieldId);
-	}
-	else if (UUInt32Property* UInt32Property = Cast<UUInt32Property>(Property))
-	{
-		return Schema_GetUint32Count(Object, FieldId);
-	}
-	else if (UUInt64Property* UInt64Property = Cast<UUInt64Property>(Property))
-	{
+	case ESchemaPropertyKind::UInt64:
 		return Schema_GetUint64Count(Object, FieldId);
-	}
-	else if (UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
-	{
+	case ESchemaPropertyKind::Struct:
+	case ESchemaPropertyKind::Object:
+	case ESchemaPropertyKind::SchemaStruct:
 		return Schema_GetObjectCount(Object, FieldId);
+	default:
+		checkf(false, TEXT("Tried to get count of unknown property in field %d"), FieldId);
+		return 0;
 	}
-	else if (UNameProperty* NameProperty = Cast<UNameProperty>(Property))
-	{
-		return Schema_GetBytesCount(Object, FieldId);
-	}
-	else if (UStrProperty* StrProperty = Cast<UStrProperty>(Property))
-	{
-		return Schema_GetBytesCount(Object, FieldId);
-	}
-	else if (UTextProperty* TextProperty = Cast<UTextProperty>(Property))
-	{
-		return Schema_GetBytesCount(Object, FieldId);
-	}
-	else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
-	{
-		return GetPropertyCount(Object, FieldId, ArrayProperty->Inner);
-	}
-	else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+}
+
+const FString* ComponentReader::FindDecodedString(const Schema_Object* Object, Schema_FieldId FieldId, uint32 Index) const
+{
+	// Only top level fields are decoded, so fields of schema structs, which are read from their own objects, never match.
+	if (DecodedFields == nullptr || Object != DecodedObject)
 	{
-		if (EnumProperty->ElementSize < 4)
-		{
-			return Schema_GetUint32Count(Object, FieldId);
-		}
-		else
-		{
-			return GetPropertyCount(Object, FieldId, EnumProperty->GetUnderlyingProperty());
-		}
+		return nullptr;
 	}
-	else
+
+	const TArray<FString>* Strings = DecodedFields->Strings.Find(FieldId);
+	return Strings != nullptr && Strings->IsValidIndex(Index) ? &(*Strings)[Index] : nullptr;
+}
+
+const FUnrealObjectRef* ComponentReader::FindDecodedObjectRef(const Schema_Object* Object, Schema_FieldId FieldId, uint32 Index) const
+{
+	if (DecodedFields == nullptr || Object != DecodedObject)
 	{
-		checkf(false, TEXT("Tried to get count of unknown property in field %d"), FieldId);
-		return 0;
+		return nullptr;
 	}
+
+	const TArray<FUnrealObjectRef>* ObjectRefs = DecodedFields->ObjectRefs.Find(FieldId);
+	return ObjectRefs != nullptr && ObjectRefs->IsValidIndex(Index) ? &(*ObjectRefs)[Index] : nullptr;
 }
 
 }
@@ -0,0 +1,103 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Utils/SchemaStructUtils.h"
+
+#include "UObject/Class.h"
+#include "UObject/UnrealType.h"
+
+#include "Interop/SpatialTypebindingManager.h"
+
+namespace
+{
+
+// Structs whose NetSerialize only writes each of their fields in full, so writing the fields individually replicates the same values.
+bool HasFieldwiseNetSerialize(UScriptStruct* Struct)
+{
+	return Struct == TBaseStructure<FVector>::Get() || Struct == TBaseStructure<FVector2D>::Get();
+}
+
+UScriptStruct* GetValueStruct(UProperty* Property)
+{
+	if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		Property = ArrayProperty->Inner;
+	}
+
+	UStructProperty* StructProperty = Cast<UStructProperty>(Property);
+	return StructProperty != nullptr ? StructProperty->Struct : nullptr;
+}
+
+bool ContainsStruct(UScriptStruct* Struct, UScriptStruct* Target, TSet<UScriptStruct*>& VisitedStructs)
+{
+	for (UProperty* Property : GetSchemaStructProperties(Struct))
+	{
+		UScriptStruct* FieldStruct = GetValueStruct(Property);
+		if (FieldStruct == nullptr)
+		{
+			continue;
+		}
+
+		if (FieldStruct == Target)
+		{
+			return true;
+		}
+
+		bool bAlreadyVisited = false;
+		VisitedStructs.Add(FieldStruct, &bAlreadyVisited);
+		if (!bAlreadyVisited && ContainsStruct(FieldStruct, Target, VisitedStructs))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // ::
+
+bool IsSchemaStruct(UScriptStruct* Struct)
+{
+	if (Struct->StructFlags & STRUCT_NetDeltaSerializeNative)
+	{
+		return false;
+	}
+
+	if ((Struct->StructFlags & STRUCT_NetSerializeNative) && !HasFieldwiseNetSerialize(Struct))
+	{
+		return false;
+	}
+
+	for (UProperty* Property : GetSchemaStructProperties(Struct))
+	{
+		// Static arrays are only unrolled into separate fields at the top level of a class.
+		if (Property->ArrayDim > 1)
+		{
+			return false;
+		}
+
+		// Structs inside the struct are written as whatever they are themselves, so only need checking for cycles below.
+		UProperty* ValueProperty = Property->IsA<UArrayProperty>() ? Cast<UArrayProperty>(Property)->Inner : Property;
+		if (!ValueProperty->IsA<UStructProperty>() && GetSchemaPropertyKind(ValueProperty) == ESchemaPropertyKind::Unknown)
+		{
+			return false;
+		}
+	}
+
+	// A struct can contain itself through an array, which a schema type can't.
+	TSet<UScriptStruct*> VisitedStructs;
+	return !ContainsStruct(Struct, Struct, VisitedStructs);
+}
+
+TArray<UProperty*> GetSchemaStructProperties(UScriptStruct* Struct)
+{
+	TArray<UProperty*> Properties;
+	for (TFieldIterator<UProperty> It(Struct); It; ++It)
+	{
+		if (!It->HasAnyPropertyFlags(CPF_RepSkip))
+		{
+			Properties.Add(*It);
+		}
+	}
+
+	return Properties;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Utils/SpatialActorGrid.h"
+
+FSpatialActorGrid::FSpatialActorGrid(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+void FSpatialActorGrid::AddOrUpdateActor(AActor* Actor, const FVector& Location)
+{
+	const FIntPoint NewCell = GetCell(Location);
+
+	if (FIntPoint* OldCell = ActorCells.Find(Actor))
+	{
+		if (*OldCell == NewCell)
+		{
+			return;
+		}
+
+		TArray<AActor*>& OldCellActors = Cells.FindChecked(*OldCell);
+		OldCellActors.RemoveSingleSwap(Actor, /* bAllowShrinking */ false);
+		if (OldCellActors.Num() == 0)
+		{
+			Cells.Remove(*OldCell);
+		}
+
+		*OldCell = NewCell;
+	}
+	else
+	{
+		ActorCells.Add(Actor, NewCell);
+	}
+
+	Cells.FindOrAdd(NewCell).Add(Actor);
+}
+
+void FSpatialActorGrid::RemoveActor(AActor* Actor)
+{
+	FIntPoint Cell;
+	if (!ActorCells.RemoveAndCopyValue(Actor, Cell))
+	{
+		return;
+	}
+
+	TArray<AActor*>& CellActors = Cells.FindChecked(Cell);
+	CellActors.RemoveSingleSwap(Actor, /* bAllowShrinking */ false);
+	if (CellActors.Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+void FSpatialActorGrid::GatherActorsNear(const FVector& Location, float HalfExtent, TSet<AActor*>& OutActors) const
+{
+	const FIntPoint MinCell = GetCell(Location - FVector(HalfExtent, HalfExtent, 0.0f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(HalfExtent, HalfExtent, 0.0f));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			if (const TArray<AActor*>* CellActors = Cells.Find(FIntPoint(X, Y)))
+			{
+				OutActors.Append(*CellActors);
+			}
+		}
+	}
+}
+
+FIntPoint FSpatialActorGrid::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
@@ -90,14 +90,36 @@ public:
 	FRepChangeState CreateInitialRepChangeState(UObject* Object);
 	FHandoverChangeState CreateInitialHandoverChangeState(FClassInfo* ClassInfo);
 
+	// Returns the actor's subobject at the given index of FClassInfo::SubobjectIndices, or nullptr if it has been destroyed.
+	FORCEINLINE UObject* GetResolvedSubobject(int32 SubobjectIndex) const
+	{
+		return ResolvedSubobjects.IsValidIndex(SubobjectIndex) ? ResolvedSubobjects[SubobjectIndex].Get() : nullptr;
+	}
+
 	// For an object that is replicated by this channel (i.e. this channel's actor or its component), find out whether a given handle is an array.
 	bool IsDynamicArrayHandle(UObject* Object, uint16 Handle);
 
 	void SpatialViewTick();
+
+	// True if SpatialViewTick has something to do: the ACL or component interest hasn't been set up yet, or net ownership has changed since it was.
+	bool NeedsViewTick();
+
+	// Queue this channel to be visited by SpatialViewTick, e.g. after its ownership or authority has changed.
+	void MarkViewDirty();
+
+	// Compare the handover properties of the given object (this channel's actor or one of its subobjects) the next time the actor replicates.
+	// Only needed when HandoverFullCompareInterval is set in USpatialGDKSettings; otherwise they're compared every time.
+	// Objects whose replicated properties changed are compared anyway.
+	void MarkHandoverDirty(UObject* Object);
+
+	// Compare the handover properties of the actor and all of its subobjects the next time the actor replicates, e.g. on ForceNetUpdate.
+	void MarkAllHandoverDirty();
+
 	FObjectReplicator& PreReceiveSpatialUpdate(UObject* TargetObject);
 	void PostReceiveSpatialUpdate(UObject* TargetObject, const TArray<UProperty*>& RepNotifies);
 
 	void OnReserveEntityIdResponse(const struct Worker_ReserveEntityIdResponseOp& Op);
+	void OnEntityIdReserved(Worker_EntityId ReservedEntityId);
 	void OnCreateEntityResponse(const struct Worker_CreateEntityResponseOp& Op);
 
 	FVector GetActorSpatialPosition(AActor* Actor);
@@ -110,12 +132,17 @@ private:
 	void DeleteEntityIfAuthoritative();
 	bool IsSingletonEntity();
 	bool IsStablyNamedEntity();
+	bool IsNetOwned() const;
+
+	// If bCameToRest, any change since the last update is sent, however small.
+	void UpdateSpatialPosition(bool bCameToRest);
+	void UpdateSpatialRotation(bool bCameToRest);
 
-	void UpdateSpatialPosition();
-	void UpdateSpatialRotation();
+	void ResolveSubobjects(const FClassInfo& Info);
 
 	void InitializeHandoverShadowData(TArray<uint8>& ShadowData, UObject* Object);
 	FHandoverChangeState GetHandoverChangeList(TArray<uint8>& ShadowData, UObject* Object);
+	bool ShouldCompareHandover(UObject* Object, bool bFullHandoverCompare) const;
 
 private:
 	Worker_EntityId EntityId;
@@ -133,6 +160,17 @@ private:
 
 	FVector LastSpatialPosition;
 	FRotator LastSpatialRotation;
+	float LastSpatialTransformUpdateTime;
+
+	// The actor's transform the last time it replicated, whether or not it was sent, to tell when it comes to rest.
+	FVector LastReplicatedSpatialPosition;
+	FRotator LastReplicatedRotation;
+	bool bMovedLastReplication;
+
+	// Resolved from USpatialGDKSettings for the actor's class when the actor is set.
+	float SpatialPositionThresholdSquared;
+	float SpatialRotationThreshold;
+	float MinSpatialTransformUpdateInterval;
 
 	// Shadow data for Handover properties.
 	// For each object with handover properties, we store a blob of memory which contains
@@ -141,6 +179,14 @@ private:
 	TArray<uint8>* ActorHandoverShadowData;
 	TMap<TWeakObjectPtr<UObject>, TSharedRef<TArray<uint8>>> HandoverShadowDataMap;
 
+	// Objects whose handover properties have been marked as changed since the actor last replicated.
+	TSet<TWeakObjectPtr<UObject>> HandoverDirtyObjects;
+	bool bAllHandoverDirty;
+	float LastHandoverFullCompareTime;
+
+	// The actor's default subobject of each class in FClassInfo::SubobjectIndices, found once when the actor is set.
+	TArray<TWeakObjectPtr<UObject>> ResolvedSubobjects;
+
 	// If this actor channel is responsible for creating a new entity, this will be set to true during initial replication.
 	bool bCreatingNewEntity;
 };
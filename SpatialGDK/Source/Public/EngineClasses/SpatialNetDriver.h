@@ -10,6 +10,7 @@
 #include "Interop/Connection/ConnectionConfig.h"
 #include "Interop/SpatialOutputDevice.h"
 #include "SpatialConstants.h"
+#include "Utils/SpatialActorGrid.h"
 
 #include <WorkerSDK/improbable/c_worker.h>
 
@@ -32,6 +33,8 @@ class UEntityRegistry;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpatialOSNetDriver, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("SpatialNet"), STATGROUP_SpatialNet, STATCAT_Advanced);
+
 class FSpatialWorkerUniqueNetId : public FUniqueNetId
 {
 public:
@@ -56,6 +59,7 @@ class SPATIALGDK_API USpatialNetDriver : public UIpNetDriver
 
 public:
 	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
 
 	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar = *GLog) override;
 
@@ -67,6 +71,7 @@ public:
 	virtual void TickFlush(float DeltaTime) override;
 	virtual bool IsLevelInitializedForActor(const AActor* InActor, const UNetConnection* InConnection) const override;
 	virtual void NotifyActorDestroyed(AActor* Actor, bool IsSeamlessTravel = false) override;
+	virtual void ForceNetUpdate(AActor* Actor) override;
 	// End UNetDriver interface.
 
 #if !UE_BUILD_SHIPPING
@@ -90,6 +95,10 @@ public:
 
 	USpatialActorChannel* GetActorChannelByEntityId(Worker_EntityId EntityId) const;
 
+	// Call after changing a handover property of an actor or one of its subobjects, so that it's picked up before the next full handover compare.
+	// Not needed if the object's replicated properties changed too, or AActor::ForceNetUpdate is called on the actor.
+	void MarkHandoverDirty(UObject* Object);
+
 	UPROPERTY()
 	USpatialWorkerConnection* Connection;
 	UPROPERTY()
@@ -115,6 +124,9 @@ public:
 
 	bool bConnectAsClient;
 
+	// The actors this server replicates, by the position last sent to SpatialOS. Only valid on servers.
+	TUniquePtr<FSpatialActorGrid> ActorGrid;
+
 	bool IsAuthoritativeDestructionAllowed() const { return bAuthoritativeDestruction; }
 	void StartIgnoringAuthoritativeDestruction() { bAuthoritativeDestruction = false; }
 	void StopIgnoringAuthoritativeDestruction() { bAuthoritativeDestruction = true; }
@@ -129,6 +141,9 @@ private:
 
 	bool bAuthoritativeDestruction;
 
+	// Where in the consider list to start looking for actors far from players, so that they take turns being replicated.
+	int32 NextFarConsiderIndex;
+
 	UFUNCTION()
 	void OnMapLoaded(UWorld* LoadedWorld);
 
@@ -146,6 +161,9 @@ private:
 	int32 ServerReplicateActors_PrepConnections(const float DeltaSeconds);
 	int32 ServerReplicateActors_PrioritizeActors(UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*> ConsiderList, const bool bCPUSaturated, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors);
 	int32 ServerReplicateActors_ProcessPrioritizedActors(UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FActorPriority** PriorityActors, const int32 FinalSortedCount, int32& OutUpdated);
+
+	void UpdateActorGrid();
+	void GatherActorsNearPlayers(TSet<AActor*>& OutActors) const;
 #endif
 
 	friend class USpatialNetConnection;
@@ -31,6 +31,61 @@ public:
 	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID *OutNetGUID = NULL) override;
 };
 
+// An FUnrealObjectRef reduced to integers: the path is interned, and the outer is identified by the NetGUID it resolved to.
+// The hash is computed once on construction, so lookups don't walk the outer chain. Only refs whose outer has resolved can be
+// keyed, as an invalid OuterGUID means the ref has no outer at all.
+struct FUnrealObjectRefKey
+{
+	FUnrealObjectRefKey(Worker_EntityId InEntity, uint32 InOffset, int32 InPathId = INDEX_NONE, const FNetworkGUID& InOuterGUID = FNetworkGUID())
+		: Entity(InEntity)
+		, Offset(InOffset)
+		, PathId(InPathId)
+		, OuterGUID(InOuterGUID)
+		, Hash(HashCombine(HashCombine(::GetTypeHash(InEntity), ::GetTypeHash(InOffset)), HashCombine(::GetTypeHash(InPathId), GetTypeHash(InOuterGUID))))
+	{}
+
+	bool operator==(const FUnrealObjectRefKey& Other) const
+	{
+		return Hash == Other.Hash && Entity == Other.Entity && Offset == Other.Offset && PathId == Other.PathId && OuterGUID == Other.OuterGUID;
+	}
+
+	friend uint32 GetTypeHash(const FUnrealObjectRefKey& Key)
+	{
+		return Key.Hash;
+	}
+
+	Worker_EntityId Entity;
+	uint32 Offset;
+	int32 PathId;
+	FNetworkGUID OuterGUID;
+	uint32 Hash;
+};
+
+// Key funcs for maps from object paths. Paths of objects in the same level share long prefixes and mostly differ at the end,
+// so only the length and the last few characters are hashed, rather than every character as FString's case-insensitive hash does.
+// Keys are still compared in full, case-sensitively, as paths always come from object names.
+template <typename ValueType>
+struct TSpatialObjectPathKeyFuncs : BaseKeyFuncs<TPair<FString, ValueType>, FString, /* bInAllowDuplicateKeys */ false>
+{
+	static const int32 MaxHashedChars = 32;
+
+	static const FString& GetSetKey(const TPair<FString, ValueType>& Element)
+	{
+		return Element.Key;
+	}
+
+	static bool Matches(const FString& A, const FString& B)
+	{
+		return A.Equals(B, ESearchCase::CaseSensitive);
+	}
+
+	static uint32 GetKeyHash(const FString& Key)
+	{
+		const int32 NumHashedChars = FMath::Min(Key.Len(), MaxHashedChars);
+		return HashCombine(::GetTypeHash(Key.Len()), FCrc::MemCrc32(*Key + Key.Len() - NumHashedChars, NumHashedChars * sizeof(TCHAR)));
+	}
+};
+
 class SPATIALGDK_API FSpatialNetGUIDCache : public FNetGUIDCache
 {
 public:
@@ -47,16 +102,22 @@ public:
 	FNetworkGUID GetNetGUIDFromEntityId(Worker_EntityId EntityId) const;
 
 private:
-	void NetworkRemapObjectRefPaths(FUnrealObjectRef& ObjectRef) const;
-	FNetworkGUID GetNetGUIDFromUnrealObjectRefInternal(const FUnrealObjectRef& ObjectRef);
+	int32 InternPath(const FString& Path);
+	int32 GetNetworkRemappedPathId(const FString& Path);
 
 	FNetworkGUID GetOrAssignNetGUID_SpatialGDK(UObject* Object);
-	void RegisterObjectRef(FNetworkGUID NetGUID, const FUnrealObjectRef& ObjectRef);
+	void RegisterObjectRef(FNetworkGUID NetGUID, const FUnrealObjectRef& ObjectRef, const FUnrealObjectRefKey& ObjectRefKey);
 	
 	FNetworkGUID RegisterNetGUIDFromPath(const FString& PathName, const FNetworkGUID& OuterGUID);
 	FNetworkGUID GenerateNewNetGUID(const int32 IsStatic);
 
 	TMap<FNetworkGUID, FUnrealObjectRef> NetGUIDToUnrealObjectRef;
-	TMap<FUnrealObjectRef, FNetworkGUID> UnrealObjectRefToNetGUID;
+	TMap<FUnrealObjectRefKey, FNetworkGUID> UnrealObjectRefToNetGUID;
+
+	// Paths of stably named objects, indexed by the IDs used in FUnrealObjectRefKey.
+	TArray<FString> InternedPaths;
+	TMap<FString, int32, FDefaultSetAllocator, TSpatialObjectPathKeyFuncs<int32>> PathToId;
+	// Paths as received from the network, mapped to the ID of the path after NetworkRemapPath, so each is only remapped once.
+	TMap<FString, int32, FDefaultSetAllocator, TSpatialObjectPathKeyFuncs<int32>> NetworkPathToRemappedId;
 };
 
@@ -0,0 +1,65 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interop/Connection/SpatialOpList.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+#include <WorkerSDK/improbable/c_worker.h>
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSpatialOpListRecording, Log, All);
+
+// Writes every op list received from SpatialOS to a compact binary file, so that a load profile can be replayed
+// offline with FSpatialOpListReplayer. Metrics ops and entity query results are not recorded.
+class FSpatialOpListRecorder
+{
+public:
+	FSpatialOpListRecorder(const FString& FilePath, const FString& WorkerId);
+	~FSpatialOpListRecorder();
+
+	bool IsValid() const { return Writer.IsValid(); }
+
+	void RecordOpList(const Worker_OpList& OpList);
+
+	FSpatialOpListRecorder(const FSpatialOpListRecorder& Other) = delete;
+	FSpatialOpListRecorder& operator=(const FSpatialOpListRecorder& Other) = delete;
+
+private:
+	void RecordOp(const Worker_Op& Op);
+
+	TUniquePtr<FArchive> Writer;
+	int32 NumRecordedOpLists;
+	double StartTime;
+};
+
+// Reads op lists back from a file written by FSpatialOpListRecorder, one op list at a time, along with when each was received.
+class FSpatialOpListReplayer
+{
+public:
+	explicit FSpatialOpListReplayer(const FString& FilePath);
+
+	bool IsValid() const { return Reader.IsValid(); }
+	bool IsFinished() const;
+
+	// The worker ID of the worker that made the recording.
+	const FString& GetWorkerId() const { return WorkerId; }
+
+	// Seconds from the start of the recording until the next op list was received. Only valid if not finished.
+	double GetNextOpListTime() const { return NextOpListTime; }
+
+	// Returns nullptr once every recorded op list has been replayed. The op list is decoded with ComponentLayouts, if given.
+	TUniquePtr<FSpatialOpList> ReadNextOpList(const FSpatialComponentLayouts* ComponentLayouts = nullptr);
+
+	FSpatialOpListReplayer(const FSpatialOpListReplayer& Other) = delete;
+	FSpatialOpListReplayer& operator=(const FSpatialOpListReplayer& Other) = delete;
+
+private:
+	void ReadNextOpListTime();
+
+	TUniquePtr<FArchive> Reader;
+	FString WorkerId;
+	bool bHasNextOpList;
+	double NextOpListTime;
+};
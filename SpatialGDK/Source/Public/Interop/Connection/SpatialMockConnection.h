@@ -0,0 +1,121 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interop/Connection/SpatialOpList.h"
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+
+#include <WorkerSDK/improbable/c_schema.h>
+#include <WorkerSDK/improbable/c_worker.h>
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSpatialMockConnection, Log, All);
+
+// How much work has gone through a mock connection, and how long its responses took to be delivered.
+struct FSpatialMockConnectionStats
+{
+	double ElapsedSeconds;
+	int32 NumOpLists;
+	int32 NumOps;
+	int32 NumEntitiesCreated;
+	int32 NumComponentUpdates;
+	int32 NumRejectedComponentUpdates;
+	int32 NumCommandRequests;
+	int32 NumResponses;
+	double AverageResponseLatency;
+	double MaxResponseLatency;
+};
+
+// An in-process stand-in for a SpatialOS deployment with a single worker, used with -mockConnection to run the GDK
+// headless without a runtime. Requests are answered the way the runtime would answer them, in the op list returned by the
+// next call to GetOpList: entity ids are reserved, entities are created and deleted, component updates are echoed back,
+// and command requests are delivered to this worker if it is authoritative over the command's component.
+// Authority is delegated from each entity's EntityAcl, and changes whenever the ACL is updated.
+// Takes ownership of every schema object sent through it, as the Worker SDK does.
+class FSpatialMockConnection
+{
+public:
+	FSpatialMockConnection(const FString& InWorkerType, const FString& InWorkerId);
+	~FSpatialMockConnection();
+
+	// Adds every entity in the snapshot to the world, as the runtime would when starting from it.
+	bool LoadSnapshot(const FString& SnapshotPath);
+
+	// Entities created between BeginCheckout and EndCheckout are all added in a single critical section, as they are when a
+	// worker first checks out a populated deployment. LoadSnapshot adds its entities this way.
+	void BeginCheckout();
+	void EndCheckout();
+
+	const FString& GetWorkerId() const { return WorkerId; }
+
+	// Returns nullptr if nothing has happened since the last call. The op list is decoded with ComponentLayouts, if given.
+	TUniquePtr<FSpatialOpList> GetOpList(const FSpatialComponentLayouts* ComponentLayouts = nullptr);
+
+	Worker_RequestId SendReserveEntityIdRequest();
+	Worker_RequestId SendReserveEntityIdsRequest(uint32_t NumOfEntities);
+	Worker_RequestId SendCreateEntityRequest(uint32_t ComponentCount, const Worker_ComponentData* Components, const Worker_EntityId* EntityId);
+	Worker_RequestId SendDeleteEntityRequest(Worker_EntityId EntityId);
+	void SendComponentUpdate(Worker_EntityId EntityId, const Worker_ComponentUpdate* ComponentUpdate);
+	Worker_RequestId SendCommandRequest(Worker_EntityId EntityId, const Worker_CommandRequest* Request, uint32_t CommandId);
+	void SendCommandResponse(Worker_RequestId RequestId, const Worker_CommandResponse* Response);
+
+	FSpatialMockConnectionStats GetStats() const;
+
+	// Logs how much work has gone through the connection so far, and how long responses took to be delivered.
+	void LogStats() const;
+
+	FSpatialMockConnection(const FSpatialMockConnection& Other) = delete;
+	FSpatialMockConnection& operator=(const FSpatialMockConnection& Other) = delete;
+
+private:
+	struct FMockOpList;
+
+	struct FMockEntity
+	{
+		TArray<Worker_ComponentId> ComponentIds;
+		TSet<Worker_ComponentId> AuthoritativeComponents;
+		improbable::EntityAcl Acl;
+	};
+
+	struct FPendingCommand
+	{
+		Worker_EntityId EntityId;
+		Worker_ComponentId ComponentId;
+		uint32 CommandId;
+		double SendTime;
+	};
+
+	Worker_Op& AddOp(uint8_t OpType);
+	Worker_RequestId AddRequest();
+	void AddResponse(double SendTime);
+	void AddEntity(Worker_EntityId EntityId, const TArray<Worker_ComponentData>& Components);
+	void UpdateAuthority(Worker_EntityId EntityId, FMockEntity& Entity);
+	bool HasWriteAccess(const FMockEntity& Entity, Worker_ComponentId ComponentId) const;
+	void AddCommandFailure(Worker_RequestId RequestId, Worker_EntityId EntityId, Worker_ComponentId ComponentId, uint32 CommandId, uint8_t StatusCode, const FString& Message);
+
+	FString WorkerType;
+	FString WorkerId;
+	TArray<FString> WorkerAttributes;
+
+	TMap<Worker_EntityId_Key, FMockEntity> Entities;
+	TMap<Worker_RequestId, FPendingCommand> PendingCommands;
+
+	Worker_EntityId NextEntityId;
+	Worker_RequestId NextRequestId;
+	bool bInCheckout;
+
+	TUniquePtr<FMockOpList> PendingOpList;
+
+	double StartTime;
+	int32 NumOpLists;
+	int32 NumOps;
+	int32 NumEntitiesCreated;
+	int32 NumComponentUpdates;
+	int32 NumRejectedComponentUpdates;
+	int32 NumCommandRequests;
+	int32 NumResponses;
+	double TotalResponseLatency;
+	double MaxResponseLatency;
+};
@@ -0,0 +1,85 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interop/SpatialTypebindingManager.h"
+#include "Schema/Component.h"
+#include "UObject/improbable/UnrealObjectRef.h"
+
+#include <WorkerSDK/improbable/c_worker.h>
+
+namespace improbable
+{
+
+// Parses component data for the components tracked by the USpatialStaticComponentView.
+// Returns nullptr for any other component. Does not touch any UObjects, so is safe to call off the game thread.
+TUniquePtr<ComponentStorageBase> CreateStaticComponentStorage(const Worker_ComponentData& Data);
+
+// A component update for one of the components tracked by the USpatialStaticComponentView, parsed ahead of dispatch.
+class ComponentUpdateBase
+{
+public:
+	virtual ~ComponentUpdateBase() {}
+	virtual void ApplyTo(Component& Target) const = 0;
+};
+
+// Parses updates for the components tracked by the USpatialStaticComponentView which can change. Returns nullptr for any
+// other component, or if the update doesn't change anything. Does not touch any UObjects, so is safe to call off the game thread.
+TUniquePtr<ComponentUpdateBase> CreateStaticComponentUpdate(const Worker_ComponentUpdate& Update);
+
+// The fields of a generated replicated or handover component's data or update, read out ahead of dispatch. Strings and
+// object refs in top level fields are converted here, the rest are cheap to read and are left to ComponentReader.
+struct GeneratedComponentFields
+{
+	// Every field which is present, in the order the schema object holds them.
+	TArray<Schema_FieldId> FieldIds;
+	// Fields cleared by an update. These aren't otherwise present, so are applied as empty.
+	TSet<Schema_FieldId> ClearedFieldIds;
+	// Every element of each String, Name and Text field, keyed by field id.
+	TMap<Schema_FieldId, TArray<FString>> Strings;
+	// Every element of each Object field, keyed by field id.
+	TMap<Schema_FieldId, TArray<FUnrealObjectRef>> ObjectRefs;
+};
+
+// Reads out the fields of generated component data or updates, given the kinds of the component's fields.
+// Does not touch any UObjects, so is safe to call off the game thread.
+TSharedPtr<GeneratedComponentFields> CreateGeneratedComponentFields(const Worker_ComponentData& Data, const TArray<ESchemaPropertyKind>& FieldKinds);
+TSharedPtr<GeneratedComponentFields> CreateGeneratedComponentFields(const Worker_ComponentUpdate& Update, const TArray<ESchemaPropertyKind>& FieldKinds);
+
+}
+
+// An op list received from SpatialOS, along with the component data that was decoded from it before dispatch.
+// Decoding happens on whichever thread fetched the op list, so that the game thread only has to apply the results.
+struct SPATIALGDK_API FSpatialOpList
+{
+	// Takes ownership of an op list allocated by the Worker SDK.
+	explicit FSpatialOpList(Worker_OpList* InOpList);
+	virtual ~FSpatialOpList();
+
+	FSpatialOpList(const FSpatialOpList& Other) = delete;
+	FSpatialOpList& operator=(const FSpatialOpList& Other) = delete;
+
+	// Decodes the component data and updates of every ADD_COMPONENT and COMPONENT_UPDATE op in the list. Static components are
+	// parsed completely. The fields of generated components are read out if ComponentLayouts has the component's layout, which it
+	// does once its class has been bound; writing them into the replicated UObjects is left to the game thread.
+	void Decode(const FSpatialComponentLayouts* ComponentLayouts = nullptr);
+
+	Worker_OpList* OpList;
+
+	// Keyed by the index of the ADD_COMPONENT op within OpList.
+	TMap<uint32, TUniquePtr<improbable::ComponentStorageBase>> DecodedComponents;
+
+	// Keyed by the index of the COMPONENT_UPDATE op within OpList.
+	TMap<uint32, TUniquePtr<improbable::ComponentUpdateBase>> DecodedUpdates;
+
+	// Keyed by the index of the ADD_COMPONENT or COMPONENT_UPDATE op within OpList. Shared, since component data is held by
+	// the receiver along with its fields until its entity's actor is spawned.
+	TMap<uint32, TSharedPtr<improbable::GeneratedComponentFields>> DecodedGeneratedComponents;
+
+protected:
+	// For op lists which were not allocated by the Worker SDK. The subclass owns the memory OpList points to,
+	// and must set OpList back to nullptr when releasing it.
+	FSpatialOpList();
+};
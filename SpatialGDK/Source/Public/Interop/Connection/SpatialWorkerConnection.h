@@ -1,7 +1,15 @@
 // Copyright (c) Improbable Worlds Ltd, All Rights Reserved
 #pragma once
 
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+
 #include "Interop/Connection/ConnectionConfig.h"
+#include "Interop/Connection/OpListRecording.h"
+#include "Interop/Connection/SpatialMockConnection.h"
+#include "Interop/Connection/SpatialOpList.h"
 
 #include <WorkerSDK/improbable/c_schema.h>
 #include <WorkerSDK/improbable/c_worker.h>
@@ -14,7 +22,7 @@ DECLARE_DELEGATE(FOnConnectedDelegate);
 DECLARE_DELEGATE_OneParam(FOnConnectFailedDelegate, const FString&);
 
 UCLASS()
-class SPATIALGDK_API USpatialWorkerConnection : public UObject
+class SPATIALGDK_API USpatialWorkerConnection : public UObject, public FRunnable
 {
 
 	GENERATED_BODY()
@@ -27,8 +35,10 @@ public:
 	FORCEINLINE bool IsConnected() { return bIsConnected; }
 
 	// Worker Connection Interface
-	Worker_OpList* GetOpList();
+	// Returns every op list received since the last call, in the order they were received.
+	TArray<TUniquePtr<FSpatialOpList>> GetOpLists();
 	Worker_RequestId SendReserveEntityIdRequest();
+	Worker_RequestId SendReserveEntityIdsRequest(uint32_t NumOfEntities);
 	Worker_RequestId SendCreateEntityRequest(uint32_t ComponentCount, const Worker_ComponentData* Components, const Worker_EntityId* EntityId);
 	Worker_RequestId SendDeleteEntityRequest(Worker_EntityId EntityId);
 	void SendComponentUpdate(Worker_EntityId EntityId, const Worker_ComponentUpdate* ComponentUpdate);
@@ -44,17 +54,68 @@ public:
 	FReceptionistConfig ReceptionistConfig;
 	FLocatorConfig LocatorConfig;
 
+	// Connect to an in-process FSpatialMockConnection instead of SpatialOS. Also set by -mockConnection.
+	bool bConnectToMock = false;
+
+	// Only valid once connected to a mock.
+	const FSpatialMockConnection* GetMockConnection() const { return MockConnection.Get(); }
+
+	// Used to decode the generated components in op lists as they are fetched. Set by the net driver before connecting.
+	TSharedPtr<const FSpatialComponentLayouts, ESPMode::ThreadSafe> ComponentLayouts;
+
+	// FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
 private:
 	void ConnectToReceptionist(bool bConnectAsClient);
 	void ConnectToLocator();
+	void ConnectToReplay(const FString& ReplayFilePath);
+	void ConnectToMock(bool bConnectAsClient);
 
 	Worker_ConnectionParameters CreateConnectionParameters(FConnectionConfig& Config);
 	bool ShouldConnectWithLocator();
 
 	void GetAndPrintConnectionFailureMessage();
 
+	void OnConnectionSuccess();
+	void StartOpsProcessingThread();
+	void StopOpsProcessingThread();
+	void QueueLatestOpList();
+	void RecordOpList(const Worker_OpList& OpList);
+	TUniquePtr<FSpatialOpList> GetNextReplayedOpList();
+
 	Worker_Connection* WorkerConnection;
 	Worker_Locator* WorkerLocator;
 
 	bool bIsConnected;
+
+	// Used when op lists are fetched and decoded on a worker thread rather than the game thread.
+	FRunnableThread* OpsProcessingThread;
+	FThreadSafeBool KeepRunning;
+	float OpsUpdateInterval;
+	TQueue<FSpatialOpList*> OpListQueue;
+	// The ops in OpListQueue. No more are fetched while there are over MaxQueuedOps, unless it is 0.
+	FThreadSafeCounter NumQueuedOps;
+	uint32 MaxQueuedOps;
+
+	// Guards WorkerConnection while the ops processing thread is running.
+	FCriticalSection ConnectionCriticalSection;
+
+	// Set with -recordOps=<file> to write every received op list to disk.
+	TUniquePtr<FSpatialOpListRecorder> OpListRecorder;
+
+	// Set with -replayOps=<file> to feed a recording back to the dispatcher instead of connecting to SpatialOS. Op lists are
+	// delivered as long after the replay started as they were received after the recording started, however often the game
+	// ticks, or all at once with -replayOpsAsFastAsPossible.
+	TUniquePtr<FSpatialOpListReplayer> OpListReplayer;
+	bool bReplayAsFastAsPossible;
+	double ReplayStartTime;
+	int32 NumReplayedOpLists;
+	int32 NumReplayedOps;
+	// Nothing is sent while replaying, but callers still track their requests by id, so each is given a new one.
+	Worker_RequestId NextReplayRequestId;
+
+	// Set with -mockConnection to run against an in-process mock of SpatialOS, optionally starting from -mockSnapshot=<file>.
+	TUniquePtr<FSpatialMockConnection> MockConnection;
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 
+#include "SpatialConstants.h"
 #include "Utils/SchemaUtils.h"
 
 #include <WorkerSDK/improbable/c_schema.h>
@@ -34,11 +35,15 @@ public:
 	void LinkExistingSingletonActors();
 	void ExecuteInitialSingletonActorReplication();
 	void UpdateSingletonEntityId(const FString& ClassName, const Worker_EntityId SingletonEntityId);
+	// Sends the singleton map if UpdateSingletonEntityId has changed it since the last call. Called once per tick from USpatialNetDriver::TickFlush.
+	void FlushSingletonEntityIds();
 
 	bool IsSingletonEntity(Worker_EntityId EntityId);
 
 private:
-	void GetSingletonActorAndChannel(FString ClassName, AActor*& OutActor, USpatialActorChannel*& OutChannel);
+	void OnSingletonNameToEntityIdChanged();
+	void FindSingletonActors();
+	void GetSingletonActorAndChannel(const FString& ClassName, AActor*& OutActor, USpatialActorChannel*& OutChannel);
 
 private:
 	UPROPERTY()
@@ -51,4 +56,12 @@ private:
 	USpatialSender* Sender;
 
 	StringToEntityMap SingletonNameToEntityId;
+	TMap<Worker_EntityId_Key, FString> SingletonEntityIdToName;
+	bool bSingletonEntityIdsDirty;
+
+	// Singleton classes and the actors of each class in the world, found once rather than on every lookup.
+	UPROPERTY()
+	TMap<FString, UClass*> SingletonClasses;
+	TMap<UClass*, TArray<TWeakObjectPtr<AActor>>> SingletonClassToActors;
+	bool bSingletonActorsFound;
 };
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"
 
+#include "Interop/Connection/SpatialOpList.h"
 #include "Schema/Component.h"
 #include "Schema/StandardLibrary.h"
 #include "Schema/UnrealMetadata.h"
@@ -16,6 +18,7 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpatialView, Log, All);
 
+class USpatialActorChannel;
 class USpatialNetDriver;
 class USpatialReceiver;
 class USpatialStaticComponentView;
@@ -27,9 +30,34 @@ class SPATIALGDK_API USpatialDispatcher : public UObject
 
 public:
 	void Init(USpatialNetDriver* NetDriver);
-	void ProcessOps(Worker_OpList* OpList);
+	virtual void BeginDestroy() override;
+
+	// Takes ownership of op lists received from SpatialOS, to be processed by ProcessOps in the order they were queued.
+	void QueueOpLists(TArray<TUniquePtr<FSpatialOpList>>&& OpLists);
+
+	// Processes queued ops until there are none left or the per-tick time budget is spent.
+	// Any remaining ops are carried over, and processing resumes from the same op on the next call.
+	void ProcessOps();
+
+	// True if so many ops have been carried over that no new op lists should be queued until they are processed.
+	bool IsBackedUp() const;
+
+	// True if ProcessOps has yet to finish with some of the queued op lists.
+	bool HasQueuedOpLists() const { return CurrentOpList.IsValid() || NumQueuedOpLists > 0; }
+
+	// Queue a channel to have its ownership, ACL and interest re-evaluated at the end of the next ProcessOps.
+	void MarkChannelDirty(USpatialActorChannel* Channel);
 
 private:
+	// Returns false if the time budget ran out before the whole op list was processed.
+	bool ProcessOpList(FSpatialOpList& OpList, double Deadline);
+	void ProcessOp(FSpatialOpList& OpList, uint32 OpIndex);
+	void TickDirtyChannels();
+	// Every OwnershipSweepInterval, marks dirty any channel whose net ownership has changed without it being marked.
+	void SweepChannels();
+	// Counts and logs the ticks for which new op lists are held back by IsBackedUp.
+	void UpdateBackedUp();
+
 	UPROPERTY()
 	USpatialNetDriver* NetDriver;
 
@@ -38,4 +66,26 @@ private:
 
 	UPROPERTY()
 	USpatialStaticComponentView* StaticComponentView;
+
+	// Channels whose ownership, ACL or interest inputs have changed since they were last ticked.
+	TSet<TWeakObjectPtr<USpatialActorChannel>> DirtyChannels;
+	double LastSweepTime;
+
+	// Op lists waiting to be processed after CurrentOpList. Owned by the dispatcher.
+	TQueue<FSpatialOpList*> QueuedOpLists;
+	int32 NumQueuedOpLists;
+	uint32 QueuedOpCount;
+
+	// The op list being processed, and progress through it, kept across calls to ProcessOps.
+	TUniquePtr<FSpatialOpList> CurrentOpList;
+	uint32 NextOpIndex;
+	// Indices into CurrentOpList of the COMPONENT_UPDATE ops to apply once the rest of it has been processed.
+	TArray<uint32> QueuedComponentUpdateOps;
+	int32 NextComponentUpdateIndex;
+	// Set by the op ending a critical section, until the receiver has received every entity added in it.
+	bool bLeavingCriticalSection;
+
+	// Whether new op lists were being held back with the connection at the end of the last ProcessOps.
+	bool bWasBackedUp;
+	uint32 BackedUpTicks;
 };
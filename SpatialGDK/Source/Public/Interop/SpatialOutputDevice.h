@@ -3,13 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Misc/OutputDevice.h"
 
 #include <WorkerSDK/improbable/c_worker.h>
 
 class USpatialWorkerConnection;
 
-class SPATIALGDK_API FSpatialOutputDevice : public FOutputDevice
+// Forwards log messages to SpatialOS. Messages are copied into a fixed ring of preallocated slots by whichever thread logs them,
+// without locking or allocating, and sent from a worker thread, where identical messages are coalesced and each category is rate limited,
+// so a log storm can't stall the game or flood the connection.
+class SPATIALGDK_API FSpatialOutputDevice : public FOutputDevice, public FRunnable
 {
 public:
 	FSpatialOutputDevice(USpatialWorkerConnection* InConnection, FString LoggerName);
@@ -19,12 +25,66 @@ public:
 	void RemoveRedirectCategory(const FName& Category);
 	void SetVerbosityFilterLevel(ELogVerbosity::Type Verbosity);
 	void Serialize(const TCHAR* InData, ELogVerbosity::Type Verbosity, const FName& Category) override;
+	bool CanBeUsedOnAnyThread() const override { return true; }
+
+	// FRunnable Interface
+	uint32 Run() override;
+	void Stop() override;
 
 	static Worker_LogLevel ConvertLogLevelToSpatial(ELogVerbosity::Type Verbosity);
 
 protected:
+	// Longer messages are truncated so every slot can be allocated up front.
+	static const int32 MaxMessageLength = 512;
+
+	struct FLogMessageSlot
+	{
+		// Position in the ring this slot can next be written at, or that position + 1 once the message is written.
+		volatile int32 Sequence;
+		FName Category;
+		ELogVerbosity::Type Verbosity;
+		TCHAR Message[MaxMessageLength];
+	};
+
+	struct FCoalescedLogMessage
+	{
+		const FLogMessageSlot* Slot;
+		int32 Count;
+	};
+
+	struct FCategoryRateLimit
+	{
+		double Tokens;
+		double LastRefillTime;
+		int32 NumSuppressed;
+	};
+
+	bool EnqueueMessage(const TCHAR* InData, ELogVerbosity::Type Verbosity, const FName& Category);
+	void FlushQueuedMessages();
+	void SendCoalescedMessages();
+	bool ConsumeToken(FCategoryRateLimit& RateLimit, double Now) const;
+	// Called on the flush thread. Overridden by tests to capture what would be sent.
+	virtual void SendLogMessage(ELogVerbosity::Type Verbosity, const TCHAR* Message);
+
 	ELogVerbosity::Type FilterLevel;
 	TSet<FName> CategoriesToRedirect;
 	USpatialWorkerConnection* Connection;
 	FString Name;
+
+	// Bounded multi-producer ring; only the flush thread (or the destructor, once it has stopped) consumes it.
+	TArray<FLogMessageSlot> Slots;
+	int32 SlotMask;
+	volatile int32 EnqueuePosition;
+	int32 DequeuePosition;
+	FThreadSafeCounter NumDroppedMessages;
+
+	FRunnableThread* FlushThread;
+	FThreadSafeBool KeepRunning;
+
+	// Only touched by the flush thread, or by the destructor once the flush thread has stopped.
+	TArray<FCoalescedLogMessage> CoalescedMessages;
+	TMap<uint32, int32> CoalescedMessageIndices;
+	TMap<FName, FCategoryRateLimit> CategoryRateLimits;
+	double MessagesPerSecond;
+	double MessageBurst;
 };
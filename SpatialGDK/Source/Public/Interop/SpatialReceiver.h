@@ -7,10 +7,12 @@
 #include "EngineClasses/SpatialActorChannel.h"
 #include "EngineClasses/SpatialNetDriver.h"
 #include "EngineClasses/SpatialPackageMapClient.h"
+#include "Interop/Connection/SpatialOpList.h"
 #include "Interop/SpatialTypebindingManager.h"
 #include "Schema/StandardLibrary.h"
 #include "Schema/Rotation.h"
 #include "UObject/improbable/UnrealObjectRef.h"
+#include "Utils/UnresolvedRefTable.h"
 
 #include <WorkerSDK/improbable/c_schema.h>
 #include <WorkerSDK/improbable/c_worker.h>
@@ -31,12 +33,14 @@ using FReliableRPCMap = TMap<Worker_RequestId, TSharedRef<struct FPendingRPCPara
 struct PendingAddComponentWrapper
 {
 	PendingAddComponentWrapper() = default;
-	PendingAddComponentWrapper(Worker_EntityId InEntityId, Worker_ComponentId InComponentId, const TSharedPtr<improbable::Component>& InData)
-		: EntityId(InEntityId), ComponentId(InComponentId), Data(InData) {}
+	PendingAddComponentWrapper(Worker_EntityId InEntityId, Worker_ComponentId InComponentId, const TSharedPtr<improbable::Component>& InData, const TSharedPtr<improbable::GeneratedComponentFields>& InDecodedFields)
+		: EntityId(InEntityId), ComponentId(InComponentId), Data(InData), DecodedFields(InDecodedFields) {}
 
 	Worker_EntityId EntityId;
 	Worker_ComponentId ComponentId;
 	TSharedPtr<improbable::Component> Data;
+	// The fields of Data, if they were read out when the op list was decoded.
+	TSharedPtr<improbable::GeneratedComponentFields> DecodedFields;
 };
 
 struct FObjectReferences
@@ -77,19 +81,41 @@ struct FObjectReferences
 	UProperty*							Property;
 };
 
+// The unresolved properties of an object, waiting in USpatialReceiver::PendingRepUpdates for the object refs they point to.
+struct FPendingIncomingRepUpdate
+{
+	FPendingIncomingRepUpdate(const FChannelObjectPair& InChannelObjectPair, FObjectReferencesMap&& InObjectReferencesMap)
+		: ChannelObjectPair(InChannelObjectPair), ObjectReferencesMap(MoveTemp(InObjectReferencesMap)) {}
+
+	FChannelObjectPair ChannelObjectPair;
+	FObjectReferencesMap ObjectReferencesMap;
+};
+
 struct FPendingIncomingRPC
 {
-	FPendingIncomingRPC(const TSet<FUnrealObjectRef>& InUnresolvedRefs, UObject* InTargetObject, UFunction* InFunction, const TArray<uint8>& InPayloadData, int64 InCountBits)
-		: UnresolvedRefs(InUnresolvedRefs), TargetObject(InTargetObject), Function(InFunction), PayloadData(InPayloadData), CountBits(InCountBits) {}
+	FPendingIncomingRPC(UObject* InTargetObject, UFunction* InFunction, const uint8* InPayloadData, int64 InCountBits)
+		: TargetObject(InTargetObject), Function(InFunction), PayloadData(InPayloadData, FMath::DivideAndRoundUp<int64>(InCountBits, 8)), CountBits(InCountBits) {}
 
-	TSet<FUnrealObjectRef> UnresolvedRefs;
 	TWeakObjectPtr<UObject> TargetObject;
 	UFunction* Function;
 	TArray<uint8> PayloadData;
 	int64 CountBits;
 };
 
-using FIncomingRPCArray = TArray<TSharedPtr<FPendingIncomingRPC>>;
+// A reliable RPC whose command failed, waiting to be sent again. Ordered so the heap in USpatialReceiver has the earliest retry on top.
+struct FReliableRPCRetry
+{
+	FReliableRPCRetry(double InRetryTime, const TSharedRef<struct FPendingRPCParams>& InParams)
+		: RetryTime(InRetryTime), Params(InParams) {}
+
+	bool operator<(const FReliableRPCRetry& Other) const
+	{
+		return RetryTime < Other.RetryTime;
+	}
+
+	double RetryTime;
+	TSharedRef<struct FPendingRPCParams> Params;
+};
 
 UCLASS()
 class USpatialReceiver : public UObject
@@ -101,29 +127,45 @@ public:
 
 	// Dispatcher Calls
 	void OnCriticalSection(bool InCriticalSection);
+	// Receives the entities added in the critical section which has just ended, stopping early once Deadline has passed.
+	// Returns false if some are left, in which case it must be called again before any other op is dispatched.
+	bool LeaveCriticalSection(double Deadline = TNumericLimits<double>::Max());
 	void OnAddEntity(Worker_AddEntityOp& Op);
-	void OnAddComponent(Worker_AddComponentOp& Op);
+	// DecodedFields, if given, are the fields of generated component data or updates read out when the op list was decoded.
+	void OnAddComponent(Worker_AddComponentOp& Op, const TSharedPtr<improbable::GeneratedComponentFields>& DecodedFields = nullptr);
 	void OnRemoveEntity(Worker_RemoveEntityOp& Op);
 	void OnAuthorityChange(Worker_AuthorityChangeOp& Op);
 
-	void OnComponentUpdate(Worker_ComponentUpdateOp& Op);
+	void OnComponentUpdate(Worker_ComponentUpdateOp& Op, const improbable::GeneratedComponentFields* DecodedFields = nullptr);
 	void OnCommandRequest(Worker_CommandRequestOp& Op);
 	void OnCommandResponse(Worker_CommandResponseOp& Op);
 
 	void OnReserveEntityIdResponse(Worker_ReserveEntityIdResponseOp& Op);
+	void OnReserveEntityIdsResponse(Worker_ReserveEntityIdsResponseOp& Op);
 	void OnCreateEntityIdResponse(Worker_CreateEntityResponseOp& Op);
 
 	void AddPendingActorRequest(Worker_RequestId RequestId, USpatialActorChannel* Channel);
 	void AddPendingReliableRPC(Worker_RequestId RequestId, TSharedRef<struct FPendingRPCParams> Params);
+	// Reliable RPCs which have been sent, and are waiting for a response.
+	int32 GetNumPendingReliableRPCs() const { return PendingReliableRPCs.Num(); }
+	// Reliable RPCs which have failed and are waiting to be resent, kept in a heap with the earliest retry on top.
+	const TArray<FReliableRPCRetry>& GetReliableRPCRetries() const { return ReliableRPCRetries; }
+	void ClearReliableRPCRetries() { ReliableRPCRetries.Reset(); }
+	// Resends the reliable RPCs whose retry time has come. Called once per tick from USpatialNetDriver::TickFlush.
+	void ProcessReliableRPCRetries();
 
 	void CleanupDeletedEntity(Worker_EntityId EntityId);
 
+	// Drops the property updates and RPCs for Actor which are waiting on unresolved object refs.
+	void DropPendingOperations(AActor* Actor);
+	// Drops pending operations which have waited longer than the configured timeout, or exceed the configured maximum.
+	void RemoveExpiredPendingOperations();
+
 	void ProcessQueuedResolvedObjects();
 	void ResolvePendingOperations(UObject* Object, const FUnrealObjectRef& ObjectRef);
 
 private:
 	void EnterCriticalSection();
-	void LeaveCriticalSection();
 
 	void ReceiveActor(Worker_EntityId EntityId);
 	void RemoveActor(Worker_EntityId EntityId);
@@ -132,17 +174,20 @@ private:
 
 	void HandleActorAuthority(Worker_AuthorityChangeOp& Op);
 
-	void ApplyComponentData(Worker_EntityId EntityId, Worker_ComponentData& Data, USpatialActorChannel* Channel);
-	void ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, USpatialActorChannel* Channel, bool bIsHandover);
+	void ApplyComponentData(Worker_EntityId EntityId, Worker_ComponentData& Data, USpatialActorChannel* Channel, const improbable::GeneratedComponentFields* DecodedFields);
+	void ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, USpatialActorChannel* Channel, bool bIsHandover, const improbable::GeneratedComponentFields* DecodedFields);
 
 	void ReceiveRPCCommandRequest(const Worker_CommandRequest& CommandRequest, UObject* TargetObject, UFunction* Function);
 	void ReceiveMulticastUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* TargetObject, const TArray<UFunction*>& RPCArray);
-	void ApplyRPC(UObject* TargetObject, UFunction* Function, TArray<uint8>& PayloadData, int64 CountBits);
+	void ApplyRPC(UObject* TargetObject, UFunction* Function, const uint8* PayloadData, int64 CountBits);
 
 	void ReceiveCommandResponse(Worker_CommandResponseOp& Op);
 
-	void QueueIncomingRepUpdates(FChannelObjectPair ChannelObjectPair, const FObjectReferencesMap& ObjectReferencesMap, const TSet<FUnrealObjectRef>& UnresolvedRefs);
-	void QueueIncomingRPC(const TSet<FUnrealObjectRef>& UnresolvedRefs, UObject* TargetObject, UFunction* Function, const TArray<uint8>& PayloadData, int64 CountBits);
+	FObjectReferencesMap* FindPendingObjectReferences(const FChannelObjectPair& ChannelObjectPair);
+	void QueueIncomingRepUpdates(const FChannelObjectPair& ChannelObjectPair, FObjectReferencesMap& NewObjectReferencesMap, const TSet<FUnrealObjectRef>& UnresolvedRefs);
+	void RemovePendingRepUpdate(FUnresolvedRefHandle Handle);
+	void RemovePendingRepUpdateHandle(FUnresolvedRefHandle Handle, const FPendingIncomingRepUpdate& PendingRepUpdate);
+	void QueueIncomingRPC(const TSet<FUnrealObjectRef>& UnresolvedRefs, UObject* TargetObject, UFunction* Function, const uint8* PayloadData, int64 CountBits);
 
 	void ResolvePendingOperations_Internal(UObject* Object, const FUnrealObjectRef& ObjectRef);
 	void ResolveIncomingOperations(UObject* Object, const FUnrealObjectRef& ObjectRef);
@@ -180,19 +225,24 @@ private:
 
 	FTimerManager* TimerManager;
 
-	// TODO: Figure out how to remove entries when Channel/Actor gets deleted - UNR:100
-	TMap<FUnrealObjectRef, TSet<FChannelObjectPair>> IncomingRefsMap;
-	TMap<FChannelObjectPair, FObjectReferencesMap> UnresolvedRefsMap;
+	// Owned by the actor they apply to, and dropped when it is destroyed.
+	TUnresolvedRefTable<FUnrealObjectRef, FPendingIncomingRepUpdate> PendingRepUpdates;
+	TMap<FChannelObjectPair, FUnresolvedRefHandle> PendingRepUpdateHandles;
 	TArray<TPair<UObject*, FUnrealObjectRef>> ResolvedObjectQueue;
 
-	TMap<FUnrealObjectRef, FIncomingRPCArray> IncomingRPCMap;
+	TUnresolvedRefTable<FUnrealObjectRef, FPendingIncomingRPC> PendingIncomingRPCs;
 
 	bool bInCriticalSection;
 	TArray<Worker_EntityId> PendingAddEntities;
+	// How many of PendingAddEntities have been received by a LeaveCriticalSection which ran out of time.
+	int32 NextPendingAddEntityIndex;
 	TArray<Worker_AuthorityChangeOp> PendingAuthorityChanges;
-	TArray<PendingAddComponentWrapper> PendingAddComponents;
+	// Keyed by entity, so that receiving each entity of a large checkout doesn't scan the components of all the others.
+	TMap<Worker_EntityId, TArray<PendingAddComponentWrapper>> PendingAddComponents;
 	TArray<Worker_EntityId> PendingRemoveEntities;
 
 	TMap<Worker_RequestId, USpatialActorChannel*> PendingActorRequests;
 	FReliableRPCMap PendingReliableRPCs;
+	// Min-heap on retry time.
+	TArray<FReliableRPCRetry> ReliableRPCRetries;
 };
@@ -4,8 +4,10 @@
 
 #include "CoreMinimal.h"
 
+#include "SpatialConstants.h"
 #include "SpatialTypebindingManager.h"
 #include "Utils/RepDataUtils.h"
+#include "Utils/UnresolvedRefTable.h"
 
 #include <WorkerSDK/improbable/c_schema.h>
 #include <WorkerSDK/improbable/c_worker.h>
@@ -31,16 +33,26 @@ struct FPendingRPCParams
 	UFunction* Function;
 	TArray<uint8> Parameters;
 	int Attempts; // For reliable RPCs
+	double Deadline; // For reliable RPCs, 0 if they can be retried until they run out of attempts
 };
 
-// TODO: Clear TMap entries when USpatialActorChannel gets deleted - UNR:100
-// care for actor getting deleted before actor channel
 using FChannelObjectPair = TPair<TWeakObjectPtr<USpatialActorChannel>, TWeakObjectPtr<UObject>>;
-using FOutgoingRPCMap = TMap<const UObject*, TArray<TSharedRef<FPendingRPCParams>>>;
-using FUnresolvedEntry = TSharedPtr<TSet<const UObject*>>;
-using FHandleToUnresolved = TMap<uint16, FUnresolvedEntry>;
-using FChannelToHandleToUnresolved = TMap<FChannelObjectPair, FHandleToUnresolved>;
-using FOutgoingRepUpdates = TMap<const UObject*, FChannelToHandleToUnresolved>;
+using FOutgoingRepUpdateKey = TPair<FChannelObjectPair, uint16>;
+using FEntityComponentKey = TPair<Worker_EntityId_Key, Worker_ComponentId>;
+
+// A contiguous range of entity IDs, as returned by a reserve entity IDs request.
+struct FEntityRange
+{
+	Worker_EntityId NextEntityId;
+	Worker_EntityId LastEntityId;
+};
+
+// A replicated property which can't be sent until the objects it references have entity IDs.
+struct FPendingOutgoingRepUpdate
+{
+	FChannelObjectPair ChannelObjectPair;
+	uint16 Handle;
+};
 
 UCLASS()
 class SPATIALGDK_API USpatialSender : public UObject
@@ -49,6 +61,7 @@ class SPATIALGDK_API USpatialSender : public UObject
 
 public:
 	void Init(USpatialNetDriver* InNetDriver);
+	virtual void BeginDestroy() override;
 
 	// Actor Updates
 	void SendComponentUpdates(UObject* Object, USpatialActorChannel* Channel, const FRepChangeState* RepChanges, const FHandoverChangeState* HandoverChanges);
@@ -56,15 +69,39 @@ public:
 	void SendPositionUpdate(Worker_EntityId EntityId, const FVector& Location);
 	void SendRotationUpdate(Worker_EntityId EntityId, const FRotator& Rotation);
 	void SendRPC(TSharedRef<FPendingRPCParams> Params);
+
+	// Queues an update to be sent by FlushComponentUpdates, merging it with any update already queued for the same entity and component.
+	// Use this for updates which are likely to be followed by more to the same component in the same tick.
+	// Takes ownership of the update's schema data.
+	void QueueComponentUpdate(Worker_EntityId EntityId, Worker_ComponentUpdate& Update);
+
+	// Sends the component updates queued during this tick. Called once per tick from USpatialNetDriver::TickFlush.
+	void FlushComponentUpdates();
 	void SendCommandResponse(Worker_RequestId request_id, Worker_CommandResponse& Response);
 
 	void SendReserveEntityIdRequest(USpatialActorChannel* Channel);
+
+	// Hands the channel an entity ID from the reserved pool if there is one, otherwise sends a reserve request for it.
+	void ReserveEntityId(USpatialActorChannel* Channel);
+	void OnReserveEntityIdsResponse(const Worker_ReserveEntityIdsResponseOp& Op);
+
+	// Takes the next entity ID from the reserved pool, requesting another batch if it runs low. Returns 0 if the pool is empty.
+	Worker_EntityId TakeReservedEntityId();
+	int64 GetNumReservedEntityIds() const;
+	bool IsEntityPoolRequestInFlight() const { return bEntityPoolRequestInFlight; }
+	Worker_RequestId GetEntityPoolRequestId() const { return EntityPoolRequestId; }
+
 	void SendCreateEntityRequest(USpatialActorChannel* Channel);
 	void SendDeleteEntityRequest(Worker_EntityId EntityId);
 
 	void ResolveOutgoingOperations(UObject* Object, bool bIsHandover);
 	void ResolveOutgoingRPCs(UObject* Object);
 
+	// Drops the property updates and RPCs for Actor which are waiting on unresolved objects.
+	void DropPendingOperations(AActor* Actor);
+	// Drops pending operations which have waited longer than the configured timeout, or exceed the configured maximum.
+	void RemoveExpiredPendingOperations();
+
 	bool UpdateEntityACLs(AActor* Actor, Worker_EntityId EntityId);
 private:
 	// Actor Lifecycle
@@ -80,6 +117,9 @@ private:
 	Worker_ComponentUpdate CreateMulticastUpdate(UObject* TargetObject, UFunction* Function, void* Parameters, Worker_ComponentId ComponentId, Schema_FieldId EventIndex, Worker_EntityId& OutEntityId, const UObject*& OutUnresolvedObject);
 
 	TArray<Worker_InterestOverride> CreateComponentInterest(AActor* Actor);
+
+	// Entity Pool
+	void RefillEntityPool(uint32 NumOfEntities);
 	FString GetOwnerWorkerAttribute(AActor* Actor);
 
 private:
@@ -101,13 +141,22 @@ private:
 	UPROPERTY()
 	USpatialTypebindingManager* TypebindingManager;
 
-	FChannelToHandleToUnresolved RepPropertyToUnresolved;
-	FOutgoingRepUpdates RepObjectToUnresolved;
+	// Owned by the actor they apply to, and dropped when it is destroyed.
+	TUnresolvedRefTable<const UObject*, FPendingOutgoingRepUpdate> PendingRepUpdates;
+	TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle> PendingRepUpdateHandles;
+
+	TUnresolvedRefTable<const UObject*, FPendingOutgoingRepUpdate> PendingHandoverUpdates;
+	TMap<FOutgoingRepUpdateKey, FUnresolvedRefHandle> PendingHandoverUpdateHandles;
 
-	FChannelToHandleToUnresolved HandoverPropertyToUnresolved;
-	FOutgoingRepUpdates HandoverObjectToUnresolved;
+	TUnresolvedRefTable<const UObject*, TSharedRef<FPendingRPCParams>> PendingOutgoingRPCs;
 
-	FOutgoingRPCMap OutgoingRPCs;
+	// Outgoing component updates for this tick, keyed by entity and component.
+	TMap<FEntityComponentKey, Worker_ComponentUpdate> PendingComponentUpdates;
 
 	TMap<Worker_RequestId, USpatialActorChannel*> PendingActorRequests;
+
+	// Entity IDs reserved ahead of time, so new actors don't have to wait for a reservation.
+	TArray<FEntityRange> ReservedEntityIds;
+	Worker_RequestId EntityPoolRequestId;
+	bool bEntityPoolRequestInFlight;
 };
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/ChunkedArray.h"
+#include "Misc/Optional.h"
 
 #include "Schema/Component.h"
+#include "Schema/Rotation.h"
 #include "Schema/StandardLibrary.h"
 #include "Schema/UnrealMetadata.h"
 #include "SpatialConstants.h"
@@ -14,6 +17,11 @@
 
 #include "SpatialStaticComponentView.generated.h"
 
+namespace improbable
+{
+class ComponentUpdateBase;
+}
+
 UCLASS()
 class SPATIALGDK_API USpatialStaticComponentView : public UObject
 {
@@ -23,15 +31,70 @@ public:
 	Worker_Authority GetAuthority(Worker_EntityId EntityId, Worker_ComponentId ComponentId);
 	bool HasAuthority(Worker_EntityId EntityId, Worker_ComponentId ComponentId);
 
+	// Component data is stored in chunks which never move, so the returned pointer stays valid until the component or its entity is removed.
 	template <typename T>
-	T* GetComponentData(Worker_EntityId EntityId);
+	T* GetComponentData(Worker_EntityId EntityId)
+	{
+		if (const int32* Slot = EntitySlots.Find(EntityId))
+		{
+			TOptional<T>& Component = GetStorage(static_cast<T*>(nullptr))[*Slot];
+			return Component.IsSet() ? &Component.GetValue() : nullptr;
+		}
 
-	void OnAddComponent(const Worker_AddComponentOp& Op);
+		return nullptr;
+	}
+
+	void OnAddComponent(const Worker_AddComponentOp& Op, TUniquePtr<improbable::ComponentStorageBase> Data = nullptr);
+	void OnRemoveComponent(const Worker_RemoveComponentOp& Op);
 	void OnRemoveEntity(const Worker_RemoveEntityOp& Op);
-	void OnComponentUpdate(const Worker_ComponentUpdateOp& Op);
+	// DecodedUpdate, if given, is Op's update parsed ahead of dispatch by improbable::CreateStaticComponentUpdate.
+	void OnComponentUpdate(const Worker_ComponentUpdateOp& Op, const improbable::ComponentUpdateBase* DecodedUpdate = nullptr);
 	void OnAuthorityChange(const Worker_AuthorityChangeOp& Op);
 
 private:
-	TMap<Worker_EntityId_Key, TMap<Worker_ComponentId, Worker_Authority>> EntityComponentAuthorityMap;
-	TMap<Worker_EntityId_Key, TMap<Worker_ComponentId, TUniquePtr<improbable::ComponentStorageBase>>> EntityComponentMap;
+	struct FEntityComponentId
+	{
+		Worker_EntityId EntityId;
+		Worker_ComponentId ComponentId;
+
+		bool operator==(const FEntityComponentId& Other) const
+		{
+			return EntityId == Other.EntityId && ComponentId == Other.ComponentId;
+		}
+
+		friend uint32 GetTypeHash(const FEntityComponentId& Value)
+		{
+			return HashCombine(GetTypeHash(Value.EntityId), GetTypeHash(Value.ComponentId));
+		}
+	};
+
+	template <typename T>
+	using TComponentStorage = TChunkedArray<TOptional<T>>;
+
+	int32 FindOrAddEntitySlot(Worker_EntityId EntityId);
+	template <typename T>
+	void SetComponentData(int32 Slot, TUniquePtr<improbable::ComponentStorageBase> Data);
+
+	TComponentStorage<improbable::EntityAcl>& GetStorage(improbable::EntityAcl*) { return EntityAclStorage; }
+	TComponentStorage<improbable::Metadata>& GetStorage(improbable::Metadata*) { return MetadataStorage; }
+	TComponentStorage<improbable::Position>& GetStorage(improbable::Position*) { return PositionStorage; }
+	TComponentStorage<improbable::Persistence>& GetStorage(improbable::Persistence*) { return PersistenceStorage; }
+	TComponentStorage<improbable::Rotation>& GetStorage(improbable::Rotation*) { return RotationStorage; }
+	TComponentStorage<improbable::UnrealMetadata>& GetStorage(improbable::UnrealMetadata*) { return UnrealMetadataStorage; }
+
+	// Every entity in view is given a slot, which indexes into the storage arrays below. Slots are reused once an entity leaves view.
+	TMap<Worker_EntityId_Key, int32> EntitySlots;
+	TArray<int32> FreeSlots;
+
+	// Keyed on both ids so that checking authority is a single lookup. The components of each entity with an entry
+	// are listed by slot, so they can be removed along with the entity.
+	TMap<FEntityComponentId, Worker_Authority> ComponentAuthority;
+	TArray<TArray<Worker_ComponentId>> EntityAuthorityComponents;
+
+	TComponentStorage<improbable::EntityAcl> EntityAclStorage;
+	TComponentStorage<improbable::Metadata> MetadataStorage;
+	TComponentStorage<improbable::Position> PositionStorage;
+	TComponentStorage<improbable::Persistence> PersistenceStorage;
+	TComponentStorage<improbable::Rotation> RotationStorage;
+	TComponentStorage<improbable::UnrealMetadata> UnrealMetadataStorage;
 };
@@ -3,12 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
 #include "Utils/SchemaDatabase.h"
 
 #include <WorkerSDK/improbable/c_worker.h>
 
 #include "SpatialTypebindingManager.generated.h"
 
+class UNetDriver;
+
 enum ERPCType
 {
 	RPC_Client = 0,
@@ -42,12 +45,59 @@ struct FRPCInfo
 	uint32 Index;
 };
 
+// How a property is stored in schema. Worked out once when classes are bound, so that ComponentFactory
+// and ComponentReader can switch on it rather than casting the property for every field they read or write.
+enum class ESchemaPropertyKind : uint8
+{
+	Unknown,
+	Bool,
+	Float,
+	Double,
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	Byte,
+	UInt16,
+	UInt32,
+	UInt64,
+	SmallEnum, // Enums whose underlying type is smaller than 4 bytes, stored as a uint32.
+	Object,
+	Name,
+	String,
+	Text,
+	Struct, // Structs serialized to bytes, through NetSerialize or their rep layout.
+	SchemaStruct, // Structs generated as their own schema type, and written field by field.
+	Array
+};
+
+struct FSchemaPropertyHandler
+{
+	ESchemaPropertyKind Kind;
+	ESchemaPropertyKind InnerKind; // The kind of the elements if this is an array.
+	int32 ElementSize; // The size of the elements if this is an array.
+	UProperty* Property;
+	// The handlers of the struct's fields, indexed by field id - 1, if this is or is an array of a SchemaStruct.
+	TSharedPtr<const TArray<FSchemaPropertyHandler>> StructFields;
+};
+
+SPATIALGDK_API ESchemaPropertyKind GetSchemaPropertyKind(UProperty* Property);
+SPATIALGDK_API FSchemaPropertyHandler CreateSchemaPropertyHandler(UProperty* Property);
+
+struct FRepPropertyInfo
+{
+	uint16 Handle;
+	int32 Offset;
+	FSchemaPropertyHandler Handler;
+};
+
 struct FHandoverPropertyInfo
 {
 	uint16 Handle;
 	int32 Offset;
 	int32 ArrayIdx;
 	UProperty* Property;
+	FSchemaPropertyHandler Handler;
 };
 
 USTRUCT()
@@ -58,6 +108,10 @@ struct FClassInfo
 	TMap<ERPCType, TArray<UFunction*>> RPCs;
 	TMap<UFunction*, FRPCInfo> RPCInfoMap;
 
+	// Indexed by rep handle - 1, for the top level rep handles of the class's rep layout. Bound the first time the class info is found.
+	TArray<FRepPropertyInfo> RepProperties;
+	bool bRepPropertiesBound = false;
+
 	TArray<FHandoverPropertyInfo> HandoverProperties;
 
 	Worker_ComponentId SingleClientComponent;
@@ -66,6 +120,26 @@ struct FClassInfo
 	Worker_ComponentId RPCComponents[RPC_Count];
 
 	TSet<UClass*> SubobjectClasses;
+
+	// Index of each of SubobjectClasses into USpatialActorChannel's resolved subobjects.
+	TMap<UClass*, int32> SubobjectIndices;
+
+	// Indices into the resolved subobjects of those subobjects which have handover properties.
+	TArray<int32> HandoverSubobjectIndices;
+};
+
+// The kind of every field of the generated replicated and handover components, indexed by field id - 1, for arrays the kind
+// of their elements. Layouts are added on the game thread as classes are bound, and can be read from any thread, so that
+// op lists can be decoded on the thread that fetched them.
+class SPATIALGDK_API FSpatialComponentLayouts
+{
+public:
+	void Add(Worker_ComponentId ComponentId, TArray<ESchemaPropertyKind>&& FieldKinds);
+	TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe> Find(Worker_ComponentId ComponentId) const;
+
+private:
+	mutable FRWLock Lock;
+	TMap<Worker_ComponentId, TSharedPtr<const TArray<ESchemaPropertyKind>, ESPMode::ThreadSafe>> Layouts;
 };
 
 UCLASS()
@@ -74,21 +148,26 @@ class SPATIALGDK_API USpatialTypebindingManager : public UObject
 	GENERATED_BODY()
 
 public:
-	void Init();
+	void Init(UNetDriver* InNetDriver);
 
 	bool IsSupportedClass(UClass* Class);
 	FClassInfo* FindClassInfoByClass(UClass* Class);
 	FClassInfo* FindClassInfoByComponentId(Worker_ComponentId ComponentId);
 	UClass* FindClassByComponentId(Worker_ComponentId ComponentId);
 
-	TArray<UObject*> GetHandoverSubobjects(AActor* Actor);
+	TSharedRef<const FSpatialComponentLayouts, ESPMode::ThreadSafe> GetComponentLayouts() const { return ComponentLayouts; }
 
 private:
 	void FindSupportedClasses();
 	void CreateTypebindings();
+	void BindRepProperties(UClass* Class, FClassInfo& Info);
 	void AddSubobjectClass(FClassInfo& ClassInfo, UClass* Class);
+	void FindHandoverSubobjects(FClassInfo& ClassInfo);
 
 private:
+	UPROPERTY()
+	UNetDriver* NetDriver;
+
 	UPROPERTY()
 	USchemaDatabase* SchemaDatabase;
 
@@ -99,4 +178,6 @@ private:
 	TMap<UClass*, FClassInfo> ClassInfoMap;
 
 	TMap<Worker_ComponentId, UClass*> ComponentToClassMap;
+
+	TSharedRef<FSpatialComponentLayouts, ESPMode::ThreadSafe> ComponentLayouts = MakeShared<FSpatialComponentLayouts, ESPMode::ThreadSafe>();
 };
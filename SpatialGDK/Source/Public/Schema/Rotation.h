@@ -28,9 +28,7 @@ struct Rotation : Component
 	{
 		Schema_Object* ComponentObject = Schema_GetComponentDataFields(Data.schema_type);
 
-		Pitch = Schema_GetFloat(ComponentObject, 1);
-		Yaw = Schema_GetFloat(ComponentObject, 2);
-		Roll = Schema_GetFloat(ComponentObject, 3);
+		Unpack(Schema_GetUint64(ComponentObject, 1));
 	}
 
 	FRotator ToFRotator()
@@ -45,9 +43,7 @@ struct Rotation : Component
 		Data.schema_type = Schema_CreateComponentData(ComponentId);
 		Schema_Object* ComponentObject = Schema_GetComponentDataFields(Data.schema_type);
 
-		Schema_AddFloat(ComponentObject, 1, Pitch);
-		Schema_AddFloat(ComponentObject, 2, Yaw);
-		Schema_AddFloat(ComponentObject, 3, Roll);
+		Schema_AddUint64(ComponentObject, 1, Pack());
 
 		return Data;
 	}
@@ -59,9 +55,7 @@ struct Rotation : Component
 		ComponentUpdate.schema_type = Schema_CreateComponentUpdate(ComponentId);
 		Schema_Object* ComponentObject = Schema_GetComponentUpdateFields(ComponentUpdate.schema_type);
 
-		Schema_AddFloat(ComponentObject, 1, Pitch);
-		Schema_AddFloat(ComponentObject, 2, Yaw);
-		Schema_AddFloat(ComponentObject, 3, Roll);
+		Schema_AddUint64(ComponentObject, 1, Pack());
 
 		return ComponentUpdate;
 	}
@@ -69,9 +63,27 @@ struct Rotation : Component
 	void ApplyComponentUpdate(const Worker_ComponentUpdate& Update)
 	{
 		Schema_Object* ComponentObject = Schema_GetComponentUpdateFields(Update.schema_type);
-		Pitch = Schema_GetDouble(ComponentObject, 1);
-		Yaw = Schema_GetDouble(ComponentObject, 2);
-		Roll = Schema_GetDouble(ComponentObject, 3);
+
+		if (Schema_GetUint64Count(ComponentObject, 1) > 0)
+		{
+			Unpack(Schema_GetUint64(ComponentObject, 1));
+		}
+	}
+
+	// Each axis is rounded to the nearest 360/65536 degrees and stored in 16 bits, so is accurate to within half that (~0.0027 degrees).
+	// Decompressed axes are in the range [0, 360).
+	uint64 Pack() const
+	{
+		return (uint64)FRotator::CompressAxisToShort(Pitch)
+			| ((uint64)FRotator::CompressAxisToShort(Yaw) << 16)
+			| ((uint64)FRotator::CompressAxisToShort(Roll) << 32);
+	}
+
+	void Unpack(uint64 Packed)
+	{
+		Pitch = FRotator::DecompressAxisFromShort((uint16)(Packed & 0xFFFF));
+		Yaw = FRotator::DecompressAxisFromShort((uint16)((Packed >> 16) & 0xFFFF));
+		Roll = FRotator::DecompressAxisFromShort((uint16)((Packed >> 32) & 0xFFFF));
 	}
 
 	float Pitch;
@@ -0,0 +1,149 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SpatialGDKSettings.generated.h"
+
+class AActor;
+
+USTRUCT()
+struct FSpatialTransformReplicationSettings
+{
+	GENERATED_BODY()
+
+	FSpatialTransformReplicationSettings()
+		: PositionThreshold(100.0f)
+		, RotationThreshold(5.73f)
+		, MaxUpdateRate(0.0f)
+	{
+	}
+
+	/** Distance in cm an actor has to move before its position is sent to SpatialOS. */
+	UPROPERTY(EditAnywhere, config, Category = "Transform Replication", meta = (ClampMin = "0.0"))
+	float PositionThreshold;
+
+	/** Angle in degrees an actor has to rotate before its rotation is sent to SpatialOS. */
+	UPROPERTY(EditAnywhere, config, Category = "Transform Replication", meta = (ClampMin = "0.0"))
+	float RotationThreshold;
+
+	/** Maximum number of position and rotation updates sent per second for each actor. 0 means no limit. */
+	UPROPERTY(EditAnywhere, config, Category = "Transform Replication", meta = (ClampMin = "0.0"))
+	float MaxUpdateRate;
+};
+
+UCLASS(config = SpatialGDKSettings, defaultconfig)
+class SPATIALGDK_API USpatialGDKSettings : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USpatialGDKSettings(const FObjectInitializer& ObjectInitializer);
+
+	/** Fetch and decode op lists on the game thread rather than on a dedicated worker thread. */
+	UPROPERTY(EditAnywhere, config, Category = "Worker Connection", meta = (ConfigRestartRequired = true, DisplayName = "Run Worker Connection on Game Thread"))
+	bool bRunSpatialWorkerConnectionOnGameThread;
+
+	/** Number of times per second the worker thread polls SpatialOS for new ops. Only used when the worker connection is not run on the game thread. */
+	UPROPERTY(EditAnywhere, config, Category = "Worker Connection", meta = (ConfigRestartRequired = true, ClampMin = "1.0", DisplayName = "Op Polling Rate"))
+	float OpsUpdateRate;
+
+	/** Maximum time in milliseconds spent processing ops each tick. Remaining ops are carried over to the next tick, even part way through a critical section. 0 means no limit. */
+	UPROPERTY(EditAnywhere, config, Category = "Worker Connection", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Op Processing Time Budget (ms)"))
+	float OpsProcessingTimeBudgetMs;
+
+	/** Stop taking new op lists from the connection while more than this many ops have been carried over. The worker thread likewise stops fetching ops from SpatialOS while it holds more than this many, leaving them with the Worker SDK. 0 means no limit. */
+	UPROPERTY(EditAnywhere, config, Category = "Worker Connection", meta = (ConfigRestartRequired = false, DisplayName = "Max Carried Over Ops"))
+	uint32 MaxCarriedOverOps;
+
+	/**
+	 * Seconds between full comparisons of every handover property of an actor and its subobjects. In between, only objects
+	 * whose replicated properties changed, actors passed to AActor::ForceNetUpdate and objects passed to
+	 * USpatialNetDriver::MarkHandoverDirty are compared. 0 compares every handover property each time an actor replicates.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Handover Full Compare Interval"))
+	float HandoverFullCompareInterval;
+
+	/**
+	 * Seconds between checks of every actor channel for net ownership changes which nothing else reports, such as a new owner
+	 * further up an actor's owner chain, or a PlayerController gaining its PlayerState. 0 turns the checks off.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Ownership Sweep Interval"))
+	float OwnershipSweepInterval;
+
+	/** Number of entity IDs reserved by a server worker when it connects, so new actors can be created without waiting for a reservation. */
+	UPROPERTY(EditAnywhere, config, Category = "Entity Pool", meta = (ConfigRestartRequired = false, DisplayName = "Initial Entity ID Reservation Count"))
+	uint32 EntityPoolInitialReservationCount;
+
+	/** When fewer than this many reserved entity IDs are left, another batch is requested. */
+	UPROPERTY(EditAnywhere, config, Category = "Entity Pool", meta = (ConfigRestartRequired = false, DisplayName = "Pool Refresh Threshold"))
+	uint32 EntityPoolRefreshThreshold;
+
+	/** Number of entity IDs requested each time the pool drops below the refresh threshold. */
+	UPROPERTY(EditAnywhere, config, Category = "Entity Pool", meta = (ConfigRestartRequired = false, ClampMin = "1", DisplayName = "Refresh Count"))
+	uint32 EntityPoolRefreshCount;
+
+	/** Maximum number of actors a server replicates each tick, highest priority first. The rest are replicated on later ticks. 0 means no limit, in which case actors are not sorted by priority. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, DisplayName = "Max Actor Replications Per Tick"))
+	uint32 MaxActorReplicationsPerTick;
+
+	/** Size in cm of the cells of the grid used to find the replicated actors near a player. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = true, ClampMin = "100.0", DisplayName = "Actor Grid Cell Size"))
+	float ActorGridCellSize;
+
+	/** When Max Actor Replications Per Tick is set, actors within this distance in cm of a player's view target on this worker are given higher priority. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Player Priority Distance"))
+	float PlayerPriorityDistance;
+
+	/**
+	 * Multiplier applied to the replication priority of actors within Player Priority Distance of a player.
+	 * 1 turns this off. While this and Max Actor Replications Per Tick are set, only as many actors away from players as fit in the limit are
+	 * prioritized each tick, taking turns. The grid used to find these actors is only maintained while both are set.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "1.0", DisplayName = "Near Player Priority Multiplier"))
+	float NearPlayerPriorityMultiplier;
+
+	/**
+	 * Maximum number of property updates, and separately of RPCs, that can wait on unresolved object references in each direction.
+	 * When exceeded, the ones which have waited longest are dropped. 0 means no limit.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, DisplayName = "Max Unresolved Operations"))
+	uint32 MaxUnresolvedOperations;
+
+	/** Seconds after which property updates and RPCs still waiting on unresolved object references are dropped. 0 means they wait until their actor is destroyed. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Unresolved Reference Timeout"))
+	float UnresolvedReferenceTimeout;
+
+	/** Maximum number of failed reliable RPCs waiting to be retried at once. Any that fail beyond this are dropped. 0 means no limit. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, DisplayName = "Max Reliable RPC Retries"))
+	uint32 MaxReliableRPCRetries;
+
+	/** Seconds after a reliable RPC is first sent after which it is no longer retried. 0 means it is retried until it runs out of attempts. */
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ConfigRestartRequired = false, ClampMin = "0.0", DisplayName = "Reliable RPC Timeout"))
+	float ReliableRPCTimeout;
+
+	/** Maximum number of log messages waiting to be sent to SpatialOS, rounded up to a power of two. Space for them is allocated up front. Messages logged while the queue is full are dropped and counted. */
+	UPROPERTY(EditAnywhere, config, Category = "Logging", meta = (ConfigRestartRequired = true, ClampMin = "16", ClampMax = "65536", DisplayName = "Max Queued Log Messages"))
+	uint32 MaxQueuedLogMessages;
+
+	/** Average number of messages per second each log category can send to SpatialOS. The rest are suppressed and counted. 0 means no limit. */
+	UPROPERTY(EditAnywhere, config, Category = "Logging", meta = (ConfigRestartRequired = true, ClampMin = "0.0", DisplayName = "Log Messages Per Second Per Category"))
+	float LogMessagesPerSecondPerCategory;
+
+	/** Number of messages a log category can send to SpatialOS at once before it is held to Log Messages Per Second Per Category. */
+	UPROPERTY(EditAnywhere, config, Category = "Logging", meta = (ConfigRestartRequired = true, ClampMin = "1.0", DisplayName = "Log Message Burst Per Category"))
+	float LogMessageBurstPerCategory;
+
+	/** How far actors have to move or rotate, and how often, before their SpatialOS position and rotation are updated. */
+	UPROPERTY(EditAnywhere, config, Category = "Transform Replication", meta = (ConfigRestartRequired = false, DisplayName = "Default Transform Replication"))
+	FSpatialTransformReplicationSettings DefaultTransformReplication;
+
+	/** Overrides Default Transform Replication for the given actor classes and their subclasses. */
+	UPROPERTY(EditAnywhere, config, Category = "Transform Replication", meta = (ConfigRestartRequired = false, DisplayName = "Transform Replication Overrides"))
+	TMap<TSoftClassPtr<AActor>, FSpatialTransformReplicationSettings> TransformReplicationOverrides;
+
+	// Returns the override for the closest class in the hierarchy of Class, or the defaults if there isn't one.
+	const FSpatialTransformReplicationSettings& GetTransformReplicationSettings(UClass* Class) const;
+};
@@ -33,6 +33,9 @@ public:
 
 	static Worker_ComponentData CreateEmptyComponentData(Worker_ComponentId ComponentId);
 
+	// Writes the property Handler describes, at Data, as field FieldId of Object. Objects which can't be referenced yet are added to UnresolvedObjects.
+	void AddProperty(Schema_Object* Object, Schema_FieldId FieldId, const FSchemaPropertyHandler& Handler, const uint8* Data, TSet<const UObject*>& UnresolvedObjects, TArray<Schema_FieldId>* ClearedIds);
+
 private:
 	Worker_ComponentData CreateComponentData(Worker_ComponentId ComponentId, UObject* Object, const FRepChangeState& Changes, EReplicatedPropertyGroup PropertyGroup);
 	Worker_ComponentUpdate CreateComponentUpdate(Worker_ComponentId ComponentId, UObject* Object, const FRepChangeState& Changes, EReplicatedPropertyGroup PropertyGroup, bool& bWroteSomething);
@@ -44,7 +47,7 @@ private:
 
 	bool FillHandoverSchemaObject(Schema_Object* ComponentObject, UObject* Object, const FHandoverChangeState& Changes, bool bIsInitialData, TArray<Schema_FieldId>* ClearedIds = nullptr);
 
-	void AddProperty(Schema_Object* Object, Schema_FieldId FieldId, UProperty* Property, const uint8* Data, TSet<const UObject*>& UnresolvedObjects, TArray<Schema_FieldId>* ClearedIds);
+	void AddPropertyValue(Schema_Object* Object, Schema_FieldId FieldId, ESchemaPropertyKind Kind, UProperty* Property, const TArray<FSchemaPropertyHandler>* StructFields, const uint8* Data, TSet<const UObject*>& UnresolvedObjects);
 
 	void AssignUnrealObjectRefToContext(UProperty* Property, const uint8* Data, FUnrealObjectRef ObjectRef);
 
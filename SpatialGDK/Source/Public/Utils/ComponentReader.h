@@ -3,6 +3,7 @@
 #pragma once
 
 #include "EngineClasses/SpatialNetBitReader.h"
+#include "Interop/Connection/SpatialOpList.h"
 #include "Interop/SpatialReceiver.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSpatialComponentReader, All, All);
@@ -15,17 +16,26 @@ class ComponentReader
 public:
 	ComponentReader(class USpatialNetDriver* InNetDriver, FObjectReferencesMap& InObjectReferencesMap, TSet<FUnrealObjectRef>& InUnresolvedRefs);
 
-	void ApplyComponentData(const Worker_ComponentData& ComponentData, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover);
-	void ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover);
+	// DecodedFields, if given, are the fields of the data or update read out ahead of dispatch by CreateGeneratedComponentFields.
+	void ApplyComponentData(const Worker_ComponentData& ComponentData, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover, const GeneratedComponentFields* DecodedFields = nullptr);
+	void ApplyComponentUpdate(const Worker_ComponentUpdate& ComponentUpdate, UObject* Object, USpatialActorChannel* Channel, bool bIsHandover, const GeneratedComponentFields* DecodedFields = nullptr);
+
+	// Reads a single field written by ComponentFactory::AddProperty into the property Handler describes, at Data.
+	// Offset and ParentIndex are those of the property within the object, for tracking unresolved object references.
+	void ApplyField(Schema_Object* Object, Schema_FieldId FieldId, const FSchemaPropertyHandler& Handler, uint8* Data, int32 Offset, int32 ParentIndex);
 
 private:
-	void ApplySchemaObject(Schema_Object* ComponentObject, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, TArray<Schema_FieldId>* ClearedIds = nullptr);
-	void ApplyHandoverSchemaObject(Schema_Object* ComponentObject, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, TArray<Schema_FieldId>* ClearedIds = nullptr);
+	void ApplySchemaObject(Schema_Object* ComponentObject, const TArray<Schema_FieldId>& UpdateFields, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, const TSet<Schema_FieldId>* ClearedIds = nullptr);
+	void ApplyHandoverSchemaObject(Schema_Object* ComponentObject, const TArray<Schema_FieldId>& UpdateFields, UObject* Object, USpatialActorChannel* Channel, bool bIsInitialData, const TSet<Schema_FieldId>* ClearedIds = nullptr);
+
+	void ApplyProperty(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, uint32 Index, ESchemaPropertyKind Kind, UProperty* Property, const TArray<FSchemaPropertyHandler>* StructFields, uint8* Data, int32 Offset, int32 ParentIndex);
+	void ApplyArray(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, const FSchemaPropertyHandler& Handler, uint8* Data, int32 Offset, int32 ParentIndex);
 
-	void ApplyProperty(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, uint32 Index, UProperty* Property, uint8* Data, int32 Offset, int32 ParentIndex);
-	void ApplyArray(Schema_Object* Object, Schema_FieldId FieldId, FObjectReferencesMap& InObjectReferencesMap, UArrayProperty* Property, uint8* Data, int32 Offset, int32 ParentIndex);
+	uint32 GetPropertyCount(const Schema_Object* Object, Schema_FieldId Id, const FSchemaPropertyHandler& Handler);
 
-	uint32 GetPropertyCount(const Schema_Object* Object, Schema_FieldId Id, UProperty* Property);
+	// The values read out ahead of dispatch for a top level field of the component being applied, if there are any.
+	const FString* FindDecodedString(const Schema_Object* Object, Schema_FieldId FieldId, uint32 Index) const;
+	const FUnrealObjectRef* FindDecodedObjectRef(const Schema_Object* Object, Schema_FieldId FieldId, uint32 Index) const;
 
 private:
 	class USpatialPackageMapClient* PackageMap;
@@ -33,6 +43,10 @@ private:
 	class USpatialTypebindingManager* TypebindingManager;
 	FObjectReferencesMap& RootObjectReferencesMap;
 	TSet<FUnrealObjectRef>& UnresolvedRefs;
+
+	// The decoded fields of the component being applied, and the schema object they were read from.
+	const GeneratedComponentFields* DecodedFields;
+	const Schema_Object* DecodedObject;
 };
 
 }
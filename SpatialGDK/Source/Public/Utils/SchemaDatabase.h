@@ -39,4 +39,9 @@ class SPATIALGDK_API USchemaDatabase : public UDataAsset
 public:
 	UPROPERTY(EditAnywhere)
 	TMap<UClass*, FSchemaData> ClassToSchema;
+
+	// The first component id allocated to each class, by class path. Classes which no longer generate schema keep their
+	// allocation, so their ids aren't given to another class while snapshots or workers may still refer to them.
+	UPROPERTY()
+	TMap<FString, int32> ComponentIdAllocations;
 };
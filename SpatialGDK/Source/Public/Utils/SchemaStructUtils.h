@@ -0,0 +1,16 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UProperty;
+class UScriptStruct;
+
+// Whether a struct is generated as its own schema type and written field by field, rather than serialized to bytes.
+// Shared with the schema generator, so that both agree on how every struct is stored.
+SPATIALGDK_API bool IsSchemaStruct(UScriptStruct* Struct);
+
+// The properties of a struct which are written to its schema type, in field id order. These are the same properties,
+// in the same order, as the struct's rep layout.
+SPATIALGDK_API TArray<UProperty*> GetSchemaStructProperties(UScriptStruct* Struct);
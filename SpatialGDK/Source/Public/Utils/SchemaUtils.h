@@ -36,23 +36,30 @@ inline FString GetStringFromSchema(const Schema_Object* Object, Schema_FieldId I
 	return IndexStringFromSchema(Object, Id, 0);
 }
 
+// Payloads are written as an UnrealPayload, which carries the number of bits written alongside the bytes holding them.
 inline void AddPayloadToSchema(Schema_Object* Object, Schema_FieldId Id, FSpatialNetBitWriter& Writer)
 {
+	Schema_Object* PayloadObject = Schema_AddObject(Object, Id);
+
+	// Schema_AddBytes doesn't copy, and the writer owns its buffer, so the payload has to be copied into memory owned by the schema object.
 	uint32 PayloadSize = Writer.GetNumBytes();
-	uint8* PayloadBuffer = Schema_AllocateBuffer(Object, sizeof(char) * PayloadSize);
+	uint8* PayloadBuffer = Schema_AllocateBuffer(PayloadObject, sizeof(char) * PayloadSize);
 	FMemory::Memcpy(PayloadBuffer, Writer.GetData(), sizeof(char) * PayloadSize);
-	Schema_AddBytes(Object, Id, PayloadBuffer, sizeof(char) * PayloadSize);
+	Schema_AddBytes(PayloadObject, 1, PayloadBuffer, sizeof(char) * PayloadSize);
+	Schema_AddUint32(PayloadObject, 2, (uint32)Writer.GetNumBits());
 }
 
-inline TArray<uint8> IndexPayloadFromSchema(const Schema_Object* Object, Schema_FieldId Id, uint32 Index)
+// Returns the payload in place, so it is only valid for as long as the schema object is.
+inline const uint8* IndexPayloadFromSchema(Schema_Object* Object, Schema_FieldId Id, uint32 Index, int64& OutCountBits)
 {
-	int32 PayloadSize = (int32)Schema_IndexBytesLength(Object, Id, Index);
-	return TArray<uint8>((const uint8*)Schema_IndexBytes(Object, Id, Index), PayloadSize);
+	Schema_Object* PayloadObject = Schema_IndexObject(Object, Id, Index);
+	OutCountBits = Schema_GetUint32(PayloadObject, 2);
+	return Schema_GetBytes(PayloadObject, 1);
 }
 
-inline TArray<uint8> GetPayloadFromSchema(const Schema_Object* Object, Schema_FieldId Id)
+inline const uint8* GetPayloadFromSchema(Schema_Object* Object, Schema_FieldId Id, int64& OutCountBits)
 {
-	return IndexPayloadFromSchema(Object, Id, 0);
+	return IndexPayloadFromSchema(Object, Id, 0, OutCountBits);
 }
 
 inline void AddWorkerRequirementSetToSchema(Schema_Object* Object, Schema_FieldId Id, const WorkerRequirementSet& Value)
@@ -0,0 +1,28 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// A uniform 2D grid of the actors this worker replicates, bucketed by the position last sent to SpatialOS.
+// Only pointers are stored and compared, so actors must be removed when they are destroyed.
+class SPATIALGDK_API FSpatialActorGrid
+{
+public:
+	explicit FSpatialActorGrid(float InCellSize);
+
+	void AddOrUpdateActor(AActor* Actor, const FVector& Location);
+	void RemoveActor(AActor* Actor);
+
+	// Adds every actor in a cell that overlaps the square around Location with the given half extent.
+	void GatherActorsNear(const FVector& Location, float HalfExtent, TSet<AActor*>& OutActors) const;
+
+	int32 Num() const { return ActorCells.Num(); }
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+
+	float CellSize;
+	TMap<FIntPoint, TArray<AActor*>> Cells;
+	TMap<AActor*, FIntPoint> ActorCells;
+};
@@ -0,0 +1,360 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+// Identifies an entry in a TUnresolvedRefTable. When an entry is removed its slot's generation is bumped,
+// so a handle that outlives its entry no longer finds anything rather than finding whatever reused the slot.
+struct FUnresolvedRefHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool operator==(const FUnresolvedRefHandle& Other) const
+	{
+		return Index == Other.Index && Generation == Other.Generation;
+	}
+
+	friend uint32 GetTypeHash(const FUnresolvedRefHandle& Handle)
+	{
+		return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Generation));
+	}
+};
+
+// Operations which are waiting for object references to be resolved. Each entry waits on any number of keys,
+// and is linked into an intrusive list per key, so resolving a key only visits the entries waiting on it, oldest first.
+// Entries also belong to an owner (normally the actor they apply to), so everything an actor was waiting on can be dropped
+// when it is destroyed, and are kept in the order they were added so the table can be capped and timed out cheaply.
+// Entries and links live in flat arrays with free lists, so a steady stream of unresolved references doesn't allocate.
+template <typename KeyType, typename ValueType>
+class TUnresolvedRefTable
+{
+public:
+	FUnresolvedRefHandle Add(const UObject* Owner, ValueType&& Value, double Time)
+	{
+		int32 Index;
+		if (FreeEntries.Num() > 0)
+		{
+			Index = FreeEntries.Pop(false);
+		}
+		else
+		{
+			Index = Entries.AddDefaulted();
+		}
+
+		FEntry& Entry = Entries[Index];
+		Entry.Value.Emplace(MoveTemp(Value));
+		Entry.Owner = Owner;
+		Entry.Time = Time;
+
+		// Entries are added with increasing times, so appending keeps the age list sorted.
+		Entry.AgePrev = AgeList.Tail;
+		Entry.AgeNext = INDEX_NONE;
+		if (AgeList.Tail != INDEX_NONE)
+		{
+			Entries[AgeList.Tail].AgeNext = Index;
+		}
+		else
+		{
+			AgeList.Head = Index;
+		}
+		AgeList.Tail = Index;
+
+		FList& OwnerList = OwnerLists.FindOrAdd(Owner);
+		Entry.OwnerPrev = OwnerList.Tail;
+		Entry.OwnerNext = INDEX_NONE;
+		if (OwnerList.Tail != INDEX_NONE)
+		{
+			Entries[OwnerList.Tail].OwnerNext = Index;
+		}
+		else
+		{
+			OwnerList.Head = Index;
+		}
+		OwnerList.Tail = Index;
+
+		NumEntries++;
+
+		return FUnresolvedRefHandle{ Index, Entry.Generation };
+	}
+
+	// Makes the entry wait on Key, if it isn't already.
+	void AddKey(FUnresolvedRefHandle Handle, const KeyType& Key)
+	{
+		if (!IsValid(Handle))
+		{
+			return;
+		}
+
+		FEntry& Entry = Entries[Handle.Index];
+		for (int32 LinkIndex : Entry.Links)
+		{
+			if (Links[LinkIndex].Key == Key)
+			{
+				return;
+			}
+		}
+
+		int32 LinkIndex;
+		if (FreeLinks.Num() > 0)
+		{
+			LinkIndex = FreeLinks.Pop(false);
+			Links[LinkIndex].Key = Key;
+		}
+		else
+		{
+			LinkIndex = Links.Emplace(Key);
+		}
+
+		FList& KeyList = KeyLists.FindOrAdd(Key);
+		FLink& Link = Links[LinkIndex];
+		Link.Entry = Handle.Index;
+		Link.Prev = KeyList.Tail;
+		Link.Next = INDEX_NONE;
+		if (KeyList.Tail != INDEX_NONE)
+		{
+			Links[KeyList.Tail].Next = LinkIndex;
+		}
+		else
+		{
+			KeyList.Head = LinkIndex;
+		}
+		KeyList.Tail = LinkIndex;
+
+		Entry.Links.Add(LinkIndex);
+	}
+
+	// Returns the entries that were waiting on Key, oldest first, and stops them waiting on it.
+	// The entries themselves stay in the table until they are removed.
+	void ResolveKey(const KeyType& Key, TArray<FUnresolvedRefHandle>& OutHandles)
+	{
+		FList KeyList;
+		if (!KeyLists.RemoveAndCopyValue(Key, KeyList))
+		{
+			return;
+		}
+
+		int32 LinkIndex = KeyList.Head;
+		while (LinkIndex != INDEX_NONE)
+		{
+			const int32 NextLinkIndex = Links[LinkIndex].Next;
+			FEntry& Entry = Entries[Links[LinkIndex].Entry];
+
+			OutHandles.Add(FUnresolvedRefHandle{ Links[LinkIndex].Entry, Entry.Generation });
+			Entry.Links.RemoveSingleSwap(LinkIndex, false);
+			FreeLinks.Add(LinkIndex);
+
+			LinkIndex = NextLinkIndex;
+		}
+	}
+
+	bool IsValid(FUnresolvedRefHandle Handle) const
+	{
+		return Entries.IsValidIndex(Handle.Index) && Entries[Handle.Index].Generation == Handle.Generation && Entries[Handle.Index].Value.IsSet();
+	}
+
+	ValueType* Find(FUnresolvedRefHandle Handle)
+	{
+		return IsValid(Handle) ? &Entries[Handle.Index].Value.GetValue() : nullptr;
+	}
+
+	// Number of keys the entry is still waiting on.
+	int32 NumKeys(FUnresolvedRefHandle Handle) const
+	{
+		return IsValid(Handle) ? Entries[Handle.Index].Links.Num() : 0;
+	}
+
+	void Remove(FUnresolvedRefHandle Handle)
+	{
+		if (IsValid(Handle))
+		{
+			RemoveAt(Handle.Index);
+		}
+	}
+
+	// Called with each entry removed by RemoveOwner or RemoveExpired, just before it is removed, so callers can forget its
+	// handle without searching for it. Must not modify the table.
+	using FOnRemoved = TFunctionRef<void(FUnresolvedRefHandle Handle, ValueType& Value)>;
+
+	// Removes every entry belonging to Owner. Returns the number of entries removed.
+	int32 RemoveOwner(const UObject* Owner, FOnRemoved OnRemoved)
+	{
+		FList OwnerList;
+		if (!OwnerLists.RemoveAndCopyValue(Owner, OwnerList))
+		{
+			return 0;
+		}
+
+		int32 NumRemoved = 0;
+		int32 Index = OwnerList.Head;
+		while (Index != INDEX_NONE)
+		{
+			const int32 NextIndex = Entries[Index].OwnerNext;
+			// The owner list is already gone, so unlinking from it would only find a stale list.
+			Entries[Index].OwnerPrev = INDEX_NONE;
+			Entries[Index].OwnerNext = INDEX_NONE;
+			OnRemoved(FUnresolvedRefHandle{ Index, Entries[Index].Generation }, Entries[Index].Value.GetValue());
+			RemoveAt(Index, /* bUnlinkOwner */ false);
+			NumRemoved++;
+			Index = NextIndex;
+		}
+
+		return NumRemoved;
+	}
+
+	// Removes entries older than Timeout seconds, then the oldest entries until there are at most MaxEntries left.
+	// A Timeout or MaxEntries of 0 disables that limit. Each removal takes the head of the age list, so costs the same
+	// however many entries there are. Returns the number of entries removed.
+	int32 RemoveExpired(double Now, double Timeout, int32 MaxEntries, FOnRemoved OnRemoved)
+	{
+		int32 NumRemoved = 0;
+		while (AgeList.Head != INDEX_NONE)
+		{
+			const bool bTimedOut = Timeout > 0.0 && Now - Entries[AgeList.Head].Time > Timeout;
+			const bool bOverCapacity = MaxEntries > 0 && NumEntries > MaxEntries;
+			if (!bTimedOut && !bOverCapacity)
+			{
+				break;
+			}
+
+			const int32 Index = AgeList.Head;
+			OnRemoved(FUnresolvedRefHandle{ Index, Entries[Index].Generation }, Entries[Index].Value.GetValue());
+			RemoveAt(Index);
+			NumRemoved++;
+		}
+
+		return NumRemoved;
+	}
+
+	int32 Num() const { return NumEntries; }
+
+private:
+	struct FList
+	{
+		int32 Head = INDEX_NONE;
+		int32 Tail = INDEX_NONE;
+	};
+
+	struct FLink
+	{
+		explicit FLink(const KeyType& InKey) : Key(InKey) {}
+
+		KeyType Key;
+		int32 Entry = INDEX_NONE;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	struct FEntry
+	{
+		TOptional<ValueType> Value;
+		uint32 Generation = 0;
+		const UObject* Owner = nullptr;
+		double Time = 0.0;
+
+		int32 AgePrev = INDEX_NONE;
+		int32 AgeNext = INDEX_NONE;
+		int32 OwnerPrev = INDEX_NONE;
+		int32 OwnerNext = INDEX_NONE;
+
+		// Indices into Links of the keys this entry is waiting on.
+		TArray<int32, TInlineAllocator<2>> Links;
+	};
+
+	void RemoveAt(int32 Index, bool bUnlinkOwner = true)
+	{
+		FEntry& Entry = Entries[Index];
+
+		for (int32 LinkIndex : Entry.Links)
+		{
+			FLink& Link = Links[LinkIndex];
+			FList& KeyList = KeyLists.FindChecked(Link.Key);
+			if (Link.Prev != INDEX_NONE)
+			{
+				Links[Link.Prev].Next = Link.Next;
+			}
+			else
+			{
+				KeyList.Head = Link.Next;
+			}
+			if (Link.Next != INDEX_NONE)
+			{
+				Links[Link.Next].Prev = Link.Prev;
+			}
+			else
+			{
+				KeyList.Tail = Link.Prev;
+			}
+
+			if (KeyList.Head == INDEX_NONE)
+			{
+				KeyLists.Remove(Link.Key);
+			}
+			FreeLinks.Add(LinkIndex);
+		}
+		Entry.Links.Reset();
+
+		if (bUnlinkOwner)
+		{
+			FList& OwnerList = OwnerLists.FindChecked(Entry.Owner);
+			if (Entry.OwnerPrev != INDEX_NONE)
+			{
+				Entries[Entry.OwnerPrev].OwnerNext = Entry.OwnerNext;
+			}
+			else
+			{
+				OwnerList.Head = Entry.OwnerNext;
+			}
+			if (Entry.OwnerNext != INDEX_NONE)
+			{
+				Entries[Entry.OwnerNext].OwnerPrev = Entry.OwnerPrev;
+			}
+			else
+			{
+				OwnerList.Tail = Entry.OwnerPrev;
+			}
+
+			if (OwnerList.Head == INDEX_NONE)
+			{
+				OwnerLists.Remove(Entry.Owner);
+			}
+		}
+
+		if (Entry.AgePrev != INDEX_NONE)
+		{
+			Entries[Entry.AgePrev].AgeNext = Entry.AgeNext;
+		}
+		else
+		{
+			AgeList.Head = Entry.AgeNext;
+		}
+		if (Entry.AgeNext != INDEX_NONE)
+		{
+			Entries[Entry.AgeNext].AgePrev = Entry.AgePrev;
+		}
+		else
+		{
+			AgeList.Tail = Entry.AgePrev;
+		}
+
+		Entry.Value.Reset();
+		Entry.Owner = nullptr;
+		Entry.Generation++;
+
+		FreeEntries.Add(Index);
+		NumEntries--;
+	}
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TArray<FLink> Links;
+	TArray<int32> FreeLinks;
+
+	TMap<KeyType, FList> KeyLists;
+	TMap<const UObject*, FList> OwnerLists;
+	FList AgeList;
+
+	int32 NumEntries = 0;
+};
@@ -7,6 +7,7 @@
 #include "Utils/CodeWriter.h"
 #include "Utils/ComponentIdGenerator.h"
 #include "Utils/DataTypeUtilities.h"
+#include "Utils/SchemaStructUtils.h"
 
 // Given a RepLayout cmd type (a data type supported by the replication system). Generates the corresponding
 // type used in schema.
@@ -29,15 +30,15 @@ FString PropertyToSchemaType(UProperty* Property, bool bIsRPCProperty)
 	{
 		UStructProperty* StructProp = Cast<UStructProperty>(Property);
 		UScriptStruct* Struct = StructProp->Struct;
-		if (Struct->StructFlags & STRUCT_NetSerializeNative)
+		if (IsSchemaStruct(Struct))
 		{
-			// Specifically when NetSerialize is implemented for a struct we want to use 'bytes'.
-			// This includes RepMovement and UniqueNetId.
-			DataType = TEXT("bytes");
+			DataType = SchemaStructTypeName(Struct);
 		}
 		else
 		{
-			DataType = TEXT("bytes");
+			// Structs with NetSerialize, or which can't be written field by field, are written by a bit writer into an UnrealPayload.
+			// This includes RepMovement and UniqueNetId.
+			DataType = TEXT("UnrealPayload");
 		}
 	}
 	else if (Property->IsA(UBoolProperty::StaticClass()))
@@ -109,7 +110,7 @@ FString PropertyToSchemaType(UProperty* Property, bool bIsRPCProperty)
 	return DataType;
 }
 
-void WriteSchemaRepField(FCodeWriter& Writer, const TSharedPtr<FUnrealProperty> RepProp, const FString& PropertyPath, const int FieldCounter)
+void WriteSchemaRepField(FCodeWriter& Writer, const FUnrealProperty* RepProp, const FString& PropertyPath, const int FieldCounter)
 {
 	Writer.Printf("{0} {1} = {2}; // {3} // {4}",
 		*PropertyToSchemaType(RepProp->Property, false),
@@ -120,16 +121,29 @@ void WriteSchemaRepField(FCodeWriter& Writer, const TSharedPtr<FUnrealProperty>
 	);
 }
 
-void WriteSchemaHandoverField(FCodeWriter& Writer, const TSharedPtr<FUnrealProperty> HandoverProp, const int FieldCounter)
+// Handover structs which are schema types are written as a field for each of their fields, recursively, so a change to
+// one field only sends that field. Must match the handover handles USpatialTypebindingManager gives them.
+void WriteSchemaHandoverFields(FCodeWriter& Writer, UProperty* Property, const FString& FieldName, int& FieldCounter)
 {
+	UStructProperty* StructProperty = Cast<UStructProperty>(Property);
+	if (StructProperty != nullptr && IsSchemaStruct(StructProperty->Struct))
+	{
+		for (UProperty* FieldProperty : GetSchemaStructProperties(StructProperty->Struct))
+		{
+			WriteSchemaHandoverFields(Writer, FieldProperty, FieldName + TEXT("_") + UnrealNameToSchemaTypeName(FieldProperty->GetName().ToLower()), FieldCounter);
+		}
+		return;
+	}
+
+	FieldCounter++;
 	Writer.Printf("{0} {1} = {2};",
-		*PropertyToSchemaType(HandoverProp->Property, false),
-		*SchemaFieldName(HandoverProp),
+		*PropertyToSchemaType(Property, false),
+		*FieldName,
 		FieldCounter
 	);
 }
 
-void WriteSchemaRPCField(TSharedPtr<FCodeWriter> Writer, const TSharedPtr<FUnrealProperty> RPCProp, const int FieldCounter)
+void WriteSchemaRPCField(TSharedPtr<FCodeWriter> Writer, const FUnrealProperty* RPCProp, const int FieldCounter)
 {
 	Writer->Printf("{0} {1} = {2};",
 		*PropertyToSchemaType(RPCProp->Property, true),
@@ -138,11 +152,86 @@ void WriteSchemaRPCField(TSharedPtr<FCodeWriter> Writer, const TSharedPtr<FUnrea
 	);
 }
 
+// Adds the structs generated as schema types which a property uses, including those nested inside them, each after the
+// structs it contains.
+void CollectSchemaStructs(UProperty* Property, TArray<UScriptStruct*>& OutStructs)
+{
+	if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		Property = ArrayProperty->Inner;
+	}
+
+	UStructProperty* StructProperty = Cast<UStructProperty>(Property);
+	if (StructProperty == nullptr || !IsSchemaStruct(StructProperty->Struct) || OutStructs.Contains(StructProperty->Struct))
+	{
+		return;
+	}
+
+	for (UProperty* FieldProperty : GetSchemaStructProperties(StructProperty->Struct))
+	{
+		CollectSchemaStructs(FieldProperty, OutStructs);
+	}
+
+	OutStructs.Add(StructProperty->Struct);
+}
+
+void WriteSchemaStructType(FCodeWriter& Writer, UScriptStruct* Struct)
+{
+	Writer.Printf("type {0} {", *SchemaStructTypeName(Struct));
+	Writer.Indent();
+
+	TArray<UProperty*> FieldProperties = GetSchemaStructProperties(Struct);
+	for (int32 i = 0; i < FieldProperties.Num(); i++)
+	{
+		Writer.Printf("{0} {1} = {2};",
+			*PropertyToSchemaType(FieldProperties[i], false),
+			*SchemaStructFieldName(FieldProperties[i]),
+			i + 1
+		);
+	}
+
+	Writer.Outdent().Print("}");
+}
+
+// True if the schema type of a property is declared in core_types.schema, or is a list of such a type.
+bool PropertyUsesCoreTypes(UProperty* Property)
+{
+	if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		Property = ArrayProperty->Inner;
+	}
+
+	if (Property->IsA<UObjectPropertyBase>())
+	{
+		return true;
+	}
+
+	UStructProperty* StructProperty = Cast<UStructProperty>(Property);
+	return StructProperty != nullptr && !IsSchemaStruct(StructProperty->Struct);
+}
+
+bool SchemaStructsUseCoreTypes(const TArray<UScriptStruct*>& Structs)
+{
+	for (UScriptStruct* Struct : Structs)
+	{
+		for (UProperty* FieldProperty : GetSchemaStructProperties(Struct))
+		{
+			if (PropertyUsesCoreTypes(FieldProperty))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 // core_types.schema should only be included if any components in the file have
 // 1. An UnrealObjectRef
-// 2. A list of UnrealObjectRefs
-// 3. An RPC
-bool ShouldIncludeCoreTypes(TSharedPtr<FUnrealType>& TypeInfo)
+// 2. An UnrealPayload
+// 3. A list of either
+// 4. An RPC
+bool ShouldIncludeCoreTypes(FUnrealType* TypeInfo)
 {
 	FUnrealFlatRepData RepData = GetFlatRepData(TypeInfo);
 
@@ -150,19 +239,18 @@ bool ShouldIncludeCoreTypes(TSharedPtr<FUnrealType>& TypeInfo)
 	{
 		for (auto& PropertyPair : PropertyGroup.Value)
 		{
-			UProperty* Property = PropertyPair.Value->Property;
-			if(Property->IsA<UObjectPropertyBase>())
+			if (PropertyUsesCoreTypes(PropertyPair.Value->Property))
 			{
 				return true;
 			}
+		}
+	}
 
-			if (Property->IsA<UArrayProperty>())
-			{
-				if (Cast<UArrayProperty>(Property)->Inner->IsA<UObjectPropertyBase>())
-				{
-					return true;
-				}
-			}
+	for (auto& PropertyPair : GetFlatHandoverData(TypeInfo))
+	{
+		if (PropertyUsesCoreTypes(PropertyPair.Value->Property))
+		{
+			return true;
 		}
 	}
 
@@ -174,7 +262,7 @@ bool ShouldIncludeCoreTypes(TSharedPtr<FUnrealType>& TypeInfo)
 	return false;
 }
 
-int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Class, TSharedPtr<FUnrealType> TypeInfo, FString SchemaPath)
+int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Class, FUnrealType* TypeInfo, FString SchemaPath)
 {
 	FComponentIdGenerator IdGenerator(ComponentId);
 
@@ -184,7 +272,24 @@ int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Clas
 		package improbable.unreal.generated.{0};)""",
 		*UnrealNameToSchemaTypeName(Class->GetName().ToLower()));
 
-	if (ShouldIncludeCoreTypes(TypeInfo))
+	FUnrealFlatRepData RepData = GetFlatRepData(TypeInfo);
+	FCmdHandlePropertyMap HandoverData = GetFlatHandoverData(TypeInfo);
+
+	// Replicated structs without NetSerialize are generated as types in each file which uses them.
+	TArray<UScriptStruct*> SchemaStructs;
+	for (EReplicatedPropertyGroup Group : GetAllReplicatedPropertyGroups())
+	{
+		for (auto& RepProp : RepData[Group])
+		{
+			CollectSchemaStructs(RepProp.Value->Property, SchemaStructs);
+		}
+	}
+	for (auto& Prop : HandoverData)
+	{
+		CollectSchemaStructs(Prop.Value->Property, SchemaStructs);
+	}
+
+	if (ShouldIncludeCoreTypes(TypeInfo) || SchemaStructsUseCoreTypes(SchemaStructs))
 	{
 		Writer.PrintNewLine();
 		Writer.Printf("import \"improbable/unreal/gdk/core_types.schema\";");
@@ -192,7 +297,10 @@ int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Clas
 
 	Writer.PrintNewLine();
 
-	FUnrealFlatRepData RepData = GetFlatRepData(TypeInfo);
+	for (UScriptStruct* Struct : SchemaStructs)
+	{
+		WriteSchemaStructType(Writer, Struct);
+	}
 
 	// Client-server replicated properties.
 	for (EReplicatedPropertyGroup Group : GetAllReplicatedPropertyGroups())
@@ -208,18 +316,14 @@ int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Clas
 			// This loop will add the owner class of each field in the component. Meant for short-term debugging only.
 			// TODO UNR-166: Delete this when InteropCodegen is in a more complete state.
 			FString PropertyPath;
-			TSharedPtr<FUnrealProperty> UnrealProperty = RepProp.Value;
+			FUnrealProperty* UnrealProperty = RepProp.Value;
 			while (UnrealProperty->ContainerType != nullptr)
 			{
-				TSharedPtr<FUnrealType> ContainerType = UnrealProperty->ContainerType.Pin();
-				check(ContainerType.IsValid());
+				FUnrealType* ContainerType = UnrealProperty->ContainerType;
 				if (ContainerType->ParentProperty != nullptr)
 				{
-					TSharedPtr<FUnrealProperty> ParentProperty = ContainerType->ParentProperty.Pin();
-					if (ParentProperty.IsValid())
-					{
-						PropertyPath += FString::Printf(TEXT("%s::%s"), *ContainerType->Type->GetName(), *ParentProperty->Property->GetName());
-					}
+					FUnrealProperty* ParentProperty = ContainerType->ParentProperty;
+					PropertyPath += FString::Printf(TEXT("%s::%s"), *ContainerType->Type->GetName(), *ParentProperty->Property->GetName());
 					UnrealProperty = ParentProperty;
 				}
 				else
@@ -247,12 +351,9 @@ int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Clas
 	Writer.Indent();
 	Writer.Printf("id = {0};", IdGenerator.GetNextAvailableId());
 	int FieldCounter = 0;
-	for (auto& Prop : GetFlatHandoverData(TypeInfo))
+	for (auto& Prop : HandoverData)
 	{
-		FieldCounter++;
-		WriteSchemaHandoverField(Writer,
-			Prop.Value,
-			FieldCounter);
+		WriteSchemaHandoverFields(Writer, Prop.Value->Property, SchemaFieldName(Prop.Value), FieldCounter);
 	}
 	Writer.Outdent().Print("}");
 
@@ -298,5 +399,12 @@ int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Clas
 		UE_LOG(LogTemp, Warning, TEXT("Unreal GDK currently does not support Reliable Multicast RPCs. These RPC will be treated as unreliable:\n%s"), *AllReliableMulticasts);
 	}
 
+	check(IdGenerator.GetNumUsedIds() == GetNumTypeBindingComponents());
 	return IdGenerator.GetNumUsedIds();
 }
+
+int GetNumTypeBindingComponents()
+{
+	// One component per replicated property group, one for handover data, and one per RPC type.
+	return GetAllReplicatedPropertyGroups().Num() + 1 + GetRPCTypes().Num();
+}
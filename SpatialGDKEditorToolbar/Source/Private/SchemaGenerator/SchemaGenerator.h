@@ -7,4 +7,7 @@
 class FCodeWriter;
 
 // Generates a schema file, given an output code writer, component ID, Unreal type and type info.
-int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Class, TSharedPtr<FUnrealType> TypeInfo, FString SchemaPath);
+int GenerateTypeBindingSchema(FCodeWriter& Writer, int ComponentId, UClass* Class, FUnrealType* TypeInfo, FString SchemaPath);
+
+// Returns the number of components GenerateTypeBindingSchema generates for every class, so component ids can be assigned up front.
+int GetNumTypeBindingComponents();
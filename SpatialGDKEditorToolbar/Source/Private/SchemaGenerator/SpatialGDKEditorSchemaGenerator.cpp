@@ -3,12 +3,16 @@
 #include "SpatialGDKEditorSchemaGenerator.h"
 
 #include "AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
 #include "Engine/LevelScriptActor.h"
 #include "GeneralProjectSettings.h"
 #include "GenericPlatform/GenericPlatformFile.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "Misc/FileHelper.h"
 #include "Misc/MonitoredProcess.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
 #include "SchemaGenerator.h"
 #include "SharedPointer.h"
 #include "TypeStructure.h"
@@ -24,23 +28,159 @@ DEFINE_LOG_CATEGORY(LogSpatialGDKSchemaGenerator);
 namespace
 {
 
+const TCHAR* SCHEMA_DATABASE_PACKAGE_PATH = TEXT("/Game/Spatial/SchemaDatabase");
+
+// Component ids derived from class paths are spread over this many blocks, starting well clear of the ids that used to be
+// assigned sequentially from STARTING_GENERATED_COMPONENT_ID, so classes which already have those can keep them.
+const Worker_ComponentId FIRST_ALLOCATED_COMPONENT_ID = 1000000;
+const uint32 NUM_COMPONENT_ID_BLOCKS = 65536;
+
+// Bump this whenever the generated schema changes for an unchanged class, so that cached schema files are regenerated.
+const int32 SCHEMA_CACHE_VERSION = 4;
+
+// What was generated for a class the last time schema was generated.
+struct FSchemaCacheEntry
+{
+	uint32 Checksum;
+	Worker_ComponentId ComponentId;
+	int NumComponents;
+};
+
+FString GetSchemaCachePath()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectIntermediateDir(), TEXT("Improbable/SchemaCache.json")));
+}
+
+FString GetSchemaFilename(UClass* Class)
+{
+	return FString::Printf(TEXT("Unreal%s.schema"), *UnrealNameToSchemaTypeName(Class->GetName()));
+}
+
+// Returns the cached entries by class path, or nothing if the cache is missing or was written for a different output folder.
+TMap<FString, FSchemaCacheEntry> LoadSchemaCache(const FString& SchemaCachePath, const FString& SchemaPath)
+{
+	TMap<FString, FSchemaCacheEntry> Cache;
+
+	FString CacheContents;
+	if (!FFileHelper::LoadFileToString(CacheContents, *SchemaCachePath))
+	{
+		return Cache;
+	}
+
+	TSharedPtr<FJsonObject> RootObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(CacheContents);
+	if (!FJsonSerializer::Deserialize(Reader, RootObject) || !RootObject.IsValid())
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Warning, TEXT("Schema cache %s could not be read. Regenerating schema for all classes."), *SchemaCachePath);
+		return Cache;
+	}
+
+	if (RootObject->GetIntegerField(TEXT("version")) != SCHEMA_CACHE_VERSION || RootObject->GetStringField(TEXT("schemaPath")) != SchemaPath)
+	{
+		return Cache;
+	}
+
+	for (const TSharedPtr<FJsonValue>& ClassValue : RootObject->GetArrayField(TEXT("classes")))
+	{
+		const TSharedPtr<FJsonObject>& ClassObject = ClassValue->AsObject();
+
+		FSchemaCacheEntry Entry;
+		Entry.Checksum = static_cast<uint32>(ClassObject->GetNumberField(TEXT("checksum")));
+		Entry.ComponentId = static_cast<Worker_ComponentId>(ClassObject->GetNumberField(TEXT("componentId")));
+		Entry.NumComponents = ClassObject->GetIntegerField(TEXT("numComponents"));
+		Cache.Add(ClassObject->GetStringField(TEXT("class")), Entry);
+	}
+
+	return Cache;
+}
+
+void SaveSchemaCache(const FString& SchemaCachePath, const FString& SchemaPath, const TMap<FString, FSchemaCacheEntry>& Cache)
+{
+	TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+	RootObject->SetNumberField(TEXT("version"), SCHEMA_CACHE_VERSION);
+	RootObject->SetStringField(TEXT("schemaPath"), SchemaPath);
+
+	TArray<TSharedPtr<FJsonValue>> ClassValues;
+	for (const auto& Pair : Cache)
+	{
+		TSharedRef<FJsonObject> ClassObject = MakeShared<FJsonObject>();
+		ClassObject->SetStringField(TEXT("class"), Pair.Key);
+		ClassObject->SetNumberField(TEXT("checksum"), Pair.Value.Checksum);
+		ClassObject->SetNumberField(TEXT("componentId"), Pair.Value.ComponentId);
+		ClassObject->SetNumberField(TEXT("numComponents"), Pair.Value.NumComponents);
+		ClassValues.Add(MakeShared<FJsonValueObject>(ClassObject));
+	}
+	RootObject->SetArrayField(TEXT("classes"), ClassValues);
+
+	FString CacheContents;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&CacheContents);
+	FJsonSerializer::Serialize(RootObject, Writer);
+
+	if (!FFileHelper::SaveStringToFile(CacheContents, *SchemaCachePath))
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Warning, TEXT("Unable to save schema cache to %s. Schema for all classes will be regenerated next time."), *SchemaCachePath);
+	}
+}
+
+// Returns the first component id allocated to each class path, as saved in the schema database.
+TMap<FString, Worker_ComponentId> LoadComponentIdAllocations()
+{
+	// Assets can only be loaded on the game thread, and schema is normally generated on a background thread.
+	if (!IsInGameThread())
+	{
+		TPromise<TMap<FString, Worker_ComponentId>> Promise;
+		TFuture<TMap<FString, Worker_ComponentId>> Future = Promise.GetFuture();
+		AsyncTask(ENamedThreads::GameThread, [&Promise]{
+			Promise.SetValue(LoadComponentIdAllocations());
+		});
+		return Future.Get();
+	}
+
+	TMap<FString, Worker_ComponentId> ComponentIds;
+	if (!FPackageName::DoesPackageExist(SCHEMA_DATABASE_PACKAGE_PATH))
+	{
+		return ComponentIds;
+	}
+
+	const USchemaDatabase* SchemaDatabase = LoadObject<USchemaDatabase>(nullptr, *FString::Printf(TEXT("%s.SchemaDatabase"), SCHEMA_DATABASE_PACKAGE_PATH));
+	if (SchemaDatabase == nullptr)
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Warning, TEXT("Unable to load the schema database. Component ids will be allocated from scratch."));
+		return ComponentIds;
+	}
+
+	for (const auto& Pair : SchemaDatabase->ComponentIdAllocations)
+	{
+		ComponentIds.Add(Pair.Key, static_cast<Worker_ComponentId>(Pair.Value));
+	}
+
+	// Databases saved before allocations were recorded only have the ids of the classes they were generated for.
+	if (ComponentIds.Num() == 0)
+	{
+		for (const auto& Pair : SchemaDatabase->ClassToSchema)
+		{
+			if (Pair.Key != nullptr)
+			{
+				ComponentIds.Add(Pair.Key->GetPathName(), static_cast<Worker_ComponentId>(Pair.Value.SingleClientRepData));
+			}
+		}
+	}
+
+	return ComponentIds;
+}
+
 void OnStatusOutput(FString Message)
 {
 	UE_LOG(LogSpatialGDKSchemaGenerator, Log, TEXT("%s"), *Message);
 }
 
-int GenerateCompleteSchemaFromClass(const FString& SchemaPath, int ComponentId, UClass* Class)
+int GenerateCompleteSchemaFromClass(const FString& SchemaPath, int ComponentId, UClass* Class, FUnrealType* TypeInfo)
 {
 	FCodeWriter OutputSchema;
 
-	FString SchemaFilename = FString::Printf(TEXT("Unreal%s"), *UnrealNameToSchemaTypeName(Class->GetName()));
-
-	// Parent and static array index start at 0 for checksum calculations.
-	TSharedPtr<FUnrealType> TypeInfo = CreateUnrealTypeInfo(Class, 0, 0, false);
-
 	// Generate schema.
 	int NumComponents = GenerateTypeBindingSchema(OutputSchema, ComponentId, Class, TypeInfo, SchemaPath);
-	OutputSchema.WriteToFile(FString::Printf(TEXT("%s%s.schema"), *SchemaPath, *SchemaFilename));
+	OutputSchema.WriteToFile(SchemaPath + GetSchemaFilename(Class));
 
 	return NumComponents;
 }
@@ -78,16 +218,158 @@ bool CheckClassNameListValidity(const TArray<UClass*>& Classes)
 	}
 	return true;
 }
+
+bool SchemaDataEquals(const FSchemaData& A, const FSchemaData& B)
+{
+	return A.SingleClientRepData == B.SingleClientRepData && A.MultiClientRepData == B.MultiClientRepData && A.HandoverData == B.HandoverData
+		&& A.ClientRPCs == B.ClientRPCs && A.ServerRPCs == B.ServerRPCs && A.NetMulticastRPCs == B.NetMulticastRPCs && A.CrossServerRPCs == B.CrossServerRPCs;
+}
 }// ::
 
-void GenerateSchemaFromClasses(const TArray<UClass*>& Classes, const FString& CombinedSchemaPath)
+TMap<FString, Worker_ComponentId> AllocateComponentIds(const TArray<UClass*>& Classes, const TMap<FString, Worker_ComponentId>& ExistingComponentIds, bool bCompact)
+{
+	FComponentIdAllocator Allocator(FIRST_ALLOCATED_COMPONENT_ID, NUM_COMPONENT_ID_BLOCKS, GetNumTypeBindingComponents());
+
+	if (!bCompact)
+	{
+		// Reserve in a fixed order, so that if two allocations overlap it is always the same one which is moved.
+		TArray<FString> ExistingClassPaths;
+		ExistingComponentIds.GenerateKeyArray(ExistingClassPaths);
+		ExistingClassPaths.Sort();
+
+		for (const FString& ClassPath : ExistingClassPaths)
+		{
+			if (!Allocator.Reserve(ClassPath, ExistingComponentIds[ClassPath]))
+			{
+				UE_LOG(LogSpatialGDKSchemaGenerator, Warning, TEXT("Component ids of %s overlap those of another class, so it will be given new ones."), *ClassPath);
+			}
+		}
+	}
+
+	// Allocate in a fixed order too, so collisions between new classes are always resolved the same way.
+	TArray<FString> ClassPaths;
+	for (UClass* Class : Classes)
+	{
+		ClassPaths.Add(Class->GetPathName());
+	}
+	ClassPaths.Sort();
+
+	for (const FString& ClassPath : ClassPaths)
+	{
+		Allocator.Allocate(ClassPath);
+	}
+
+	if (Allocator.GetNumCollisions() > 0)
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Log, TEXT("%d classes collided with another class's component ids and were allocated the next free ones."), Allocator.GetNumCollisions());
+	}
+
+	TMap<FString, Worker_ComponentId> ComponentIds;
+	for (const auto& Pair : Allocator.GetAllocations())
+	{
+		ComponentIds.Add(Pair.Key, static_cast<Worker_ComponentId>(Pair.Value));
+	}
+
+	return ComponentIds;
+}
+
+FSchemaGenerationChanges GenerateSchemaFromClasses(const TArray<UClass*>& Classes, const FString& CombinedSchemaPath, const FString& SchemaCachePath, const TMap<FString, Worker_ComponentId>& ComponentIds)
 {
-	Worker_ComponentId ComponentId = SpatialConstants::STARTING_GENERATED_COMPONENT_ID;
+	const double StartTime = FPlatformTime::Seconds();
+
+	TMap<FString, FSchemaCacheEntry> OldCache = LoadSchemaCache(SchemaCachePath, CombinedSchemaPath);
+	TMap<FString, FSchemaCacheEntry> NewCache;
+	TSet<FString> SchemaFilenames;
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	TArray<UClass*> ClassesToGenerate;
+	TArray<Worker_ComponentId> ClassComponentIds;
 
 	for (const auto& Class : Classes)
 	{
-		ComponentId += GenerateCompleteSchemaFromClass(CombinedSchemaPath, ComponentId, Class);
+		const FString ClassPath = Class->GetPathName();
+		const FString SchemaFilename = GetSchemaFilename(Class);
+		SchemaFilenames.Add(SchemaFilename);
+
+		FSchemaCacheEntry Entry;
+		Entry.Checksum = GenerateClassChecksum(Class);
+		Entry.ComponentId = ComponentIds[ClassPath];
+		Entry.NumComponents = GetNumTypeBindingComponents();
+
+		// A class only gets new component ids if its previous ones were compacted away or taken by another class.
+		const FSchemaCacheEntry* CachedEntry = OldCache.Find(ClassPath);
+		if (CachedEntry == nullptr || CachedEntry->Checksum != Entry.Checksum || CachedEntry->ComponentId != Entry.ComponentId
+			|| CachedEntry->NumComponents != Entry.NumComponents || !PlatformFile.FileExists(*(CombinedSchemaPath + SchemaFilename)))
+		{
+			ClassesToGenerate.Add(Class);
+			ClassComponentIds.Add(Entry.ComponentId);
+		}
+
+		NewCache.Add(ClassPath, Entry);
+	}
+
+	const double ChecksumEndTime = FPlatformTime::Seconds();
+
+	// Building the type info for each class is independent of every other class, so it's done in parallel. It creates CDOs and
+	// sets up class replication data on demand, which isn't thread safe, so make sure that has already happened for each class
+	// and for the subobject classes it recurses into.
+	const int32 NumPreparedClasses = PrepareClassesForTypeInfo(ClassesToGenerate);
+
+	const double TypeInfoStartTime = FPlatformTime::Seconds();
+
+	const TArray<FUnrealClassTypeInfo> ClassTypeInfos = CreateUnrealClassTypeInfos(ClassesToGenerate);
+
+	const double WriteStartTime = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < ClassesToGenerate.Num(); i++)
+	{
+		GenerateCompleteSchemaFromClass(CombinedSchemaPath, ClassComponentIds[i], ClassesToGenerate[i], ClassTypeInfos[i].TypeInfo);
 	}
+
+	const double WriteEndTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogSpatialGDKSchemaGenerator, Log, TEXT("Schema generation timings: checksums for %d classes %.2fs, preparing %d classes for type info %.2fs, type info for %d classes %.2fs, writing schema %.2fs."),
+		Classes.Num(), ChecksumEndTime - StartTime, NumPreparedClasses, TypeInfoStartTime - ChecksumEndTime,
+		ClassesToGenerate.Num(), WriteStartTime - TypeInfoStartTime, WriteEndTime - WriteStartTime);
+
+	// The slowest classes are usually the ones worth looking at when generation gets slow.
+	const int32 NumSlowestClasses = 10;
+	TArray<int32> SlowestClasses;
+	for (int32 i = 0; i < ClassesToGenerate.Num(); i++)
+	{
+		SlowestClasses.Add(i);
+	}
+	SlowestClasses.Sort([&ClassTypeInfos](int32 A, int32 B) { return ClassTypeInfos[A].BuildSeconds > ClassTypeInfos[B].BuildSeconds; });
+	for (int32 i = 0; i < FMath::Min(NumSlowestClasses, SlowestClasses.Num()); i++)
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Log, TEXT("Building type info for %s took %.3fs."), *ClassesToGenerate[SlowestClasses[i]]->GetPathName(), ClassTypeInfos[SlowestClasses[i]].BuildSeconds);
+	}
+	for (int32 i = NumSlowestClasses; i < SlowestClasses.Num(); i++)
+	{
+		UE_LOG(LogSpatialGDKSchemaGenerator, Verbose, TEXT("Building type info for %s took %.3fs."), *ClassesToGenerate[SlowestClasses[i]]->GetPathName(), ClassTypeInfos[SlowestClasses[i]].BuildSeconds);
+	}
+
+	FSchemaGenerationChanges Changes;
+	Changes.GeneratedClasses = ClassesToGenerate;
+
+	// Remove schema for classes which no longer have any.
+	TArray<FString> ExistingFilenames;
+	IFileManager::Get().FindFiles(ExistingFilenames, *(CombinedSchemaPath + TEXT("*.schema")), true, false);
+	for (const FString& ExistingFilename : ExistingFilenames)
+	{
+		if (!SchemaFilenames.Contains(ExistingFilename))
+		{
+			PlatformFile.DeleteFile(*(CombinedSchemaPath + ExistingFilename));
+			Changes.RemovedSchemaFiles.Add(ExistingFilename);
+		}
+	}
+
+	SaveSchemaCache(SchemaCachePath, CombinedSchemaPath, NewCache);
+
+	UE_LOG(LogSpatialGDKSchemaGenerator, Display, TEXT("Generated schema for %d of %d classes (%d unchanged, %d removed) in %.2f seconds."),
+		Changes.GeneratedClasses.Num(), Classes.Num(), Classes.Num() - Changes.GeneratedClasses.Num(), Changes.RemovedSchemaFiles.Num(), FPlatformTime::Seconds() - StartTime);
+
+	return Changes;
 }
 
 FString GenerateIntermediateDirectory()
@@ -99,35 +381,91 @@ FString GenerateIntermediateDirectory()
 	return AbsoluteCombinedIntermediatePath;
 }
 
-void CreateSchemaDatabase(TArray<UClass*> Classes)
+FSchemaDatabaseChanges UpdateSchemaDatabase(USchemaDatabase* SchemaDatabase, const TArray<UClass*>& Classes, const TMap<FString, Worker_ComponentId>& ComponentIds)
 {
-	AsyncTask(ENamedThreads::GameThread, [Classes]{
-		FString PackagePath = TEXT("/Game/Spatial/SchemaDatabase");
+	FSchemaDatabaseChanges Changes;
 
-		UPackage *Package = CreatePackage(nullptr, *PackagePath);
+	// Classes which were deleted since the database was saved are loaded back as null.
+	TSet<UClass*> ClassSet;
+	ClassSet.Append(Classes);
+	for (auto It = SchemaDatabase->ClassToSchema.CreateIterator(); It; ++It)
+	{
+		if (!ClassSet.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+			Changes.NumRemovedClasses++;
+		}
+	}
 
-		USchemaDatabase* SchemaDatabase = NewObject<USchemaDatabase>(Package, USchemaDatabase::StaticClass(), FName("SchemaDatabase"), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone);
+	for (UClass* Class : Classes)
+	{
+		Worker_ComponentId ComponentId = ComponentIds[Class->GetPathName()];
+
+		FSchemaData SchemaData;
+		SchemaData.SingleClientRepData = ComponentId++;
+		SchemaData.MultiClientRepData = ComponentId++;
+		SchemaData.HandoverData = ComponentId++;
+		SchemaData.ClientRPCs = ComponentId++;
+		SchemaData.ServerRPCs = ComponentId++;
+		SchemaData.CrossServerRPCs = ComponentId++;
+		SchemaData.NetMulticastRPCs = ComponentId++;
+
+		const FSchemaData* ExistingSchemaData = SchemaDatabase->ClassToSchema.Find(Class);
+		if (ExistingSchemaData == nullptr || !SchemaDataEquals(*ExistingSchemaData, SchemaData))
+		{
+			SchemaDatabase->ClassToSchema.Add(Class, SchemaData);
+			Changes.UpdatedClasses.Add(Class);
+		}
+	}
 
-		Worker_ComponentId ComponentId = SpatialConstants::STARTING_GENERATED_COMPONENT_ID;
+	TMap<FString, int32> ComponentIdAllocations;
+	for (const auto& Pair : ComponentIds)
+	{
+		ComponentIdAllocations.Add(Pair.Key, static_cast<int32>(Pair.Value));
+	}
+	if (!ComponentIdAllocations.OrderIndependentCompareEqual(SchemaDatabase->ComponentIdAllocations))
+	{
+		SchemaDatabase->ComponentIdAllocations = MoveTemp(ComponentIdAllocations);
+		Changes.bComponentIdAllocationsChanged = true;
+	}
 
-		for (UClass* Class : Classes)
+	return Changes;
+}
+
+// Updates the saved schema database, creating it if there isn't one, and only saves it if something changed.
+void UpdateSchemaDatabaseAsset(TArray<UClass*> Classes, TMap<FString, Worker_ComponentId> ComponentIds)
+{
+	AsyncTask(ENamedThreads::GameThread, [Classes, ComponentIds]{
+		FString PackagePath = SCHEMA_DATABASE_PACKAGE_PATH;
+
+		USchemaDatabase* SchemaDatabase = nullptr;
+		if (FPackageName::DoesPackageExist(PackagePath))
 		{
-			FSchemaData SchemaData;
-			SchemaData.SingleClientRepData = ComponentId++;
-			SchemaData.MultiClientRepData = ComponentId++;
-			SchemaData.HandoverData = ComponentId++;
-			SchemaData.ClientRPCs = ComponentId++;
-			SchemaData.ServerRPCs = ComponentId++;
-			SchemaData.CrossServerRPCs = ComponentId++;
-			SchemaData.NetMulticastRPCs = ComponentId++;
+			SchemaDatabase = LoadObject<USchemaDatabase>(nullptr, *FString::Printf(TEXT("%s.SchemaDatabase"), *PackagePath));
+		}
 
-			SchemaDatabase->ClassToSchema.Add(Class, SchemaData);
+		const bool bCreated = SchemaDatabase == nullptr;
+		if (bCreated)
+		{
+			UPackage *Package = CreatePackage(nullptr, *PackagePath);
+			SchemaDatabase = NewObject<USchemaDatabase>(Package, USchemaDatabase::StaticClass(), FName("SchemaDatabase"), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone);
 		}
 
-		FAssetRegistryModule::AssetCreated(SchemaDatabase);
+		const FSchemaDatabaseChanges Changes = UpdateSchemaDatabase(SchemaDatabase, Classes, ComponentIds);
+		if (!bCreated && !Changes.HasChanges())
+		{
+			return;
+		}
+
+		UE_LOG(LogSpatialGDKSchemaGenerator, Log, TEXT("Schema database: %d classes added or updated, %d removed."), Changes.UpdatedClasses.Num(), Changes.NumRemovedClasses);
+
+		if (bCreated)
+		{
+			FAssetRegistryModule::AssetCreated(SchemaDatabase);
+		}
 		SchemaDatabase->MarkPackageDirty();
 
-		FString FilePath = FString::Printf(TEXT("%s%s"), *PackagePath, *FPackageName::GetAssetPackageExtension());
+		UPackage* Package = SchemaDatabase->GetOutermost();
 		bool bSuccess = UPackage::SavePackage(Package, SchemaDatabase, EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, *FPackageName::LongPackageNameToFilename(PackagePath, FPackageName::GetAssetPackageExtension()));
 
 		if (!bSuccess)
@@ -199,7 +537,7 @@ TArray<UClass*> GetAllSupportedClasses()
 	return Classes;
 }
 
-bool SpatialGDKGenerateSchema()
+bool SpatialGDKGenerateSchema(bool bCompactComponentIds)
 {
 	const USpatialGDKEditorToolbarSettings* SpatialGDKToolbarSettings = GetDefault<USpatialGDKEditorToolbarSettings>();
 
@@ -229,17 +567,15 @@ bool SpatialGDKGenerateSchema()
 		return false;
 	}
 
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	if (PlatformFile.DirectoryExists(*SchemaOutputPath))
-	{
-		PlatformFile.DeleteDirectoryRecursively(*SchemaOutputPath);
-		PlatformFile.CreateDirectory(*SchemaOutputPath);
-	}
+	const TMap<FString, Worker_ComponentId> ExistingComponentIds = LoadComponentIdAllocations();
+	const TMap<FString, Worker_ComponentId> ComponentIds = AllocateComponentIds(SchemaGeneratedClasses, ExistingComponentIds, bCompactComponentIds);
 
 	check(GetDefault<UGeneralProjectSettings>()->bSpatialNetworking);
-	GenerateSchemaFromClasses(SchemaGeneratedClasses, SchemaOutputPath);
+	GenerateSchemaFromClasses(SchemaGeneratedClasses, SchemaOutputPath, GetSchemaCachePath(), ComponentIds);
 
-	CreateSchemaDatabase(SchemaGeneratedClasses);
+	// The schema database only depends on the classes and their component ids, so only the entries of added, removed or
+	// reallocated classes change, and it's only saved if one did.
+	UpdateSchemaDatabaseAsset(SchemaGeneratedClasses, ComponentIds);
 
 	return true;
 }
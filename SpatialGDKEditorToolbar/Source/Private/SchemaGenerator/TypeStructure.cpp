@@ -2,9 +2,12 @@
 
 #include "TypeStructure.h"
 
+#include "Async/ParallelFor.h"
 #include "Engine/SCS_Node.h"
+#include "Net/UnrealNetwork.h"
 
 #include "SpatialGDKEditorSchemaGenerator.h"
+#include "Utils/SchemaStructUtils.h"
 
 namespace Errors
 {
@@ -106,12 +109,12 @@ FString GetRPCTypeName(ERPCType RPCType)
 	}
 }
 
-void VisitAllObjects(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TSharedPtr<FUnrealType>)> Visitor, bool bRecurseIntoSubobjects)
+void VisitAllObjects(FUnrealType* TypeNode, TFunction<bool(FUnrealType*)> Visitor, bool bRecurseIntoSubobjects)
 {
 	bool bShouldRecurseFurther = Visitor(TypeNode);
 	for (auto& PropertyPair : TypeNode->Properties)
 	{
-		if (bShouldRecurseFurther && PropertyPair.Value->Type.IsValid())
+		if (bShouldRecurseFurther && PropertyPair.Value->Type != nullptr)
 		{
 			// Either recurse into subobjects if they're structs or bRecurseIntoSubobjects is true.
 			if (bRecurseIntoSubobjects || PropertyPair.Value->Property->IsA<UStructProperty>())
@@ -122,12 +125,12 @@ void VisitAllObjects(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TSharedPtr
 	}
 }
 
-void VisitAllProperties(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TSharedPtr<FUnrealProperty>)> Visitor, bool bRecurseIntoSubobjects)
+void VisitAllProperties(FUnrealType* TypeNode, TFunction<bool(FUnrealProperty*)> Visitor, bool bRecurseIntoSubobjects)
 {
 	for (auto& PropertyPair : TypeNode->Properties)
 	{
 		bool bShouldRecurseFurther = Visitor(PropertyPair.Value);
-		if (bShouldRecurseFurther && PropertyPair.Value->Type.IsValid())
+		if (bShouldRecurseFurther && PropertyPair.Value->Type != nullptr)
 		{
 			// Either recurse into subobjects if they're structs or bRecurseIntoSubobjects is true.
 			if (bRecurseIntoSubobjects || PropertyPair.Value->Property->IsA<UStructProperty>())
@@ -138,12 +141,12 @@ void VisitAllProperties(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TShared
 	}
 }
 
-void VisitAllProperties(TSharedPtr<FUnrealRPC> RPCNode, TFunction<bool(TSharedPtr<FUnrealProperty>)> Visitor, bool bRecurseIntoSubobjects)
+void VisitAllProperties(FUnrealRPC* RPCNode, TFunction<bool(FUnrealProperty*)> Visitor, bool bRecurseIntoSubobjects)
 {
 	for (auto& PropertyPair : RPCNode->Parameters)
 	{
 		bool bShouldRecurseFurther = Visitor(PropertyPair.Value);
-		if (bShouldRecurseFurther && PropertyPair.Value->Type.IsValid())
+		if (bShouldRecurseFurther && PropertyPair.Value->Type != nullptr)
 		{
 			// Either recurse into subobjects if they're structs or bRecurseIntoSubobjects is true.
 			if (bRecurseIntoSubobjects || PropertyPair.Value->Property->IsA<UStructProperty>())
@@ -165,9 +168,82 @@ uint32 GenerateChecksum(UProperty* Property, uint32 ParentChecksum, int32 Static
 	return Checksum;
 }
 
-TSharedPtr<FUnrealProperty> CreateUnrealProperty(TSharedPtr<FUnrealType> TypeNode, UProperty* Property, uint32 ParentChecksum, uint32 StaticArrayIndex)
+// Evolves Checksum over every property in Type, recursing into the same structs and subobjects as CreateUnrealTypeInfo.
+uint32 GenerateTypeChecksum(UStruct* Type, uint32 Checksum)
 {
-	TSharedPtr<FUnrealProperty> PropertyNode = MakeShared<FUnrealProperty>();
+	UClass* Class = Cast<UClass>(Type);
+	UObject* ContainerCDO = Class ? Class->GetDefaultObject() : nullptr;
+
+	for (TFieldIterator<UProperty> It(Type); It; ++It)
+	{
+		UProperty* Property = *It;
+
+		Checksum = GenerateChecksum(Property, Checksum, Property->ArrayDim);
+		const uint64 PropertyFlags = Property->PropertyFlags & (CPF_Net | CPF_Handover | CPF_RepNotify | CPF_RepSkip);
+		Checksum = FCrc::MemCrc32(&PropertyFlags, sizeof(PropertyFlags), Checksum);
+
+		if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+		{
+			const uint32 StructFlags = StructProperty->Struct->StructFlags & (STRUCT_NetSerializeNative | STRUCT_NetDeltaSerializeNative);
+			Checksum = FCrc::MemCrc32(&StructFlags, sizeof(StructFlags), Checksum);
+			Checksum = GenerateTypeChecksum(StructProperty->Struct, Checksum);
+		}
+		else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+		{
+			// Structs in arrays only change the schema if they are generated as schema types, which can't contain themselves.
+			UStructProperty* InnerStructProperty = Cast<UStructProperty>(ArrayProperty->Inner);
+			if (InnerStructProperty != nullptr && IsSchemaStruct(InnerStructProperty->Struct))
+			{
+				Checksum = GenerateTypeChecksum(InnerStructProperty->Struct, Checksum);
+			}
+		}
+		else if (UObjectProperty* ObjectProperty = Cast<UObjectProperty>(Property))
+		{
+			// Only subobjects owned by the CDO are recursed into, see CreateUnrealTypeInfo.
+			UObject* Value = ContainerCDO ? ObjectProperty->GetPropertyValue_InContainer(ContainerCDO) : nullptr;
+			if (Value && !Value->IsEditorOnly() && Value->GetOuter() == ContainerCDO)
+			{
+				Checksum = GenerateTypeChecksum(ObjectProperty->PropertyClass, Checksum);
+			}
+		}
+	}
+
+	return Checksum;
+}
+
+uint32 GenerateClassChecksum(UClass* Class)
+{
+	uint32 Checksum = FCrc::StrCrc32(*Class->GetPathName());
+	Checksum = GenerateTypeChecksum(Class, Checksum);
+
+	// Replication conditions aren't part of the properties, they come from the CDO in the same way FRepLayout gets them.
+	TArray<FLifetimeProperty> LifetimeProps;
+	Class->GetDefaultObject()->GetLifetimeReplicatedProps(LifetimeProps);
+	for (const FLifetimeProperty& LifetimeProp : LifetimeProps)
+	{
+		const uint32 Condition[3] = { LifetimeProp.RepIndex, static_cast<uint32>(LifetimeProp.Condition), static_cast<uint32>(LifetimeProp.RepNotifyCondition) };
+		Checksum = FCrc::MemCrc32(Condition, sizeof(Condition), Checksum);
+	}
+
+	for (TFieldIterator<UFunction> RemoteFunction(Class); RemoteFunction; ++RemoteFunction)
+	{
+		const uint32 FunctionFlags = RemoteFunction->FunctionFlags & (FUNC_NetClient | FUNC_NetServer | FUNC_NetCrossServer | FUNC_NetMulticast | FUNC_NetReliable);
+		if ((FunctionFlags & ~FUNC_NetReliable) == 0)
+		{
+			continue;
+		}
+
+		Checksum = FCrc::StrCrc32(*RemoteFunction->GetName(), Checksum);
+		Checksum = FCrc::MemCrc32(&FunctionFlags, sizeof(FunctionFlags), Checksum);
+		Checksum = GenerateTypeChecksum(*RemoteFunction, Checksum);
+	}
+
+	return Checksum;
+}
+
+FUnrealProperty* CreateUnrealProperty(FUnrealTypeArena& Arena, FUnrealType* TypeNode, UProperty* Property, uint32 ParentChecksum, uint32 StaticArrayIndex)
+{
+	FUnrealProperty* PropertyNode = Arena.NewProperty();
 	PropertyNode->Property = Property;
 	PropertyNode->ContainerType = TypeNode;
 	PropertyNode->ParentChecksum = ParentChecksum;
@@ -179,13 +255,13 @@ TSharedPtr<FUnrealProperty> CreateUnrealProperty(TSharedPtr<FUnrealType> TypeNod
 	return PropertyNode;
 }
 
-TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksum, int32 StaticArrayIndex, bool bIsRPC)
+FUnrealType* CreateUnrealTypeInfo(FUnrealTypeArena& Arena, UStruct* Type, uint32 ParentChecksum, int32 StaticArrayIndex, bool bIsRPC)
 {
 	// Struct types will set this to nullptr.
 	UClass* Class = Cast<UClass>(Type);
 
 	// Create type node.
-	TSharedPtr<FUnrealType> TypeNode = MakeShared<FUnrealType>();
+	FUnrealType* TypeNode = Arena.NewType();
 	TypeNode->Type = Type;
 
 	// Iterate through each property in the struct.
@@ -194,7 +270,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 		UProperty* Property = *It;
 
 		// Create property node and add it to the AST.
-		TSharedPtr<FUnrealProperty> PropertyNode = CreateUnrealProperty(TypeNode, Property, ParentChecksum, StaticArrayIndex);
+		FUnrealProperty* PropertyNode = CreateUnrealProperty(Arena, TypeNode, Property, ParentChecksum, StaticArrayIndex);
 
 		// If this property not a struct or object (which can contain more properties), stop here.
 		if (!Property->IsA<UStructProperty>() && !Property->IsA<UObjectProperty>())
@@ -206,7 +282,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 			{
 				for (int i = 1; i < Property->ArrayDim; i++)
 				{
-					CreateUnrealProperty(TypeNode, Property, ParentChecksum, i);
+					CreateUnrealProperty(Arena, TypeNode, Property, ParentChecksum, i);
 				}
 			}
 			continue;
@@ -219,7 +295,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 
 			// This is the property for the 0th struct array member.
 			uint32 ParentPropertyNodeChecksum = PropertyNode->CompatibleChecksum;
-			PropertyNode->Type = CreateUnrealTypeInfo(StructProperty->Struct, ParentPropertyNodeChecksum, 0, bIsRPC);
+			PropertyNode->Type = CreateUnrealTypeInfo(Arena, StructProperty->Struct, ParentPropertyNodeChecksum, 0, bIsRPC);
 			PropertyNode->Type->ParentProperty = PropertyNode;
 
 			if (!bIsRPC)
@@ -228,11 +304,11 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 				for (int i = 1; i < Property->ArrayDim; i++)
 				{
 					// Create a new PropertyNode.
-					TSharedPtr<FUnrealProperty> StaticStructArrayPropertyNode = CreateUnrealProperty(TypeNode, Property, ParentChecksum, i);
+					FUnrealProperty* StaticStructArrayPropertyNode = CreateUnrealProperty(Arena, TypeNode, Property, ParentChecksum, i);
 
 					// Generate Type information on the inner struct.
 					// Note: The parent checksum of the properties within a struct that is a member of a static struct array, is the checksum for the struct itself after index modification.
-					StaticStructArrayPropertyNode->Type = CreateUnrealTypeInfo(StructProperty->Struct, StaticStructArrayPropertyNode->CompatibleChecksum, 0, bIsRPC);
+					StaticStructArrayPropertyNode->Type = CreateUnrealTypeInfo(Arena, StructProperty->Struct, StaticStructArrayPropertyNode->CompatibleChecksum, 0, bIsRPC);
 					StaticStructArrayPropertyNode->Type->ParentProperty = StaticStructArrayPropertyNode;
 				}
 			}
@@ -282,7 +358,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 				UE_LOG(LogSpatialGDKSchemaGenerator, Warning, TEXT("Property Class: %s Instance Class: %s"), *ObjectProperty->PropertyClass->GetName(), *Value->GetClass()->GetName());
 
 				// This property is definitely a strong reference, recurse into it.
-				PropertyNode->Type = CreateUnrealTypeInfo(ObjectProperty->PropertyClass, ParentChecksum, 0, bIsRPC);
+				PropertyNode->Type = CreateUnrealTypeInfo(Arena, ObjectProperty->PropertyClass, ParentChecksum, 0, bIsRPC);
 				PropertyNode->Type->ParentProperty = PropertyNode;
 
 				if (!bIsRPC)
@@ -290,10 +366,10 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 					// For static arrays we need to make a new object array member node.
 					for (int i = 1; i < Property->ArrayDim; i++)
 					{
-						TSharedPtr<FUnrealProperty> StaticObjectArrayPropertyNode = CreateUnrealProperty(TypeNode, Property, ParentChecksum, i);
+						FUnrealProperty* StaticObjectArrayPropertyNode = CreateUnrealProperty(Arena, TypeNode, Property, ParentChecksum, i);
 
 						// Note: The parent checksum of static arrays of strong object references will be the parent checksum of this class.
-						StaticObjectArrayPropertyNode->Type = CreateUnrealTypeInfo(ObjectProperty->PropertyClass, ParentChecksum, 0, bIsRPC);
+						StaticObjectArrayPropertyNode->Type = CreateUnrealTypeInfo(Arena, ObjectProperty->PropertyClass, ParentChecksum, 0, bIsRPC);
 						StaticObjectArrayPropertyNode->Type->ParentProperty = StaticObjectArrayPropertyNode;
 					}
 				}
@@ -316,7 +392,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 		{
 			for (int i = 1; i < Property->ArrayDim; i++)
 			{
-				CreateUnrealProperty(TypeNode, Property, ParentChecksum, i);
+				CreateUnrealProperty(Arena, TypeNode, Property, ParentChecksum, i);
 			}
 		}
 	} // END TFieldIterator<UProperty>
@@ -335,7 +411,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 			RemoteFunction->FunctionFlags & FUNC_NetCrossServer ||
 			RemoteFunction->FunctionFlags & FUNC_NetMulticast)
 		{
-			TSharedPtr<FUnrealRPC> RPCNode = MakeShared<FUnrealRPC>();
+			FUnrealRPC* RPCNode = Arena.NewRPC();
 			RPCNode->CallerType = Class;
 			RPCNode->Function = *RemoteFunction;
 			RPCNode->Type = GetRPCTypeFromFunction(*RemoteFunction);
@@ -347,7 +423,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 			{
 				UProperty* Parameter = *It;
 
-				TSharedPtr<FUnrealProperty> PropertyNode = MakeShared<FUnrealProperty>();
+				FUnrealProperty* PropertyNode = Arena.NewProperty();
 				PropertyNode->Property = Parameter;
 
 				// RPCs can't have static arrays as parameters so we don't have to special case for them here, however struct parameters can have static arrays in them.
@@ -358,7 +434,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 				{
 					uint32 StructChecksum = GenerateChecksum(Parameter, ParentChecksum, 0);
 					PropertyNode->CompatibleChecksum = StructChecksum;
-					PropertyNode->Type = CreateUnrealTypeInfo(StructParameter->Struct, StructChecksum, 0 , true);
+					PropertyNode->Type = CreateUnrealTypeInfo(Arena, StructParameter->Struct, StructChecksum, 0 , true);
 					PropertyNode->Type->ParentProperty = PropertyNode;
 				}
 			}
@@ -403,7 +479,7 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 		// The parents array will contain "Bar", and the cmds array will contain "Nested", but we have no reference to "Baz" anywhere in the RepLayout.
 		// What we do here is recurse into all of Bar's properties in the AST until we find Baz.
 
-		TSharedPtr<FUnrealProperty> PropertyNode = nullptr;
+		FUnrealProperty* PropertyNode = nullptr;
 
 		// Simple case: Cmd is a root property in the object.
 		if (Parent.Property == Cmd.Property)
@@ -420,27 +496,27 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 		else
 		{
 			// It's possible to have duplicate parent properties (they are distinguished by ArrayIndex), so we make sure to look at them all.
-			TArray<TSharedPtr<FUnrealProperty>> RootProperties;
+			TArray<FUnrealProperty*> RootProperties;
 			TypeNode->Properties.MultiFind(Parent.Property, RootProperties);
 
-			for (TSharedPtr<FUnrealProperty>& RootProperty : RootProperties)
+			for (FUnrealProperty* RootProperty : RootProperties)
 			{
-				checkf(RootProperty->Type.IsValid(), TEXT("Properties in the AST which are parent properties in the rep layout must have child properties"));
-				VisitAllProperties(RootProperty->Type, [&PropertyNode, &Cmd](TSharedPtr<FUnrealProperty> Property)
+				checkf(RootProperty->Type != nullptr, TEXT("Properties in the AST which are parent properties in the rep layout must have child properties"));
+				VisitAllProperties(RootProperty->Type, [&PropertyNode, &Cmd](FUnrealProperty* Property)
 				{
 					if (Property->CompatibleChecksum == Cmd.CompatibleChecksum)
 					{
-						checkf(!PropertyNode.IsValid(), TEXT("We've already found a previous property node with the same property. This indicates that we have a 'diamond of death' style situation."))
+						checkf(PropertyNode == nullptr, TEXT("We've already found a previous property node with the same property. This indicates that we have a 'diamond of death' style situation."))
 						PropertyNode = Property;
 					}
 					return true;
 				}, false);
 			}
 		}
-		checkf(PropertyNode.IsValid(), TEXT("Couldn't find the Cmd property inside the Parent's sub-properties. This shouldn't happen."));
+		checkf(PropertyNode != nullptr, TEXT("Couldn't find the Cmd property inside the Parent's sub-properties. This shouldn't happen."));
 
 		// We now have the right property node. Fill in the rep data.
-		TSharedPtr<FUnrealRepData> RepDataNode = MakeShared<FUnrealRepData>();
+		FUnrealRepData* RepDataNode = Arena.NewRepData();
 		RepDataNode->RepLayoutType = (ERepLayoutCmdType)Cmd.Type;
 		RepDataNode->Condition = Parent.Condition;
 		RepDataNode->RepNotifyCondition = Parent.RepNotifyCondition;
@@ -466,11 +542,11 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 
 	// Find the handover properties.
 	uint16 HandoverDataHandle = 1;
-	VisitAllProperties(TypeNode, [&HandoverDataHandle](TSharedPtr<FUnrealProperty> PropertyInfo)
+	VisitAllProperties(TypeNode, [&Arena, &HandoverDataHandle](FUnrealProperty* PropertyInfo)
 	{
 		if (PropertyInfo->Property->PropertyFlags & CPF_Handover)
 		{
-			PropertyInfo->HandoverData = MakeShared<FUnrealHandoverData>();
+			PropertyInfo->HandoverData = Arena.NewHandoverData();
 			PropertyInfo->HandoverData->Handle = HandoverDataHandle++;
 		}
 		return true;
@@ -479,15 +555,72 @@ TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksu
 	return TypeNode;
 }
 
-FUnrealFlatRepData GetFlatRepData(TSharedPtr<FUnrealType> TypeInfo)
+namespace
+{
+
+// Follows the same CDO-owned subobjects as GenerateTypeChecksum, which are the ones CreateUnrealTypeInfo recurses into.
+void PrepareClassForTypeInfo(UClass* Class, TSet<UClass*>& PreparedClasses)
+{
+	bool bAlreadyPrepared = false;
+	PreparedClasses.Add(Class, &bAlreadyPrepared);
+	if (bAlreadyPrepared)
+	{
+		return;
+	}
+
+	UObject* ContainerCDO = Class->GetDefaultObject();
+	Class->SetUpRuntimeReplicationData();
+
+	for (TFieldIterator<UObjectProperty> It(Class); It; ++It)
+	{
+		UObjectProperty* ObjectProperty = *It;
+		UObject* Value = ObjectProperty->GetPropertyValue_InContainer(ContainerCDO);
+		if (Value && !Value->IsEditorOnly() && Value->GetOuter() == ContainerCDO)
+		{
+			PrepareClassForTypeInfo(ObjectProperty->PropertyClass, PreparedClasses);
+		}
+	}
+}
+
+} // ::
+
+int32 PrepareClassesForTypeInfo(const TArray<UClass*>& Classes)
+{
+	TSet<UClass*> PreparedClasses;
+	for (UClass* Class : Classes)
+	{
+		PrepareClassForTypeInfo(Class, PreparedClasses);
+	}
+	return PreparedClasses.Num();
+}
+
+TArray<FUnrealClassTypeInfo> CreateUnrealClassTypeInfos(const TArray<UClass*>& Classes)
+{
+	TArray<FUnrealClassTypeInfo> ClassTypeInfos;
+	ClassTypeInfos.SetNum(Classes.Num());
+	ParallelFor(Classes.Num(), [&Classes, &ClassTypeInfos](int32 Index)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		// Parent and static array index start at 0 for checksum calculations.
+		FUnrealClassTypeInfo& ClassTypeInfo = ClassTypeInfos[Index];
+		ClassTypeInfo.Arena = MakeUnique<FUnrealTypeArena>();
+		ClassTypeInfo.TypeInfo = CreateUnrealTypeInfo(*ClassTypeInfo.Arena, Classes[Index], 0, 0, false);
+
+		ClassTypeInfo.BuildSeconds = FPlatformTime::Seconds() - StartTime;
+	});
+	return ClassTypeInfos;
+}
+
+FUnrealFlatRepData GetFlatRepData(FUnrealType* TypeInfo)
 {
 	FUnrealFlatRepData RepData;
 	RepData.Add(REP_MultiClient);
 	RepData.Add(REP_SingleClient);
 
-	VisitAllProperties(TypeInfo, [&RepData](TSharedPtr<FUnrealProperty> PropertyInfo)
+	VisitAllProperties(TypeInfo, [&RepData](FUnrealProperty* PropertyInfo)
 	{
-		if (PropertyInfo->ReplicationData.IsValid())
+		if (PropertyInfo->ReplicationData != nullptr)
 		{
 			EReplicatedPropertyGroup Group = REP_MultiClient;
 			switch (PropertyInfo->ReplicationData->Condition)
@@ -514,12 +647,12 @@ FUnrealFlatRepData GetFlatRepData(TSharedPtr<FUnrealType> TypeInfo)
 	return RepData;
 }
 
-FCmdHandlePropertyMap GetFlatHandoverData(TSharedPtr<FUnrealType> TypeInfo)
+FCmdHandlePropertyMap GetFlatHandoverData(FUnrealType* TypeInfo)
 {
 	FCmdHandlePropertyMap HandoverData;
-	VisitAllProperties(TypeInfo, [&HandoverData](TSharedPtr<FUnrealProperty> PropertyInfo)
+	VisitAllProperties(TypeInfo, [&HandoverData](FUnrealProperty* PropertyInfo)
 	{
-		if (PropertyInfo->HandoverData.IsValid())
+		if (PropertyInfo->HandoverData != nullptr)
 		{
 			HandoverData.Add(PropertyInfo->HandoverData->Handle, PropertyInfo);
 		}
@@ -535,10 +668,10 @@ FCmdHandlePropertyMap GetFlatHandoverData(TSharedPtr<FUnrealType> TypeInfo)
 }
 
 // Goes through all RPCs in the TypeInfo and returns a list of all the unique RPC source classes.
-TArray<FString> GetRPCTypeOwners(TSharedPtr<FUnrealType> TypeInfo)
+TArray<FString> GetRPCTypeOwners(FUnrealType* TypeInfo)
 {
 	TArray<FString> RPCTypeOwners;
-	VisitAllObjects(TypeInfo, [&RPCTypeOwners](TSharedPtr<FUnrealType> Type)
+	VisitAllObjects(TypeInfo, [&RPCTypeOwners](FUnrealType* Type)
 	{
 		for (auto& RPC : Type->RPCs)
 		{
@@ -551,14 +684,14 @@ TArray<FString> GetRPCTypeOwners(TSharedPtr<FUnrealType> TypeInfo)
 	return RPCTypeOwners;
 }
 
-FUnrealRPCsByType GetAllRPCsByType(TSharedPtr<FUnrealType> TypeInfo)
+FUnrealRPCsByType GetAllRPCsByType(FUnrealType* TypeInfo)
 {
 	FUnrealRPCsByType RPCsByType;
 	RPCsByType.Add(RPC_Client);
 	RPCsByType.Add(RPC_Server);
 	RPCsByType.Add(RPC_CrossServer);
 	RPCsByType.Add(RPC_NetMulticast);
-	VisitAllObjects(TypeInfo, [&RPCsByType](TSharedPtr<FUnrealType> Type)
+	VisitAllObjects(TypeInfo, [&RPCsByType](FUnrealType* Type)
 	{
 		for (auto& RPC : Type->RPCs)
 		{
@@ -620,10 +753,10 @@ void AddComponentClassToSet(UClass* ComponentClass, TSet<UClass*>& ComponentClas
 	}
 }
 
-TArray<TSharedPtr<FUnrealProperty>> GetFlatRPCParameters(TSharedPtr<FUnrealRPC> RPCNode)
+TArray<FUnrealProperty*> GetFlatRPCParameters(FUnrealRPC* RPCNode)
 {
-	TArray<TSharedPtr<FUnrealProperty>> ParamList;
-	VisitAllProperties(RPCNode, [&ParamList](TSharedPtr<FUnrealProperty> Property)
+	TArray<FUnrealProperty*> ParamList;
+	VisitAllProperties(RPCNode, [&ParamList](FUnrealProperty* Property)
 	{
 		// If the property is a generic struct without NetSerialize, recurse further.
 		if (Property->Property->IsA<UStructProperty>())
@@ -655,21 +788,20 @@ TArray<TSharedPtr<FUnrealProperty>> GetFlatRPCParameters(TSharedPtr<FUnrealRPC>
 	return ParamList;
 }
 
-TArray<TSharedPtr<FUnrealProperty>> GetPropertyChain(TSharedPtr<FUnrealProperty> LeafProperty)
+TArray<const FUnrealProperty*> GetPropertyChain(const FUnrealProperty* LeafProperty)
 {
-	TArray<TSharedPtr<FUnrealProperty>> OutputChain;
-	TSharedPtr<FUnrealProperty> CurrentProperty = LeafProperty;
-	while (CurrentProperty.IsValid())
+	TArray<const FUnrealProperty*> OutputChain;
+	const FUnrealProperty* CurrentProperty = LeafProperty;
+	while (CurrentProperty != nullptr)
 	{
 		OutputChain.Add(CurrentProperty);
-		if (CurrentProperty->ContainerType.IsValid())
+		if (CurrentProperty->ContainerType != nullptr)
 		{
-			TSharedPtr<FUnrealType> EnclosingType = CurrentProperty->ContainerType.Pin();
-			CurrentProperty = EnclosingType->ParentProperty.Pin();
+			CurrentProperty = CurrentProperty->ContainerType->ParentProperty;
 		}
 		else
 		{
-			CurrentProperty.Reset();
+			CurrentProperty = nullptr;
 		}
 	}
 
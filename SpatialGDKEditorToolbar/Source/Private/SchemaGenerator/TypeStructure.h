@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Containers/ChunkedArray.h"
 #include "EngineMinimal.h"
 #include "Net/RepLayout.h"
 
@@ -102,36 +103,36 @@ struct FUnrealHandoverData;
 // A node which represents an unreal type, such as ACharacter or UCharacterMovementComponent.
 struct FUnrealType
 {
-	UStruct* Type;
-	TMultiMap<UProperty*, TSharedPtr<FUnrealProperty>> Properties;
-	TMap<UFunction*, TSharedPtr<FUnrealRPC>> RPCs;
-	TWeakPtr<FUnrealProperty> ParentProperty;
+	UStruct* Type = nullptr;
+	TMultiMap<UProperty*, FUnrealProperty*> Properties;
+	TMap<UFunction*, FUnrealRPC*> RPCs;
+	FUnrealProperty* ParentProperty = nullptr;
 };
 
 // A node which represents a single property or parameter in an RPC.
 struct FUnrealProperty
 {
-	UProperty* Property;
-	TSharedPtr<FUnrealType> Type; // Only set if strong reference to object/struct property.
-	TSharedPtr<FUnrealRepData> ReplicationData; // Only set if property is replicated.
-	TSharedPtr<FUnrealHandoverData> HandoverData; // Only set if property is marked for handover (and not replicated).
-	TWeakPtr<FUnrealType> ContainerType; // Not set if this property is an RPC parameter.
+	UProperty* Property = nullptr;
+	FUnrealType* Type = nullptr; // Only set if strong reference to object/struct property.
+	FUnrealRepData* ReplicationData = nullptr; // Only set if property is replicated.
+	FUnrealHandoverData* HandoverData = nullptr; // Only set if property is marked for handover (and not replicated).
+	FUnrealType* ContainerType = nullptr; // Not set if this property is an RPC parameter.
 
 	// These variables are used for unique variable checksum generation. We do this to accurately match properties at run-time.
 	// They are used in the function GenerateChecksum which will use all three variables and the UProperty itself to create a checksum for each FUnrealProperty.
-	int32 StaticArrayIndex;
-	uint32 CompatibleChecksum;
-	uint32 ParentChecksum;
+	int32 StaticArrayIndex = 0;
+	uint32 CompatibleChecksum = 0;
+	uint32 ParentChecksum = 0;
 };
 
 // A node which represents an RPC.
 struct FUnrealRPC
 {
-	UClass* CallerType;
-	UFunction* Function;
-	ERPCType Type;
-	TMap<UProperty*, TSharedPtr<FUnrealProperty>> Parameters;
-	bool bReliable;
+	UClass* CallerType = nullptr;
+	UFunction* Function = nullptr;
+	ERPCType Type = RPC_Unknown;
+	TMap<UProperty*, FUnrealProperty*> Parameters;
+	bool bReliable = false;
 };
 
 // A node which represents replication data generated by the FRepLayout instantiated from a UClass.
@@ -140,20 +141,58 @@ struct FUnrealRepData
 	ERepLayoutCmdType RepLayoutType;
 	ELifetimeCondition Condition;
 	ELifetimeRepNotifyCondition RepNotifyCondition;
-	uint16 Handle;
-	int32 RoleSwapHandle;
-	int32 ArrayIndex;
+	uint16 Handle = 0;
+	int32 RoleSwapHandle = -1;
+	int32 ArrayIndex = 0;
 };
 
 // A node which represents handover (server to server) data.
 struct FUnrealHandoverData
 {
-	uint16 Handle;
+	uint16 Handle = 0;
 };
 
-using FUnrealFlatRepData = TMap<EReplicatedPropertyGroup, TMap<uint16, TSharedPtr<FUnrealProperty>>>;
-using FUnrealRPCsByType = TMap<ERPCType, TArray<TSharedPtr<FUnrealRPC>>>;
-using FCmdHandlePropertyMap = TMap<uint16, TSharedPtr<FUnrealProperty>>;
+// Owns the nodes of an AST. Nodes are allocated a chunk at a time rather than one by one, stay at the same address until the
+// arena is destroyed, and are all freed together then, so nodes refer to each other with plain pointers. An arena isn't thread
+// safe, so each AST which is built on its own thread needs its own.
+class FUnrealTypeArena : public FNoncopyable
+{
+public:
+	FUnrealType* NewType() { return NewNode(Types); }
+	FUnrealProperty* NewProperty() { return NewNode(Properties); }
+	FUnrealRPC* NewRPC() { return NewNode(RPCs); }
+	FUnrealRepData* NewRepData() { return NewNode(RepData); }
+	FUnrealHandoverData* NewHandoverData() { return NewNode(HandoverData); }
+
+	int32 GetNumNodes() const { return Types.Num() + Properties.Num() + RPCs.Num() + RepData.Num() + HandoverData.Num(); }
+
+private:
+	template <typename NodeType, uint32 TargetBytesPerChunk>
+	static NodeType* NewNode(TChunkedArray<NodeType, TargetBytesPerChunk>& Nodes)
+	{
+		return &Nodes[Nodes.Add(1)];
+	}
+
+	TChunkedArray<FUnrealType> Types;
+	TChunkedArray<FUnrealProperty> Properties;
+	TChunkedArray<FUnrealRPC> RPCs;
+	TChunkedArray<FUnrealRepData> RepData;
+	TChunkedArray<FUnrealHandoverData> HandoverData;
+};
+
+// The AST of a class, along with the arena which owns it.
+struct FUnrealClassTypeInfo
+{
+	TUniquePtr<FUnrealTypeArena> Arena;
+	FUnrealType* TypeInfo = nullptr;
+
+	// How long building the AST took.
+	double BuildSeconds = 0.0;
+};
+
+using FUnrealFlatRepData = TMap<EReplicatedPropertyGroup, TMap<uint16, FUnrealProperty*>>;
+using FUnrealRPCsByType = TMap<ERPCType, TArray<FUnrealRPC*>>;
+using FCmdHandlePropertyMap = TMap<uint16, FUnrealProperty*>;
 
 // Given a UClass, returns either "AFoo" or "UFoo" depending on whether Foo is a subclass of actor.
 FString GetFullCPPName(UClass* Class);
@@ -174,7 +213,7 @@ TArray<ERPCType> GetRPCTypes();
 // Given a UFunction, determines the RPC type.
 ERPCType GetRPCTypeFromFunction(UFunction* Function);
 
-TArray<FString> GetRPCTypeOwners(TSharedPtr<FUnrealType> TypeInfo);
+TArray<FString> GetRPCTypeOwners(FUnrealType* TypeInfo);
 
 // Converts an RPC type to string. Used to generate component names.
 FString GetRPCTypeName(ERPCType RPCType);
@@ -182,41 +221,55 @@ FString GetRPCTypeName(ERPCType RPCType);
 // Given an AST, this applies the function 'Visitor' to all FUnrealType's contained transitively within the properties. bRecurseIntoObjects will control
 // whether this function will recurse into a UObject's properties, which may not always be desirable. However, it will always recurse into substructs.
 // If the Visitor function returns false, it will not recurse any further into that part of the tree.
-void VisitAllObjects(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TSharedPtr<FUnrealType>)> Visitor, bool bRecurseIntoSubobjects);
+void VisitAllObjects(FUnrealType* TypeNode, TFunction<bool(FUnrealType*)> Visitor, bool bRecurseIntoSubobjects);
 
 // Similar to 'VisitAllObjects', but instead applies the Visitor function to all properties which are traversed.
-void VisitAllProperties(TSharedPtr<FUnrealType> TypeNode, TFunction<bool(TSharedPtr<FUnrealProperty>)> Visitor, bool bRecurseIntoSubobjects);
+void VisitAllProperties(FUnrealType* TypeNode, TFunction<bool(FUnrealProperty*)> Visitor, bool bRecurseIntoSubobjects);
 
 // Similar to 'VisitAllObjects', but instead applies the Visitor function to all parameters in an RPC (and subproperties of structs/objects where appropriate).
-void VisitAllProperties(TSharedPtr<FUnrealRPC> RPCNode, TFunction<bool(TSharedPtr<FUnrealProperty>)> Visitor, bool bRecurseIntoSubobjects);
+void VisitAllProperties(FUnrealRPC* RPCNode, TFunction<bool(FUnrealProperty*)> Visitor, bool bRecurseIntoSubobjects);
 
 // Generates a unique checksum for the Property that allows matching to Unreal's RepLayout Cmds.
 uint32 GenerateChecksum(UProperty* Property, uint32 ParentChecksum, int32 StaticArrayIndex);
 
-// Creates a new FUnrealProperty for the included UProperty, generates a checksum for it and then adds it to the TypeNode included.
-TSharedPtr<FUnrealProperty> CreateUnrealProperty(TSharedPtr<FUnrealType> TypeNode, UProperty* Property, uint32 ParentChecksum, uint32 StaticArrayIndex);
+// Generates a checksum over everything about a class that affects its generated schema: its properties (including those of
+// structs and owned subobjects), their replication conditions, and its RPCs. This is much cheaper than building the AST, so it
+// can be used to tell whether a class's schema needs to be regenerated.
+uint32 GenerateClassChecksum(UClass* Class);
+
+// Creates a new FUnrealProperty in Arena for the included UProperty, generates a checksum for it and then adds it to the TypeNode included.
+FUnrealProperty* CreateUnrealProperty(FUnrealTypeArena& Arena, FUnrealType* TypeNode, UProperty* Property, uint32 ParentChecksum, uint32 StaticArrayIndex);
+
+// Generates an AST from an Unreal UStruct or UClass, with every node allocated in Arena.
+FUnrealType* CreateUnrealTypeInfo(FUnrealTypeArena& Arena, UStruct* Type, uint32 ParentChecksum, int32 StaticArrayIndex, bool bIsRPC);
+
+// Creates the CDO and sets up the replication data of each class and of every subobject class CreateUnrealTypeInfo will recurse
+// into for it. CreateUnrealTypeInfo builds a rep layout for each of these, which sets them up on demand, and that isn't safe to do
+// from several threads for a class shared between them. Returns the number of classes prepared.
+int32 PrepareClassesForTypeInfo(const TArray<UClass*>& Classes);
 
-// Generates an AST from an Unreal UStruct or UClass.
-TSharedPtr<FUnrealType> CreateUnrealTypeInfo(UStruct* Type, uint32 ParentChecksum, int32 StaticArrayIndex, bool bIsRPC);
+// Generates the AST of each class in parallel, each in its own arena, in the same order as Classes. The classes must have been
+// prepared with PrepareClassesForTypeInfo. Each AST is only touched by the task which builds it until this returns.
+TArray<FUnrealClassTypeInfo> CreateUnrealClassTypeInfos(const TArray<UClass*>& Classes);
 
 // Traverses an AST, and generates a flattened list of replicated properties, which will match the Cmds array of FRepLayout.
 // The list of replicated properties will all have the ReplicatedData field set to a valid FUnrealRepData node which contains
 // data such as the handle or replication condition.
 //
 // This function will _not_ traverse into subobject properties (as the replication system deals with each object separately).
-FUnrealFlatRepData GetFlatRepData(TSharedPtr<FUnrealType> TypeInfo);
+FUnrealFlatRepData GetFlatRepData(FUnrealType* TypeInfo);
 
 // Traverses an AST, and generates a flattened list of handover properties. The list of handover properties will all have
 // the HandoverData field set to a value FUnrealHandoverData node which contains data such as the handle or replication type.
 //
 // This function will traverse into subobject properties.
-FCmdHandlePropertyMap GetFlatHandoverData(TSharedPtr<FUnrealType> TypeInfo);
+FCmdHandlePropertyMap GetFlatHandoverData(FUnrealType* TypeInfo);
 
 // Traverses an AST fully (including subobjects) and generates a list of all RPCs which would be routed through an actor channel
 // of the Unreal class represented by TypeInfo.
 //
 // This function will traverse into subobject properties.
-FUnrealRPCsByType GetAllRPCsByType(TSharedPtr<FUnrealType> TypeInfo);
+FUnrealRPCsByType GetAllRPCsByType(FUnrealType* TypeInfo);
 
 // Get all supported components (not all subobjects) of an Actor class
 TArray<UClass*> GetAllSupportedComponents(UClass* Class);
@@ -225,8 +278,8 @@ TArray<UClass*> GetAllSupportedComponents(UClass* Class);
 void AddComponentClassToSet(UClass* ComponentClass, TSet<UClass*>& ComponentClasses, UClass* ActorClass);
 
 // Given an AST, traverses all its parameters (and properties within structs) and generates a complete flattened list of properties.
-TArray<TSharedPtr<FUnrealProperty>> GetFlatRPCParameters(TSharedPtr<FUnrealRPC> RPCNode);
+TArray<FUnrealProperty*> GetFlatRPCParameters(FUnrealRPC* RPCNode);
 
 // Given a property, traverse up to the root property and create a list of properties needed to reach the leaf property.
 // For example: foo->bar->baz becomes {"foo", "bar", "baz"}.
-TArray<TSharedPtr<FUnrealProperty>> GetPropertyChain(TSharedPtr<FUnrealProperty> LeafProperty);
+TArray<const FUnrealProperty*> GetPropertyChain(const FUnrealProperty* LeafProperty);
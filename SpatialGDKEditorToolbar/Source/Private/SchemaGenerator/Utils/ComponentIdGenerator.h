@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "CoreMinimal.h"
+
 struct FComponentIdGenerator
 {
 	FComponentIdGenerator(int StartId) : InitialId(StartId), NumIds(0)
@@ -22,3 +24,93 @@ private:
 	int InitialId;
 	int NumIds;
 };
+
+// Allocates each class a block of consecutive component ids. A new class's block is derived from a hash of its path, so it
+// doesn't depend on which other classes exist or the order they are allocated in. If any id in that block is already taken,
+// the following blocks are tried in turn. Blocks allocated by a previous run should be reserved first, so they are kept.
+struct FComponentIdAllocator
+{
+	FComponentIdAllocator(int StartId, uint32 InNumBlocks, int InBlockSize) : InitialId(StartId), NumBlocks(InNumBlocks), BlockSize(InBlockSize), NumCollisions(0)
+	{
+	}
+
+	// Keeps a block allocated by a previous run. Returns false if it overlaps a block which is already reserved.
+	bool Reserve(const FString& ClassPath, int FirstId)
+	{
+		if (!IsBlockFree(FirstId))
+		{
+			return false;
+		}
+
+		AddAllocation(ClassPath, FirstId);
+		return true;
+	}
+
+	// Returns the first id of the class's block, allocating one if it doesn't have one yet.
+	int Allocate(const FString& ClassPath)
+	{
+		if (const int* ExistingId = Allocations.Find(ClassPath))
+		{
+			return *ExistingId;
+		}
+
+		const uint32 HomeBlock = FCrc::StrCrc32(*ClassPath) % NumBlocks;
+		for (uint32 Probe = 0; Probe < NumBlocks; Probe++)
+		{
+			const int FirstId = InitialId + static_cast<int>((HomeBlock + Probe) % NumBlocks) * BlockSize;
+			if (IsBlockFree(FirstId))
+			{
+				if (Probe > 0)
+				{
+					NumCollisions++;
+				}
+				AddAllocation(ClassPath, FirstId);
+				return FirstId;
+			}
+		}
+
+		checkf(false, TEXT("Ran out of component ids allocating %s"), *ClassPath);
+		return INDEX_NONE;
+	}
+
+	const TMap<FString, int>& GetAllocations() const
+	{
+		return Allocations;
+	}
+
+	// The number of classes which couldn't be given the block derived from their path.
+	int GetNumCollisions() const
+	{
+		return NumCollisions;
+	}
+
+private:
+	bool IsBlockFree(int FirstId) const
+	{
+		for (int Id = FirstId; Id < FirstId + BlockSize; Id++)
+		{
+			if (UsedIds.Contains(Id))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void AddAllocation(const FString& ClassPath, int FirstId)
+	{
+		Allocations.Add(ClassPath, FirstId);
+		for (int Id = FirstId; Id < FirstId + BlockSize; Id++)
+		{
+			UsedIds.Add(Id);
+		}
+	}
+
+	int InitialId;
+	uint32 NumBlocks;
+	int BlockSize;
+	int NumCollisions;
+
+	TMap<FString, int> Allocations;
+	TSet<int> UsedIds;
+};
@@ -75,11 +75,11 @@ FString CPPCommandClassName(UClass* Class, UFunction* Function)
 	return SchemaName;
 }
 
-FString SchemaFieldName(const TSharedPtr<FUnrealProperty> Property)
+FString SchemaFieldName(const FUnrealProperty* Property)
 {
 	// Transform the property chain into a chain of names.
 	TArray<FString> ChainNames;
-	Algo::Transform(GetPropertyChain(Property), ChainNames, [](const TSharedPtr<FUnrealProperty>& Property) -> FString
+	Algo::Transform(GetPropertyChain(Property), ChainNames, [](const FUnrealProperty* Property) -> FString
 	{
 		FString PropName = Property->Property->GetName().ToLower();
 		PropName.Append(FString::FromInt(Property->StaticArrayIndex));
@@ -91,3 +91,15 @@ FString SchemaFieldName(const TSharedPtr<FUnrealProperty> Property)
 	FString FieldName = TEXT("field_") + FString::Join(ChainNames, TEXT("_"));
 	return FieldName;
 }
+
+FString SchemaStructTypeName(UScriptStruct* Struct)
+{
+	// Structs in different packages can share a name, as can structs whose names only differ by underscores, and a class's
+	// schema file can use any of them. Suffixing a hash of the struct's full path keeps their types apart.
+	return FString::Printf(TEXT("%sStruct%08X"), *UnrealNameToSchemaTypeName(Struct->GetName()), FCrc::StrCrc32(*Struct->GetPathName()));
+}
+
+FString SchemaStructFieldName(UProperty* Property)
+{
+	return TEXT("field_") + UnrealNameToSchemaTypeName(Property->GetName().ToLower());
+}
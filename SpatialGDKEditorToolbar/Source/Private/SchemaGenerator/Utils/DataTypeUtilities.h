@@ -42,4 +42,11 @@ FString SchemaRPCName(UClass* Class, UFunction* Function);
 FString CPPCommandClassName(UClass* Class, UFunction* Function);
 
 // Given a property node, generates the schema field name.
-FString SchemaFieldName(const TSharedPtr<FUnrealProperty> Property);
+FString SchemaFieldName(const FUnrealProperty* Property);
+
+// Given a struct which is generated as a schema type, generates the name of that type.
+// For example: FVector -> VectorStruct followed by a hash of /Script/CoreUObject.Vector
+FString SchemaStructTypeName(UScriptStruct* Struct);
+
+// Given a property of a struct which is generated as a schema type, generates the name of its field in that type.
+FString SchemaStructFieldName(UProperty* Property);
@@ -18,6 +18,7 @@
 #include "Utils/RepLayoutUtils.h"
 #include "Utils/SchemaUtils.h"
 
+#include "Async/Async.h"
 #include "EngineUtils.h"
 #include "Runtime/Core/Public/HAL/PlatformFilemanager.h"
 #include "UObjectIterator.h"
@@ -38,6 +39,9 @@ const WorkerRequirementSet AnyWorkerPermission{ {UnrealClientAttributeSet, Unrea
 
 const improbable::Coordinates Origin{ 0, 0, 0 };
 
+// Number of startup actor entities created before they're handed to the snapshot writer.
+const int32 SNAPSHOT_WRITE_BATCH_SIZE = 256;
+
 bool CreateSpawnerEntity(Worker_SnapshotOutputStream* OutputStream)
 {
 	Worker_Entity SpawnerEntity;
@@ -271,11 +275,8 @@ TArray<Worker_ComponentData> CreateStartupActorData(USpatialActorChannel* Channe
 	return ComponentData;
 }
 
-bool CreateStartupActor(Worker_SnapshotOutputStream* OutputStream, AActor* Actor, Worker_EntityId EntityId, USpatialNetConnection* NetConnection, USpatialTypebindingManager* TypebindingManager)
+TArray<Worker_ComponentData> CreateStartupActorComponents(AActor* Actor, USpatialNetConnection* NetConnection, USpatialTypebindingManager* TypebindingManager)
 {
-	Worker_Entity Entity;
-	Entity.entity_id = EntityId;
-
 	UClass* ActorClass = Actor->GetClass();
 
 	FClassInfo* ActorInfo = TypebindingManager->FindClassInfoByClass(ActorClass);
@@ -321,15 +322,13 @@ bool CreateStartupActor(Worker_SnapshotOutputStream* OutputStream, AActor* Actor
 
 	Components.Append(CreateStartupActorData(Channel, Actor, TypebindingManager, Cast<USpatialNetDriver>(NetConnection->Driver)));
 
-	Entity.component_count = Components.Num();
-	Entity.components = Components.GetData();
-
-	return Worker_SnapshotOutputStream_WriteEntity(OutputStream, &Entity) != 0;
+	return Components;
 }
 
-bool ProcessSupportedActors(UWorld* World, USpatialTypebindingManager* TypebindingManager, TFunction<bool(AActor*, Worker_EntityId)> Process)
+// Returns the actors which should be saved to the snapshot, in the order their entity ids are assigned.
+TArray<AActor*> GetSupportedActors(UWorld* World, USpatialTypebindingManager* TypebindingManager)
 {
-	Worker_EntityId CurrentEntityId = SpatialConstants::PLACEHOLDER_ENTITY_ID_LAST + 1;
+	TArray<AActor*> Actors;
 
 	for (TActorIterator<AActor> It(World); It; ++It)
 	{
@@ -347,12 +346,46 @@ bool ProcessSupportedActors(UWorld* World, USpatialTypebindingManager* Typebindi
 			continue;
 		}
 
-		if (!Process(Actor, CurrentEntityId))
+		Actors.Add(Actor);
+	}
+
+	return Actors;
+}
+
+struct FSnapshotEntity
+{
+	Worker_EntityId EntityId;
+	TArray<Worker_ComponentData> Components;
+};
+
+// The output stream takes ownership of the component data of the entities written to it, so this is only needed for ones which weren't.
+void DestroyComponentData(const TArray<FSnapshotEntity>& Entities, int32 FirstEntityIndex)
+{
+	for (int32 i = FirstEntityIndex; i < Entities.Num(); i++)
+	{
+		for (const Worker_ComponentData& Component : Entities[i].Components)
 		{
-			return false;
+			Schema_DestroyComponentData(Component.schema_type);
 		}
+	}
+}
+
+bool WriteEntities(Worker_SnapshotOutputStream* OutputStream, const TArray<FSnapshotEntity>& Entities)
+{
+	for (int32 i = 0; i < Entities.Num(); i++)
+	{
+		const FSnapshotEntity& SnapshotEntity = Entities[i];
+
+		Worker_Entity Entity;
+		Entity.entity_id = SnapshotEntity.EntityId;
+		Entity.component_count = SnapshotEntity.Components.Num();
+		Entity.components = SnapshotEntity.Components.GetData();
 
-		CurrentEntityId++;
+		if (Worker_SnapshotOutputStream_WriteEntity(OutputStream, &Entity) == 0)
+		{
+			DestroyComponentData(Entities, i + 1);
+			return false;
+		}
 	}
 
 	return true;
@@ -368,23 +401,66 @@ bool CreateStartupActors(Worker_SnapshotOutputStream* OutputStream, UWorld* Worl
 
 	SetupStartupActorCreation(NetDriver, NetConnection, PackageMap, TypebindingManager, EntityRegistry, World);
 
-	bool bSuccess = true;
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<AActor*> Actors = GetSupportedActors(World, TypebindingManager);
+	const Worker_EntityId FirstEntityId = SpatialConstants::PLACEHOLDER_ENTITY_ID_LAST + 1;
 
 	// Need to add all actors in the world to the package map so they have assigned UnrealObjRefs for the ComponentFactory to use
-	bSuccess &= ProcessSupportedActors(World, TypebindingManager, [&PackageMap, &EntityRegistry](AActor* Actor, Worker_EntityId EntityId)
+	for (int32 i = 0; i < Actors.Num(); i++)
 	{
-		EntityRegistry->AddToRegistry(EntityId, Actor);
-		PackageMap->ResolveEntityActor(Actor, EntityId, improbable::CreateOffsetMapFromActor(Actor));
-		return true;
-	});
+		EntityRegistry->AddToRegistry(FirstEntityId + i, Actors[i]);
+		PackageMap->ResolveEntityActor(Actors[i], FirstEntityId + i, improbable::CreateOffsetMapFromActor(Actors[i]));
+	}
 
-	bSuccess &= ProcessSupportedActors(World, TypebindingManager, [&NetConnection, &OutputStream, &TypebindingManager](AActor* Actor, Worker_EntityId EntityId)
+	// Component data has to be created on the game thread, as it reads from the actors, but serializing it into the snapshot doesn't.
+	// Entities are written in batches on the thread pool while the next batch is created, with at most one batch waiting to be
+	// written, so only a couple of batches of entity data are ever held in memory. Only one batch is written at a time, which keeps
+	// the entities in id order.
+	TFuture<bool> PendingWrite;
+	bool bSuccess = true;
+
+	for (int32 BatchStart = 0; BatchStart < Actors.Num() && bSuccess; BatchStart += SNAPSHOT_WRITE_BATCH_SIZE)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + SNAPSHOT_WRITE_BATCH_SIZE, Actors.Num());
+
+		TArray<FSnapshotEntity> Batch;
+		Batch.Reserve(BatchEnd - BatchStart);
+		for (int32 i = BatchStart; i < BatchEnd; i++)
+		{
+			Batch.Add(FSnapshotEntity{ FirstEntityId + i, CreateStartupActorComponents(Actors[i], NetConnection, TypebindingManager) });
+		}
+
+		if (PendingWrite.IsValid())
+		{
+			bSuccess = PendingWrite.Get();
+		}
+
+		if (bSuccess)
+		{
+			PendingWrite = Async<bool>(EAsyncExecution::ThreadPool, [OutputStream, Batch = MoveTemp(Batch)]()
+			{
+				return WriteEntities(OutputStream, Batch);
+			});
+		}
+		else
+		{
+			DestroyComponentData(Batch, 0);
+		}
+	}
+
+	if (PendingWrite.IsValid())
 	{
-		return CreateStartupActor(OutputStream, Actor, EntityId, NetConnection, TypebindingManager);
-	});
+		bSuccess &= PendingWrite.Get();
+	}
 
 	CleanupNetDriverAndConnection(NetDriver, NetConnection);
 
+	if (bSuccess)
+	{
+		UE_LOG(LogSpatialGDKSnapshot, Display, TEXT("Wrote %d startup actors to snapshot in %.2f seconds."), Actors.Num(), FPlatformTime::Seconds() - StartTime);
+	}
+
 	return bSuccess;
 }
 
@@ -412,7 +488,11 @@ bool ValidateAndCreateSnapshotGenerationPath(FString& SavePath)
 bool SpatialGDKGenerateSnapshot(UWorld* World)
 {
 	const USpatialGDKEditorToolbarSettings* Settings = GetDefault<USpatialGDKEditorToolbarSettings>();
-	FString SavePath = FPaths::Combine(Settings->GetSpatialOSSnapshotPath(), Settings->GetSpatialOSSnapshotFile());
+	return SpatialGDKGenerateSnapshot(World, FPaths::Combine(Settings->GetSpatialOSSnapshotPath(), Settings->GetSpatialOSSnapshotFile()));
+}
+
+bool SpatialGDKGenerateSnapshot(UWorld* World, FString SavePath)
+{
 	if (!ValidateAndCreateSnapshotGenerationPath(SavePath))
 	{
 		return false;
@@ -170,6 +170,11 @@ void FSpatialGDKEditorToolbarModule::MapActions(TSharedPtr<class FUICommandList>
 		FExecuteAction::CreateRaw(this, &FSpatialGDKEditorToolbarModule::SchemaGenerateButtonClicked),
 		FCanExecuteAction::CreateRaw(this, &FSpatialGDKEditorToolbarModule::CanExecuteSchemaGenerator));
 
+	InPluginCommands->MapAction(
+		FSpatialGDKEditorToolbarCommands::Get().CompactSpatialGDKSchema,
+		FExecuteAction::CreateRaw(this, &FSpatialGDKEditorToolbarModule::SchemaCompactButtonClicked),
+		FCanExecuteAction::CreateRaw(this, &FSpatialGDKEditorToolbarModule::CanExecuteSchemaGenerator));
+
 	InPluginCommands->MapAction(
 		FSpatialGDKEditorToolbarCommands::Get().CreateSpatialGDKSnapshot,
 		FExecuteAction::CreateRaw(this, &FSpatialGDKEditorToolbarModule::CreateSnapshotButtonClicked),
@@ -221,6 +226,7 @@ void FSpatialGDKEditorToolbarModule::AddMenuExtension(FMenuBuilder& Builder)
 	Builder.BeginSection("SpatialOS Unreal GDK", LOCTEXT("SpatialOS Unreal GDK", "SpatialOS Unreal GDK"));
 	{
 		Builder.AddMenuEntry(FSpatialGDKEditorToolbarCommands::Get().CreateSpatialGDKSchema);
+		Builder.AddMenuEntry(FSpatialGDKEditorToolbarCommands::Get().CompactSpatialGDKSchema);
 		Builder.AddMenuEntry(FSpatialGDKEditorToolbarCommands::Get().CreateSpatialGDKSnapshot);
 		Builder.AddMenuEntry(FSpatialGDKEditorToolbarCommands::Get().StartSpatialOSStackAction);
 		Builder.AddMenuEntry(FSpatialGDKEditorToolbarCommands::Get().StopSpatialOSStackAction);
@@ -260,7 +266,17 @@ void FSpatialGDKEditorToolbarModule::CreateSnapshotButtonClicked()
 
 void FSpatialGDKEditorToolbarModule::SchemaGenerateButtonClicked()
 {
-	ShowTaskStartNotification("Generating Schema");
+	GenerateSchema(false);
+}
+
+void FSpatialGDKEditorToolbarModule::SchemaCompactButtonClicked()
+{
+	GenerateSchema(true);
+}
+
+void FSpatialGDKEditorToolbarModule::GenerateSchema(bool bCompactComponentIds)
+{
+	ShowTaskStartNotification(bCompactComponentIds ? "Generating Schema with compacted component ids" : "Generating Schema");
 	bSchemaGeneratorRunning = true;
 
 	// Force spatial networking so schema layouts are correct
@@ -272,7 +288,7 @@ void FSpatialGDKEditorToolbarModule::SchemaGenerateButtonClicked()
 	// Ensure all our spatial classes are loaded into memory before running
 	CacheSpatialObjects(SPATIALCLASS_GenerateTypeBindings);
 
-	SchemaGeneratorResult = Async<bool>(EAsyncExecution::Thread, SpatialGDKGenerateSchema, [this, bCachedSpatialNetworking]()
+	SchemaGeneratorResult = Async<bool>(EAsyncExecution::Thread, [bCompactComponentIds]() { return SpatialGDKGenerateSchema(bCompactComponentIds); }, [this, bCachedSpatialNetworking]()
 	{
 		if (!SchemaGeneratorResult.IsReady() || SchemaGeneratorResult.Get() != true)
 		{
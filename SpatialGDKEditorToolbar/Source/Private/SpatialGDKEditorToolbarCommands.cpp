@@ -7,6 +7,7 @@
 void FSpatialGDKEditorToolbarCommands::RegisterCommands()
 {
 	UI_COMMAND(CreateSpatialGDKSchema, "Schema", "Creates SpatialOS Unreal GDK schema.", EUserInterfaceActionType::Button, FInputGesture());
+	UI_COMMAND(CompactSpatialGDKSchema, "Compact Schema", "Creates SpatialOS Unreal GDK schema, releasing the component ids of classes which no longer generate schema. Snapshots must be regenerated and workers rebuilt afterwards.", EUserInterfaceActionType::Button, FInputGesture());
 	UI_COMMAND(CreateSpatialGDKSnapshot, "Snapshot", "Creates SpatialOS Unreal GDK snapshot.", EUserInterfaceActionType::Button, FInputGesture());
 	UI_COMMAND(StartSpatialOSStackAction, "Launch", "Starts a local instance of SpatialOS.", EUserInterfaceActionType::Button, FInputGesture());
 	UI_COMMAND(StopSpatialOSStackAction, "Stop", "Stops SpatialOS.", EUserInterfaceActionType::Button, FInputGesture());
@@ -0,0 +1,173 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Algo/Reverse.h"
+
+#include "SchemaGenerator/Utils/ComponentIdGenerator.h"
+
+namespace
+{
+
+const int TEST_FIRST_ID = 1000000;
+const int TEST_BLOCK_SIZE = 4;
+
+// Allocates in sorted order, as the schema generator does.
+TMap<FString, int> AllocateSorted(FComponentIdAllocator& Allocator, TArray<FString> ClassPaths)
+{
+	ClassPaths.Sort();
+	for (const FString& ClassPath : ClassPaths)
+	{
+		Allocator.Allocate(ClassPath);
+	}
+	return Allocator.GetAllocations();
+}
+
+// Reserves a previous run's allocations in sorted order, as the schema generator does.
+void ReserveSorted(FComponentIdAllocator& Allocator, const TMap<FString, int>& Allocations)
+{
+	TArray<FString> ClassPaths;
+	Allocations.GenerateKeyArray(ClassPaths);
+	ClassPaths.Sort();
+	for (const FString& ClassPath : ClassPaths)
+	{
+		Allocator.Reserve(ClassPath, Allocations[ClassPath]);
+	}
+}
+
+bool BlocksOverlap(int FirstIdA, int FirstIdB)
+{
+	return FMath::Abs(FirstIdA - FirstIdB) < TEST_BLOCK_SIZE;
+}
+
+bool HasOverlappingBlocks(const TMap<FString, int>& Allocations)
+{
+	TArray<int> FirstIds;
+	Allocations.GenerateValueArray(FirstIds);
+	for (int i = 0; i < FirstIds.Num(); i++)
+	{
+		for (int j = i + 1; j < FirstIds.Num(); j++)
+		{
+			if (BlocksOverlap(FirstIds[i], FirstIds[j]))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+TArray<FString> MakeClassPaths(int NumClasses)
+{
+	TArray<FString> ClassPaths;
+	for (int i = 0; i < NumClasses; i++)
+	{
+		ClassPaths.Add(FString::Printf(TEXT("/Game/Test/Class%d.Class%d_C"), i, i));
+	}
+	return ClassPaths;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentIdAllocatorReserveTest, "SpatialGDK.SchemaGenerator.ComponentIdAllocator.Reserve", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FComponentIdAllocatorReserveTest::RunTest(const FString& Parameters)
+{
+	FComponentIdAllocator Allocator(TEST_FIRST_ID, 1024, TEST_BLOCK_SIZE);
+
+	const int ReservedId = TEST_FIRST_ID + 10 * TEST_BLOCK_SIZE;
+	TestTrue(TEXT("A free block can be reserved"), Allocator.Reserve(TEXT("/Game/Test/Reserved.Reserved_C"), ReservedId));
+	TestEqual(TEXT("A reserved class keeps its block when allocated"), Allocator.Allocate(TEXT("/Game/Test/Reserved.Reserved_C")), ReservedId);
+	TestFalse(TEXT("The same block can't be reserved twice"), Allocator.Reserve(TEXT("/Game/Test/Other.Other_C"), ReservedId));
+	TestFalse(TEXT("A block overlapping a reserved one can't be reserved"), Allocator.Reserve(TEXT("/Game/Test/Other.Other_C"), ReservedId + TEST_BLOCK_SIZE - 1));
+	TestTrue(TEXT("The block after a reserved one can be reserved"), Allocator.Reserve(TEXT("/Game/Test/Other.Other_C"), ReservedId + TEST_BLOCK_SIZE));
+	TestEqual(TEXT("Reserving doesn't count as a collision"), Allocator.GetNumCollisions(), 0);
+
+	const TMap<FString, int> Allocations = AllocateSorted(Allocator, MakeClassPaths(100));
+	TestFalse(TEXT("New classes aren't given ids overlapping reserved ones"), HasOverlappingBlocks(Allocations));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentIdAllocatorStableIdsTest, "SpatialGDK.SchemaGenerator.ComponentIdAllocator.StableIds", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FComponentIdAllocatorStableIdsTest::RunTest(const FString& Parameters)
+{
+	// Few enough blocks that some classes collide, so moved allocations are covered too.
+	const uint32 NumBlocks = 64;
+	const TArray<FString> ClassPaths = MakeClassPaths(48);
+
+	FComponentIdAllocator FirstRun(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	const TMap<FString, int> FirstAllocations = AllocateSorted(FirstRun, ClassPaths);
+	TestEqual(TEXT("Every class is allocated a block"), FirstAllocations.Num(), ClassPaths.Num());
+	TestFalse(TEXT("No two classes share a component id"), HasOverlappingBlocks(FirstAllocations));
+
+	for (const auto& Pair : FirstAllocations)
+	{
+		TestTrue(TEXT("Allocated ids are in range"), Pair.Value >= TEST_FIRST_ID && Pair.Value < TEST_FIRST_ID + static_cast<int>(NumBlocks) * TEST_BLOCK_SIZE);
+		TestEqual(TEXT("Allocated ids are block aligned"), (Pair.Value - TEST_FIRST_ID) % TEST_BLOCK_SIZE, 0);
+	}
+
+	// Remove a class and add a new one, reserving the first run's allocations as the schema generator does.
+	const FString RemovedClassPath = ClassPaths[7];
+	const FString AddedClassPath = TEXT("/Game/Test/Added.Added_C");
+
+	TArray<FString> SecondClassPaths = ClassPaths;
+	SecondClassPaths.Remove(RemovedClassPath);
+	SecondClassPaths.Add(AddedClassPath);
+
+	FComponentIdAllocator SecondRun(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	ReserveSorted(SecondRun, FirstAllocations);
+	const TMap<FString, int> SecondAllocations = AllocateSorted(SecondRun, SecondClassPaths);
+
+	for (const FString& ClassPath : ClassPaths)
+	{
+		TestEqual(FString::Printf(TEXT("%s keeps its component ids"), *ClassPath), SecondAllocations.FindRef(ClassPath), FirstAllocations[ClassPath]);
+	}
+
+	TestTrue(TEXT("The new class is allocated a block"), SecondAllocations.Contains(AddedClassPath));
+	TestEqual(TEXT("The removed class keeps its block reserved"), SecondAllocations.FindRef(RemovedClassPath), FirstAllocations[RemovedClassPath]);
+	TestFalse(TEXT("The new class doesn't reuse another class's ids"), HasOverlappingBlocks(SecondAllocations));
+
+	// Compacting starts from scratch, so the removed class's block is released.
+	FComponentIdAllocator CompactRun(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	const TMap<FString, int> CompactAllocations = AllocateSorted(CompactRun, SecondClassPaths);
+	TestFalse(TEXT("Compacting releases the removed class's ids"), CompactAllocations.Contains(RemovedClassPath));
+	TestEqual(TEXT("Compacting allocates every current class"), CompactAllocations.Num(), SecondClassPaths.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FComponentIdAllocatorCollisionTest, "SpatialGDK.SchemaGenerator.ComponentIdAllocator.Collisions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FComponentIdAllocatorCollisionTest::RunTest(const FString& Parameters)
+{
+	// As many classes as blocks, so every block is used and most classes collide.
+	const uint32 NumBlocks = 16;
+	const TArray<FString> ClassPaths = MakeClassPaths(NumBlocks);
+
+	TArray<FString> ReversedClassPaths = ClassPaths;
+	Algo::Reverse(ReversedClassPaths);
+
+	FComponentIdAllocator AllocatorA(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	FComponentIdAllocator AllocatorB(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	const TMap<FString, int> AllocationsA = AllocateSorted(AllocatorA, ClassPaths);
+	const TMap<FString, int> AllocationsB = AllocateSorted(AllocatorB, ReversedClassPaths);
+
+	TestTrue(TEXT("Some classes collided"), AllocatorA.GetNumCollisions() > 0);
+	TestEqual(TEXT("Collisions don't depend on the order classes are found in"), AllocatorB.GetNumCollisions(), AllocatorA.GetNumCollisions());
+	TestTrue(TEXT("Collisions are resolved the same way every time"), AllocationsA.OrderIndependentCompareEqual(AllocationsB));
+	TestFalse(TEXT("Colliding classes are given distinct ids"), HasOverlappingBlocks(AllocationsA));
+
+	// A class with no collisions is given the block derived from its path.
+	FComponentIdAllocator SingleAllocator(TEST_FIRST_ID, NumBlocks, TEST_BLOCK_SIZE);
+	const int HomeId = TEST_FIRST_ID + static_cast<int>(FCrc::StrCrc32(*ClassPaths[0]) % NumBlocks) * TEST_BLOCK_SIZE;
+	TestEqual(TEXT("A class is given its home block when it is free"), SingleAllocator.Allocate(ClassPaths[0]), HomeId);
+	TestEqual(TEXT("Allocating a class again returns the same ids"), SingleAllocator.Allocate(ClassPaths[0]), HomeId);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,145 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Components/SceneComponent.h"
+#include "Engine/LevelScriptActor.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectIterator.h"
+
+#include "SchemaGenerator/Utils/DataTypeUtilities.h"
+#include "SpatialGDKEditorSchemaGenerator.h"
+#include "Utils/SchemaDatabase.h"
+
+namespace
+{
+
+// One class is removed and another added between runs, so at least this many are needed.
+const int32 NUM_TEST_CLASSES = 4;
+
+// Loaded classes with replicated or handover properties, as the schema generator picks them, whose schema file names differ.
+TArray<UClass*> GetTestClasses()
+{
+	TArray<UClass*> Classes;
+	TSet<FString> SchemaTypeNames;
+	for (TObjectIterator<UClass> It; It && Classes.Num() < NUM_TEST_CLASSES; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->IsChildOf<USceneComponent>() || Class->IsChildOf<ALevelScriptActor>()
+			|| Class->GetName().StartsWith(TEXT("SKEL_"), ESearchCase::CaseSensitive) || Class->GetName().StartsWith(TEXT("REINST_"), ESearchCase::CaseSensitive))
+		{
+			continue;
+		}
+
+		const FString SchemaTypeName = UnrealNameToSchemaTypeName(Class->GetName());
+		if (SchemaTypeNames.Contains(SchemaTypeName))
+		{
+			continue;
+		}
+
+		for (TFieldIterator<UProperty> PropertyIt(Class); PropertyIt; ++PropertyIt)
+		{
+			if (PropertyIt->HasAnyPropertyFlags(CPF_Net | CPF_Handover))
+			{
+				Classes.Add(Class);
+				SchemaTypeNames.Add(SchemaTypeName);
+				break;
+			}
+		}
+	}
+	return Classes;
+}
+
+// Generates schema for Classes as a schema generation run would, keeping the component ids of the previous runs.
+FSchemaGenerationChanges GenerateSchema(const TArray<UClass*>& Classes, const FString& SchemaPath, const FString& SchemaCachePath, TMap<FString, Worker_ComponentId>& ComponentIds)
+{
+	ComponentIds = AllocateComponentIds(Classes, ComponentIds, false);
+	return GenerateSchemaFromClasses(Classes, SchemaPath, SchemaCachePath, ComponentIds);
+}
+
+FString GetClassNames(const TArray<UClass*>& Classes)
+{
+	TArray<FString> ClassNames;
+	for (UClass* Class : Classes)
+	{
+		ClassNames.Add(Class->GetName());
+	}
+	return FString::Join(ClassNames, TEXT(", "));
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSchemaGeneratorCacheTest, "SpatialGDK.SchemaGenerator.SchemaCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSchemaGeneratorCacheTest::RunTest(const FString& Parameters)
+{
+	const TArray<UClass*> TestClasses = GetTestClasses();
+	if (TestClasses.Num() < NUM_TEST_CLASSES)
+	{
+		AddWarning(FString::Printf(TEXT("Fewer than %d replicated classes are loaded, so regenerating schema for changed classes can't be tested."), NUM_TEST_CLASSES));
+		return true;
+	}
+
+	UClass* RemovedClass = TestClasses[0];
+	UClass* AddedClass = TestClasses[NUM_TEST_CLASSES - 1];
+	const TArray<UClass*> FirstClasses(TestClasses.GetData(), NUM_TEST_CLASSES - 1);
+	const TArray<UClass*> SecondClasses(TestClasses.GetData() + 1, NUM_TEST_CLASSES - 1);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString SchemaPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("SchemaGeneratorCacheTest"))) / TEXT("");
+	const FString SchemaCachePath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("SchemaGeneratorCacheTest"), TEXT(".json")));
+	PlatformFile.CreateDirectoryTree(*SchemaPath);
+
+	TMap<FString, Worker_ComponentId> ComponentIds;
+
+	// The first run has nothing cached, so it generates every class.
+	FSchemaGenerationChanges Changes = GenerateSchema(FirstClasses, SchemaPath, SchemaCachePath, ComponentIds);
+	TestEqual(TEXT("The first run generates schema for every class"), GetClassNames(Changes.GeneratedClasses), GetClassNames(FirstClasses));
+	TestEqual(TEXT("The first run removes no schema"), Changes.RemovedSchemaFiles.Num(), 0);
+
+	// Nothing changed, so nothing is generated again.
+	Changes = GenerateSchema(FirstClasses, SchemaPath, SchemaCachePath, ComponentIds);
+	TestFalse(FString::Printf(TEXT("Running again with the same classes changes nothing, but generated %s"), *GetClassNames(Changes.GeneratedClasses)), Changes.HasChanges());
+
+	// Only the added class is generated, and only the removed class's schema is deleted.
+	Changes = GenerateSchema(SecondClasses, SchemaPath, SchemaCachePath, ComponentIds);
+	TestEqual(TEXT("Adding a class generates schema for only that class"), GetClassNames(Changes.GeneratedClasses), AddedClass->GetName());
+	const FString RemovedSchemaFile = FString::Printf(TEXT("Unreal%s.schema"), *UnrealNameToSchemaTypeName(RemovedClass->GetName()));
+	TestEqual(TEXT("Removing a class removes only its schema"), FString::Join(Changes.RemovedSchemaFiles, TEXT(", ")), RemovedSchemaFile);
+	TestFalse(TEXT("The removed class's schema file is deleted"), PlatformFile.FileExists(*(SchemaPath + RemovedSchemaFile)));
+
+	// The schema database is only touched for the same classes.
+	USchemaDatabase* SchemaDatabase = NewObject<USchemaDatabase>(GetTransientPackage());
+	const TMap<FString, Worker_ComponentId> FirstComponentIds = AllocateComponentIds(FirstClasses, ComponentIds, false);
+
+	FSchemaDatabaseChanges DatabaseChanges = UpdateSchemaDatabase(SchemaDatabase, FirstClasses, FirstComponentIds);
+	TestEqual(TEXT("The first update adds every class to the schema database"), GetClassNames(DatabaseChanges.UpdatedClasses), GetClassNames(FirstClasses));
+
+	const TMap<UClass*, FSchemaData> FirstClassToSchema = SchemaDatabase->ClassToSchema;
+	DatabaseChanges = UpdateSchemaDatabase(SchemaDatabase, FirstClasses, FirstComponentIds);
+	TestFalse(TEXT("Updating the schema database with the same classes changes nothing"), DatabaseChanges.HasChanges());
+
+	DatabaseChanges = UpdateSchemaDatabase(SchemaDatabase, SecondClasses, ComponentIds);
+	TestEqual(TEXT("Adding a class updates only its schema database entry"), GetClassNames(DatabaseChanges.UpdatedClasses), AddedClass->GetName());
+	TestEqual(TEXT("Removing a class removes only its schema database entry"), DatabaseChanges.NumRemovedClasses, 1);
+	TestFalse(TEXT("The removed class's schema database entry is gone"), SchemaDatabase->ClassToSchema.Contains(RemovedClass));
+	for (UClass* Class : SecondClasses)
+	{
+		if (Class != AddedClass)
+		{
+			TestEqual(FString::Printf(TEXT("%s keeps its schema database entry"), *Class->GetName()),
+				SchemaDatabase->ClassToSchema[Class].SingleClientRepData, FirstClassToSchema[Class].SingleClientRepData);
+		}
+	}
+
+	PlatformFile.DeleteDirectoryRecursively(*SchemaPath);
+	PlatformFile.DeleteFile(*SchemaCachePath);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,197 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+#include "Schema/StandardLibrary.h"
+#include "SpatialConstants.h"
+#include "SpatialGDKEditorGenerateSnapshot.h"
+#include "SpatialTypebindingManager.h"
+
+#include <WorkerSDK/improbable/c_worker.h>
+#include <WorkerSDK/improbable/c_schema.h>
+
+namespace
+{
+
+// The number of startup actors to generate a snapshot for can be given as the test's parameters, e.g. "10000 100000".
+const int32 DEFAULT_NUM_SNAPSHOT_ACTORS[] = { 100000 };
+
+// Actors are laid out on a grid this far apart, so each one's position identifies it.
+const float TEST_ACTOR_SPACING = 100.0f;
+const int32 TEST_ACTORS_PER_ROW = 1000;
+const float MAX_POSITION_ERROR = 0.01f;
+
+// Any actor class in the schema database that can be spawned on its own and saved as a startup actor. Null if there isn't one.
+UClass* FindStartupActorClass(USpatialTypebindingManager* TypebindingManager)
+{
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->IsChildOf<AActor>() && !Class->IsChildOf<AInfo>() && !Class->IsChildOf<AController>() && !Class->IsChildOf<APawn>() &&
+			!Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists) &&
+			!Class->HasAnySpatialClassFlags(SPATIALCLASS_Singleton) &&
+			Class->GetDefaultObject<AActor>()->GetIsReplicated() &&
+			TypebindingManager->IsSupportedClass(Class))
+		{
+			return Class;
+		}
+	}
+
+	return nullptr;
+}
+
+FVector GetTestActorLocation(int32 Index)
+{
+	return FVector((Index % TEST_ACTORS_PER_ROW) * TEST_ACTOR_SPACING, (Index / TEST_ACTORS_PER_ROW) * TEST_ACTOR_SPACING, 0.0f);
+}
+
+struct FSnapshotContents
+{
+	int32 NumEntities = 0;
+	int32 NumStartupActorEntities = 0;
+	bool bEntityIdsAscending = true;
+	int32 NumMisplacedActors = 0;
+	FString Error;
+};
+
+// Reads back every entity in the snapshot, checking the startup actors are in entity id order and each is where its actor was.
+FSnapshotContents ReadSnapshot(const FString& SnapshotPath)
+{
+	FSnapshotContents Contents;
+
+	Worker_ComponentVtable DefaultVtable{};
+	Worker_SnapshotParameters Parameters{};
+	Parameters.default_component_vtable = &DefaultVtable;
+	Worker_SnapshotInputStream* InputStream = Worker_SnapshotInputStream_Create(TCHAR_TO_UTF8(*SnapshotPath), &Parameters);
+
+	const Worker_EntityId FirstStartupActorEntityId = SpatialConstants::PLACEHOLDER_ENTITY_ID_LAST + 1;
+	Worker_EntityId LastEntityId = 0;
+	while (Worker_SnapshotInputStream_HasNext(InputStream))
+	{
+		const Worker_Entity* Entity = Worker_SnapshotInputStream_ReadEntity(InputStream);
+		if (Entity == nullptr)
+		{
+			break;
+		}
+
+		Contents.NumEntities++;
+		Contents.bEntityIdsAscending &= Entity->entity_id > LastEntityId;
+		LastEntityId = Entity->entity_id;
+
+		if (Entity->entity_id < FirstStartupActorEntityId)
+		{
+			continue;
+		}
+
+		// Entity ids are given to startup actors in the order they were spawned.
+		const int32 ActorIndex = Contents.NumStartupActorEntities++;
+		bool bPlaced = false;
+		for (uint32 i = 0; i < Entity->component_count; i++)
+		{
+			if (Entity->components[i].component_id == SpatialConstants::POSITION_COMPONENT_ID)
+			{
+				const improbable::Position Position(Entity->components[i]);
+				bPlaced = improbable::Coordinates::ToFVector(Position.Coords).Equals(GetTestActorLocation(ActorIndex), MAX_POSITION_ERROR);
+			}
+		}
+		Contents.NumMisplacedActors += bPlaced ? 0 : 1;
+	}
+
+	if (const char* Error = Worker_SnapshotInputStream_GetError(InputStream))
+	{
+		Contents.Error = UTF8_TO_TCHAR(Error);
+	}
+
+	Worker_SnapshotInputStream_Destroy(InputStream);
+
+	return Contents;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSnapshotGenerationTest, "SpatialGDK.Snapshot.StartupActors", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSnapshotGenerationTest::RunTest(const FString& Parameters)
+{
+	USpatialTypebindingManager* TypebindingManager = NewObject<USpatialTypebindingManager>();
+	TypebindingManager->Init();
+
+	UClass* ActorClass = FindStartupActorClass(TypebindingManager);
+	if (ActorClass == nullptr)
+	{
+		AddWarning(TEXT("No replicated actor class which can be spawned on its own is in the schema database, so snapshot generation can't be tested."));
+		return true;
+	}
+
+	TArray<int32> NumActorsToTest;
+	TArray<FString> NumActorsStrings;
+	Parameters.ParseIntoArrayWS(NumActorsStrings);
+	for (const FString& NumActorsString : NumActorsStrings)
+	{
+		if (NumActorsString.IsNumeric() && FCString::Atoi(*NumActorsString) > 0)
+		{
+			NumActorsToTest.Add(FCString::Atoi(*NumActorsString));
+		}
+	}
+	if (NumActorsToTest.Num() == 0)
+	{
+		NumActorsToTest.Append(DEFAULT_NUM_SNAPSHOT_ACTORS, ARRAY_COUNT(DEFAULT_NUM_SNAPSHOT_ACTORS));
+	}
+
+	const FString SnapshotPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("SnapshotGenerationTest"), TEXT(".snapshot")));
+	const int32 NumPlaceholders = SpatialConstants::PLACEHOLDER_ENTITY_ID_LAST - SpatialConstants::PLACEHOLDER_ENTITY_ID_FIRST + 1;
+
+	for (int32 NumActors : NumActorsToTest)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+
+		for (int32 i = 0; i < NumActors; i++)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			World->SpawnActor<AActor>(ActorClass, GetTestActorLocation(i), FRotator::ZeroRotator, SpawnParameters);
+		}
+
+		// Benchmark: generating the whole snapshot, and how much more memory is in use once it's written.
+		const uint64 UsedMemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bGenerated = SpatialGDKGenerateSnapshot(World, SnapshotPath);
+		const double GenerateSeconds = FPlatformTime::Seconds() - StartTime;
+		const int64 UsedMemoryGrowth = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(UsedMemoryBefore);
+
+		World->DestroyWorld(false);
+
+		if (!TestTrue(FString::Printf(TEXT("%d actors: the snapshot is generated"), NumActors), bGenerated))
+		{
+			break;
+		}
+
+		const int64 SnapshotBytes = FPlatformFileManager::Get().GetPlatformFile().FileSize(*SnapshotPath);
+		const FSnapshotContents Contents = ReadSnapshot(SnapshotPath);
+
+		TestTrue(FString::Printf(TEXT("%d actors: the snapshot can be read back: %s"), NumActors, *Contents.Error), Contents.Error.IsEmpty());
+		TestEqual(FString::Printf(TEXT("%d actors: every startup actor is in the snapshot"), NumActors), Contents.NumStartupActorEntities, NumActors);
+		TestEqual(FString::Printf(TEXT("%d actors: the spawner, global state manager and placeholders are in the snapshot"), NumActors), Contents.NumEntities - Contents.NumStartupActorEntities, 2 + NumPlaceholders);
+		TestTrue(FString::Printf(TEXT("%d actors: entities are written in entity id order"), NumActors), Contents.bEntityIdsAscending);
+		TestEqual(FString::Printf(TEXT("%d actors: every startup actor's entity is where the actor was"), NumActors), Contents.NumMisplacedActors, 0);
+
+		AddInfo(FString::Printf(TEXT("%d %s actors: generated a %.1f MB snapshot in %.3f s, with %.1f MB more memory in use afterwards."),
+			NumActors, *ActorClass->GetName(), SnapshotBytes / (1024.0 * 1024.0), GenerateSeconds, UsedMemoryGrowth / (1024.0 * 1024.0)));
+	}
+
+	FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*SnapshotPath);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,191 @@
+// Copyright (c) Improbable Worlds Ltd, All Rights Reserved
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Components/SceneComponent.h"
+#include "Engine/LevelScriptActor.h"
+#include "UObject/UObjectIterator.h"
+
+#include "SchemaGenerator/TypeStructure.h"
+
+namespace
+{
+
+// The number of classes to build type info for can be given as the test's parameters, e.g. "1000 5000". Editors don't load
+// that many replicated classes on their own, so the ones which are loaded are used several times over.
+const int32 DEFAULT_NUM_BENCHMARK_CLASSES[] = { 1000, 5000 };
+
+// Every loaded class with replicated or handover properties, as the schema generator picks them when generating schema for all supported classes.
+TArray<UClass*> GetReplicatedClasses()
+{
+	TArray<UClass*> Classes;
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->IsChildOf<USceneComponent>() || Class->IsChildOf<ALevelScriptActor>()
+			|| Class->GetName().StartsWith(TEXT("SKEL_"), ESearchCase::CaseSensitive) || Class->GetName().StartsWith(TEXT("REINST_"), ESearchCase::CaseSensitive))
+		{
+			continue;
+		}
+
+		for (TFieldIterator<UProperty> PropertyIt(Class); PropertyIt; ++PropertyIt)
+		{
+			if (PropertyIt->HasAnyPropertyFlags(CPF_Net | CPF_Handover))
+			{
+				Classes.Add(Class);
+				break;
+			}
+		}
+	}
+	return Classes;
+}
+
+// What schema generation reads from an AST: the replicated and handover handles with their property checksums, and the RPCs.
+FString DescribeTypeInfo(FUnrealType* TypeInfo)
+{
+	FString Description;
+
+	FUnrealFlatRepData RepData = GetFlatRepData(TypeInfo);
+	for (EReplicatedPropertyGroup Group : GetAllReplicatedPropertyGroups())
+	{
+		for (auto& RepProp : RepData[Group])
+		{
+			Description += FString::Printf(TEXT("R%d:%u:%u "), (int32)Group, RepProp.Key, RepProp.Value->CompatibleChecksum);
+		}
+	}
+
+	for (auto& HandoverProp : GetFlatHandoverData(TypeInfo))
+	{
+		Description += FString::Printf(TEXT("H%u:%u "), HandoverProp.Key, HandoverProp.Value->CompatibleChecksum);
+	}
+
+	FUnrealRPCsByType RPCsByType = GetAllRPCsByType(TypeInfo);
+	for (ERPCType Group : GetRPCTypes())
+	{
+		for (FUnrealRPC* RPC : RPCsByType[Group])
+		{
+			Description += FString::Printf(TEXT("P%d:%s:%d "), (int32)Group, *RPC->Function->GetName(), GetFlatRPCParameters(RPC).Num());
+		}
+	}
+
+	return Description;
+}
+
+} // ::
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTypeStructureParallelTest, "SpatialGDK.SchemaGenerator.TypeStructure.Parallel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTypeStructureParallelTest::RunTest(const FString& Parameters)
+{
+	const TArray<UClass*> Classes = GetReplicatedClasses();
+	if (Classes.Num() == 0)
+	{
+		AddWarning(TEXT("No replicated classes are loaded, so building type info can't be tested."));
+		return true;
+	}
+
+	PrepareClassesForTypeInfo(Classes);
+
+	// Building in parallel gives every class the same AST as building it on its own.
+	const TArray<FUnrealClassTypeInfo> ClassTypeInfos = CreateUnrealClassTypeInfos(Classes);
+	if (!TestEqual(TEXT("Type info is built for every class"), ClassTypeInfos.Num(), Classes.Num()))
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < Classes.Num(); i++)
+	{
+		FUnrealTypeArena Arena;
+		FUnrealType* TypeInfo = CreateUnrealTypeInfo(Arena, Classes[i], 0, 0, false);
+
+		if (!TestEqual(FString::Printf(TEXT("%s's type info is built in parallel as it is on its own"), *Classes[i]->GetName()), DescribeTypeInfo(ClassTypeInfos[i].TypeInfo), DescribeTypeInfo(TypeInfo)) ||
+			!TestEqual(FString::Printf(TEXT("%s's type info has as many nodes in parallel as on its own"), *Classes[i]->GetName()), ClassTypeInfos[i].Arena->GetNumNodes(), Arena.GetNumNodes()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTypeStructureBenchmark, "SpatialGDK.SchemaGenerator.TypeStructure.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTypeStructureBenchmark::RunTest(const FString& Parameters)
+{
+	const TArray<UClass*> ReplicatedClasses = GetReplicatedClasses();
+	if (ReplicatedClasses.Num() == 0)
+	{
+		AddWarning(TEXT("No replicated classes are loaded, so building type info can't be benchmarked."));
+		return true;
+	}
+
+	TArray<int32> NumClassesToBenchmark;
+	TArray<FString> NumClassesStrings;
+	Parameters.ParseIntoArrayWS(NumClassesStrings);
+	for (const FString& NumClassesString : NumClassesStrings)
+	{
+		if (NumClassesString.IsNumeric() && FCString::Atoi(*NumClassesString) > 0)
+		{
+			NumClassesToBenchmark.Add(FCString::Atoi(*NumClassesString));
+		}
+	}
+	if (NumClassesToBenchmark.Num() == 0)
+	{
+		NumClassesToBenchmark.Append(DEFAULT_NUM_BENCHMARK_CLASSES, ARRAY_COUNT(DEFAULT_NUM_BENCHMARK_CLASSES));
+	}
+
+	// Preparing is the same for every run, so it's timed once.
+	const double PrepareStartTime = FPlatformTime::Seconds();
+	const int32 NumPreparedClasses = PrepareClassesForTypeInfo(ReplicatedClasses);
+	const double PrepareSeconds = FPlatformTime::Seconds() - PrepareStartTime;
+	AddInfo(FString::Printf(TEXT("Prepared %d loaded replicated classes and %d subobject classes for type info in %.3f ms."),
+		ReplicatedClasses.Num(), NumPreparedClasses - ReplicatedClasses.Num(), 1000.0 * PrepareSeconds));
+
+	for (int32 NumClasses : NumClassesToBenchmark)
+	{
+		TArray<UClass*> Classes;
+		for (int32 i = 0; i < NumClasses; i++)
+		{
+			Classes.Add(ReplicatedClasses[i % ReplicatedClasses.Num()]);
+		}
+
+		// Benchmark: building every class's type info one after another, as schema generation used to, against in parallel.
+		int32 NumSerialNodes = 0;
+		const double SerialStartTime = FPlatformTime::Seconds();
+		for (UClass* Class : Classes)
+		{
+			FUnrealTypeArena Arena;
+			CreateUnrealTypeInfo(Arena, Class, 0, 0, false);
+			NumSerialNodes += Arena.GetNumNodes();
+		}
+		const double SerialSeconds = FPlatformTime::Seconds() - SerialStartTime;
+
+		const double ParallelStartTime = FPlatformTime::Seconds();
+		TArray<FUnrealClassTypeInfo> ClassTypeInfos = CreateUnrealClassTypeInfos(Classes);
+		const double ParallelSeconds = FPlatformTime::Seconds() - ParallelStartTime;
+
+		int32 NumParallelNodes = 0;
+		double SlowestClassSeconds = 0.0;
+		for (const FUnrealClassTypeInfo& ClassTypeInfo : ClassTypeInfos)
+		{
+			NumParallelNodes += ClassTypeInfo.Arena->GetNumNodes();
+			SlowestClassSeconds = FMath::Max(SlowestClassSeconds, ClassTypeInfo.BuildSeconds);
+		}
+
+		const double FreeStartTime = FPlatformTime::Seconds();
+		ClassTypeInfos.Empty();
+		const double FreeSeconds = FPlatformTime::Seconds() - FreeStartTime;
+
+		TestEqual(FString::Printf(TEXT("%d classes: as many nodes are built in parallel as one after another"), NumClasses), NumParallelNodes, NumSerialNodes);
+
+		AddInfo(FString::Printf(TEXT("%d classes: built %d AST nodes one class after another in %.3f ms, and in parallel in %.3f ms on %d threads (slowest class %.3f ms). Freeing the arenas took %.3f ms."),
+			NumClasses, NumParallelNodes, 1000.0 * SerialSeconds, 1000.0 * ParallelSeconds, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, 1000.0 * SlowestClassSeconds, 1000.0 * FreeSeconds));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -5,3 +5,6 @@
 DECLARE_LOG_CATEGORY_EXTERN(LogSpatialGDKSnapshot, Log, All);
 
 bool SpatialGDKGenerateSnapshot(UWorld* World);
+
+// Generates the snapshot at SavePath rather than where the toolbar settings say.
+bool SpatialGDKGenerateSnapshot(UWorld* World, FString SavePath);
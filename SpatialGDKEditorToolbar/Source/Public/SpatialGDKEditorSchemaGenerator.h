@@ -4,6 +4,49 @@
 
 #include "LogMacros.h"
 
+#include <WorkerSDK/improbable/c_worker.h>
+
+class USchemaDatabase;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogSpatialGDKSchemaGenerator, Log, All);
 
-bool SpatialGDKGenerateSchema();
+// Compacting releases the component ids of classes which no longer generate schema, and moves every other class back to
+// the ids derived from its path. This changes component ids, so snapshots must be regenerated and workers rebuilt.
+bool SpatialGDKGenerateSchema(bool bCompactComponentIds = false);
+
+// Allocates component ids to classes which don't have any, keeping the ids of every class which did, including classes which
+// no longer generate schema. Compacting instead discards every previous allocation and allocates ids from scratch.
+TMap<FString, Worker_ComponentId> AllocateComponentIds(const TArray<UClass*>& Classes, const TMap<FString, Worker_ComponentId>& ExistingComponentIds, bool bCompact);
+
+// What a run of GenerateSchemaFromClasses wrote and removed.
+struct FSchemaGenerationChanges
+{
+	// Classes which were new, changed, or had their schema file deleted since the last run.
+	TArray<UClass*> GeneratedClasses;
+
+	// Schema files of classes which no longer generate schema.
+	TArray<FString> RemovedSchemaFiles;
+
+	bool HasChanges() const { return GeneratedClasses.Num() > 0 || RemovedSchemaFiles.Num() > 0; }
+};
+
+// Writes the schema of each class to CombinedSchemaPath, skipping classes which are unchanged since the run recorded in the
+// schema cache at SchemaCachePath, and removes the schema of classes which are no longer given.
+FSchemaGenerationChanges GenerateSchemaFromClasses(const TArray<UClass*>& Classes, const FString& CombinedSchemaPath, const FString& SchemaCachePath, const TMap<FString, Worker_ComponentId>& ComponentIds);
+
+// What a call to UpdateSchemaDatabase changed.
+struct FSchemaDatabaseChanges
+{
+	// Classes whose entries were added, or changed because their component ids did.
+	TArray<UClass*> UpdatedClasses;
+
+	// Entries of classes which no longer generate schema.
+	int32 NumRemovedClasses = 0;
+
+	bool bComponentIdAllocationsChanged = false;
+
+	bool HasChanges() const { return UpdatedClasses.Num() > 0 || NumRemovedClasses > 0 || bComponentIdAllocationsChanged; }
+};
+
+// Brings SchemaDatabase up to date with Classes and their component ids, leaving the entries of unchanged classes as they are.
+FSchemaDatabaseChanges UpdateSchemaDatabase(USchemaDatabase* SchemaDatabase, const TArray<UClass*>& Classes, const TMap<FString, Worker_ComponentId>& ComponentIds);
@@ -51,6 +51,8 @@ private:
 	void LaunchInspectorWebpageButtonClicked();
 	void CreateSnapshotButtonClicked();
 	void SchemaGenerateButtonClicked();
+	void SchemaCompactButtonClicked();
+	void GenerateSchema(bool bCompactComponentIds);
 	void OnPropertyChanged(UObject* ObjectBeingModified, FPropertyChangedEvent& PropertyChangedEvent);
 
 	void CacheSpatialObjects(uint32 SpatialFlags);